@@ -0,0 +1,102 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesAdaptivePolicy.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief The location strategies used by ACPPlacesMonitorModeAdaptive
+ *
+ * @discussion
+ *  - far (ACPPlacesAdaptiveStateFar) - the device is away from every fence, only significant changes are used
+ *  - approaching (ACPPlacesAdaptiveStateApproaching) - the device is near a fence boundary, continuous updates are
+ *    used with a tightened accuracy and distance filter
+ *  - backed off (ACPPlacesAdaptiveStateBackedOff) - the device stayed near a fence longer than the continuous time
+ *    limit, only significant changes are used until the device moves away from the fence again
+ */
+typedef NS_ENUM(NSInteger, ACPPlacesAdaptiveState) {
+    ACPPlacesAdaptiveStateFar = 0,
+    ACPPlacesAdaptiveStateApproaching,
+    ACPPlacesAdaptiveStateBackedOff
+};
+
+/**
+ * @class ACPPlacesAdaptivePolicy
+ *
+ * @discussion The tunable rules used by ACPPlacesMonitorModeAdaptive to decide how closely the device's location
+ * needs to be tracked, based on its distance to the nearest fence boundary.
+ *
+ * The device starts approaching once it is within nearDistance meters of a boundary, and is only considered far
+ * again once it is at least farDistance meters away, so a device moving along the threshold does not flap between
+ * strategies.
+ */
+@interface ACPPlacesAdaptivePolicy : NSObject
+
+/**
+ * @brief Distance in meters from a fence boundary under which continuous updates are used
+ */
+@property(nonatomic) CLLocationDistance nearDistance;
+
+/**
+ * @brief Distance in meters from every fence boundary over which the device is considered far again
+ */
+@property(nonatomic) CLLocationDistance farDistance;
+
+/**
+ * @brief Maximum number of seconds continuous updates are used before backing off
+ */
+@property(nonatomic) NSTimeInterval continuousTimeLimit;
+
+@property(nonatomic) CLLocationAccuracy nearDesiredAccuracy;
+@property(nonatomic) CLLocationDistance nearDistanceFilter;
+@property(nonatomic) CLLocationAccuracy farDesiredAccuracy;
+@property(nonatomic) CLLocationDistance farDistanceFilter;
+
+/**
+ * @brief Creates a policy using the default values defined in ACPPlacesMonitorConstants
+ */
+- (instancetype) init;
+
+/**
+ * @brief Decides which strategy should be used next
+ *
+ * @param state the strategy currently in use
+ * @param distance the distance in meters from the device to the nearest fence boundary
+ * @param timeInState the number of seconds the current strategy has been in use
+ * @return the ACPPlacesAdaptiveState that should be used next
+ */
+- (ACPPlacesAdaptiveState) nextStateFromState: (ACPPlacesAdaptiveState) state
+                              distanceToFence: (CLLocationDistance) distance
+                                  timeInState: (NSTimeInterval) timeInState;
+
+/**
+ * @brief Indicates whether continuous location updates should be running for the provided state
+ */
+- (BOOL) usesContinuousUpdatesInState: (ACPPlacesAdaptiveState) state;
+
+- (CLLocationAccuracy) desiredAccuracyForState: (ACPPlacesAdaptiveState) state;
+- (CLLocationDistance) distanceFilterForState: (ACPPlacesAdaptiveState) state;
+
+/**
+ * @brief A readable name for the state, used for logging
+ */
++ (NSString*) nameForState: (ACPPlacesAdaptiveState) state;
+
+@end
+
+NS_ASSUME_NONNULL_END
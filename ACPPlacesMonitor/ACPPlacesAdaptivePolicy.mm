@@ -0,0 +1,67 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesAdaptivePolicy.mm
+//
+
+#import "ACPPlacesAdaptivePolicy.h"
+#import "ACPPlacesMonitorConstants.h"
+
+#include "placesmonitor/AdaptivePolicy.hpp"
+
+@implementation ACPPlacesAdaptivePolicy
+
+- (instancetype) init {
+    if (self = [super init]) {
+        self.nearDistance = ACPPlacesMonitorAdaptiveNearDistance;
+        self.farDistance = ACPPlacesMonitorAdaptiveFarDistance;
+        self.continuousTimeLimit = ACPPlacesMonitorAdaptiveContinuousTimeLimit;
+        self.nearDesiredAccuracy = kCLLocationAccuracyNearestTenMeters;
+        self.nearDistanceFilter = ACPPlacesMonitorAdaptiveNearDistanceFilter;
+        self.farDesiredAccuracy = kCLLocationAccuracyHundredMeters;
+        self.farDistanceFilter = ACPPlacesMonitorDefaultDistanceFilter;
+    }
+
+    return self;
+}
+
+- (ACPPlacesAdaptiveState) nextStateFromState: (ACPPlacesAdaptiveState) state
+                              distanceToFence: (CLLocationDistance) distance
+                                  timeInState: (NSTimeInterval) timeInState {
+    placesmonitor::AdaptivePolicy policy;
+    policy.nearDistance = _nearDistance;
+    policy.farDistance = _farDistance;
+    policy.continuousTimeLimit = _continuousTimeLimit;
+
+    return static_cast<ACPPlacesAdaptiveState>(policy.nextState(static_cast<placesmonitor::AdaptiveState>(state),
+                                                                distance,
+                                                                timeInState));
+}
+
+- (BOOL) usesContinuousUpdatesInState: (ACPPlacesAdaptiveState) state {
+    return placesmonitor::AdaptivePolicy::usesContinuousUpdates(static_cast<placesmonitor::AdaptiveState>(state));
+}
+
+- (CLLocationAccuracy) desiredAccuracyForState: (ACPPlacesAdaptiveState) state {
+    return [self usesContinuousUpdatesInState:state] ? _nearDesiredAccuracy : _farDesiredAccuracy;
+}
+
+- (CLLocationDistance) distanceFilterForState: (ACPPlacesAdaptiveState) state {
+    return [self usesContinuousUpdatesInState:state] ? _nearDistanceFilter : _farDistanceFilter;
+}
+
++ (NSString*) nameForState: (ACPPlacesAdaptiveState) state {
+    return @(placesmonitor::AdaptivePolicy::name(static_cast<placesmonitor::AdaptiveState>(state)));
+}
+
+@end
@@ -0,0 +1,141 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesBeaconRanger.h
+//
+
+#import <ACPPlaces/ACPPlaces.h>
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesMetrics;
+
+/**
+ * @class ACPPlacesBeaconRanger
+ *
+ * @discussion Ranges the beacons placed in POIs, and turns the readings into entries and exits of those POIs.
+ *
+ * A POI carries its beacon in its metadata, under the ACPPlacesMonitorPoiMetadataBeacon keys.  The monitor hands the
+ * ranger the beacon POIs whose geofence contains the device, and nothing is ranged while there are none.  The beacons
+ * are ranged as one CLBeaconRegion per UUID, in windows of rangingWindow seconds every rangingInterval seconds, so the
+ * radio is not kept on for as long as the device stays in the geofence.
+ *
+ * Ranging runs on a CLLocationManager of its own, since ranging results are delivered to the delegate of the manager
+ * that started it.  The manager is created on the main thread the first time it is needed.
+ *
+ * The clock, timer and location manager can be replaced for testing.
+ */
+@interface ACPPlacesBeaconRanger : NSObject <CLLocationManagerDelegate>
+
+/**
+ * @brief Number of seconds beacons are ranged for in each window
+ */
+@property(nonatomic, readonly) NSTimeInterval rangingWindow;
+
+/**
+ * @brief Number of seconds from the start of one ranging window to the start of the next
+ */
+@property(nonatomic, readonly) NSTimeInterval rangingInterval;
+
+/**
+ * @brief YES while there are beacon POIs to range for
+ */
+@property(nonatomic, readonly) BOOL isActive;
+
+/**
+ * @brief YES during a ranging window
+ */
+@property(nonatomic, readonly) BOOL isRanging;
+
+/**
+ * @brief Number of beacon POIs being ranged for
+ */
+@property(nonatomic, readonly) NSUInteger count;
+
+/**
+ * @brief Receives the beacon entry, entry latency and ranging time metrics, if set
+ */
+@property(nonatomic, strong, nullable) ACPPlacesMetrics* metrics;
+
+/**
+ * @brief Called with the beacon region of a POI when it is entered or exited, outside of the ranger's lock
+ *
+ * @discussion The identifier of the region is the identifier of the POI.
+ */
+@property(nonatomic, copy, nullable) void (^transitionHandler)(CLBeaconRegion* region, ACPRegionEventType type);
+
+/**
+ * @brief Returns the current time in seconds, defaults to the system uptime
+ */
+@property(nonatomic, copy) NSTimeInterval (^clock)(void);
+
+/**
+ * @brief Runs the block after the delay, defaults to dispatch_after on a utility queue
+ */
+@property(nonatomic, copy) void (^dispatcher)(NSTimeInterval delay, dispatch_block_t block);
+
+/**
+ * @brief Creates the CLLocationManager used for ranging, called on the main thread
+ */
+@property(nonatomic, copy) CLLocationManager* (^locationManagerFactory)(void);
+
+/**
+ * @brief Creates a ranger using the ranging window and interval defined in ACPPlacesMonitorConstants
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates a ranger which ranges for window seconds every interval seconds
+ */
+- (instancetype) initWithRangingWindow: (NSTimeInterval) window
+                              interval: (NSTimeInterval) interval NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Returns YES if the device can range beacons
+ */
++ (BOOL) isRangingAvailable;
+
+/**
+ * @brief Returns the beacon region described by the metadata of the POI
+ *
+ * @return a CLBeaconRegion identified by the POI identifier, or nil if the POI has no valid beacon UUID
+ */
++ (nullable CLBeaconRegion*) beaconRegionForPoi: (ACPPlacesPoi*) poi;
+
+/**
+ * @brief Replaces the beacon POIs to range for
+ *
+ * @discussion POIs which are kept keep their state.  An entered POI which is not in the list is exited.  POIs
+ * without a beacon are ignored.
+ *
+ * @param pois the beacon POIs whose geofence contains the device
+ */
+- (void) rangePois: (NSArray<ACPPlacesPoi*>*) pois;
+
+/**
+ * @brief Updates the POIs from the beacons heard in one ranging round
+ *
+ * @param beacons every beacon heard in the round, possibly none
+ */
+- (void) processBeacons: (NSArray<CLBeacon*>*) beacons;
+
+/**
+ * @brief Stops ranging and forgets every POI, without reporting exits
+ */
+- (void) stop;
+
+@end
+
+NS_ASSUME_NONNULL_END
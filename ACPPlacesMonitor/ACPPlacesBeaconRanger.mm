@@ -0,0 +1,416 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesBeaconRanger.mm
+//
+
+#import <ACPCore/ACPCore.h>
+#import "ACPPlacesBeaconRanger.h"
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesMetrics.h"
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesMonitorLog.h"
+
+#include <cmath>
+
+#include "placesmonitor/BeaconTracker.hpp"
+
+static placesmonitor::BeaconIdentity ACPPlacesCoreBeaconIdentity(NSUUID* uuid, NSNumber* major, NSNumber* minor) {
+    placesmonitor::BeaconIdentity identity;
+    identity.uuid = ACPPlacesCoreString(uuid.UUIDString);
+    identity.major = major ? major.intValue : -1;
+    identity.minor = minor ? minor.intValue : -1;
+    return identity;
+}
+
+static NSNumber* ACPPlacesBeaconValue(NSString* value) {
+    if (!value.length) {
+        return nil;
+    }
+
+    // majors and minors are unsigned 16 bit values
+    NSInteger number = value.integerValue;
+    return number >= 0 && number <= UINT16_MAX ? @(number) : nil;
+}
+
+@interface ACPPlacesBeaconRanger() {
+    placesmonitor::BeaconTracker _tracker;
+}
+@property(nonatomic, strong, nullable) CLLocationManager* locationManager;
+@property(nonatomic, strong) NSDictionary<NSString*, CLBeaconRegion*>* poiRegions;
+@property(nonatomic, strong) NSMutableDictionary<NSString*, NSNumber*>* waitingSince;
+@property(nonatomic, strong) NSArray<CLBeaconRegion*>* rangedRegions;
+@property(nonatomic, readwrite) BOOL isRanging;
+@property(nonatomic) NSTimeInterval windowStartedAt;
+@property(nonatomic) NSUInteger timerGeneration;
+@end
+
+@implementation ACPPlacesBeaconRanger
+
+- (instancetype) init {
+    return [self initWithRangingWindow:ACPPlacesMonitorBeaconRangingWindow
+                              interval:ACPPlacesMonitorBeaconRangingInterval];
+}
+
+- (instancetype) initWithRangingWindow: (NSTimeInterval) window interval: (NSTimeInterval) interval {
+    if (self = [super init]) {
+        _rangingWindow = MAX(window, 0);
+        _rangingInterval = MAX(interval, 0);
+        _tracker = placesmonitor::BeaconTracker(ACPPlacesMonitorBeaconEntryDistance,
+                                                ACPPlacesMonitorBeaconExitDistance,
+                                                ACPPlacesMonitorBeaconExitTimeout);
+        self.poiRegions = @{};
+        self.waitingSince = [[NSMutableDictionary alloc] init];
+        self.rangedRegions = @[];
+
+        self.clock = ^NSTimeInterval {
+            return [[NSProcessInfo processInfo] systemUptime];
+        };
+        self.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                           dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), block);
+        };
+        self.locationManagerFactory = ^CLLocationManager* {
+            return [[CLLocationManager alloc] init];
+        };
+    }
+
+    return self;
+}
+
++ (BOOL) isRangingAvailable {
+    return [CLLocationManager isRangingAvailable];
+}
+
++ (CLBeaconRegion*) beaconRegionForPoi: (ACPPlacesPoi*) poi {
+    NSString* uuidString = poi.metaData[ACPPlacesMonitorPoiMetadataBeaconUuid];
+    NSUUID* uuid = uuidString.length ? [[NSUUID alloc] initWithUUIDString:uuidString] : nil;
+
+    if (!uuid || !poi.identifier) {
+        return nil;
+    }
+
+    NSNumber* major = ACPPlacesBeaconValue(poi.metaData[ACPPlacesMonitorPoiMetadataBeaconMajor]);
+    NSNumber* minor = major ? ACPPlacesBeaconValue(poi.metaData[ACPPlacesMonitorPoiMetadataBeaconMinor]) : nil;
+
+    if (minor) {
+        return [[CLBeaconRegion alloc] initWithProximityUUID:uuid
+                                                       major:major.unsignedShortValue
+                                                       minor:minor.unsignedShortValue
+                                                  identifier:poi.identifier];
+    } else if (major) {
+        return [[CLBeaconRegion alloc] initWithProximityUUID:uuid
+                                                       major:major.unsignedShortValue
+                                                  identifier:poi.identifier];
+    }
+
+    return [[CLBeaconRegion alloc] initWithProximityUUID:uuid identifier:poi.identifier];
+}
+
+- (BOOL) isActive {
+    @synchronized (self) {
+        return _poiRegions.count > 0;
+    }
+}
+
+- (NSUInteger) count {
+    @synchronized (self) {
+        return _poiRegions.count;
+    }
+}
+
+- (void) rangePois: (NSArray<ACPPlacesPoi*>*) pois {
+    NSMutableArray<CLBeaconRegion*>* exits = [[NSMutableArray alloc] init];
+
+    @synchronized (self) {
+        NSMutableDictionary<NSString*, CLBeaconRegion*>* poiRegions = [[NSMutableDictionary alloc] init];
+        std::vector<placesmonitor::BeaconPoi> beaconPois;
+        beaconPois.reserve(pois.count);
+
+        for (ACPPlacesPoi* poi in pois) {
+            CLBeaconRegion* region = [ACPPlacesBeaconRanger beaconRegionForPoi:poi];
+
+            if (!region || poiRegions[region.identifier]) {
+                continue;
+            }
+
+            poiRegions[region.identifier] = region;
+            placesmonitor::BeaconPoi beaconPoi;
+            beaconPoi.identifier = ACPPlacesCoreString(region.identifier);
+            beaconPoi.beacon = ACPPlacesCoreBeaconIdentity(region.proximityUUID, region.major, region.minor);
+            beaconPois.push_back(beaconPoi);
+        }
+
+        placesmonitor::BeaconTracker::Transitions transitions = _tracker.track(beaconPois);
+
+        for (const std::string& identifier : transitions.exited) {
+            CLBeaconRegion* region = _poiRegions[ACPPlacesNSString(identifier)];
+
+            if (region) {
+                [exits addObject:region];
+            }
+        }
+
+        // the entry latency of a POI runs from when its geofence was entered
+        NSTimeInterval now = _clock();
+        NSMutableDictionary<NSString*, NSNumber*>* waitingSince = [[NSMutableDictionary alloc] init];
+
+        for (NSString* identifier in poiRegions) {
+            waitingSince[identifier] = _waitingSince[identifier] ?: @(now);
+        }
+
+        BOOL wasActive = _poiRegions.count > 0;
+        self.poiRegions = poiRegions;
+        self.waitingSince = waitingSince;
+
+        if (!poiRegions.count) {
+            _timerGeneration++;
+            [self endWindow];
+        } else if (!wasActive) {
+            [self startWindow];
+        } else if (_isRanging) {
+            // the UUIDs may have changed, the window which is running picks them up
+            [self rangeRegions:[self uuidRegions]];
+        }
+    }
+
+    [self reportRegions:exits eventType:ACPRegionEventTypeExit];
+}
+
+- (void) processBeacons: (NSArray<CLBeacon*>*) beacons {
+    NSMutableArray<CLBeaconRegion*>* entries = [[NSMutableArray alloc] init];
+    NSMutableArray<CLBeaconRegion*>* exits = [[NSMutableArray alloc] init];
+
+    @synchronized (self) {
+        if (!_poiRegions.count) {
+            return;
+        }
+
+        std::vector<placesmonitor::BeaconReading> readings;
+        readings.reserve(beacons.count);
+
+        for (CLBeacon* beacon in beacons) {
+            placesmonitor::BeaconReading reading;
+            reading.beacon = ACPPlacesCoreBeaconIdentity(beacon.proximityUUID, beacon.major, beacon.minor);
+            reading.distance = beacon.accuracy;
+            readings.push_back(reading);
+        }
+
+        NSTimeInterval now = _clock();
+        placesmonitor::BeaconTracker::Transitions transitions = _tracker.update(readings, now);
+
+        for (const std::string& identifier : transitions.entered) {
+            NSString* poiIdentifier = ACPPlacesNSString(identifier);
+            [entries addObject:_poiRegions[poiIdentifier]];
+
+            NSNumber* waitingSince = _waitingSince[poiIdentifier];
+            [_metrics incrementCounter:ACPPlacesMetricCounterBeaconEntries];
+            [_metrics recordValue:now - waitingSince.doubleValue inHistogram:ACPPlacesMetricHistogramBeaconEntryLatency];
+        }
+
+        for (const std::string& identifier : transitions.exited) {
+            NSString* poiIdentifier = ACPPlacesNSString(identifier);
+            [exits addObject:_poiRegions[poiIdentifier]];
+
+            // a later entry during the same geofence visit is measured from the exit
+            _waitingSince[poiIdentifier] = @(now);
+        }
+    }
+
+    [self reportRegions:exits eventType:ACPRegionEventTypeExit];
+    [self reportRegions:entries eventType:ACPRegionEventTypeEntry];
+}
+
+- (void) stop {
+    @synchronized (self) {
+        _tracker.track({});
+        self.poiRegions = @{};
+        [_waitingSince removeAllObjects];
+        _timerGeneration++;
+        [self endWindow];
+    }
+}
+
+#pragma mark - CLLocationManagerDelegate
+- (void) locationManager: (CLLocationManager*) manager
+         didRangeBeacons: (NSArray<CLBeacon*>*) beacons
+                inRegion: (CLBeaconRegion*) region {
+    [self processBeacons:beacons];
+}
+
+- (void) locationManager: (CLLocationManager*) manager
+        rangingBeaconsDidFailForRegion: (CLBeaconRegion*) region
+                             withError: (NSError*) error {
+    ACPPlacesMonitorLogWarning(@"Ranging beacons failed for region %@: %@", region.identifier, error.localizedDescription);
+}
+
+#pragma mark - private methods
+/**
+ * @brief Must be called while holding the lock
+ */
+- (void) startWindow {
+    _isRanging = YES;
+    _windowStartedAt = _clock();
+    [self rangeRegions:[self uuidRegions]];
+
+    // a window as long as the interval never closes
+    if (_rangingWindow >= _rangingInterval) {
+        return;
+    }
+
+    NSUInteger generation = ++_timerGeneration;
+    __weak ACPPlacesBeaconRanger* weakSelf = self;
+    _dispatcher(_rangingWindow, ^{
+        [weakSelf windowElapsedForGeneration:generation];
+    });
+}
+
+/**
+ * @brief Must be called while holding the lock
+ */
+- (void) endWindow {
+    if (!_isRanging) {
+        return;
+    }
+
+    _isRanging = NO;
+    [_metrics addValue:(uint64_t) llround(_clock() - _windowStartedAt) toCounter:ACPPlacesMetricCounterBeaconRangingSeconds];
+    [self rangeRegions:@[]];
+}
+
+- (void) windowElapsedForGeneration: (NSUInteger) generation {
+    @synchronized (self) {
+        if (generation != _timerGeneration) {
+            return;
+        }
+
+        [self endWindow];
+
+        NSUInteger nextGeneration = ++_timerGeneration;
+        __weak ACPPlacesBeaconRanger* weakSelf = self;
+        _dispatcher(_rangingInterval - _rangingWindow, ^{
+            [weakSelf windowDueForGeneration:nextGeneration];
+        });
+    }
+}
+
+- (void) windowDueForGeneration: (NSUInteger) generation {
+    @synchronized (self) {
+        if (generation != _timerGeneration || !_poiRegions.count) {
+            return;
+        }
+
+        [self startWindow];
+    }
+}
+
+/**
+ * @brief Must be called while holding the lock
+ *
+ * @discussion Every beacon sharing a UUID is heard through a single region, however many POIs they belong to.
+ */
+- (NSArray<CLBeaconRegion*>*) uuidRegions {
+    NSMutableArray<CLBeaconRegion*>* regions = [[NSMutableArray alloc] init];
+
+    for (const std::string& uuid : _tracker.uuids()) {
+        NSString* uuidString = ACPPlacesNSString(uuid);
+        NSString* identifier = [ACPPlacesMonitorBeaconRegionIdentifierPrefix stringByAppendingString:uuidString];
+        [regions addObject:[[CLBeaconRegion alloc] initWithProximityUUID:[[NSUUID alloc] initWithUUIDString:uuidString]
+                                                              identifier:identifier]];
+    }
+
+    return regions;
+}
+
+/**
+ * @brief Must be called while holding the lock
+ *
+ * @discussion Only the difference to the regions being ranged is sent to the location manager.
+ */
+- (void) rangeRegions: (NSArray<CLBeaconRegion*>*) regions {
+    NSSet<NSString*>* identifiers = [NSSet setWithArray:[regions valueForKey:@"identifier"]];
+    NSSet<NSString*>* rangedIdentifiers = [NSSet setWithArray:[_rangedRegions valueForKey:@"identifier"]];
+    NSMutableArray<CLBeaconRegion*>* stopped = [[NSMutableArray alloc] init];
+    NSMutableArray<CLBeaconRegion*>* started = [[NSMutableArray alloc] init];
+
+    for (CLBeaconRegion* region in _rangedRegions) {
+        if (![identifiers containsObject:region.identifier]) {
+            [stopped addObject:region];
+        }
+    }
+
+    for (CLBeaconRegion* region in regions) {
+        if (![rangedIdentifiers containsObject:region.identifier]) {
+            [started addObject:region];
+        }
+    }
+
+    self.rangedRegions = regions;
+
+    if (!stopped.count && !started.count) {
+        return;
+    }
+
+    [self performWithLocationManager:^(CLLocationManager* locationManager) {
+        for (CLBeaconRegion* region in stopped) {
+            [locationManager stopRangingBeaconsInRegion:region];
+        }
+
+        for (CLBeaconRegion* region in started) {
+            [locationManager startRangingBeaconsInRegion:region];
+        }
+    }];
+}
+
+/**
+ * @brief Runs the block with the ranging CLLocationManager on the main thread, creating the manager if needed
+ *
+ * @discussion Blocks run in the order they were handed over, so a stop never overtakes the start before it.
+ */
+- (void) performWithLocationManager: (void (^)(CLLocationManager* locationManager)) block {
+    __weak ACPPlacesBeaconRanger* weakSelf = self;
+    dispatch_block_t run = ^{
+        ACPPlacesBeaconRanger* strongSelf = weakSelf;
+
+        if (!strongSelf) {
+            return;
+        }
+
+        if (!strongSelf.locationManager) {
+            CLLocationManager* locationManager = strongSelf.locationManagerFactory();
+            locationManager.delegate = strongSelf;
+            strongSelf.locationManager = locationManager;
+        }
+
+        block(strongSelf.locationManager);
+    };
+
+    if ([NSThread isMainThread]) {
+        run();
+        return;
+    }
+
+    dispatch_async(dispatch_get_main_queue(), run);
+}
+
+- (void) reportRegions: (NSArray<CLBeaconRegion*>*) regions eventType: (ACPRegionEventType) type {
+    if (!_transitionHandler) {
+        return;
+    }
+
+    for (CLBeaconRegion* region in regions) {
+        _transitionHandler(region, type);
+    }
+}
+
+@end
@@ -0,0 +1,79 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesContainmentEngine.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesPoi;
+
+/**
+ * @class ACPPlacesContainmentEngine
+ *
+ * @discussion Detects geofence entries and exits on the device by testing location fixes against the circles of
+ * the monitored POIs, without waiting for CoreLocation's region callbacks.
+ *
+ * The circles are stored as parallel arrays of coordinates so a fix can be tested against all of them in one tight
+ * loop.  To avoid flapping on noisy fixes, an entry requires the fix to be inside the circle by at least a hysteresis
+ * band, and an exit requires it to be outside the circle by at least the same band.  The band grows with the
+ * horizontal accuracy of the fix.
+ */
+@interface ACPPlacesContainmentEngine : NSObject
+
+/**
+ * @brief Number of circles the engine is testing against
+ */
+@property(nonatomic, readonly) NSUInteger count;
+
+/**
+ * @brief Creates an engine using the default values defined in ACPPlacesMonitorConstants
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates an engine with the provided hysteresis settings
+ *
+ * @param minimumBand the smallest hysteresis band in meters, used for very accurate fixes
+ * @param maximumAccuracy fixes with a horizontal accuracy worse than this many meters are ignored
+ */
+- (instancetype) initWithMinimumBand: (CLLocationDistance) minimumBand
+                     maximumAccuracy: (CLLocationAccuracy) maximumAccuracy NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Replaces the circles tested by the engine
+ *
+ * @param pois the POIs whose circles should be tested
+ */
+- (void) loadPois: (NSArray<ACPPlacesPoi*>*) pois;
+
+/**
+ * @brief Tests the location against every loaded circle
+ *
+ * @param location the location fix to test
+ * @param insideIdentifiers identifiers of the POIs the device is currently known to be within
+ * @param entered on return, the regions the device has entered
+ * @param exited on return, the regions the device has exited
+ * @return NO if the fix was not accurate enough to be evaluated
+ */
+- (BOOL) evaluateLocation: (CLLocation*) location
+        insideIdentifiers: (NSSet<NSString*>*) insideIdentifiers
+                  entered: (NSArray<CLCircularRegion*>* _Nullable * _Nonnull) entered
+                   exited: (NSArray<CLCircularRegion*>* _Nullable * _Nonnull) exited;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,110 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesContainmentEngine.mm
+//
+
+#import <ACPPlaces/ACPPlaces.h>
+#import "ACPPlacesContainmentEngine.h"
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesMonitorConstants.h"
+
+#include "placesmonitor/ContainmentEngine.hpp"
+
+@interface ACPPlacesContainmentEngine() {
+    placesmonitor::ContainmentEngine _engine;
+
+    // scratch buffers reused between fixes to keep the hot path free of allocations
+    std::vector<bool> _inside;
+    std::vector<std::size_t> _entered;
+    std::vector<std::size_t> _exited;
+}
+@property(nonatomic, strong) NSArray<CLCircularRegion*>* regions;
+@end
+
+@implementation ACPPlacesContainmentEngine
+
+- (instancetype) init {
+    return [self initWithMinimumBand:ACPPlacesMonitorContainmentMinimumBand
+                     maximumAccuracy:ACPPlacesMonitorContainmentMaximumAccuracy];
+}
+
+- (instancetype) initWithMinimumBand: (CLLocationDistance) minimumBand
+                     maximumAccuracy: (CLLocationAccuracy) maximumAccuracy {
+    if (self = [super init]) {
+        _engine = placesmonitor::ContainmentEngine(minimumBand, maximumAccuracy);
+        self.regions = @[];
+    }
+
+    return self;
+}
+
+- (NSUInteger) count {
+    return _engine.count();
+}
+
+- (void) loadPois: (NSArray<ACPPlacesPoi*>*) pois {
+    NSMutableArray<CLCircularRegion*>* regions = [[NSMutableArray alloc] initWithCapacity:pois.count];
+    std::vector<placesmonitor::Region> coreRegions;
+    coreRegions.reserve(pois.count);
+
+    for (ACPPlacesPoi* poi in pois) {
+        placesmonitor::Region region;
+        region.identifier = ACPPlacesCoreString(poi.identifier);
+        region.center = placesmonitor::Coordinate{poi.latitude, poi.longitude};
+        region.radius = poi.radius;
+        coreRegions.push_back(region);
+
+        [regions addObject:ACPPlacesCircularRegion(region)];
+    }
+
+    _engine.load(coreRegions);
+    self.regions = regions;
+}
+
+- (BOOL) evaluateLocation: (CLLocation*) location
+        insideIdentifiers: (NSSet<NSString*>*) insideIdentifiers
+                  entered: (NSArray<CLCircularRegion*>**) entered
+                   exited: (NSArray<CLCircularRegion*>**) exited {
+    *entered = nil;
+    *exited = nil;
+
+    const NSUInteger count = _regions.count;
+    _inside.assign(count, false);
+
+    for (NSUInteger i = 0; i < count; i++) {
+        _inside[i] = [insideIdentifiers containsObject:_regions[i].identifier];
+    }
+
+    if (!_engine.evaluate(ACPPlacesCoreLocation(location), _inside, _entered, _exited)) {
+        return NO;
+    }
+
+    NSMutableArray<CLCircularRegion*>* enteredRegions = [[NSMutableArray alloc] initWithCapacity:_entered.size()];
+    NSMutableArray<CLCircularRegion*>* exitedRegions = [[NSMutableArray alloc] initWithCapacity:_exited.size()];
+
+    for (std::size_t index : _entered) {
+        [enteredRegions addObject:_regions[index]];
+    }
+
+    for (std::size_t index : _exited) {
+        [exitedRegions addObject:_regions[index]];
+    }
+
+    *entered = enteredRegions;
+    *exited = exitedRegions;
+
+    return YES;
+}
+
+@end
@@ -0,0 +1,111 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesCoreBridge.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+#import <ACPPlaces/ACPPlaces.h>
+
+#include <string>
+#include <vector>
+
+#include "placesmonitor/Types.hpp"
+
+// conversions between the Foundation and CoreLocation types and the types of the portable core, ObjC++ only
+
+static inline std::string ACPPlacesCoreString(NSString* string) {
+    return string ? std::string(string.UTF8String) : std::string();
+}
+
+static inline NSString* ACPPlacesNSString(const std::string& string) {
+    return [[NSString alloc] initWithBytes:string.data() length:string.size() encoding:NSUTF8StringEncoding];
+}
+
+static inline placesmonitor::Coordinate ACPPlacesCoreCoordinate(CLLocationCoordinate2D coordinate) {
+    return placesmonitor::Coordinate{coordinate.latitude, coordinate.longitude};
+}
+
+static inline placesmonitor::Location ACPPlacesCoreLocation(CLLocation* location) {
+    placesmonitor::Location coreLocation;
+    coreLocation.coordinate = ACPPlacesCoreCoordinate(location.coordinate);
+    coreLocation.horizontalAccuracy = location.horizontalAccuracy;
+    coreLocation.speed = location.speed;
+    coreLocation.course = location.course;
+    coreLocation.timestamp = location.timestamp.timeIntervalSince1970;
+    return coreLocation;
+}
+
+static inline CLLocation* ACPPlacesCLLocation(const placesmonitor::Location& location) {
+    return [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(location.coordinate.latitude,
+                                                                             location.coordinate.longitude)
+                                         altitude:0
+                               horizontalAccuracy:location.horizontalAccuracy
+                                 verticalAccuracy:-1
+                                           course:location.course
+                                            speed:location.speed
+                                        timestamp:[NSDate dateWithTimeIntervalSince1970:location.timestamp]];
+}
+
+static inline placesmonitor::Poi ACPPlacesCorePoi(ACPPlacesPoi* poi) {
+    placesmonitor::Poi corePoi;
+    corePoi.identifier = ACPPlacesCoreString(poi.identifier);
+    corePoi.center = placesmonitor::Coordinate{poi.latitude, poi.longitude};
+    corePoi.radius = poi.radius;
+    corePoi.userIsWithin = poi.userIsWithin;
+    corePoi.name = ACPPlacesCoreString(poi.name);
+    return corePoi;
+}
+
+static inline ACPPlacesPoi* ACPPlacesPoiFromCorePoi(const placesmonitor::Poi& corePoi) {
+    ACPPlacesPoi* poi = [[ACPPlacesPoi alloc] init];
+    poi.identifier = ACPPlacesNSString(corePoi.identifier);
+    poi.name = ACPPlacesNSString(corePoi.name);
+    poi.latitude = corePoi.center.latitude;
+    poi.longitude = corePoi.center.longitude;
+    poi.radius = (NSUInteger) corePoi.radius;
+    poi.userIsWithin = corePoi.userIsWithin;
+    return poi;
+}
+
+static inline std::vector<placesmonitor::Poi> ACPPlacesCorePois(NSArray<ACPPlacesPoi*>* pois) {
+    std::vector<placesmonitor::Poi> corePois;
+    corePois.reserve(pois.count);
+
+    for (ACPPlacesPoi* poi in pois) {
+        corePois.push_back(ACPPlacesCorePoi(poi));
+    }
+
+    return corePois;
+}
+
+static inline placesmonitor::Region ACPPlacesCoreRegion(CLCircularRegion* region) {
+    placesmonitor::Region coreRegion;
+    coreRegion.identifier = ACPPlacesCoreString(region.identifier);
+    coreRegion.center = ACPPlacesCoreCoordinate(region.center);
+    coreRegion.radius = region.radius;
+    coreRegion.notifyOnEntry = region.notifyOnEntry;
+    coreRegion.notifyOnExit = region.notifyOnExit;
+    return coreRegion;
+}
+
+static inline CLCircularRegion* ACPPlacesCircularRegion(const placesmonitor::Region& region) {
+    CLCircularRegion* circularRegion = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(region.center.latitude,
+                                                                                                          region.center.longitude)
+                                                                         radius:region.radius
+                                                                     identifier:ACPPlacesNSString(region.identifier)];
+    circularRegion.notifyOnEntry = region.notifyOnEntry;
+    circularRegion.notifyOnExit = region.notifyOnExit;
+    return circularRegion;
+}
@@ -0,0 +1,68 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesGeofenceDiff.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @class ACPPlacesGeofenceDiff
+ *
+ * @discussion Compares the geofences the monitor wants registered with the regions it currently has registered
+ * with the CLLocationManager, producing the minimal set of start and stop operations needed to reconcile them.
+ *
+ * A desired region that is already registered with the same center and radius is kept untouched.  A region that is
+ * registered with a different center or radius is stopped and started again with its new geometry.  Only regions
+ * whose identifiers are owned by the monitor are ever stopped, so regions registered elsewhere in the app are safe.
+ */
+@interface ACPPlacesGeofenceDiff : NSObject
+
+/**
+ * @brief Regions that must be registered with the CLLocationManager, including updated regions
+ */
+@property(nonatomic, readonly) NSArray<CLCircularRegion*>* regionsToStart;
+
+/**
+ * @brief Regions that must be unregistered from the CLLocationManager, including the old geometry of updated regions
+ */
+@property(nonatomic, readonly) NSArray<CLRegion*>* regionsToStop;
+
+/**
+ * @brief Identifiers of regions which are already registered and need no changes
+ */
+@property(nonatomic, readonly) NSArray<NSString*>* keptIdentifiers;
+
+@property(nonatomic, readonly) NSUInteger addedCount;
+@property(nonatomic, readonly) NSUInteger removedCount;
+@property(nonatomic, readonly) NSUInteger updatedCount;
+@property(nonatomic, readonly) NSUInteger keptCount;
+
+/**
+ * @brief Calculates the operations needed to move from the monitored regions to the desired regions
+ *
+ * @param desiredRegions the regions that should be registered after reconciliation
+ * @param monitoredRegions the regions currently registered with the CLLocationManager
+ * @param ownedIdentifiers identifiers of the regions registered by the monitor
+ * @return a new ACPPlacesGeofenceDiff
+ */
++ (instancetype) diffWithDesiredRegions: (NSArray<CLCircularRegion*>*) desiredRegions
+                       monitoredRegions: (nullable NSSet<CLRegion*>*) monitoredRegions
+                       ownedIdentifiers: (NSSet<NSString*>*) ownedIdentifiers;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,102 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesGeofenceDiff.mm
+//
+
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesGeofenceDiff.h"
+
+#include <unordered_set>
+
+#include "placesmonitor/GeofenceDiff.hpp"
+
+@interface ACPPlacesGeofenceDiff()
+@property(nonatomic, readwrite) NSArray<CLCircularRegion*>* regionsToStart;
+@property(nonatomic, readwrite) NSArray<CLRegion*>* regionsToStop;
+@property(nonatomic, readwrite) NSArray<NSString*>* keptIdentifiers;
+@property(nonatomic, readwrite) NSUInteger addedCount;
+@property(nonatomic, readwrite) NSUInteger removedCount;
+@property(nonatomic, readwrite) NSUInteger updatedCount;
+@end
+
+@implementation ACPPlacesGeofenceDiff
+
++ (instancetype) diffWithDesiredRegions: (NSArray<CLCircularRegion*>*) desiredRegions
+                       monitoredRegions: (NSSet<CLRegion*>*) monitoredRegions
+                       ownedIdentifiers: (NSSet<NSString*>*) ownedIdentifiers {
+    std::vector<placesmonitor::Region> desired;
+    desired.reserve(desiredRegions.count);
+
+    for (CLCircularRegion* region in desiredRegions) {
+        desired.push_back(ACPPlacesCoreRegion(region));
+    }
+
+    // only circular regions can be compared, anything else registered by the app is left alone
+    NSMutableArray<CLCircularRegion*>* circularRegions = [[NSMutableArray alloc] initWithCapacity:monitoredRegions.count];
+    std::vector<placesmonitor::Region> monitored;
+    monitored.reserve(monitoredRegions.count);
+
+    for (CLRegion* region in monitoredRegions) {
+        if ([region isKindOfClass:[CLCircularRegion class]]) {
+            [circularRegions addObject:(CLCircularRegion*) region];
+            monitored.push_back(ACPPlacesCoreRegion((CLCircularRegion*) region));
+        }
+    }
+
+    std::unordered_set<std::string> owned;
+
+    for (NSString* identifier in ownedIdentifiers) {
+        owned.insert(ACPPlacesCoreString(identifier));
+    }
+
+    const placesmonitor::GeofenceDiff coreDiff = placesmonitor::GeofenceDiff::compute(desired, monitored, owned);
+
+    NSMutableArray<CLCircularRegion*>* toStart = [[NSMutableArray alloc] initWithCapacity:coreDiff.toStart().size()];
+    NSMutableArray<CLRegion*>* toStop = [[NSMutableArray alloc] initWithCapacity:coreDiff.toStop().size()];
+    NSMutableArray<NSString*>* kept = [[NSMutableArray alloc] initWithCapacity:coreDiff.keptCount()];
+
+    for (std::size_t index : coreDiff.toStart()) {
+        [toStart addObject:desiredRegions[index]];
+    }
+
+    for (std::size_t index : coreDiff.toStop()) {
+        [toStop addObject:circularRegions[index]];
+    }
+
+    for (std::size_t index : coreDiff.kept()) {
+        [kept addObject:desiredRegions[index].identifier];
+    }
+
+    ACPPlacesGeofenceDiff* diff = [[ACPPlacesGeofenceDiff alloc] init];
+    diff.regionsToStart = toStart;
+    diff.regionsToStop = toStop;
+    diff.keptIdentifiers = kept;
+    diff.addedCount = coreDiff.addedCount();
+    diff.removedCount = coreDiff.removedCount();
+    diff.updatedCount = coreDiff.updatedCount();
+
+    return diff;
+}
+
+- (NSUInteger) keptCount {
+    return _keptIdentifiers.count;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat:@"added: %lu, removed: %lu, updated: %lu, kept: %lu",
+            (unsigned long)_addedCount, (unsigned long)_removedCount, (unsigned long)_updatedCount,
+            (unsigned long)self.keptCount];
+}
+
+@end
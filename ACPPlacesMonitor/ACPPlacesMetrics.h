@@ -0,0 +1,109 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesMetrics.h
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, ACPPlacesMetricCounter) {
+    ACPPlacesMetricCounterLocationUpdates = 0,
+    ACPPlacesMetricCounterPoiQueries,
+    ACPPlacesMetricCounterPoiQueryErrors,
+    ACPPlacesMetricCounterPoiCacheHits,
+    ACPPlacesMetricCounterRegionsStarted,
+    ACPPlacesMetricCounterRegionsStopped,
+    ACPPlacesMetricCounterEntryEvents,
+    ACPPlacesMetricCounterExitEvents,
+    ACPPlacesMetricCounterSuppressedEntryEvents,
+    ACPPlacesMetricCounterSuppressedRegionEvents,
+    ACPPlacesMetricCounterRegionEventBatches,
+    ACPPlacesMetricCounterPoiPrefetches,
+    ACPPlacesMetricCounterPrefetchHits,
+    ACPPlacesMetricCounterPrefetchMisses,
+    ACPPlacesMetricCounterPoiPackQueries,
+    ACPPlacesMetricCounterClusterSlotsSaved,
+    ACPPlacesMetricCounterClusterResolutionFixes,
+    ACPPlacesMetricCounterBeaconEntries,
+    ACPPlacesMetricCounterBeaconRangingSeconds,
+    ACPPlacesMetricCounterContinuousLocationSeconds,
+    ACPPlacesMetricCounterAvoidedSharedStateLookups,
+    ACPPlacesMetricCounterCount
+};
+
+typedef NS_ENUM(NSUInteger, ACPPlacesMetricHistogram) {
+    ACPPlacesMetricHistogramFixToFencesLatency = 0,
+    ACPPlacesMetricHistogramPoiQueryLatency,
+    ACPPlacesMetricHistogramEventQueueDepth,
+    ACPPlacesMetricHistogramRegistrationLatency,
+    ACPPlacesMetricHistogramLocationManagerReadyLatency,
+    ACPPlacesMetricHistogramBeaconEntryLatency,
+    ACPPlacesMetricHistogramCount
+};
+
+/**
+ * @class ACPPlacesMetrics
+ *
+ * @discussion Counters and fixed-bucket histograms describing what the monitor does.
+ *
+ * Recording is a single relaxed atomic add, without locks or allocations, so it is safe to call from any thread
+ * and cheap enough to leave enabled.  Latencies are recorded in milliseconds.  A snapshot reads every value
+ * independently, so values recorded while it is taken may or may not be included.
+ */
+@interface ACPPlacesMetrics : NSObject
+
+/**
+ * @brief Adds one to the counter
+ */
+- (void) incrementCounter: (ACPPlacesMetricCounter) counter;
+
+/**
+ * @brief Adds the amount to the counter
+ */
+- (void) addValue: (uint64_t) amount toCounter: (ACPPlacesMetricCounter) counter;
+
+/**
+ * @brief Records a non-negative sample in the histogram
+ */
+- (void) recordValue: (double) value inHistogram: (ACPPlacesMetricHistogram) histogram;
+
+/**
+ * @brief Returns the current value of the counter
+ */
+- (uint64_t) valueOfCounter: (ACPPlacesMetricCounter) counter;
+
+/**
+ * @brief Returns the number of samples recorded in the histogram
+ */
+- (uint64_t) sampleCountOfHistogram: (ACPPlacesMetricHistogram) histogram;
+
+/**
+ * @brief Returns a property list describing all metrics since the last reset
+ *
+ * @discussion The dictionary contains the start time and length of the collection period, a counters dictionary,
+ * a histograms dictionary where every histogram lists its bucket upper bounds, bucket counts (the last bucket
+ * collects everything above the last bound), sample count and sum, and derived rates such as region registrations
+ * per hour.
+ */
+- (NSDictionary*) snapshot;
+
+/**
+ * @brief Sets every counter and histogram back to zero and starts a new collection period
+ */
+- (void) reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,222 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesMetrics.m
+//
+
+#import <stdatomic.h>
+#import "ACPPlacesMetrics.h"
+
+#define ACPPlacesMetricMaximumBucketCount 12
+
+// upper bounds of the buckets, a sample lands in the first bucket whose bound it doesn't exceed
+static double const ACPPlacesMetricLatencyBounds[] = {10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000};
+static double const ACPPlacesMetricDepthBounds[] = {0, 1, 2, 4, 8, 16, 32};
+static double const ACPPlacesMetricStartupBounds[] = {1, 2, 5, 10, 25, 50, 100, 250, 500, 1000};
+static double const ACPPlacesMetricBeaconLatencyBounds[] = {1, 2, 5, 10, 20, 30, 60, 120, 300, 600};
+
+typedef struct {
+    const double* bounds;
+    NSUInteger boundCount;
+} ACPPlacesMetricHistogramLayout;
+
+static ACPPlacesMetricHistogramLayout ACPPlacesMetricLayoutForHistogram(ACPPlacesMetricHistogram histogram) {
+    switch (histogram) {
+        case ACPPlacesMetricHistogramEventQueueDepth:
+            return (ACPPlacesMetricHistogramLayout) {
+                ACPPlacesMetricDepthBounds, sizeof(ACPPlacesMetricDepthBounds) / sizeof(double)
+            };
+        case ACPPlacesMetricHistogramRegistrationLatency:
+        case ACPPlacesMetricHistogramLocationManagerReadyLatency:
+            return (ACPPlacesMetricHistogramLayout) {
+                ACPPlacesMetricStartupBounds, sizeof(ACPPlacesMetricStartupBounds) / sizeof(double)
+            };
+        case ACPPlacesMetricHistogramBeaconEntryLatency:
+            return (ACPPlacesMetricHistogramLayout) {
+                ACPPlacesMetricBeaconLatencyBounds, sizeof(ACPPlacesMetricBeaconLatencyBounds) / sizeof(double)
+            };
+        default:
+            return (ACPPlacesMetricHistogramLayout) {
+                ACPPlacesMetricLatencyBounds, sizeof(ACPPlacesMetricLatencyBounds) / sizeof(double)
+            };
+    }
+}
+
+static NSString* const ACPPlacesMetricCounterNames[] = {
+    @"locationUpdates",
+    @"poiQueries",
+    @"poiQueryErrors",
+    @"poiCacheHits",
+    @"regionsStarted",
+    @"regionsStopped",
+    @"entryEvents",
+    @"exitEvents",
+    @"suppressedEntryEvents",
+    @"suppressedRegionEvents",
+    @"regionEventBatches",
+    @"poiPrefetches",
+    @"prefetchHits",
+    @"prefetchMisses",
+    @"poiPackQueries",
+    @"clusterSlotsSaved",
+    @"clusterResolutionFixes",
+    @"beaconEntries",
+    @"beaconRangingSeconds",
+    @"continuousLocationSeconds",
+    @"avoidedSharedStateLookups"
+};
+
+static NSString* const ACPPlacesMetricHistogramNames[] = {
+    @"fixToFencesLatencyMs",
+    @"poiQueryLatencyMs",
+    @"eventQueueDepth",
+    @"registrationLatencyMs",
+    @"locationManagerReadyLatencyMs",
+    @"beaconEntryLatencySeconds"
+};
+
+@interface ACPPlacesMetrics()
+@property(nonatomic, strong) NSDate* periodStart;
+@property(nonatomic) NSTimeInterval periodStartUptime;
+@end
+
+@implementation ACPPlacesMetrics {
+    _Atomic(uint64_t) _counters[ACPPlacesMetricCounterCount];
+    _Atomic(uint64_t) _buckets[ACPPlacesMetricHistogramCount][ACPPlacesMetricMaximumBucketCount];
+    _Atomic(uint64_t) _sums[ACPPlacesMetricHistogramCount];
+}
+
+- (instancetype) init {
+    if (self = [super init]) {
+        [self reset];
+    }
+
+    return self;
+}
+
+- (void) incrementCounter: (ACPPlacesMetricCounter) counter {
+    [self addValue:1 toCounter:counter];
+}
+
+- (void) addValue: (uint64_t) amount toCounter: (ACPPlacesMetricCounter) counter {
+    if (counter >= ACPPlacesMetricCounterCount) {
+        return;
+    }
+
+    atomic_fetch_add_explicit(&_counters[counter], amount, memory_order_relaxed);
+}
+
+- (void) recordValue: (double) value inHistogram: (ACPPlacesMetricHistogram) histogram {
+    if (histogram >= ACPPlacesMetricHistogramCount || !(value >= 0)) {
+        return;
+    }
+
+    ACPPlacesMetricHistogramLayout layout = ACPPlacesMetricLayoutForHistogram(histogram);
+    NSUInteger bucket = 0;
+
+    while (bucket < layout.boundCount && value > layout.bounds[bucket]) {
+        bucket++;
+    }
+
+    atomic_fetch_add_explicit(&_buckets[histogram][bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_sums[histogram], (uint64_t)llround(value), memory_order_relaxed);
+}
+
+- (uint64_t) valueOfCounter: (ACPPlacesMetricCounter) counter {
+    if (counter >= ACPPlacesMetricCounterCount) {
+        return 0;
+    }
+
+    return atomic_load_explicit(&_counters[counter], memory_order_relaxed);
+}
+
+- (uint64_t) sampleCountOfHistogram: (ACPPlacesMetricHistogram) histogram {
+    if (histogram >= ACPPlacesMetricHistogramCount) {
+        return 0;
+    }
+
+    uint64_t count = 0;
+
+    for (NSUInteger i = 0; i < ACPPlacesMetricMaximumBucketCount; i++) {
+        count += atomic_load_explicit(&_buckets[histogram][i], memory_order_relaxed);
+    }
+
+    return count;
+}
+
+- (NSDictionary*) snapshot {
+    NSMutableDictionary* counters = [NSMutableDictionary dictionaryWithCapacity:ACPPlacesMetricCounterCount];
+
+    for (NSUInteger i = 0; i < ACPPlacesMetricCounterCount; i++) {
+        counters[ACPPlacesMetricCounterNames[i]] = @([self valueOfCounter:i]);
+    }
+
+    NSMutableDictionary* histograms = [NSMutableDictionary dictionaryWithCapacity:ACPPlacesMetricHistogramCount];
+
+    for (NSUInteger i = 0; i < ACPPlacesMetricHistogramCount; i++) {
+        ACPPlacesMetricHistogramLayout layout = ACPPlacesMetricLayoutForHistogram(i);
+        NSMutableArray* bounds = [NSMutableArray arrayWithCapacity:layout.boundCount];
+        NSMutableArray* counts = [NSMutableArray arrayWithCapacity:layout.boundCount + 1];
+        uint64_t total = 0;
+
+        for (NSUInteger bucket = 0; bucket <= layout.boundCount; bucket++) {
+            uint64_t count = atomic_load_explicit(&_buckets[i][bucket], memory_order_relaxed);
+            total += count;
+            [counts addObject:@(count)];
+
+            if (bucket < layout.boundCount) {
+                [bounds addObject:@(layout.bounds[bucket])];
+            }
+        }
+
+        histograms[ACPPlacesMetricHistogramNames[i]] = @{@"bounds": bounds,
+                                                         @"counts": counts,
+                                                         @"count": @(total),
+                                                         @"sum": @(atomic_load_explicit(&_sums[i], memory_order_relaxed))};
+    }
+
+    NSTimeInterval period = MAX([[NSProcessInfo processInfo] systemUptime] - _periodStartUptime, 0);
+    double hours = period / 3600.0;
+    double registrationsPerHour = hours > 0 ? [self valueOfCounter:ACPPlacesMetricCounterRegionsStarted] / hours : 0;
+    uint64_t prefetchHits = [self valueOfCounter:ACPPlacesMetricCounterPrefetchHits];
+    uint64_t prefetchesScored = prefetchHits + [self valueOfCounter:ACPPlacesMetricCounterPrefetchMisses];
+    double prefetchHitRate = prefetchesScored ? (double) prefetchHits / prefetchesScored : 0;
+
+    return @{@"periodStart": @([_periodStart timeIntervalSince1970]),
+             @"periodSeconds": @(period),
+             @"counters": counters,
+             @"histograms": histograms,
+             @"rates": @{@"regionRegistrationsPerHour": @(registrationsPerHour),
+                         @"prefetchHitRate": @(prefetchHitRate)}};
+}
+
+- (void) reset {
+    for (NSUInteger i = 0; i < ACPPlacesMetricCounterCount; i++) {
+        atomic_store_explicit(&_counters[i], 0, memory_order_relaxed);
+    }
+
+    for (NSUInteger i = 0; i < ACPPlacesMetricHistogramCount; i++) {
+        atomic_store_explicit(&_sums[i], 0, memory_order_relaxed);
+
+        for (NSUInteger bucket = 0; bucket < ACPPlacesMetricMaximumBucketCount; bucket++) {
+            atomic_store_explicit(&_buckets[i][bucket], 0, memory_order_relaxed);
+        }
+    }
+
+    @synchronized (self) {
+        self.periodStart = [NSDate date];
+        self.periodStartUptime = [[NSProcessInfo processInfo] systemUptime];
+    }
+}
+
+@end
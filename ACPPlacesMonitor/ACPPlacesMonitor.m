@@ -19,6 +19,7 @@
 #import "ACPPlacesMonitor.h"
 #import "ACPPlacesMonitorConstants.h"
 #import "ACPPlacesMonitorInternal.h"
+#import "ACPPlacesMonitorLog.h"
 
 @implementation ACPPlacesMonitor
 
@@ -30,14 +31,10 @@
     NSError* error = nil;
 
     if ([ACPCore registerExtension:[ACPPlacesMonitorInternal class] error:&error]) {
-        [ACPCore log:ACPMobileLogLevelDebug
-                 tag:ACPPlacesMonitorExtensionName
-             message:[NSString stringWithFormat:@"The ACPPlacesMonitor extension was successfully registered. Version : %@",ACPPlacesMonitorExtensionVersion]];
+        ACPPlacesMonitorLogDebug(@"The ACPPlacesMonitor extension was successfully registered. Version : %@",ACPPlacesMonitorExtensionVersion);
     } else {
-        [ACPCore log:ACPMobileLogLevelError
-                 tag:ACPPlacesMonitorExtensionName
-             message:[NSString stringWithFormat:@"An error occurred while attempting to register the ACPPlacesMonitor extension: %@. For more details refer to %@",
-         [error localizedDescription] ? : @"unknown error", ACPPlacesMonitorRegisterExtensionDocs]];
+        ACPPlacesMonitorLogError(@"An error occurred while attempting to register the ACPPlacesMonitor extension: %@. For more details refer to %@",
+                                 [error localizedDescription] ? : @"unknown error", ACPPlacesMonitorRegisterExtensionDocs);
     }
 }
 
@@ -65,6 +62,53 @@
     [ACPPlacesMonitor dispatchMonitorEvent:ACPPlacesMonitorEventNameUpdateLocationNow withData:@ {}];
 }
 
++ (void) getMetrics: (void (^) (NSDictionary* _Nullable)) callback {
+    if (!callback) {
+        return;
+    }
+
+    NSError* eventCreationError = nil;
+    ACPExtensionEvent* event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameGetMetrics
+                                                                    type:ACPPlacesMonitorEventTypeMonitor
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent
+                                                                    data:@ {}
+                                                                   error:&eventCreationError];
+
+    if (!event) {
+        ACPPlacesMonitorLogWarning(@"An error occurred while creating event '%@': %@", ACPPlacesMonitorEventNameGetMetrics,
+                                   [eventCreationError localizedDescription] ? : @"unknown error");
+        callback(nil);
+        return;
+    }
+
+    NSError* dispatchError = nil;
+
+    if (![ACPCore dispatchEventWithResponseCallback:event responseCallback:^(ACPExtensionEvent* _Nonnull responseEvent) {
+        callback(responseEvent.eventData[ACPPlacesMonitorEventDataMetrics]);
+    } error:&dispatchError]) {
+        ACPPlacesMonitorLogWarning(@"An error occurred while dispatching event '%@': %@", ACPPlacesMonitorEventNameGetMetrics,
+                                   [dispatchError localizedDescription] ? : @"unknown error");
+        callback(nil);
+    }
+}
+
++ (void) setMetricsReportingInterval: (NSTimeInterval) interval {
+    [ACPPlacesMonitor dispatchMonitorEvent:ACPPlacesMonitorEventNameSetMetricsReportingInterval withData:@ {
+        ACPPlacesMonitorEventDataMetricsReportingInterval : @(MAX(interval, 0))
+    }];
+}
+
++ (void) setRegionEventDwellTime: (NSTimeInterval) dwellTime {
+    [ACPPlacesMonitor dispatchMonitorEvent:ACPPlacesMonitorEventNameSetRegionEventDwellTime withData:@ {
+        ACPPlacesMonitorEventDataRegionEventDwellTime : @(MAX(dwellTime, 0))
+    }];
+}
+
++ (void) setPoiPackPath: (NSString*) path {
+    [ACPPlacesMonitor dispatchMonitorEvent:ACPPlacesMonitorEventNameSetPoiPack
+                                  withData:path.length ? @{ACPPlacesMonitorEventDataPoiPackPath : path} : @{}];
+}
+
 #pragma mark - private methods
 + (void) dispatchMonitorEvent: (NSString*) eventName withData: (NSDictionary*) eventData {
     NSError* eventCreationError = nil;
@@ -75,20 +119,16 @@
                                                                    error:&eventCreationError];
 
     if (!event) {
-        [ACPCore log:ACPMobileLogLevelWarning
-                 tag:ACPPlacesMonitorExtensionName
-             message:[NSString stringWithFormat:@"An error occurred while creating event '%@': %@", eventName,
-         [eventCreationError localizedDescription] ? : @"unknown error"]];
+        ACPPlacesMonitorLogWarning(@"An error occurred while creating event '%@': %@", eventName,
+                                   [eventCreationError localizedDescription] ? : @"unknown error");
         return;
     }
 
     NSError* dispatchError = nil;
 
     if (![ACPCore dispatchEvent:event error:&dispatchError]) {
-        [ACPCore log:ACPMobileLogLevelWarning
-                 tag:ACPPlacesMonitorExtensionName
-             message:[NSString stringWithFormat:@"An error occurred while dispatching event '%@': %@", eventName,
-         [dispatchError localizedDescription] ? : @"unknown error"]];
+        ACPPlacesMonitorLogWarning(@"An error occurred while dispatching event '%@': %@", eventName,
+                                   [dispatchError localizedDescription] ? : @"unknown error");
     }
 }
 
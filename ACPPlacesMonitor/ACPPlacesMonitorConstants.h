@@ -21,6 +21,61 @@
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorExtensionVersion;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorExtensionName;
 FOUNDATION_EXPORT int const ACPPlacesMonitorDefaultMaxMonitoredRegionCount;
+FOUNDATION_EXPORT int const ACPPlacesMonitorCandidatePoiCount;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorBoundaryRegionIdentifier;
+FOUNDATION_EXPORT double const ACPPlacesMonitorBoundaryMinimumRadius;
+FOUNDATION_EXPORT double const ACPPlacesMonitorClusterMaximumRadius;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorExecutorLabel;
+
+// nearby poi cache
+FOUNDATION_EXPORT double const ACPPlacesMonitorPoiCacheCellSize;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPoiCacheValidityRadius;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPoiCacheTimeToLive;
+FOUNDATION_EXPORT int const ACPPlacesMonitorPoiCacheCapacity;
+
+// offline poi pack
+FOUNDATION_EXPORT double const ACPPlacesMonitorPoiPackSearchRadius;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPoiPackRefreshInterval;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPoiPackRefreshRadius;
+FOUNDATION_EXPORT int const ACPPlacesMonitorPoiPackDeltaCapacity;
+
+// trajectory prefetch
+FOUNDATION_EXPORT int const ACPPlacesMonitorPrefetchHistorySize;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPrefetchHistoryWindow;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPrefetchHorizon;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPrefetchMinimumSpeed;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPrefetchSpacing;
+FOUNDATION_EXPORT int const ACPPlacesMonitorPrefetchMaximumPoints;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPrefetchHitRadius;
+
+// location tracking
+FOUNDATION_EXPORT double const ACPPlacesMonitorDefaultDistanceFilter;
+FOUNDATION_EXPORT double const ACPPlacesMonitorAdaptiveNearDistance;
+FOUNDATION_EXPORT double const ACPPlacesMonitorAdaptiveFarDistance;
+FOUNDATION_EXPORT double const ACPPlacesMonitorAdaptiveNearDistanceFilter;
+FOUNDATION_EXPORT double const ACPPlacesMonitorAdaptiveContinuousTimeLimit;
+
+// on-device containment
+FOUNDATION_EXPORT double const ACPPlacesMonitorContainmentMinimumBand;
+FOUNDATION_EXPORT double const ACPPlacesMonitorContainmentMaximumAccuracy;
+
+// beacon refinement
+FOUNDATION_EXPORT double const ACPPlacesMonitorBeaconRangingWindow;
+FOUNDATION_EXPORT double const ACPPlacesMonitorBeaconRangingInterval;
+FOUNDATION_EXPORT double const ACPPlacesMonitorBeaconEntryDistance;
+FOUNDATION_EXPORT double const ACPPlacesMonitorBeaconExitDistance;
+FOUNDATION_EXPORT double const ACPPlacesMonitorBeaconExitTimeout;
+FOUNDATION_EXPORT double const ACPPlacesMonitorBeaconDesiredAccuracy;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorBeaconRegionIdentifierPrefix;
+
+// region events
+FOUNDATION_EXPORT double const ACPPlacesMonitorRegionEventDwellTime;
+
+FOUNDATION_EXPORT double const ACPPlacesMonitorRetryBaseDelay;
+FOUNDATION_EXPORT double const ACPPlacesMonitorRetryMaximumDelay;
+FOUNDATION_EXPORT int const ACPPlacesMonitorRetryMaximumAttempts;
+FOUNDATION_EXPORT int const ACPPlacesMonitorCircuitBreakerFailureThreshold;
+FOUNDATION_EXPORT double const ACPPlacesMonitorCircuitBreakerOpenDuration;
 
 // persistance
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorDefaultsMonitoredRegions;
@@ -28,6 +83,11 @@ FOUNDATION_EXPORT NSString* const ACPPlacesMonitorDefaultsUserWithinRegions;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorDefaultsMonitorMode;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorDefaultsRequestAuthorizationLevel;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorDefaultsIsMonitoringStarted;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorStateLastQueryLocation;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorStateDirectoryName;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorStateFileName;
+FOUNDATION_EXPORT double const ACPPlacesMonitorPersistenceFlushDelay;
+FOUNDATION_EXPORT int const ACPPlacesMonitorEventQueueCapacity;
 
 #pragma mark - Event Data Keys
 // event sources
@@ -61,12 +121,27 @@ FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameStop;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameUpdateLocationNow;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameUpdateMonitorConfiguration;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameSetRequestAuthorizationLevel;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameGetMetrics;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameSetMetricsReportingInterval;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameMetrics;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameSetRegionEventDwellTime;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameLocationManagerReady;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventNameSetPoiPack;
 
 
 // places monitor event data keys
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventDataMonitorMode;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventDataRequestAuthorizationLevel;
 FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventDataClear;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventDataMetrics;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventDataMetricsReportingInterval;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventDataRegionEventDwellTime;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorEventDataPoiPackPath;
+
+// poi metadata keys
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorPoiMetadataBeaconUuid;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorPoiMetadataBeaconMajor;
+FOUNDATION_EXPORT NSString* const ACPPlacesMonitorPoiMetadataBeaconMinor;
 
 // places documentation Links
 #pragma mark - Places Documentation Links
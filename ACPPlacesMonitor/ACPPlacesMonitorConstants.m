@@ -20,12 +20,65 @@
 NSString* const ACPPlacesMonitorExtensionVersion = @"2.1.4";
 NSString* const ACPPlacesMonitorExtensionName = @"com.adobe.placesMonitor";
 int const ACPPlacesMonitorDefaultMaxMonitoredRegionCount = 20;
+int const ACPPlacesMonitorCandidatePoiCount = 50;
+NSString* const ACPPlacesMonitorBoundaryRegionIdentifier = @"acpplacesmonitor.boundary";
+double const ACPPlacesMonitorBoundaryMinimumRadius = 100.0;
+double const ACPPlacesMonitorClusterMaximumRadius = 200.0;
+NSString* const ACPPlacesMonitorExecutorLabel = @"com.adobe.placesMonitor.executor";
+
+double const ACPPlacesMonitorPoiCacheCellSize = 1000.0;
+double const ACPPlacesMonitorPoiCacheValidityRadius = 500.0;
+double const ACPPlacesMonitorPoiCacheTimeToLive = 900.0;
+int const ACPPlacesMonitorPoiCacheCapacity = 16;
+
+double const ACPPlacesMonitorPoiPackSearchRadius = 50000.0;
+double const ACPPlacesMonitorPoiPackRefreshInterval = 86400.0;
+double const ACPPlacesMonitorPoiPackRefreshRadius = 2000.0;
+int const ACPPlacesMonitorPoiPackDeltaCapacity = 16;
+
+int const ACPPlacesMonitorPrefetchHistorySize = 8;
+double const ACPPlacesMonitorPrefetchHistoryWindow = 600.0;
+double const ACPPlacesMonitorPrefetchHorizon = 300.0;
+double const ACPPlacesMonitorPrefetchMinimumSpeed = 5.0;
+double const ACPPlacesMonitorPrefetchSpacing = 1000.0;
+int const ACPPlacesMonitorPrefetchMaximumPoints = 4;
+double const ACPPlacesMonitorPrefetchHitRadius = 500.0;
+
+double const ACPPlacesMonitorDefaultDistanceFilter = 100.0;
+double const ACPPlacesMonitorAdaptiveNearDistance = 500.0;
+double const ACPPlacesMonitorAdaptiveFarDistance = 1000.0;
+double const ACPPlacesMonitorAdaptiveNearDistanceFilter = 10.0;
+double const ACPPlacesMonitorAdaptiveContinuousTimeLimit = 300.0;
+
+double const ACPPlacesMonitorContainmentMinimumBand = 10.0;
+double const ACPPlacesMonitorContainmentMaximumAccuracy = 100.0;
+
+double const ACPPlacesMonitorBeaconRangingWindow = 4.0;
+double const ACPPlacesMonitorBeaconRangingInterval = 20.0;
+double const ACPPlacesMonitorBeaconEntryDistance = 3.0;
+double const ACPPlacesMonitorBeaconExitDistance = 8.0;
+double const ACPPlacesMonitorBeaconExitTimeout = 45.0;
+double const ACPPlacesMonitorBeaconDesiredAccuracy = 100.0;
+NSString* const ACPPlacesMonitorBeaconRegionIdentifierPrefix = @"acpplacesmonitor.beacon.";
+
+double const ACPPlacesMonitorRegionEventDwellTime = 0.0;
+
+double const ACPPlacesMonitorRetryBaseDelay = 2.0;
+double const ACPPlacesMonitorRetryMaximumDelay = 300.0;
+int const ACPPlacesMonitorRetryMaximumAttempts = 5;
+int const ACPPlacesMonitorCircuitBreakerFailureThreshold = 3;
+double const ACPPlacesMonitorCircuitBreakerOpenDuration = 600.0;
 
 NSString* const ACPPlacesMonitorDefaultsMonitoredRegions = @"acpplacesmonitor.monitoredregions";
 NSString* const ACPPlacesMonitorDefaultsUserWithinRegions = @"acpplacesmonitor.userwithinregions";
 NSString* const ACPPlacesMonitorDefaultsMonitorMode = @"acpplacesmonitor.monitormode";
 NSString* const ACPPlacesMonitorDefaultsRequestAuthorizationLevel = @"acpplacesmonitor.requestauthorizationlevel";
 NSString* const ACPPlacesMonitorDefaultsIsMonitoringStarted = @"acpplacesmonitor.ismonitoringstarted";
+NSString* const ACPPlacesMonitorStateLastQueryLocation = @"acpplacesmonitor.lastquerylocation";
+NSString* const ACPPlacesMonitorStateDirectoryName = @"com.adobe.placesmonitor";
+NSString* const ACPPlacesMonitorStateFileName = @"state.bin";
+double const ACPPlacesMonitorPersistenceFlushDelay = 2.0;
+int const ACPPlacesMonitorEventQueueCapacity = 32;
 
 #pragma mark - Event Data Keys
 // event sources
@@ -59,11 +112,26 @@ NSString* const ACPPlacesMonitorEventNameStop = @"stop monitoring";
 NSString* const ACPPlacesMonitorEventNameUpdateLocationNow = @"update location now";
 NSString* const ACPPlacesMonitorEventNameUpdateMonitorConfiguration = @"update monitor configuration";
 NSString* const ACPPlacesMonitorEventNameSetRequestAuthorizationLevel = @"set request authorization level";
+NSString* const ACPPlacesMonitorEventNameGetMetrics = @"get metrics";
+NSString* const ACPPlacesMonitorEventNameSetMetricsReportingInterval = @"set metrics reporting interval";
+NSString* const ACPPlacesMonitorEventNameMetrics = @"places monitor metrics";
+NSString* const ACPPlacesMonitorEventNameSetRegionEventDwellTime = @"set region event dwell time";
+NSString* const ACPPlacesMonitorEventNameLocationManagerReady = @"location manager ready";
+NSString* const ACPPlacesMonitorEventNameSetPoiPack = @"set poi pack";
 
 // places monitor event data keys
 NSString* const ACPPlacesMonitorEventDataMonitorMode = @"monitormode";
 NSString* const ACPPlacesMonitorEventDataRequestAuthorizationLevel = @"requestauthorizationlevel";
 NSString* const ACPPlacesMonitorEventDataClear = @"clearclientdata";
+NSString* const ACPPlacesMonitorEventDataMetrics = @"metrics";
+NSString* const ACPPlacesMonitorEventDataMetricsReportingInterval = @"metricsreportinginterval";
+NSString* const ACPPlacesMonitorEventDataRegionEventDwellTime = @"regioneventdwelltime";
+NSString* const ACPPlacesMonitorEventDataPoiPackPath = @"poipackpath";
+
+// poi metadata keys
+NSString* const ACPPlacesMonitorPoiMetadataBeaconUuid = @"beaconuuid";
+NSString* const ACPPlacesMonitorPoiMetadataBeaconMajor = @"beaconmajor";
+NSString* const ACPPlacesMonitorPoiMetadataBeaconMinor = @"beaconminor";
 
 // places documentation Links
 NSString* const ACPPlacesMonitorRegisterExtensionDocs = @"https://docs.adobe.com/content/help/en/places/using/places-ext-aep-sdks/places-monitor-extension/places-monitor-api-reference.html#registerextension-ios";
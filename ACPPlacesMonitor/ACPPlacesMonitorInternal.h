@@ -21,6 +21,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class ACPExtensionEvent, CLLocation, CLRegion;
 
+/**
+ * @class ACPPlacesMonitorInternal
+ *
+ * @discussion The methods below can be called from any thread, and none of them waits for the monitor's serial
+ * executor, where the work itself runs one piece at a time.  The regions the device is within are kept under a lock
+ * instead, so deviceIsWithinRegion: sees the changes made by addDeviceToRegion: and removeDeviceFromRegion: as soon
+ * as they return.  A caller that reports a transition should record it with addDeviceToRegionIfAbsent: or
+ * removeDeviceFromRegionIfPresent: rather than checking first, so a transition seen on two threads is reported once.
+ */
 @interface ACPPlacesMonitorInternal : ACPExtension
 
 #pragma mark - Event Handling
@@ -39,6 +48,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void) processEvents;
 
+/**
+ * @brief Indicates to the monitor that the configuration shared state has changed
+ *
+ * @discussion The configuration snapshot used to process queued events is discarded and will be resolved again
+ * for the next event.  Cached nearby POI responses are also discarded, as they may no longer match the configured
+ * Places libraries.
+ */
+- (void) configurationDidChange;
+
 #pragma mark - Location Settings and State
 /**
  * @brief Immediately causing the monitor to stop tracking the device's location and monitoring regions
@@ -63,6 +81,17 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void) addDeviceToRegion: (CLRegion*) region;
 
+/**
+ * @brief Adds the provided region to the list of regions the device is within, unless it is already there
+ *
+ * @discussion The check and the add happen under one lock, so of two callers recording the same entry only one gets
+ * YES.  Post the entry event only when this returns YES.
+ *
+ * @param region A CLRegion object that the device is known to be within
+ * @return YES if the region was added, NO if it was already in the list or is the boundary region
+ */
+- (BOOL) addDeviceToRegionIfAbsent: (CLRegion*) region;
+
 /**
  * @brief Removes the provided region from a list of regions that the device is currently within
  *
@@ -72,9 +101,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void) removeDeviceFromRegion: (CLRegion*) region;
 
+/**
+ * @brief Removes the provided region from the list of regions the device is within, if it is there
+ *
+ * @discussion The counterpart of addDeviceToRegionIfAbsent:, post the exit event only when this returns YES.
+ *
+ * @param region a CLRegion object that the device is no longer within
+ * @return YES if the region was removed, NO if it was not in the list
+ */
+- (BOOL) removeDeviceFromRegionIfPresent: (CLRegion*) region;
+
 /**
  * @brief Determine if the device is currently within the provided region
  *
+ * @discussion Safe to call from the main thread, it does not wait for the monitor's executor.
+ *
  * @param region a CLRegion object representing the region to check if the device is within
  * @return a BOOL indicating whether the device is within the provided region
  */
@@ -85,12 +126,17 @@ NS_ASSUME_NONNULL_BEGIN
  * @brief Makes a request to the ACPPlaces extension to retrieve nearby Points of Interest
  *
  * @discussion Calling this method will result in a request to the Places Query Service to get Points of Interest (POIs)
- * that are near the device's location. Upon receiving a response, it will trigger the following actions:
- *   1. The internal list of monitored geo-fence regions will be reset.
- *   2. If the response contains any Points of Interest, regions will be created and registered with
+ * that are near the device's location, unless a still-valid response for a nearby location is held in the POI cache.
+ * Upon receiving a response, it will trigger the following actions:
+ *   1. Regions for Points of Interest that are not yet monitored will be created and registered with
  *      the CLLocationManager.
+ *   2. Regions whose center or radius changed will be registered again with their new geometry.
  *   3. Any regions that were previously registered with the CLLocationManager but are no longer in the list
- *      of nearby POIs will be unregistered.
+ *      of nearby POIs will be unregistered.  Regions that did not change are left untouched.
+ *
+ * When more POIs are nearby than the OS allows to be monitored, the POIs with the closest edges are monitored and
+ * the last slot is used by a boundary region around the device.  Leaving the boundary requests a new location,
+ * which refreshes the monitored regions.  Events for the boundary region are never sent to the Places extension.
  *
  * @param currentLocation a CLLocation object representing the current location of the device
  */
@@ -99,6 +145,9 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  * @brief Signals to the ACPPlaces extension that a region monitoring event has occurred
  *
+ * @discussion The event is held for the region event dwell time first, and is dropped if an opposite event for the
+ * same region arrives within that time.
+ *
  * @param region the CLRegion for which there was a region event
  * @param type an ACPRegionEventType representing whether the event was an entry or an exit
  */
@@ -19,23 +19,78 @@
 #import <ACPCore/ACPExtensionEvent.h>
 #import <ACPPlaces/ACPPlaces.h>
 #import "ACPPlacesMonitor.h"
+#import "ACPPlacesAdaptivePolicy.h"
+#import "ACPPlacesBeaconRanger.h"
+#import "ACPPlacesContainmentEngine.h"
+#import "ACPPlacesGeofenceDiff.h"
+#import "ACPPlacesMetrics.h"
 #import "ACPPlacesMonitorConstants.h"
 #import "ACPPlacesMonitorInternal.h"
 #import "ACPPlacesMonitorListener.h"
 #import "ACPPlacesMonitorLocationDelegate.h"
+#import "ACPPlacesMonitorLog.h"
+#import "ACPPlacesPersistence.h"
+#import "ACPPlacesPoiCache.h"
+#import "ACPPlacesPoiPack.h"
+#import "ACPPlacesPoiPrefetcher.h"
+#import "ACPPlacesPoiRequestCoordinator.h"
 #import "ACPPlacesQueue.h"
+#import "ACPPlacesRegionClusters.h"
+#import "ACPPlacesRegionEventDebouncer.h"
+#import "ACPPlacesRegionSchedule.h"
+#import "ACPPlacesRetryScheduler.h"
+#import "ACPPlacesSerialExecutor.h"
 
 #pragma mark - ACPPlacesMonitorInternal private properties
 
+// what we last asked the CLLocationManager to do for a location service.  the state is unknown until we make the
+// first call, since the OS may still be running a service that was started before the app was relaunched
+typedef NS_ENUM(NSInteger, ACPPlacesLocationServiceState) {
+    ACPPlacesLocationServiceStateUnknown = 0,
+    ACPPlacesLocationServiceStateOn,
+    ACPPlacesLocationServiceStateOff
+};
+
 @interface ACPPlacesMonitorInternal()
+@property(nonatomic, strong) ACPPlacesSerialExecutor* executor;
 @property(nonatomic, strong) ACPPlacesQueue* eventQueue;
 @property(nonatomic, strong) ACPPlacesMonitorLocationDelegate* locationDelegate;
-@property(nonatomic, strong) CLLocationManager* locationManager;
+@property(atomic, strong) CLLocationManager* locationManager;
+@property(nonatomic) BOOL locationManagerRequested;
+@property(nonatomic, strong) ACPPlacesPersistence* persistence;
+@property(nonatomic, strong) ACPPlacesPoiCache* poiCache;
+@property(nonatomic, strong) ACPPlacesPoiPack* poiPack;
+@property(nonatomic, strong) ACPPlacesPoiRequestCoordinator* poiRequests;
+@property(nonatomic, strong) ACPPlacesPoiPrefetcher* poiPrefetcher;
+@property(nonatomic, strong) ACPPlacesRetryScheduler* retryScheduler;
+@property(nonatomic, strong) ACPPlacesRegionEventDebouncer* regionEventDebouncer;
+@property(nonatomic, strong) ACPPlacesGeofenceDiff* lastGeofenceDiff;
+@property(nonatomic, strong) CLCircularRegion* boundaryRegion;
+@property(nonatomic, strong) ACPPlacesRegionClusters* regionClusters;
+@property(nonatomic) BOOL clusterResolutionPending;
+@property(nonatomic, strong) ACPPlacesBeaconRanger* beaconRanger;
+@property(nonatomic, strong) NSDictionary<NSString*, ACPPlacesPoi*>* beaconPois;
+@property(nonatomic) CLLocationAccuracy requestedDesiredAccuracy;
+@property(nonatomic, strong) ACPPlacesContainmentEngine* containmentEngine;
 @property(nonatomic, strong) NSMutableArray<NSString*>* currentlyMonitoredRegions;
 @property(nonatomic, strong) NSMutableArray<NSString*>* userWithinRegions;
 @property(nonatomic) ACPPlacesMonitorMode monitorMode;
 @property(nonatomic) ACPPlacesMonitorRequestAuthorizationLevel requestAuthorizationLevel;
 @property(nonatomic) bool isMonitoringStarted;
+@property(nonatomic) ACPPlacesLocationServiceState continuousLocationState;
+@property(nonatomic) ACPPlacesLocationServiceState significantChangeState;
+@property(nonatomic) NSTimeInterval continuousLocationStartedAt;
+@property(nonatomic, strong) NSDictionary* configurationSnapshot;
+@property(nonatomic) NSUInteger configurationVersion;
+@property(nonatomic, strong) ACPPlacesAdaptivePolicy* adaptivePolicy;
+@property(nonatomic) ACPPlacesAdaptiveState adaptiveState;
+@property(nonatomic, strong) NSDate* adaptiveStateChangedAt;
+@property(nonatomic) NSUInteger adaptiveTimerGeneration;
+@property(nonatomic, strong) ACPPlacesMetrics* metrics;
+@property(nonatomic) NSTimeInterval lastFixReceivedAt;
+@property(nonatomic, strong) CLLocation* lastQueryLocation;
+@property(nonatomic) NSTimeInterval metricsReportingInterval;
+@property(nonatomic) NSUInteger metricsTimerGeneration;
 @end
 
 @implementation ACPPlacesMonitorInternal
@@ -67,12 +122,22 @@
  *   - Registers listeners for various events
  *   - Loads data from persistence
  *   - Initializes all class properties
- *   - Assigns its locationDelegate property as a delegate to the shared CLLocationManager
+ *
+ * Every change to the monitor state is made on a serial executor, the methods called by the EventHub, the
+ * location delegate and the Places callbacks only hand their work to it.  The one exception is the list of regions
+ * the device is within, which the location delegate reads and updates from the main thread under a lock.
+ *
+ * The CLLocationManager is not created here.  It has to be created on the main thread, and waiting for the main
+ * thread during registration would hold up app launch, so it is created the first time an event needs it.
  *
  * @return A new instance of ACPPlacesMonitorInternal
  */
 - (instancetype) init {
     if (self = [super init]) {
+        NSTimeInterval startedAt = [[NSProcessInfo processInfo] systemUptime];
+        self.metrics = [[ACPPlacesMetrics alloc] init];
+        self.executor = [[ACPPlacesSerialExecutor alloc] init];
+
         // register a listener for shared state changes
         NSError* error = nil;
 
@@ -80,70 +145,77 @@
                              eventType:ACPPlacesMonitorEventTypeHub
                            eventSource:ACPPlacesMonitorEventSourceSharedState
                                  error:&error]) {
-            [ACPCore log:ACPMobileLogLevelVerbose
-                     tag:ACPPlacesMonitorExtensionName
-                 message:@"Listener successfully registered for Event Hub shared state events"];
+            ACPPlacesMonitorLogVerbose(@"Listener successfully registered for Event Hub shared state events");
         } else {
-            [ACPCore log:ACPMobileLogLevelError
-                     tag:ACPPlacesMonitorExtensionName
-                 message:[NSString stringWithFormat:@"There was an error registering for Event Hub shared state events: %@",
-             error.localizedDescription ? : @"unknown"]];
+            ACPPlacesMonitorLogError(@"There was an error registering for Event Hub shared state events: %@",
+                                     error.localizedDescription ? : @"unknown");
         }
 
         if ([self.api registerListener:[ACPPlacesMonitorListener class]
                              eventType:ACPPlacesMonitorEventTypePlaces
                            eventSource:ACPPlacesMonitorEventSourceResponseContent
                                  error:&error]) {
-            [ACPCore log:ACPMobileLogLevelVerbose
-                     tag:ACPPlacesMonitorExtensionName
-                 message:@"Listener successfully registered for Places response events"];
+            ACPPlacesMonitorLogVerbose(@"Listener successfully registered for Places response events");
         } else {
-            [ACPCore log:ACPMobileLogLevelError
-                     tag:ACPPlacesMonitorExtensionName
-                 message:[NSString stringWithFormat:@"There was an error registering for Places response events: %@",
-             error.localizedDescription ? : @"unknown"]];
+            ACPPlacesMonitorLogError(@"There was an error registering for Places response events: %@",
+                                     error.localizedDescription ? : @"unknown");
         }
 
         if ([self.api registerListener:[ACPPlacesMonitorListener class]
                              eventType:ACPPlacesMonitorEventTypeMonitor
                            eventSource:ACPPlacesMonitorEventSourceRequestContent
                                  error:&error]) {
-            [ACPCore log:ACPMobileLogLevelVerbose
-                     tag:ACPPlacesMonitorExtensionName
-                 message:@"Listener successfully registered for Places Monitor request events"];
+            ACPPlacesMonitorLogVerbose(@"Listener successfully registered for Places Monitor request events");
         } else {
-            [ACPCore log:ACPMobileLogLevelError
-                     tag:ACPPlacesMonitorExtensionName
-                 message:[NSString stringWithFormat:@"There was an error registering for Places Monitor request events: %@",
-             error.localizedDescription ? : @"unknown"]];
+            ACPPlacesMonitorLogError(@"There was an error registering for Places Monitor request events: %@",
+                                     error.localizedDescription ? : @"unknown");
         }
 
+        self.persistence = [[ACPPlacesPersistence alloc] init];
         [self loadPersistedValues];
 
         self.eventQueue = [[ACPPlacesQueue alloc] init];
-
-        // creating a CLLocationManager must happen on the main thread
-        if ([NSThread isMainThread]) {
-            self.locationManager = [[CLLocationManager alloc] init];
-        } else {
-            dispatch_sync(dispatch_get_main_queue(), ^ {
-                self.locationManager = [[CLLocationManager alloc] init];
-            });
-        }
+        self.poiCache = [[ACPPlacesPoiCache alloc] init];
+        self.poiRequests = [self createPoiRequestCoordinator];
+        self.retryScheduler = [[ACPPlacesRetryScheduler alloc] init];
+        __weak ACPPlacesMonitorInternal* weakSelf = self;
+        self.retryScheduler.replayHandler = ^(CLLocation* location) {
+            [weakSelf.executor execute:^{
+                [weakSelf requestNearbyPoisForLocation:location];
+            }];
+        };
+        self.poiPrefetcher = [[ACPPlacesPoiPrefetcher alloc] initWithCache:self.poiCache fetchBlock:[self createPoiFetchBlock]];
+        self.poiPrefetcher.metrics = self.metrics;
+        self.poiPrefetcher.canFetch = ^BOOL {
+            // no extra load while the Places extension is failing, the predictions are still scored
+            // a POI pack already answers for any location on the path
+            ACPPlacesRetryScheduler* retryScheduler = weakSelf.retryScheduler;
+            return retryScheduler.circuitState == ACPPlacesCircuitStateClosed && !retryScheduler.pendingLocation &&
+                   !weakSelf.poiPack;
+        };
+        self.regionEventDebouncer = [[ACPPlacesRegionEventDebouncer alloc] init];
+        self.regionEventDebouncer.metrics = self.metrics;
+        self.regionEventDebouncer.flushHandler = ^(NSArray<ACPPlacesRegionEvent*>* events) {
+            [weakSelf.executor execute:^{
+                [weakSelf dispatchRegionEvents:events];
+            }];
+        };
+        self.adaptivePolicy = [[ACPPlacesAdaptivePolicy alloc] init];
+        self.containmentEngine = [[ACPPlacesContainmentEngine alloc] init];
+        self.adaptiveStateChangedAt = [NSDate date];
+        self.requestedDesiredAccuracy = kCLLocationAccuracyBest;
+        self.beaconRanger = [[ACPPlacesBeaconRanger alloc] init];
+        self.beaconRanger.metrics = self.metrics;
+        self.beaconRanger.transitionHandler = ^(CLBeaconRegion* region, ACPRegionEventType type) {
+            [weakSelf postRegionUpdate:region withEventType:type];
+        };
 
         self.locationDelegate = [[ACPPlacesMonitorLocationDelegate alloc] init];
-        self.locationManager.desiredAccuracy = kCLLocationAccuracyBest;
-        self.locationManager.distanceFilter = 100;
-        self.locationManager.delegate = self.locationDelegate;
         self.locationDelegate.parent = self;
 
-        if ([self.locationManager respondsToSelector:@selector(setAllowsBackgroundLocationUpdates:)]) {
-            self.locationManager.allowsBackgroundLocationUpdates = [self backgroundLocationUpdatesEnabledInBundle];
-        } else {
-            [ACPCore log:ACPMobileLogLevelDebug
-                     tag:ACPPlacesMonitorExtensionName
-                 message:[NSString stringWithFormat:@"Background location updates are not enabled for this app. If you are doing background region monitoring, you must enable this capability. For more details refer to %@", ACPPlacesMonitorBackgroundLocationUpdatesDocs]];
-        }
+        double elapsed = ([[NSProcessInfo processInfo] systemUptime] - startedAt) * 1000;
+        [_metrics recordValue:elapsed inHistogram:ACPPlacesMetricHistogramRegistrationLatency];
+        ACPPlacesMonitorLogVerbose(@"Extension initialized in %.2f ms", elapsed);
     }
     
     return self;
@@ -170,37 +242,180 @@
 }
 
 #pragma mark - ACPPlacesMonitorInternal Public Methods
+// called from EventHub threads and from the location delegate, the work is handed to the executor which owns the
+// monitor state, so nothing below needs a lock
 #pragma mark - Event Handling
 - (void) queueEvent: (ACPExtensionEvent*) event {
     if (!event) {
         return;
     }
 
-    [self.eventQueue add:event];
+    [_executor execute:^{
+        [self addEventToQueue:event];
+    }];
 }
 
 - (void) processEvents {
-    while ([self.eventQueue hasNext]) {
-        ACPExtensionEvent* eventToProcess = [self.eventQueue peek];
+    [_executor execute:^{
+        [self processQueuedEvents];
+    }];
+}
 
-        NSError* error = nil;
-        NSDictionary* configSharedState = [[self api] getSharedEventState:ACPPlacesMonitorConfigurationSharedState
-                                                                  event:eventToProcess
-                                                                  error:&error];
-
-        // NOTE: configuration is mandatory for processing the event, so if shared state is null stop processing events
-        if (!configSharedState.count) {
-            [ACPCore log:ACPMobileLogLevelDebug
-                     tag:ACPPlacesMonitorExtensionName
-                 message:@"Waiting to process event, configuration shared state is pending"];
+#pragma mark - Location Settings and State
+- (void) stopAllMonitoring: (BOOL) clearData {
+    [_executor execute:^{
+        [self stopMonitoringAndClearData:clearData];
+    }];
+}
+
+- (void) addDeviceToRegion: (CLRegion*) region {
+    [self addDeviceToRegionIfAbsent:region];
+}
+
+- (BOOL) addDeviceToRegionIfAbsent: (CLRegion*) region {
+    // the boundary is not a place, the device is never considered to be within it
+    if ([ACPPlacesRegionSchedule isBoundaryRegion:region]) {
+        return NO;
+    }
+
+    @synchronized (self) {
+        if ([_userWithinRegions containsObject:region.identifier]) {
+            return NO;
+        }
+
+        [_userWithinRegions addObject:region.identifier];
+    }
+
+    [_executor execute:^{
+        [self updateUserWithinRegionsInPersistence];
+    }];
+
+    return YES;
+}
+
+- (void) removeDeviceFromRegion: (CLRegion*) region {
+    [self removeDeviceFromRegionIfPresent:region];
+}
+
+- (BOOL) removeDeviceFromRegionIfPresent: (CLRegion*) region {
+    @synchronized (self) {
+        if (![_userWithinRegions containsObject:region.identifier]) {
+            return NO;
+        }
+
+        [_userWithinRegions removeObject:region.identifier];
+    }
+
+    [_executor execute:^{
+        [self updateUserWithinRegionsInPersistence];
+    }];
+
+    return YES;
+}
+
+- (BOOL) deviceIsWithinRegion: (CLRegion*) region {
+    @synchronized (self) {
+        return [_userWithinRegions containsObject:region.identifier];
+    }
+}
+
+/**
+ * @brief Returns a copy of the regions the device is within
+ *
+ * @discussion The list is changed by the location delegate's callbacks as well as on the executor, so it is only
+ * read or changed while holding the lock on self.
+ */
+- (NSArray<NSString*>*) userWithinRegionsSnapshot {
+    @synchronized (self) {
+        return [_userWithinRegions copy];
+    }
+}
+
+#pragma mark - Location Updates
+- (void) postLocationUpdate: (CLLocation*) currentLocation {
+    [_executor execute:^{
+        [self processLocationUpdate:currentLocation];
+    }];
+}
+
+- (void) configurationDidChange {
+    [_executor execute:^{
+        [self resetForConfigurationChange];
+    }];
+}
+
+- (void) updateLocationNow {
+    [self performWithLocationManager:^(CLLocationManager* locationManager) {
+        [locationManager requestLocation];
+    }];
+}
+
+- (void) postRegionUpdate: (CLRegion*) region withEventType: (ACPRegionEventType) type {
+    [_executor execute:^{
+        [self processRegionUpdate:region withEventType:type];
+    }];
+}
+
+#pragma mark - Executor
+/**
+ * @brief Runs the block with the CLLocationManager on the main thread, where the manager was created
+ *
+ * @discussion Starting and stopping location services and requesting authorization are sent back to the main
+ * thread, every other CLLocationManager call is made from the executor.
+ */
+- (void) performWithLocationManager: (void (^)(CLLocationManager* locationManager)) block {
+    CLLocationManager* locationManager = self.locationManager;
+
+    if ([NSThread isMainThread]) {
+        block(locationManager);
+        return;
+    }
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+        block(locationManager);
+    });
+}
+
+#pragma mark - Event Handling
+- (void) addEventToQueue: (ACPExtensionEvent*) event {
+    // metrics requests don't need a configuration, so they are answered without waiting in the queue
+    if ([event.eventName isEqualToString:ACPPlacesMonitorEventNameGetMetrics]) {
+        [self respondWithMetricsToEvent:event];
+        return;
+    } else if ([event.eventName isEqualToString:ACPPlacesMonitorEventNameSetMetricsReportingInterval]) {
+        NSNumber* interval = [event.eventData objectForKey:ACPPlacesMonitorEventDataMetricsReportingInterval];
+        [self updateMetricsReportingInterval:[interval doubleValue]];
+        return;
+    } else if ([event.eventName isEqualToString:ACPPlacesMonitorEventNameSetRegionEventDwellTime]) {
+        NSNumber* dwellTime = [event.eventData objectForKey:ACPPlacesMonitorEventDataRegionEventDwellTime];
+        _regionEventDebouncer.dwellTime = [dwellTime doubleValue];
+        return;
+    } else if ([event.eventName isEqualToString:ACPPlacesMonitorEventNameSetPoiPack]) {
+        NSString* path = [event.eventData objectForKey:ACPPlacesMonitorEventDataPoiPackPath];
+        [self loadPoiPackAtPath:path];
+        return;
+    } else if ([event.eventName isEqualToString:ACPPlacesMonitorEventNameLocationManagerReady]) {
+        // only wakes up the listener, the events held while the location manager was created are processed next
+        return;
+    }
+
+    [self.eventQueue add:event];
+    [_metrics recordValue:[self.eventQueue count] inHistogram:ACPPlacesMetricHistogramEventQueueDepth];
+}
+
+- (void) processQueuedEvents {
+    while ([self.eventQueue hasNext]) {
+        // every event drives the location manager, they are held in the queue until it is ready
+        if (![self prepareLocationManager]) {
             return;
         }
 
-        if (error != nil) {
-            [ACPCore log:ACPMobileLogLevelWarning
-                     tag:ACPPlacesMonitorExtensionName
-                 message:[NSString stringWithFormat:@"Could not process event, an error occured while retrieving configuration shared state %ld",
-                          (long)[error code]]];
+        ACPExtensionEvent* eventToProcess = [self.eventQueue peek];
+
+        // the configuration is resolved once and reused for every event until the configuration shared state changes
+        if (_configurationSnapshot) {
+            [_metrics incrementCounter:ACPPlacesMetricCounterAvoidedSharedStateLookups];
+        } else if (![self resolveConfigurationForEvent:eventToProcess]) {
             return;
         }
 
@@ -226,17 +441,32 @@
 }
 
 #pragma mark - Location Settings and State
-- (void) stopAllMonitoring: (BOOL) clearData {
-    [ACPCore log:ACPMobileLogLevelVerbose
-             tag:ACPPlacesMonitorExtensionName
-         message:[NSString stringWithFormat:@"Stopping all monitoring. Client-side data will %@be purged",
-                  clearData ? @"" : @"not "]];
+- (void) stopMonitoringAndClearData: (BOOL) clearData {
+    ACPPlacesMonitorLogVerbose(@"Stopping all monitoring. Client-side data will %@be purged",
+                               clearData ? @"" : @"not ");
     
+    // a response that arrives after monitoring stops must not register any geofences
+    [_poiRequests cancelOutstandingRequests];
+    [_poiPrefetcher cancel];
+    [_retryScheduler cancel];
+    [_beaconRanger stop];
+    [self applyDesiredAccuracy:_requestedDesiredAccuracy];
+
+    // events still waiting out their dwell time are reported unless the client data is being purged
     if (clearData) {
+        [_regionEventDebouncer cancel];
         [ACPPlaces clear];
         [self clearMonitorData];
+        [_poiCache invalidate];
+        [_poiPack discardDeltas];
+    } else {
+        [_regionEventDebouncer drain];
     }
     
+    // cancel any pending adaptive back-off, tracking starts over from the far state
+    _adaptiveState = ACPPlacesAdaptiveStateFar;
+    _adaptiveTimerGeneration++;
+
 #if CONTINUOUS_LOCATION_SUPPORTED
     [self stopMonitoringContinuousLocationChanges];
 #endif
@@ -248,66 +478,305 @@
 #if GEOFENCES_SUPPORTED
     [self stopMonitoringGeoFences];
 #endif
+
+    // make sure the final state is on disk before the app has a chance to go away
+    [_persistence flush];
 }
 
-- (void) addDeviceToRegion: (CLRegion*) region {
-    [_userWithinRegions addObject:region.identifier];
-    [self updateUserWithinRegionsInPersistence];
+- (void) updateUserWithinRegionsInPersistence {
+    NSArray<NSString*>* userWithinRegions = [self userWithinRegionsSnapshot];
+    [_persistence setObject:userWithinRegions.count ? userWithinRegions : nil
+                     forKey:ACPPlacesMonitorDefaultsUserWithinRegions];
 }
 
-- (void) removeDeviceFromRegion: (CLRegion*) region {
-    [_userWithinRegions removeObject:region.identifier];
-    [self updateUserWithinRegionsInPersistence];
+- (void) updateCurrentlyMonitoredRegionsInPersistence {
+    [_persistence setObject:_currentlyMonitoredRegions.count ? _currentlyMonitoredRegions : nil
+                     forKey:ACPPlacesMonitorDefaultsMonitoredRegions];
 }
 
-- (void) updateUserWithinRegionsInPersistence {
-    if (_userWithinRegions.count) {
-        [[NSUserDefaults standardUserDefaults] setObject:_userWithinRegions
-                                                  forKey:ACPPlacesMonitorDefaultsUserWithinRegions];
-    } else {
-        [[NSUserDefaults standardUserDefaults] removeObjectForKey:ACPPlacesMonitorDefaultsUserWithinRegions];
+#pragma mark - Location Updates
+- (void) processLocationUpdate: (CLLocation*) currentLocation {
+    [_metrics incrementCounter:ACPPlacesMetricCounterLocationUpdates];
+    _lastFixReceivedAt = [[NSProcessInfo processInfo] systemUptime];
+
+#if CONTINUOUS_LOCATION_SUPPORTED && SIGNIFICANT_LOCATION_CHANGE_MONITORING_SUPPORTED
+
+    if (_monitorMode & ACPPlacesMonitorModeAdaptive) {
+        [self updateAdaptiveTrackingForLocation:currentLocation];
     }
 
-    [[NSUserDefaults standardUserDefaults] synchronize];
+#endif
+
+    // high-rate fixes can detect entries and exits long before CoreLocation's region callbacks do, and the fix
+    // requested after entering a cluster region tells which of its members the device is in
+    if (_continuousLocationState == ACPPlacesLocationServiceStateOn || _clusterResolutionPending) {
+        self.clusterResolutionPending = NO;
+        [self detectRegionChangesForLocation:currentLocation];
+    }
+
+    [self requestNearbyPoisForLocation:currentLocation];
+
+    // the POIs ahead of a moving device are fetched now, so a later fix can be answered from the cache
+    [_poiPrefetcher addLocation:currentLocation];
 }
 
-- (void) updateCurrentlyMonitoredRegionsInPersistence {
-    if (_currentlyMonitoredRegions.count) {
-        [[NSUserDefaults standardUserDefaults] setObject:_currentlyMonitoredRegions
-                                                  forKey:ACPPlacesMonitorDefaultsMonitoredRegions];
-    } else {
-        [[NSUserDefaults standardUserDefaults] removeObjectForKey:ACPPlacesMonitorDefaultsMonitoredRegions];
+/**
+ * @brief Schedules the POIs near the location, from the cache if possible and otherwise from the Places extension
+ */
+- (void) requestNearbyPoisForLocation: (CLLocation*) currentLocation {
+    if (_poiPack) {
+        [self requestNearbyPoisFromPackForLocation:currentLocation];
+        return;
     }
 
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    NSArray<ACPPlacesPoi*>* cachedPoi = [_poiCache poisNearLocation:currentLocation];
+
+    if (cachedPoi) {
+        ACPPlacesMonitorLogDebug(@"Using %lu cached POIs for the device location (cache hits: %lu, misses: %lu)",
+                                 (unsigned long)cachedPoi.count, (unsigned long)_poiCache.hitCount, (unsigned long)_poiCache.missCount);
+        [_metrics incrementCounter:ACPPlacesMetricCounterPoiCacheHits];
+
+        // the cached POIs are for a newer location than any request still in flight
+        if (_poiRequests.isRequestInFlight) {
+            [_poiRequests cancelOutstandingRequests];
+        }
+
+        [self scheduleNearbyPois:cachedPoi forLocation:currentLocation];
+        return;
+    }
+
+    // while a retry is waiting the location replaces the one it will replay, so an outage costs no extra requests
+    if ([_retryScheduler shouldDeferLocation:currentLocation]) {
+        ACPPlacesMonitorLogDebug(@"Deferring the nearby POI request until the scheduled retry");
+        return;
+    }
+
+    [_poiRequests requestPoisNearLocation:currentLocation];
 }
 
-- (BOOL) deviceIsWithinRegion: (CLRegion*) region {
-    return [_userWithinRegions containsObject:region.identifier];
+/**
+ * @brief Schedules the POIs near the location from the POI pack, and asks the Places extension for a delta when the
+ * area has not been refreshed recently
+ */
+- (void) requestNearbyPoisFromPackForLocation: (CLLocation*) currentLocation {
+    [_metrics incrementCounter:ACPPlacesMetricCounterPoiPackQueries];
+
+    // a response still in flight is for an older location, it is applied to the pack when it arrives
+    [self scheduleNearbyPois:[_poiPack poisNearLocation:currentLocation limit:ACPPlacesMonitorCandidatePoiCount]
+                 forLocation:currentLocation];
+
+    if (![_poiPack needsRefreshNearLocation:currentLocation] || [_retryScheduler shouldDeferLocation:currentLocation]) {
+        return;
+    }
+
+    [_poiRequests requestPoisNearLocation:currentLocation];
 }
 
-#pragma mark - Location Updates
-- (void) postLocationUpdate: (CLLocation*) currentLocation {
-    [ACPPlaces getNearbyPointsOfInterest:currentLocation
-                                   limit:ACPPlacesMonitorDefaultMaxMonitoredRegionCount
-                                callback: ^ (NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi) {
-                                    [self resetMonitoredGeofences];
-                                    
-                                    if (nearbyPoi.count) {
-                                        [ACPCore log:ACPMobileLogLevelDebug
-                                                 tag:ACPPlacesMonitorExtensionName
-                                             message:[NSString stringWithFormat:@"Received a new list of POIs from Places: %@", nearbyPoi]];
-                                        [self startMonitoringGeoFences:nearbyPoi];
-                                    } else {
-                                        [ACPCore log:ACPMobileLogLevelDebug
-                                                 tag:ACPPlacesMonitorExtensionName
-                                             message:@"There are no POIs near the device location."];
-                                    }
-                                    
-                                    [self removeNonMonitoredRegionsFromUserWithinRegions];
-                                } errorCallback:^(ACPPlacesRequestError result) {
-                                    [self handlePlacesRequestError:result];
-                                }];
+/**
+ * @brief Opens the POI pack at the path, or stops using the current pack if the path is empty
+ */
+- (void) loadPoiPackAtPath: (NSString*) path {
+    if (!path.length) {
+        self.poiPack = nil;
+        return;
+    }
+
+    if ([path isEqualToString:_poiPack.path]) {
+        return;
+    }
+
+    self.poiPack = [[ACPPlacesPoiPack alloc] initWithPath:path];
+
+    if (!_poiPack) {
+        ACPPlacesMonitorLogWarning(@"Unable to open the POI pack at %@, nearby POIs will be requested from Places", path);
+        return;
+    }
+
+    // the prefetched areas are no longer needed, the pack answers for them
+    [_poiPrefetcher cancel];
+    ACPPlacesMonitorLogDebug(@"Loaded %lu POIs from the POI pack at %@ (revision %llu)",
+                             (unsigned long)_poiPack.count, path, (unsigned long long)_poiPack.revision);
+}
+
+/**
+ * @brief Creates the coordinator that keeps a single nearby POI request in flight
+ */
+- (ACPPlacesPoiRequestCoordinator*) createPoiRequestCoordinator {
+    __weak ACPPlacesMonitorInternal* weakSelf = self;
+    return [[ACPPlacesPoiRequestCoordinator alloc] initWithFetchBlock:[self createPoiFetchBlock]
+                                                      responseHandler:^(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi, CLLocation* location) {
+        [weakSelf.retryScheduler recordSuccess];
+        [weakSelf updateLastQueryLocation:location];
+        ACPPlacesPoiPack* poiPack = weakSelf.poiPack;
+
+        if (poiPack) {
+            [poiPack applyDelta:nearbyPoi forLocation:location limit:ACPPlacesMonitorCandidatePoiCount];
+            [weakSelf scheduleNearbyPois:[poiPack poisNearLocation:location limit:ACPPlacesMonitorCandidatePoiCount]
+                             forLocation:location];
+        } else {
+            [weakSelf.poiCache cachePois:nearbyPoi forLocation:location];
+            [weakSelf scheduleNearbyPois:nearbyPoi forLocation:location];
+        }
+
+        [weakSelf logPoiRequestMetrics];
+    } errorHandler:^(ACPPlacesRequestError error, CLLocation* location) {
+        if ([weakSelf isTransientPlacesRequestError:error]) {
+            [weakSelf.retryScheduler recordFailureForLocation:location];
+        }
+
+        [weakSelf handlePlacesRequestError:error];
+    }];
+}
+
+/**
+ * @brief Creates the block querying the Places extension for nearby POIs, shared by the requests and the prefetches
+ *
+ * @discussion The Places callbacks arrive on its own threads, they are handed back to the executor.
+ */
+- (ACPPlacesPoiFetchBlock) createPoiFetchBlock {
+    __weak ACPPlacesMonitorInternal* weakSelf = self;
+    return ^(CLLocation* location, ACPPlacesPoiResponseBlock response, ACPPlacesPoiErrorBlock error) {
+        ACPPlacesMetrics* metrics = weakSelf.metrics;
+        NSTimeInterval startedAt = [[NSProcessInfo processInfo] systemUptime];
+        [metrics incrementCounter:ACPPlacesMetricCounterPoiQueries];
+        [ACPPlaces getNearbyPointsOfInterest:location
+                                       limit:ACPPlacesMonitorCandidatePoiCount
+                                    callback:^(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi) {
+            [metrics recordValue:([[NSProcessInfo processInfo] systemUptime] - startedAt) * 1000
+                     inHistogram:ACPPlacesMetricHistogramPoiQueryLatency];
+            [weakSelf.executor execute:^{
+                response(nearbyPoi);
+            }];
+        } errorCallback:^(ACPPlacesRequestError result) {
+            [metrics recordValue:([[NSProcessInfo processInfo] systemUptime] - startedAt) * 1000
+                     inHistogram:ACPPlacesMetricHistogramPoiQueryLatency];
+            [metrics incrementCounter:ACPPlacesMetricCounterPoiQueryErrors];
+            [weakSelf.executor execute:^{
+                error(result);
+            }];
+        }];
+    };
+}
+
+- (void) logPoiRequestMetrics {
+    ACPPlacesMonitorLogVerbose(@"Nearby POI requests issued: %lu, avoided: %lu, stale responses discarded: %lu",
+                               (unsigned long)_poiRequests.issuedRequestCount, (unsigned long)_poiRequests.avoidedRequestCount,
+                               (unsigned long)_poiRequests.staleResponseCount);
+}
+
+/**
+ * @brief Picks the POIs which get a region slot and the boundary region that will trigger the next refresh
+ */
+- (void) scheduleNearbyPois: (NSArray<ACPPlacesPoi*>*) nearbyPoi forLocation: (CLLocation*) location {
+    NSArray<ACPPlacesPoi*>* candidates = nearbyPoi ? : @[];
+    CLLocationDistance maximumRadius = _locationManager.maximumRegionMonitoringDistance;
+    self.regionClusters = nil;
+
+    // overlapping POIs only share a region when there are not enough slots for one region each
+    if (candidates.count > ACPPlacesMonitorDefaultMaxMonitoredRegionCount) {
+        CLLocationDistance clusterRadius = maximumRadius > 0 ? MIN(ACPPlacesMonitorClusterMaximumRadius, maximumRadius) :
+                                           ACPPlacesMonitorClusterMaximumRadius;
+        self.regionClusters = [ACPPlacesRegionClusters clustersWithPois:candidates maximumRadius:clusterRadius];
+        candidates = _regionClusters.regionPois;
+        ACPPlacesMonitorLogDebug(@"Clustered the nearby POIs (%@)", _regionClusters);
+    }
+
+    ACPPlacesRegionSchedule* schedule = [ACPPlacesRegionSchedule scheduleWithCandidates:candidates
+                                                                             atLocation:location
+                                                                              slotCount:ACPPlacesMonitorDefaultMaxMonitoredRegionCount
+                                                                          maximumRadius:maximumRadius];
+    self.boundaryRegion = schedule.boundaryRegion;
+
+    if (schedule.deferredCount) {
+        ACPPlacesMonitorLogDebug(@"More POIs are nearby than can be monitored, scheduled regions (%@)", schedule);
+    }
+
+    // only the clusters which got a slot saved one
+    for (ACPPlacesPoi* poi in schedule.selectedPois) {
+        NSArray<ACPPlacesPoi*>* members = [_regionClusters membersOfClusterWithIdentifier:poi.identifier];
+
+        if (members) {
+            [_metrics addValue:members.count - 1 toCounter:ACPPlacesMetricCounterClusterSlotsSaved];
+        }
+    }
+
+    [self processNearbyPois:schedule.selectedPois];
+}
+
+/**
+ * @brief Tests the location against the monitored POIs and reports any entry or exit to the Places extension
+ *
+ * @discussion Events go through the same userWithinRegions bookkeeping as CoreLocation's region callbacks, so a
+ * later callback for the same transition is treated as a duplicate.
+ */
+- (void) detectRegionChangesForLocation: (CLLocation*) location {
+    NSArray<CLCircularRegion*>* entered = nil;
+    NSArray<CLCircularRegion*>* exited = nil;
+
+    if (![_containmentEngine evaluateLocation:location
+                            insideIdentifiers:[NSSet setWithArray:[self userWithinRegionsSnapshot]]
+                                      entered:&entered
+                                       exited:&exited]) {
+        return;
+    }
+
+    // a region callback may have recorded the same transition since the snapshot was taken
+    for (CLCircularRegion* region in entered) {
+        if ([self addDeviceToRegionIfAbsent:region]) {
+            ACPPlacesMonitorLogDebug(@"Detected entry into region %@ from a location update", region.identifier);
+            [self postRegionUpdate:region withEventType:ACPRegionEventTypeEntry];
+        }
+    }
+
+    for (CLCircularRegion* region in exited) {
+        if ([self removeDeviceFromRegionIfPresent:region]) {
+            ACPPlacesMonitorLogDebug(@"Detected exit from region %@ from a location update", region.identifier);
+            [self postRegionUpdate:region withEventType:ACPRegionEventTypeExit];
+        }
+    }
+}
+
+- (void) resetForConfigurationChange {
+    // the next batch of events will resolve the new configuration
+    self.configurationSnapshot = nil;
+    _configurationVersion++;
+
+    // cached and in-flight responses may belong to POI libraries that are no longer configured
+    [_poiCache invalidate];
+    [_poiPack discardDeltas];
+    [_poiRequests cancelOutstandingRequests];
+    [_poiPrefetcher cancel];
+}
+
+- (void) processNearbyPois: (NSArray<ACPPlacesPoi*>*) nearbyPoi {
+    if (nearbyPoi.count) {
+        ACPPlacesMonitorLogDebug(@"Received a new list of POIs from Places: %@", nearbyPoi);
+    } else {
+        ACPPlacesMonitorLogDebug(@"There are no POIs near the device location.");
+    }
+
+    // known before the geofences are registered, so an entry posted for a beacon POI starts ranging instead
+    [self updateBeaconPoisFromPois:nearbyPoi ? : @[]];
+
+    // reconcile registered geofences with the new list, or drop all of ours if we can no longer monitor them
+    if ([self startMonitoringGeoFences:nearbyPoi ? : @[]]) {
+        [_containmentEngine loadPois:[self memberPoisOfPois:nearbyPoi ? : @[]]];
+        [self recordFixToFencesLatency];
+    } else {
+        [self resetMonitoredGeofences];
+    }
+
+    [self removeNonMonitoredRegionsFromUserWithinRegions];
+    [self updateBeaconRanging];
+}
+
+/**
+ * @brief Returns YES for errors where the same request is likely to succeed later
+ */
+- (BOOL) isTransientPlacesRequestError: (ACPPlacesRequestError) error {
+    return error == ACPPlacesRequestErrorConnectivityError ||
+           error == ACPPlacesRequestErrorQueryServiceUnavailable ||
+           error == ACPPlacesRequestErrorServerResponseError;
 }
 
 - (void) handlePlacesRequestError:(ACPPlacesRequestError) error {
@@ -340,61 +809,331 @@
             break;
     }
     
-    [ACPCore log:ACPMobileLogLevelWarning
-             tag:ACPPlacesMonitorExtensionName
-         message:[NSString stringWithFormat:message, errorString]];
+    ACPPlacesMonitorLogWarning(message, errorString);
 }
 
-- (void) updateLocationNow {
-    [_locationManager requestLocation];
+- (void) processRegionUpdate: (CLRegion*) region withEventType: (ACPRegionEventType) type {
+    // the boundary only exists to tell us the device left the area covered by the monitored regions
+    if ([ACPPlacesRegionSchedule isBoundaryRegion:region]) {
+        if (type == ACPRegionEventTypeExit) {
+            ACPPlacesMonitorLogDebug(@"The device left the area covered by the monitored regions, refreshing nearby POIs");
+            [self updateLocationNow];
+        }
+
+        return;
+    }
+
+    // a cluster only stands in for its members, which are the regions reported to Places
+    if ([ACPPlacesRegionClusters isClusterRegion:region]) {
+        [self processClusterRegionUpdate:region withEventType:type];
+        return;
+    }
+
+    // the geofence of a beacon POI only tells when to range, its beacon reports the entry and the exit
+    if ([region isKindOfClass:[CLCircularRegion class]] && _beaconPois[region.identifier]) {
+        [self updateBeaconRanging];
+        return;
+    }
+
+    [_regionEventDebouncer addRegion:region eventType:type];
 }
 
-- (void) postRegionUpdate: (CLRegion*) region withEventType: (ACPRegionEventType) type {
-    [ACPPlaces processRegionEvent:region forRegionEventType:type];
+/**
+ * @brief Resolves which members of a cluster the device entered or exited
+ *
+ * @discussion An entry asks for a single location fix, which is tested against the members when it arrives.  The
+ * device can't be in any member once it left the cluster, so an exit is reported for each member it was in.
+ */
+- (void) processClusterRegionUpdate: (CLRegion*) region withEventType: (ACPRegionEventType) type {
+    if (type == ACPRegionEventTypeEntry) {
+        // continuous updates test every fix against the members already
+        if (_continuousLocationState == ACPPlacesLocationServiceStateOn) {
+            return;
+        }
+
+        ACPPlacesMonitorLogDebug(@"Entered cluster region %@, requesting a location to resolve its members", region.identifier);
+        [_metrics incrementCounter:ACPPlacesMetricCounterClusterResolutionFixes];
+        self.clusterResolutionPending = YES;
+        [self updateLocationNow];
+        return;
+    }
+
+    NSArray<NSString*>* userWithinRegions = [self userWithinRegionsSnapshot];
+
+    for (ACPPlacesPoi* member in [_regionClusters membersOfClusterWithIdentifier:region.identifier]) {
+        if ([userWithinRegions containsObject:member.identifier]) {
+            CLCircularRegion* memberRegion = [self circularRegionForPoi:member];
+            [self removeDeviceFromRegion:memberRegion];
+
+            if (!_beaconPois[member.identifier]) {
+                [_regionEventDebouncer addRegion:memberRegion eventType:ACPRegionEventTypeExit];
+            }
+        }
+    }
+
+    // beacon members are exited by the ranger once they are no longer ranged
+    [self updateBeaconRanging];
+}
+
+/**
+ * @brief Replaces each cluster POI in the list with its members
+ */
+- (NSArray<ACPPlacesPoi*>*) memberPoisOfPois: (NSArray<ACPPlacesPoi*>*) pois {
+    if (!_regionClusters) {
+        return pois;
+    }
+
+    NSMutableArray<ACPPlacesPoi*>* memberPois = [[NSMutableArray alloc] initWithCapacity:pois.count];
+
+    for (ACPPlacesPoi* poi in pois) {
+        NSArray<ACPPlacesPoi*>* members = [_regionClusters membersOfClusterWithIdentifier:poi.identifier];
+
+        if (members) {
+            [memberPois addObjectsFromArray:members];
+        } else {
+            [memberPois addObject:poi];
+        }
+    }
+
+    return memberPois;
+}
+
+#pragma mark - Beacons
+/**
+ * @brief Keeps the POIs which carry a beacon, cluster members included
+ *
+ * @discussion Nothing is kept when the device can't range beacons, so their geofences report the POIs instead.
+ */
+- (void) updateBeaconPoisFromPois: (NSArray<ACPPlacesPoi*>*) pois {
+    NSMutableDictionary<NSString*, ACPPlacesPoi*>* beaconPois = [[NSMutableDictionary alloc] init];
+
+    if ([ACPPlacesBeaconRanger isRangingAvailable]) {
+        for (ACPPlacesPoi* poi in [self memberPoisOfPois:pois]) {
+            if ([ACPPlacesBeaconRanger beaconRegionForPoi:poi]) {
+                beaconPois[poi.identifier] = poi;
+            }
+        }
+    }
+
+    self.beaconPois = beaconPois.count ? beaconPois : nil;
+}
+
+/**
+ * @brief Ranges the beacons of the beacon POIs whose geofence contains the device
+ *
+ * @discussion Beacons tell the POIs apart while they are ranged, so location updates drop to a coarser accuracy.
+ */
+- (void) updateBeaconRanging {
+    NSMutableArray<ACPPlacesPoi*>* pois = [[NSMutableArray alloc] init];
+
+    for (NSString* identifier in [self userWithinRegionsSnapshot]) {
+        ACPPlacesPoi* poi = _beaconPois[identifier];
+
+        if (poi) {
+            [pois addObject:poi];
+        }
+    }
+
+    BOOL wasActive = _beaconRanger.isActive;
+    [_beaconRanger rangePois:pois];
+
+    if (_beaconRanger.isActive != wasActive) {
+        ACPPlacesMonitorLogDebug(@"Beacon ranging %@", wasActive ? @"stopped" : @"started");
+        [self applyDesiredAccuracy:_requestedDesiredAccuracy];
+    }
+}
+
+/**
+ * @brief Sets the accuracy asked for by the monitor mode, relaxed while beacons are ranged
+ */
+- (void) applyDesiredAccuracy: (CLLocationAccuracy) accuracy {
+    _requestedDesiredAccuracy = accuracy;
+    _locationManager.desiredAccuracy = _beaconRanger.isActive ? MAX(accuracy, ACPPlacesMonitorBeaconDesiredAccuracy) :
+                                                                accuracy;
+}
+
+/**
+ * @brief Reports a batch of settled region events to the ACPPlaces extension
+ */
+- (void) dispatchRegionEvents: (NSArray<ACPPlacesRegionEvent*>*) events {
+    for (ACPPlacesRegionEvent* event in events) {
+        [_metrics incrementCounter:event.type == ACPRegionEventTypeEntry ? ACPPlacesMetricCounterEntryEvents :
+                                                                          ACPPlacesMetricCounterExitEvents];
+        [ACPPlaces processRegionEvent:event.region forRegionEventType:event.type];
+    }
 }
 
 #pragma mark - ACPPlacesMonitorInternal Private Methods
+#pragma mark - Location Manager
+/**
+ * @brief Makes sure the CLLocationManager exists, creating it the first time it is needed
+ *
+ * @discussion A CLLocationManager must be created on the main thread.  When called from any other thread the
+ * manager is created asynchronously, and a location manager ready event is dispatched once it exists so the
+ * listener picks up the events that were held in the meantime.
+ *
+ * @return YES if the location manager can be used right away
+ */
+- (BOOL) prepareLocationManager {
+    if (self.locationManager) {
+        return YES;
+    }
+
+    @synchronized (self) {
+        if (_locationManagerRequested) {
+            return NO;
+        }
+
+        _locationManagerRequested = YES;
+    }
+
+    NSTimeInterval requestedAt = [[NSProcessInfo processInfo] systemUptime];
+
+    if ([NSThread isMainThread]) {
+        [self createLocationManagerRequestedAt:requestedAt];
+        return YES;
+    }
+
+    __weak ACPPlacesMonitorInternal* weakSelf = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [weakSelf createLocationManagerRequestedAt:requestedAt];
+        [weakSelf dispatchLocationManagerReady];
+    });
+
+    return NO;
+}
+
+- (void) createLocationManagerRequestedAt: (NSTimeInterval) requestedAt {
+    CLLocationManager* locationManager = [[CLLocationManager alloc] init];
+    locationManager.desiredAccuracy = kCLLocationAccuracyBest;
+    locationManager.distanceFilter = ACPPlacesMonitorDefaultDistanceFilter;
+    locationManager.delegate = _locationDelegate;
+
+    if ([locationManager respondsToSelector:@selector(setAllowsBackgroundLocationUpdates:)]) {
+        locationManager.allowsBackgroundLocationUpdates = [self backgroundLocationUpdatesEnabledInBundle];
+    } else {
+        ACPPlacesMonitorLogDebug(@"Background location updates are not enabled for this app. If you are doing background region monitoring, you must enable this capability. For more details refer to %@", ACPPlacesMonitorBackgroundLocationUpdatesDocs);
+    }
+
+    // only published once it is fully configured, other threads treat a non-nil manager as ready
+    self.locationManager = locationManager;
+
+    double elapsed = ([[NSProcessInfo processInfo] systemUptime] - requestedAt) * 1000;
+    [_metrics recordValue:elapsed inHistogram:ACPPlacesMetricHistogramLocationManagerReadyLatency];
+    ACPPlacesMonitorLogVerbose(@"Location manager ready %.2f ms after it was first needed", elapsed);
+}
+
+- (void) dispatchLocationManagerReady {
+    NSError* error = nil;
+    ACPExtensionEvent* event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameLocationManagerReady
+                                                                    type:ACPPlacesMonitorEventTypeMonitor
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent
+                                                                    data:nil
+                                                                   error:&error];
+
+    if (!event || ![ACPCore dispatchEvent:event error:&error]) {
+        ACPPlacesMonitorLogWarning(@"An error occurred while dispatching the location manager ready event, held events will be processed with the next event: %@",
+                                   error.localizedDescription ? : @"unknown error");
+    }
+}
+
+/**
+ * @brief Looks up the configuration shared state for the event and keeps it as the configuration snapshot
+ *
+ * @return YES if a valid configuration was found and events can be processed
+ */
+- (BOOL) resolveConfigurationForEvent: (ACPExtensionEvent*) event {
+    NSError* error = nil;
+    NSDictionary* configSharedState = [[self api] getSharedEventState:ACPPlacesMonitorConfigurationSharedState
+                                                              event:event
+                                                              error:&error];
+
+    // NOTE: configuration is mandatory for processing the event, so if shared state is null stop processing events
+    if (!configSharedState.count) {
+        ACPPlacesMonitorLogDebug(@"Waiting to process event, configuration shared state is pending");
+        return NO;
+    }
+
+    if (error != nil) {
+        ACPPlacesMonitorLogWarning(@"Could not process event, an error occured while retrieving configuration shared state %ld",
+                                   (long)[error code]);
+        return NO;
+    }
+
+    self.configurationSnapshot = configSharedState;
+    ACPPlacesMonitorLogVerbose(@"Resolved configuration snapshot (version %lu)", (unsigned long)_configurationVersion);
+
+    return YES;
+}
+
 - (void) loadPersistedValues {
-    NSNumber* monitorMode = [[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsMonitorMode];
+    NSNumber* monitorMode = [_persistence objectForKey:ACPPlacesMonitorDefaultsMonitorMode];
     self.monitorMode = monitorMode ? [monitorMode longValue] : ACPPlacesMonitorModeSignificantChanges;
     
 
-    self.isMonitoringStarted = [[NSUserDefaults standardUserDefaults] boolForKey:ACPPlacesMonitorDefaultsIsMonitoringStarted];
+    self.isMonitoringStarted = [[_persistence objectForKey:ACPPlacesMonitorDefaultsIsMonitoringStarted] boolValue];
     
-    NSNumber* requestAuthorizationLevel = [[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel];
+    NSNumber* requestAuthorizationLevel = [_persistence objectForKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel];
     self.requestAuthorizationLevel = requestAuthorizationLevel ? [requestAuthorizationLevel longValue] : ACPPlacesRequestMonitorAuthorizationLevelAlways;
     
-    NSArray* persistedRegions = [[NSUserDefaults standardUserDefaults]
-                                 arrayForKey:ACPPlacesMonitorDefaultsMonitoredRegions];
+    NSArray* persistedRegions = [self arrayFromPersistenceForKey:ACPPlacesMonitorDefaultsMonitoredRegions];
     self.currentlyMonitoredRegions = persistedRegions.count ? [persistedRegions mutableCopy] : [@[] mutableCopy];
 
-    NSArray* persistedUserWithinRegions = [[NSUserDefaults standardUserDefaults]
-                                           arrayForKey:ACPPlacesMonitorDefaultsUserWithinRegions];
-    self.userWithinRegions = persistedUserWithinRegions.count ?
-                             [persistedUserWithinRegions mutableCopy] : [@[] mutableCopy];
+    // writes are flushed lazily, so a crash can leave the two lists from different snapshots.  the device can only
+    // be within a region we are monitoring, anything else is stale
+    NSSet<NSString*>* monitoredRegions = [NSSet setWithArray:_currentlyMonitoredRegions];
+    NSArray* persistedUserWithinRegions = [self arrayFromPersistenceForKey:ACPPlacesMonitorDefaultsUserWithinRegions];
+    NSIndexSet* validIndexes = [persistedUserWithinRegions indexesOfObjectsPassingTest:^BOOL (NSString* regionId, NSUInteger idx, BOOL* stop) {
+        return [monitoredRegions containsObject:regionId];
+    }];
+    @synchronized (self) {
+        self.userWithinRegions = validIndexes.count ?
+                                 [[persistedUserWithinRegions objectsAtIndexes:validIndexes] mutableCopy] : [@[] mutableCopy];
+    }
+
+    id lastQueryLocation = [_persistence objectForKey:ACPPlacesMonitorStateLastQueryLocation];
+    self.lastQueryLocation = [lastQueryLocation isKindOfClass:[CLLocation class]] ? lastQueryLocation : nil;
+}
+
+- (NSArray*) arrayFromPersistenceForKey: (NSString*) key {
+    id value = [_persistence objectForKey:key];
+    return [value isKindOfClass:[NSArray class]] ? value : nil;
 }
 
 - (void) resetMonitoredGeofences {
     // remove regions in locationManager.moniteredRegions that we have initialized
     // NOTE - the process of verifying that each region is one we are monitoring is important
     // so we don't stop monitoring a region used elsewhere in the app
+    NSSet<NSString*>* ownedRegions = [self ownedRegionIdentifiers];
     NSArray* regions = [_locationManager.monitoredRegions copy];
 
     for (CLRegion * region in regions) {
-        if ([region isKindOfClass:[CLCircularRegion class]] && [_currentlyMonitoredRegions containsObject:region.identifier]) {
+        if ([region isKindOfClass:[CLCircularRegion class]] && [ownedRegions containsObject:region.identifier]) {
             [_locationManager stopMonitoringForRegion:region];
         }
     }
 
     // clear out our list
+    self.boundaryRegion = nil;
+    [_containmentEngine loadPois:@[]];
     [_currentlyMonitoredRegions removeAllObjects];
     [self updateCurrentlyMonitoredRegionsInPersistence];
 }
 
 - (void) updateMonitorMode: (ACPPlacesMonitorMode) monitorMode {
     _monitorMode = monitorMode;
-    [[NSUserDefaults standardUserDefaults] setInteger:monitorMode forKey:ACPPlacesMonitorDefaultsMonitorMode];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+
+    // adaptive tracking always starts from the cheapest strategy, other modes use the default accuracy
+    _adaptiveState = ACPPlacesAdaptiveStateFar;
+    self.adaptiveStateChangedAt = [NSDate date];
+    _adaptiveTimerGeneration++;
+
+    if (!(monitorMode & ACPPlacesMonitorModeAdaptive)) {
+        [self applyDesiredAccuracy:kCLLocationAccuracyBest];
+        _locationManager.distanceFilter = ACPPlacesMonitorDefaultDistanceFilter;
+    }
+
+    [_persistence setObject:@(monitorMode) forKey:ACPPlacesMonitorDefaultsMonitorMode];
 
     // a call to refresh how we are monitoring based on the new mode
     [self beginTrackingLocation];
@@ -403,8 +1142,7 @@
 
 - (void) updateRequestAuthorizationLevel: (ACPPlacesMonitorRequestAuthorizationLevel) requestAuthorizationLevel {
     _requestAuthorizationLevel = requestAuthorizationLevel;
-    [[NSUserDefaults standardUserDefaults] setInteger:requestAuthorizationLevel forKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [_persistence setObject:@(requestAuthorizationLevel) forKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel];
     
     // enchance the authorization level if the monitoring has already started
     if (_isMonitoringStarted) {
@@ -413,6 +1151,17 @@
 }
 
 - (void) beginTrackingLocation {
+#if CONTINUOUS_LOCATION_SUPPORTED && SIGNIFICANT_LOCATION_CHANGE_MONITORING_SUPPORTED
+
+    if (_monitorMode & ACPPlacesMonitorModeAdaptive) {
+        [self applyAdaptiveState];
+        [self persistMonitoringStatus];
+        [self updateLocationNow];
+        return;
+    }
+
+#endif
+
 #if CONTINUOUS_LOCATION_SUPPORTED
     
     if (_monitorMode & ACPPlacesMonitorModeContinuous) {
@@ -446,9 +1195,7 @@
     
     // if the user has denied location services, bail out early
     if ([self userHasDeclinedLocationPermission:auth]) {
-        [ACPCore log:ACPMobileLogLevelDebug
-                 tag:ACPPlacesMonitorExtensionName
-             message:@"Unable to start monitoring. Permission to use location data has been denied by the user"];
+        ACPPlacesMonitorLogDebug(@"Unable to start monitoring. Permission to use location data has been denied by the user");
         return;
     }
     
@@ -458,7 +1205,9 @@
         if (auth == kCLAuthorizationStatusNotDetermined) {
             // attempt to request whenInUse authorization
             if ([_locationManager respondsToSelector:@selector(requestWhenInUseAuthorization)]) {
-                [_locationManager requestWhenInUseAuthorization];
+                [self performWithLocationManager:^(CLLocationManager* locationManager) {
+                    [locationManager requestWhenInUseAuthorization];
+                }];
             }
         }
     }
@@ -469,7 +1218,9 @@
         if (auth == kCLAuthorizationStatusNotDetermined || auth == kCLAuthorizationStatusAuthorizedWhenInUse) {
              // attempt to request always authorization
             if ([_locationManager respondsToSelector:@selector(requestAlwaysAuthorization)]) {
-                [_locationManager requestAlwaysAuthorization];
+                [self performWithLocationManager:^(CLLocationManager* locationManager) {
+                    [locationManager requestAlwaysAuthorization];
+                }];
             }
         }
     }
@@ -477,7 +1228,7 @@
     [self beginTrackingLocation];
 }
 
-- (void) startMonitoringGeoFences: (NSArray*) newGeoFences {
+- (BOOL) startMonitoringGeoFences: (NSArray*) newGeoFences {
     CLAuthorizationStatus auth;
     if (@available(iOS 14.0, *)) {
         auth = _locationManager.authorizationStatus;
@@ -486,60 +1237,125 @@
     }
     
     if ([self userHasDeclinedLocationPermission:auth]) {
-        return;
+        return NO;
     }
 
     // make sure the device support monitoring geofences
     if (![CLLocationManager isMonitoringAvailableForClass:[CLCircularRegion class]]) {
-        [ACPCore log:ACPMobileLogLevelDebug
-                 tag:ACPPlacesMonitorExtensionName
-             message:@"This device's GPS capabilities do not support monitoring geofence regions"];
-        return;
+        ACPPlacesMonitorLogDebug(@"This device's GPS capabilities do not support monitoring geofence regions");
+        return NO;
     }
 
-    // loop through our regions while we have them AND we are under our max number of regions
+    // build the regions we want to be monitoring
+    NSMutableArray<CLCircularRegion*>* desiredRegions = [[NSMutableArray alloc] initWithCapacity:newGeoFences.count];
+
     for (ACPPlacesPoi * currentRegion in newGeoFences) {
-        // update the radius for the region if necessary
-        if (_locationManager.maximumRegionMonitoringDistance < currentRegion.radius) {
-            currentRegion.radius = _locationManager.maximumRegionMonitoringDistance;
-        }
-
-        // make the circular region
-        CLLocationCoordinate2D center = CLLocationCoordinate2DMake(currentRegion.latitude, currentRegion.longitude);
-        CLCircularRegion* currentCLRegion = [[CLCircularRegion alloc] initWithCenter:center
-                                                                              radius:currentRegion.radius
-                                                                          identifier:currentRegion.identifier];
-        currentCLRegion.notifyOnExit = YES;
-        currentCLRegion.notifyOnEntry = YES;
-
-        // start monitoring the new region
-        [_locationManager startMonitoringForRegion:currentCLRegion];
-
-        // add the region to our list of monitored regions
-        [_currentlyMonitoredRegions addObject:currentCLRegion.identifier];
-
-        // send an entry event if we had one and we know the user was not already in the region
-        if (currentRegion.userIsWithin) {
-            if ([_userWithinRegions containsObject:currentRegion.identifier]) {
-                [ACPCore log:ACPMobileLogLevelDebug
-                         tag:ACPPlacesMonitorExtensionName
-                     message:[NSString stringWithFormat:@"Suppressing an entry event for region %@, the device is already known to be in this region", currentRegion.identifier]];
-            } else {
-                [self addDeviceToRegion:currentCLRegion];
-                [ACPPlaces processRegionEvent:currentCLRegion forRegionEventType:ACPRegionEventTypeEntry];
-            }
+        [desiredRegions addObject:[self circularRegionForPoi:currentRegion]];
+    }
+
+    // only touch the regions that were added, removed or changed since the last refresh
+    NSArray<CLCircularRegion*>* regionsToMonitor = _boundaryRegion ? [desiredRegions arrayByAddingObject:_boundaryRegion] :
+                                                   desiredRegions;
+    ACPPlacesGeofenceDiff* diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:regionsToMonitor
+                                                               monitoredRegions:_locationManager.monitoredRegions
+                                                               ownedIdentifiers:[self ownedRegionIdentifiers]];
+
+    for (CLRegion* region in diff.regionsToStop) {
+        [_locationManager stopMonitoringForRegion:region];
+    }
+
+    for (CLCircularRegion* region in diff.regionsToStart) {
+        [_locationManager startMonitoringForRegion:region];
+    }
+
+    self.lastGeofenceDiff = diff;
+    [_metrics addValue:diff.regionsToStart.count toCounter:ACPPlacesMetricCounterRegionsStarted];
+    [_metrics addValue:diff.regionsToStop.count toCounter:ACPPlacesMetricCounterRegionsStopped];
+    ACPPlacesMonitorLogDebug(@"Reconciled monitored geofences (%@)", diff);
+
+    // update our list of monitored regions
+    [_currentlyMonitoredRegions removeAllObjects];
+
+    for (CLCircularRegion* region in desiredRegions) {
+        [_currentlyMonitoredRegions addObject:region.identifier];
+    }
+
+    // send an entry event if we had one and we know the user was not already in the region
+    NSMutableSet<NSString*>* userWithinRegions = [NSMutableSet setWithArray:[self userWithinRegionsSnapshot]];
+    NSUInteger index = 0;
+
+    for (ACPPlacesPoi * currentRegion in newGeoFences) {
+        CLCircularRegion* currentCLRegion = desiredRegions[index++];
+        NSArray<ACPPlacesPoi*>* members = [_regionClusters membersOfClusterWithIdentifier:currentRegion.identifier];
+
+        if (!members) {
+            [self postEntryIfUserIsWithinPoi:currentRegion region:currentCLRegion userWithinRegions:userWithinRegions];
+            continue;
+        }
+
+        // the members are monitored through the cluster, which the device is in whenever it is in one of them
+        BOOL userIsWithinCluster = NO;
+
+        for (ACPPlacesPoi* member in members) {
+            [_currentlyMonitoredRegions addObject:member.identifier];
+            [self postEntryIfUserIsWithinPoi:member region:[self circularRegionForPoi:member] userWithinRegions:userWithinRegions];
+            userIsWithinCluster = userIsWithinCluster || member.userIsWithin;
+        }
+
+        if (userIsWithinCluster && ![userWithinRegions containsObject:currentCLRegion.identifier]) {
+            [userWithinRegions addObject:currentCLRegion.identifier];
+            [self addDeviceToRegionIfAbsent:currentCLRegion];
         }
     }
 
     [self updateCurrentlyMonitoredRegionsInPersistence];
+
+    return YES;
+}
+
+/**
+ * @brief Makes the region monitored for the POI, its radius capped at the largest one CoreLocation can monitor
+ */
+- (CLCircularRegion*) circularRegionForPoi: (ACPPlacesPoi*) poi {
+    // cap the radius of the region only, the POI may be shared with the cache or the pack
+    CLLocationDistance radius = MIN(poi.radius, _locationManager.maximumRegionMonitoringDistance);
+
+    // make the circular region
+    CLLocationCoordinate2D center = CLLocationCoordinate2DMake(poi.latitude, poi.longitude);
+    CLCircularRegion* region = [[CLCircularRegion alloc] initWithCenter:center radius:radius identifier:poi.identifier];
+    region.notifyOnExit = YES;
+    region.notifyOnEntry = YES;
+
+    return region;
+}
+
+/**
+ * @brief Sends an entry event if the user is within the POI and we know they were not already in the region
+ */
+- (void) postEntryIfUserIsWithinPoi: (ACPPlacesPoi*) poi
+                             region: (CLCircularRegion*) region
+                  userWithinRegions: (NSMutableSet<NSString*>*) userWithinRegions {
+    if (!poi.userIsWithin) {
+        return;
+    }
+
+    // the region callbacks may have recorded the entry since userWithinRegions was copied
+    if ([userWithinRegions containsObject:poi.identifier] || ![self addDeviceToRegionIfAbsent:region]) {
+        ACPPlacesMonitorLogDebug(@"Suppressing an entry event for region %@, the device is already known to be in this region", poi.identifier);
+        [_metrics incrementCounter:ACPPlacesMetricCounterSuppressedEntryEvents];
+    } else {
+        [userWithinRegions addObject:poi.identifier];
+        [self postRegionUpdate:region withEventType:ACPRegionEventTypeEntry];
+    }
 }
 
 - (void) stopMonitoringGeoFences {
     // remove regions in locationManager.moniteredRegions that we have initialized
+    NSSet<NSString*>* ownedRegions = [self ownedRegionIdentifiers];
     NSArray* regions = [_locationManager.monitoredRegions copy];
 
     for (CLRegion * region in regions) {
-        if ([region isKindOfClass:[CLCircularRegion class]] && [_currentlyMonitoredRegions containsObject:region.identifier]) {
+        if ([region isKindOfClass:[CLCircularRegion class]] && [ownedRegions containsObject:region.identifier]) {
             [_locationManager stopMonitoringForRegion:region];
         }
     }
@@ -547,12 +1363,13 @@
 
 - (void) removeNonMonitoredRegionsFromUserWithinRegions {
     // remove all regions from our _userWithinRegions array if they are no longer in our _currentlyMonitoredRegions
-    NSArray* userWithinRegionsCopy = [_userWithinRegions copy];
+    NSSet<NSString*>* monitoredRegions = [NSSet setWithArray:_currentlyMonitoredRegions];
 
-    for (NSString * regionId in userWithinRegionsCopy) {
-        if (![_currentlyMonitoredRegions containsObject:regionId]) {
-            [_userWithinRegions removeObject:regionId];
-        }
+    @synchronized (self) {
+        NSIndexSet* staleIndexes = [_userWithinRegions indexesOfObjectsPassingTest:^BOOL (NSString* regionId, NSUInteger idx, BOOL* stop) {
+            return ![monitoredRegions containsObject:regionId];
+        }];
+        [_userWithinRegions removeObjectsAtIndexes:staleIndexes];
     }
 
     [self updateUserWithinRegionsInPersistence];
@@ -562,20 +1379,32 @@
 - (void) startMonitoringSignificantLocationChanges {
     if ([CLLocationManager significantLocationChangeMonitoringAvailable]) {
         _isMonitoringStarted = true;
-        [_locationManager startMonitoringSignificantLocationChanges];
-        [ACPCore log:ACPMobileLogLevelDebug
-                 tag:ACPPlacesMonitorExtensionName
-             message:@"Significant location collection is enabled"];
+
+        if (_significantChangeState == ACPPlacesLocationServiceStateOn) {
+            return;
+        }
+
+        _significantChangeState = ACPPlacesLocationServiceStateOn;
+        [self performWithLocationManager:^(CLLocationManager* locationManager) {
+            [locationManager startMonitoringSignificantLocationChanges];
+        }];
+        ACPPlacesMonitorLogDebug(@"Significant location collection is enabled");
     }
 }
 
 - (void) stopMonitoringSignificantLocationChanges {
     if ([CLLocationManager significantLocationChangeMonitoringAvailable]) {
         _isMonitoringStarted = false;
-        [_locationManager stopMonitoringSignificantLocationChanges];
-        [ACPCore log:ACPMobileLogLevelDebug
-                 tag:ACPPlacesMonitorExtensionName
-             message:@"Significant location collection is disabled"];
+
+        if (_significantChangeState == ACPPlacesLocationServiceStateOff) {
+            return;
+        }
+
+        _significantChangeState = ACPPlacesLocationServiceStateOff;
+        [self performWithLocationManager:^(CLLocationManager* locationManager) {
+            [locationManager stopMonitoringSignificantLocationChanges];
+        }];
+        ACPPlacesMonitorLogDebug(@"Significant location collection is disabled");
     }
 }
 #endif
@@ -595,37 +1424,232 @@
 
     // this method is available on iOS and starting with watchOS3
     if ([_locationManager respondsToSelector:@selector(startUpdatingLocation)]) {
-        [_locationManager startUpdatingLocation];
         _isMonitoringStarted = true;
-        [ACPCore log:ACPMobileLogLevelDebug
-                 tag:ACPPlacesMonitorExtensionName
-             message:@"Continuous location collection is enabled"];
+
+        if (_continuousLocationState == ACPPlacesLocationServiceStateOn) {
+            return;
+        }
+
+        _continuousLocationState = ACPPlacesLocationServiceStateOn;
+        _continuousLocationStartedAt = [[NSProcessInfo processInfo] systemUptime];
+        [self performWithLocationManager:^(CLLocationManager* locationManager) {
+            [locationManager startUpdatingLocation];
+        }];
+        ACPPlacesMonitorLogDebug(@"Continuous location collection is enabled");
     }
 }
 
 - (void) stopMonitoringContinuousLocationChanges {
-    [_locationManager stopUpdatingLocation];
     _isMonitoringStarted = false;
-    [ACPCore log:ACPMobileLogLevelDebug
-             tag:ACPPlacesMonitorExtensionName
-         message:@"Continuous location collection is disabled"];
+
+    if (_continuousLocationState == ACPPlacesLocationServiceStateOff) {
+        return;
+    }
+
+    // the on-time is what continuous updates cost, to weigh against the time spent ranging beacons
+    if (_continuousLocationState == ACPPlacesLocationServiceStateOn) {
+        NSTimeInterval elapsed = [[NSProcessInfo processInfo] systemUptime] - _continuousLocationStartedAt;
+        [_metrics addValue:(uint64_t) llround(elapsed) toCounter:ACPPlacesMetricCounterContinuousLocationSeconds];
+    }
+
+    _continuousLocationState = ACPPlacesLocationServiceStateOff;
+    [self performWithLocationManager:^(CLLocationManager* locationManager) {
+        [locationManager stopUpdatingLocation];
+    }];
+    ACPPlacesMonitorLogDebug(@"Continuous location collection is disabled");
 }
 #endif
 
+#if CONTINUOUS_LOCATION_SUPPORTED && SIGNIFICANT_LOCATION_CHANGE_MONITORING_SUPPORTED
+/**
+ * @brief Re-evaluates the adaptive strategy based on how far the location is from the nearest fence boundary
+ */
+- (void) updateAdaptiveTrackingForLocation: (CLLocation*) location {
+    CLLocationDistance distance = [self distanceToNearestFenceFromLocation:location];
+    ACPPlacesAdaptiveState nextState = [_adaptivePolicy nextStateFromState:_adaptiveState
+                                                          distanceToFence:distance
+                                                              timeInState:-[_adaptiveStateChangedAt timeIntervalSinceNow]];
+    NSString* reason = distance == CLLocationDistanceMax ? @"no fences are monitored" :
+                       [NSString stringWithFormat:@"%.0f meters from the nearest fence", distance];
+    [self transitionToAdaptiveState:nextState reason:reason];
+}
+
+- (void) transitionToAdaptiveState: (ACPPlacesAdaptiveState) state reason: (NSString*) reason {
+    if (state == _adaptiveState) {
+        return;
+    }
+
+    ACPPlacesMonitorLogDebug(@"Adaptive monitoring switched from %@ to %@ (%@)",
+                             [ACPPlacesAdaptivePolicy nameForState:_adaptiveState], [ACPPlacesAdaptivePolicy nameForState:state], reason);
+    _adaptiveState = state;
+    self.adaptiveStateChangedAt = [NSDate date];
+    [self applyAdaptiveState];
+}
+
 /**
- * @brief Removes all objects from currently monitored regions and user within regions, also clears them from persistence.
+ * @brief Configures the CLLocationManager for the current adaptive state
+ *
+ * @discussion Significant changes are always kept running so the app can still be relaunched by the OS.  When
+ * continuous updates are started, a timer makes sure they are stopped after the policy's time limit even if the
+ * device does not move.
+ */
+- (void) applyAdaptiveState {
+    [self applyDesiredAccuracy:[_adaptivePolicy desiredAccuracyForState:_adaptiveState]];
+    _locationManager.distanceFilter = [_adaptivePolicy distanceFilterForState:_adaptiveState];
+
+    if (![_adaptivePolicy usesContinuousUpdatesInState:_adaptiveState]) {
+        [self stopMonitoringContinuousLocationChanges];
+        [self startMonitoringSignificantLocationChanges];
+        return;
+    }
+
+    [self startMonitoringSignificantLocationChanges];
+    [self startMonitoringContinuousLocationChanges];
+
+    NSUInteger generation = ++_adaptiveTimerGeneration;
+    __weak ACPPlacesMonitorInternal* weakSelf = self;
+    [_executor execute:^{
+        [weakSelf adaptiveTimeLimitReachedForGeneration:generation];
+    } afterDelay:_adaptivePolicy.continuousTimeLimit];
+}
+
+- (void) adaptiveTimeLimitReachedForGeneration: (NSUInteger) generation {
+    // a newer transition or mode change has superseded this timer
+    if (generation != _adaptiveTimerGeneration || !(_monitorMode & ACPPlacesMonitorModeAdaptive) ||
+        _adaptiveState != ACPPlacesAdaptiveStateApproaching) {
+        return;
+    }
+
+    [self transitionToAdaptiveState:ACPPlacesAdaptiveStateBackedOff reason:@"continuous time limit reached"];
+}
+#endif
+
+#pragma mark - Metrics
+/**
+ * @brief Records the time from the last location fix to the geofences reflecting it, once per fix
+ */
+- (void) recordFixToFencesLatency {
+    if (!_lastFixReceivedAt) {
+        return;
+    }
+
+    [_metrics recordValue:([[NSProcessInfo processInfo] systemUptime] - _lastFixReceivedAt) * 1000
+              inHistogram:ACPPlacesMetricHistogramFixToFencesLatency];
+    _lastFixReceivedAt = 0;
+}
+
+- (void) respondWithMetricsToEvent: (ACPExtensionEvent*) event {
+    NSError* error = nil;
+    ACPExtensionEvent* response = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameMetrics
+                                                                       type:ACPPlacesMonitorEventTypeMonitor
+                                                                     source:ACPPlacesMonitorEventSourceResponseContent
+                                                                       data:@ {ACPPlacesMonitorEventDataMetrics: [_metrics snapshot]}
+                                                                      error:&error];
+
+    if (!response || ![ACPCore dispatchResponseEvent:response requestEvent:event error:&error]) {
+        ACPPlacesMonitorLogWarning(@"An error occurred while responding with the metrics snapshot: %@",
+                                   error.localizedDescription ? : @"unknown error");
+    }
+}
+
+- (void) updateMetricsReportingInterval: (NSTimeInterval) interval {
+    self.metricsReportingInterval = MAX(interval, 0);
+
+    // bumping the generation retires the timer armed for the previous interval
+    NSUInteger generation = ++_metricsTimerGeneration;
+
+    if (_metricsReportingInterval > 0) {
+        [self scheduleMetricsReportForGeneration:generation];
+    }
+}
+
+- (void) scheduleMetricsReportForGeneration: (NSUInteger) generation {
+    __weak ACPPlacesMonitorInternal* weakSelf = self;
+    [_executor execute:^{
+        [weakSelf reportMetricsForGeneration:generation];
+    } afterDelay:_metricsReportingInterval];
+}
+
+- (void) reportMetricsForGeneration: (NSUInteger) generation {
+    if (generation != _metricsTimerGeneration || _metricsReportingInterval <= 0) {
+        return;
+    }
+
+    NSError* error = nil;
+    ACPExtensionEvent* event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameMetrics
+                                                                    type:ACPPlacesMonitorEventTypeMonitor
+                                                                  source:ACPPlacesMonitorEventSourceResponseContent
+                                                                    data:@ {ACPPlacesMonitorEventDataMetrics: [_metrics snapshot]}
+                                                                   error:&error];
+
+    if (!event || ![ACPCore dispatchEvent:event error:&error]) {
+        ACPPlacesMonitorLogWarning(@"An error occurred while dispatching the metrics snapshot: %@",
+                                   error.localizedDescription ? : @"unknown error");
+    }
+
+    [self scheduleMetricsReportForGeneration:generation];
+}
+
+/**
+ * @brief Identifiers of every region registered by the monitor, including the boundary region
+ */
+- (NSSet<NSString*>*) ownedRegionIdentifiers {
+    NSMutableSet<NSString*>* owned = [NSMutableSet setWithArray:_currentlyMonitoredRegions];
+    [owned addObject:ACPPlacesMonitorBoundaryRegionIdentifier];
+
+    return owned;
+}
+
+/**
+ * @brief Returns the distance in meters between the location and the closest boundary of a monitored fence
+ *
+ * @return the distance, or CLLocationDistanceMax if no fences are monitored
+ */
+- (CLLocationDistance) distanceToNearestFenceFromLocation: (CLLocation*) location {
+    CLLocationDistance nearest = CLLocationDistanceMax;
+    NSSet<NSString*>* ownedRegions = [NSSet setWithArray:_currentlyMonitoredRegions];
+
+    for (CLRegion* region in _locationManager.monitoredRegions) {
+        if (![region isKindOfClass:[CLCircularRegion class]] || ![ownedRegions containsObject:region.identifier]) {
+            continue;
+        }
+
+        CLCircularRegion* fence = (CLCircularRegion*) region;
+        CLLocation* center = [[CLLocation alloc] initWithLatitude:fence.center.latitude longitude:fence.center.longitude];
+        nearest = MIN(nearest, fabs([location distanceFromLocation:center] - fence.radius));
+    }
+
+    return nearest;
+}
+
+/**
+ * @brief Removes all objects from currently monitored regions and user within regions and forgets the last query
+ * location, also clears them from persistence.
  */
 - (void) clearMonitorData {
     [_currentlyMonitoredRegions removeAllObjects];
     [self updateCurrentlyMonitoredRegionsInPersistence];
     
-    [_userWithinRegions removeAllObjects];
+    @synchronized (self) {
+        [_userWithinRegions removeAllObjects];
+    }
+
     [self updateUserWithinRegionsInPersistence];
+
+    [self updateLastQueryLocation:nil];
+    [_containmentEngine loadPois:@[]];
+    self.regionClusters = nil;
+    self.clusterResolutionPending = NO;
+    self.beaconPois = nil;
+}
+
+- (void) updateLastQueryLocation: (CLLocation*) location {
+    self.lastQueryLocation = location;
+    [_persistence setObject:location forKey:ACPPlacesMonitorStateLastQueryLocation];
 }
 
 - (void) persistMonitoringStatus {
-    [[NSUserDefaults standardUserDefaults] setBool:_isMonitoringStarted forKey:ACPPlacesMonitorDefaultsIsMonitoringStarted];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [_persistence setObject:@(_isMonitoringStarted) forKey:ACPPlacesMonitorDefaultsIsMonitoringStarted];
 }
 
 - (BOOL) userHasDeclinedLocationPermission: (CLAuthorizationStatus) status {
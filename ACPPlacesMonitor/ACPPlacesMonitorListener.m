@@ -18,6 +18,7 @@
 #import "ACPPlacesMonitorConstants.h"
 #import "ACPPlacesMonitorInternal.h"
 #import "ACPPlacesMonitorListener.h"
+#import "ACPPlacesMonitorLog.h"
 
 @implementation ACPPlacesMonitorListener
 
@@ -46,20 +47,17 @@
     ACPPlacesMonitorInternal* parentExtension = [self getParentExtension];
 
     if (parentExtension == nil) {
-        [ACPCore log:ACPMobileLogLevelError
-                 tag:ACPPlacesMonitorExtensionName
-             message:[NSString stringWithFormat:@"The parent extension is nil, unable to process the event: %@", event.eventName]];
+        ACPPlacesMonitorLogError(@"The parent extension is nil, unable to process the event: %@", event.eventName);
         return;
     }
     
-    [ACPCore log:ACPMobileLogLevelVerbose
-             tag:ACPPlacesMonitorExtensionName
-         message:[NSString stringWithFormat:@"ACPPlacesMonitor heard event '%@' (type:%@ - source:%@)", event.eventName, event.eventType, event.eventSource]];
+    ACPPlacesMonitorLogVerbose(@"ACPPlacesMonitor heard event '%@' (type:%@ - source:%@)", event.eventName, event.eventType, event.eventSource);
 
     // handle SharedState events
     if ([event.eventType isEqualToString:ACPPlacesMonitorEventTypeHub] && [event.eventSource isEqualToString:ACPPlacesMonitorEventSourceSharedState]) {
         // only concerned with configuration changes at this point
         if ([event.eventData[ACPPlacesMonitorStateOwner] isEqualToString:ACPPlacesMonitorConfigurationSharedState]) {
+            [parentExtension configurationDidChange];
             [parentExtension processEvents];
         }
     }
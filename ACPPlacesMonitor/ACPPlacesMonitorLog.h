@@ -0,0 +1,56 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesMonitorLog.h
+//
+
+#import <ACPCore/ACPCore.h>
+#import <Foundation/Foundation.h>
+#import "ACPPlacesMonitorConstants.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Returns YES if ACPCore currently prints messages of the provided level
+ */
+FOUNDATION_EXPORT BOOL ACPPlacesMonitorLogLevelEnabled(ACPMobileLogLevel level);
+
+NS_ASSUME_NONNULL_END
+
+#pragma mark - logging macros
+// the message is a format string and its arguments.  it is only formatted, and its arguments only evaluated, when
+// the level is enabled, so a log line on a hot path costs a single level check while logging is turned down
+#define ACPPlacesMonitorLog(logLevel, ...)                                                                              \
+    do {                                                                                                              \
+        if (ACPPlacesMonitorLogLevelEnabled(logLevel)) {                                                              \
+            [ACPCore log:(logLevel) tag:ACPPlacesMonitorExtensionName message:[NSString stringWithFormat:__VA_ARGS__]]; \
+        }                                                                                                             \
+    } while (0)
+
+#define ACPPlacesMonitorLogError(...) ACPPlacesMonitorLog(ACPMobileLogLevelError, __VA_ARGS__)
+#define ACPPlacesMonitorLogWarning(...) ACPPlacesMonitorLog(ACPMobileLogLevelWarning, __VA_ARGS__)
+#define ACPPlacesMonitorLogDebug(...) ACPPlacesMonitorLog(ACPMobileLogLevelDebug, __VA_ARGS__)
+
+// verbose messages are compiled out of builds without DEBUG, which Xcode and CocoaPods only define for debug
+// configurations.  the dead branch keeps the arguments type checked and keeps variables that are only logged from
+// being reported as unused
+#if !DEBUG && !defined(ACP_TESTING)
+#define ACPPlacesMonitorLogVerbose(...)                     \
+    do {                                                    \
+        if (0) {                                            \
+            (void) [NSString stringWithFormat:__VA_ARGS__]; \
+        }                                                   \
+    } while (0)
+#else
+#define ACPPlacesMonitorLogVerbose(...) ACPPlacesMonitorLog(ACPMobileLogLevelVerbose, __VA_ARGS__)
+#endif
@@ -0,0 +1,110 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPersistence.h
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesStateStore;
+
+/**
+ * @class ACPPlacesPersistence
+ *
+ * @discussion A write-behind layer in front of NSUserDefaults.
+ *
+ * Writes are staged in memory and marked dirty.  All dirty values are written to NSUserDefaults as a single snapshot
+ * followed by one call to synchronize, either after a short delay, when the application enters the background or
+ * terminates, or when flush is called explicitly.  Reads always return the most recently staged value, so callers
+ * see a consistent view regardless of whether a flush has happened yet.
+ *
+ * With a state store, the keys it stores are kept in its state file instead of NSUserDefaults.  The state file is
+ * loaded once when the persistence layer is created, migrating the keys out of NSUserDefaults if there is no state
+ * file yet, and a flush rewrites it whenever one of its keys is dirty.  Values for all other keys must be property
+ * list objects.
+ */
+@interface ACPPlacesPersistence : NSObject
+
+/**
+ * @brief Number of values written by callers
+ */
+@property(nonatomic, readonly) NSUInteger requestedWriteCount;
+
+/**
+ * @brief Number of snapshots actually written to NSUserDefaults
+ */
+@property(nonatomic, readonly) NSUInteger flushCount;
+
+/**
+ * @brief Number of staged values that were replaced before being flushed, and were never written to NSUserDefaults
+ */
+@property(nonatomic, readonly) NSUInteger coalescedWriteCount;
+
+/**
+ * @brief Approximate number of bytes that were not written thanks to coalescing
+ *
+ * @discussion The difference between the estimated size of every value written by callers and that of the values
+ * actually flushed.  Sizes are estimated without serializing, from string and data lengths and collection counts.
+ */
+@property(nonatomic, readonly) NSUInteger bytesSaved;
+
+/**
+ * @brief Creates a persistence layer over the standard user defaults and the default state file, with the default
+ * flush delay
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates a persistence layer over the provided user defaults only
+ *
+ * @param userDefaults the NSUserDefaults to be written
+ * @param flushDelay the number of seconds to wait after the first dirty write before flushing
+ */
+- (instancetype) initWithUserDefaults: (NSUserDefaults*) userDefaults flushDelay: (NSTimeInterval) flushDelay;
+
+/**
+ * @brief Creates a persistence layer over the provided user defaults and state store
+ *
+ * @param userDefaults the NSUserDefaults to be written
+ * @param stateStore the state file for the keys it stores, or nil to keep every key in NSUserDefaults
+ * @param flushDelay the number of seconds to wait after the first dirty write before flushing
+ */
+- (instancetype) initWithUserDefaults: (NSUserDefaults*) userDefaults
+                           stateStore: (nullable ACPPlacesStateStore*) stateStore
+                           flushDelay: (NSTimeInterval) flushDelay NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Returns the staged value for the key, or the persisted value if there is none
+ */
+- (nullable id) objectForKey: (NSString*) key;
+
+/**
+ * @brief Stages a value for the key, passing nil will remove the key on the next flush
+ */
+- (void) setObject: (nullable id) value forKey: (NSString*) key;
+
+/**
+ * @brief Immediately writes all dirty values to NSUserDefaults and the state file
+ */
+- (void) flush;
+
+/**
+ * @brief Indicates whether there are staged values which have not been flushed yet
+ */
+- (BOOL) hasPendingWrites;
+
+@end
+
+NS_ASSUME_NONNULL_END
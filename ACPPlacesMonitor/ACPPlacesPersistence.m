@@ -0,0 +1,220 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPersistence.m
+//
+
+#import <UIKit/UIKit.h>
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesPersistence.h"
+#import "ACPPlacesStateStore.h"
+
+@interface ACPPlacesPersistence()
+@property(nonatomic, strong) NSUserDefaults* userDefaults;
+@property(nonatomic, strong) ACPPlacesStateStore* stateStore;
+@property(nonatomic, strong) NSMutableDictionary<NSString*, id>* storedValues;
+@property(nonatomic) BOOL stateStoreNeedsWrite;
+@property(nonatomic) NSTimeInterval flushDelay;
+@property(nonatomic, strong) NSMutableDictionary<NSString*, id>* dirtyValues;
+@property(nonatomic) BOOL flushScheduled;
+@property(nonatomic, readwrite) NSUInteger requestedWriteCount;
+@property(nonatomic, readwrite) NSUInteger flushCount;
+@property(nonatomic, readwrite) NSUInteger coalescedWriteCount;
+@property(nonatomic) NSUInteger requestedBytes;
+@property(nonatomic) NSUInteger writtenBytes;
+@end
+
+// estimated size of a collection element, the persisted collections hold region identifiers
+static const NSUInteger ACPPlacesPersistenceEstimatedElementSize = 36;
+
+// estimated size of a number, date or any other fixed size value
+static const NSUInteger ACPPlacesPersistenceEstimatedScalarSize = 8;
+
+@implementation ACPPlacesPersistence
+
+- (instancetype) init {
+    return [self initWithUserDefaults:[NSUserDefaults standardUserDefaults]
+                           stateStore:[[ACPPlacesStateStore alloc] init]
+                           flushDelay:ACPPlacesMonitorPersistenceFlushDelay];
+}
+
+- (instancetype) initWithUserDefaults: (NSUserDefaults*) userDefaults flushDelay: (NSTimeInterval) flushDelay {
+    return [self initWithUserDefaults:userDefaults stateStore:nil flushDelay:flushDelay];
+}
+
+- (instancetype) initWithUserDefaults: (NSUserDefaults*) userDefaults
+                           stateStore: (ACPPlacesStateStore*) stateStore
+                           flushDelay: (NSTimeInterval) flushDelay {
+    if (self = [super init]) {
+        self.userDefaults = userDefaults;
+        self.stateStore = stateStore;
+        self.flushDelay = flushDelay;
+        self.dirtyValues = [[NSMutableDictionary alloc] init];
+
+        // the state file is read once, every later read is served from memory
+        if (stateStore) {
+            NSDictionary* storedValues = [stateStore load] ?: [stateStore migrateFromUserDefaults:userDefaults];
+            self.storedValues = [storedValues mutableCopy];
+        }
+
+        // the app may be suspended or killed at any time once it leaves the foreground
+        NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+        [center addObserver:self selector:@selector(flush) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [center addObserver:self selector:@selector(flush) name:UIApplicationWillTerminateNotification object:nil];
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (id) objectForKey: (NSString*) key {
+    @synchronized (self) {
+        id stagedValue = _dirtyValues[key];
+
+        if (stagedValue) {
+            return stagedValue == [NSNull null] ? nil : stagedValue;
+        }
+
+        if ([self isStoredKey:key]) {
+            return _storedValues[key];
+        }
+    }
+
+    return [_userDefaults objectForKey:key];
+}
+
+- (void) setObject: (id) value forKey: (NSString*) key {
+    if (!key) {
+        return;
+    }
+
+    // copy mutable collections so later mutations by the caller don't leak into the snapshot
+    id stagedValue = value ? ([value respondsToSelector:@selector(copyWithZone:)] ? [value copy] : value) : [NSNull null];
+
+    @synchronized (self) {
+        _requestedWriteCount++;
+        _requestedBytes += [self estimatedSizeOfValue:stagedValue];
+
+        // only counted, sizing the superseded value would cost more than the write it replaces
+        if (_dirtyValues[key]) {
+            _coalescedWriteCount++;
+        }
+
+        _dirtyValues[key] = stagedValue;
+        [self scheduleFlush];
+    }
+}
+
+- (void) flush {
+    // the lock is held until the values reach NSUserDefaults, so readers never see a value go missing mid-flush
+    @synchronized (self) {
+        if (!_dirtyValues.count && !_stateStoreNeedsWrite) {
+            return;
+        }
+
+        // write every dirty value before a single synchronize so the snapshot lands on disk as a whole
+        BOOL userDefaultsDirty = NO;
+
+        for (NSString* key in _dirtyValues) {
+            id value = _dirtyValues[key];
+            _writtenBytes += [self estimatedSizeOfValue:value];
+
+            if ([self isStoredKey:key]) {
+                _storedValues[key] = value == [NSNull null] ? nil : value;
+                _stateStoreNeedsWrite = YES;
+            } else if (value == [NSNull null]) {
+                [_userDefaults removeObjectForKey:key];
+                userDefaultsDirty = YES;
+            } else {
+                [_userDefaults setObject:value forKey:key];
+                userDefaultsDirty = YES;
+            }
+        }
+
+        if (userDefaultsDirty) {
+            [_userDefaults synchronize];
+        }
+
+        // the state file is rewritten as a whole, a failed write is tried again on the next flush
+        if (_stateStoreNeedsWrite && [_stateStore writeValues:_storedValues]) {
+            _stateStoreNeedsWrite = NO;
+        }
+
+        [_dirtyValues removeAllObjects];
+        _flushCount++;
+    }
+}
+
+- (NSUInteger) bytesSaved {
+    @synchronized (self) {
+        // values still staged are neither saved nor written yet
+        NSUInteger pendingBytes = 0;
+
+        for (NSString* key in _dirtyValues) {
+            pendingBytes += [self estimatedSizeOfValue:_dirtyValues[key]];
+        }
+
+        return _requestedBytes - _writtenBytes - pendingBytes;
+    }
+}
+
+- (BOOL) hasPendingWrites {
+    @synchronized (self) {
+        return _dirtyValues.count > 0;
+    }
+}
+
+#pragma mark - private methods
+- (BOOL) isStoredKey: (NSString*) key {
+    return _stateStore && [[ACPPlacesStateStore storedKeys] containsObject:key];
+}
+
+- (NSUInteger) estimatedSizeOfValue: (id) value {
+    // constant time, the value is never walked or serialized
+    if (value == [NSNull null]) {
+        return 0;
+    } else if ([value isKindOfClass:[NSString class]]) {
+        return [value length];
+    } else if ([value isKindOfClass:[NSData class]]) {
+        return [value length];
+    } else if ([value respondsToSelector:@selector(count)]) {
+        return [value count] * ACPPlacesPersistenceEstimatedElementSize;
+    }
+
+    return ACPPlacesPersistenceEstimatedScalarSize;
+}
+
+- (void) scheduleFlush {
+    if (_flushScheduled) {
+        return;
+    }
+
+    _flushScheduled = YES;
+    __weak ACPPlacesPersistence* weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_flushDelay * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        ACPPlacesPersistence* strongSelf = weakSelf;
+
+        if (strongSelf) {
+            @synchronized (strongSelf) {
+                strongSelf.flushScheduled = NO;
+            }
+            [strongSelf flush];
+        }
+    });
+}
+
+@end
@@ -0,0 +1,93 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiCache.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesPoi;
+
+/**
+ * @class ACPPlacesPoiCache
+ *
+ * @discussion A client-side spatial cache of nearby POI responses from the Places Query Service.
+ *
+ * Responses are stored in a grid of square cells, keyed by the cell containing the location used for the query.
+ * A cached response can answer a new location if it was queried within validityRadius meters of that location and
+ * is not older than timeToLive seconds.  Ages are measured using the timestamps of the provided CLLocations.
+ */
+@interface ACPPlacesPoiCache : NSObject
+
+@property(nonatomic, readonly) CLLocationDistance cellSize;
+@property(nonatomic, readonly) CLLocationDistance validityRadius;
+@property(nonatomic, readonly) NSTimeInterval timeToLive;
+@property(nonatomic, readonly) NSUInteger capacity;
+
+/**
+ * @brief Number of lookups answered by the cache
+ */
+@property(nonatomic, readonly) NSUInteger hitCount;
+
+/**
+ * @brief Number of lookups that could not be answered by the cache
+ */
+@property(nonatomic, readonly) NSUInteger missCount;
+
+/**
+ * @brief Creates a cache using the default values defined in ACPPlacesMonitorConstants
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates a cache with the provided grid and validity settings
+ *
+ * @param cellSize the length in meters of a side of a grid cell
+ * @param validityRadius the maximum distance in meters between a cached query location and a new location
+ * @param timeToLive the maximum age in seconds of a cached response
+ * @param capacity the maximum number of cells held by the cache, the oldest cell is evicted first
+ */
+- (instancetype) initWithCellSize: (CLLocationDistance) cellSize
+                   validityRadius: (CLLocationDistance) validityRadius
+                       timeToLive: (NSTimeInterval) timeToLive
+                         capacity: (NSUInteger) capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Returns the cached POIs that are valid for the provided location
+ *
+ * @discussion On a hit, the userIsWithin flag of each returned POI is recalculated for the provided location.
+ *
+ * @param location the CLLocation of the device
+ * @return an array of ACPPlacesPoi objects, or nil if the cache does not contain a valid response for the location
+ */
+- (nullable NSArray<ACPPlacesPoi*>*) poisNearLocation: (CLLocation*) location;
+
+/**
+ * @brief Stores a nearby POI response for the location that was used to query it
+ *
+ * @param pois the POIs returned by the Places Query Service, nil is stored as an empty response
+ * @param location the CLLocation used for the query
+ */
+- (void) cachePois: (nullable NSArray<ACPPlacesPoi*>*) pois forLocation: (CLLocation*) location;
+
+/**
+ * @brief Removes all cached responses
+ */
+- (void) invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,190 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiCache.m
+//
+
+#import <ACPPlaces/ACPPlaces.h>
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesPoiCache.h"
+
+// approximate length in meters of one degree of latitude
+static double const ACPPlacesPoiCacheMetersPerDegree = 111320.0;
+
+#pragma mark - ACPPlacesPoiCacheEntry
+@interface ACPPlacesPoiCacheEntry : NSObject
+@property(nonatomic, strong) CLLocation* queryLocation;
+@property(nonatomic, copy) NSArray<ACPPlacesPoi*>* pois;
+@end
+
+@implementation ACPPlacesPoiCacheEntry
+@end
+
+#pragma mark - ACPPlacesPoiCache private properties
+@interface ACPPlacesPoiCache()
+@property(nonatomic, strong) NSMutableDictionary<NSString*, ACPPlacesPoiCacheEntry*>* cells;
+@property(nonatomic, readwrite) NSUInteger hitCount;
+@property(nonatomic, readwrite) NSUInteger missCount;
+@end
+
+@implementation ACPPlacesPoiCache
+
+- (instancetype) init {
+    return [self initWithCellSize:ACPPlacesMonitorPoiCacheCellSize
+                   validityRadius:ACPPlacesMonitorPoiCacheValidityRadius
+                       timeToLive:ACPPlacesMonitorPoiCacheTimeToLive
+                         capacity:ACPPlacesMonitorPoiCacheCapacity];
+}
+
+- (instancetype) initWithCellSize: (CLLocationDistance) cellSize
+                   validityRadius: (CLLocationDistance) validityRadius
+                       timeToLive: (NSTimeInterval) timeToLive
+                         capacity: (NSUInteger) capacity {
+    if (self = [super init]) {
+        _cellSize = cellSize > 0 ? cellSize : ACPPlacesMonitorPoiCacheCellSize;
+        _validityRadius = validityRadius;
+        _timeToLive = timeToLive;
+        _capacity = capacity ? : 1;
+        self.cells = [[NSMutableDictionary alloc] initWithCapacity:_capacity];
+    }
+
+    return self;
+}
+
+- (NSArray<ACPPlacesPoi*>*) poisNearLocation: (CLLocation*) location {
+    if (!location || !_cells.count) {
+        _missCount++;
+        return nil;
+    }
+
+    // a valid entry can be at most one cell away as long as the validity radius is not larger than a cell
+    NSInteger reach = (NSInteger) ceil(_validityRadius / _cellSize);
+    NSInteger row = [self rowForLatitude:location.coordinate.latitude];
+    ACPPlacesPoiCacheEntry* bestEntry = nil;
+    CLLocationDistance bestDistance = DBL_MAX;
+
+    for (NSInteger rowOffset = -reach; rowOffset <= reach; rowOffset++) {
+        NSInteger column = [self columnForLongitude:location.coordinate.longitude inRow:row + rowOffset];
+
+        for (NSInteger columnOffset = -reach; columnOffset <= reach; columnOffset++) {
+            ACPPlacesPoiCacheEntry* entry = _cells[[self keyForRow:row + rowOffset column:column + columnOffset]];
+
+            if (!entry) {
+                continue;
+            }
+
+            NSTimeInterval age = [location.timestamp timeIntervalSinceDate:entry.queryLocation.timestamp];
+            CLLocationDistance distance = [location distanceFromLocation:entry.queryLocation];
+
+            if (fabs(age) <= _timeToLive && distance <= _validityRadius && distance < bestDistance) {
+                bestEntry = entry;
+                bestDistance = distance;
+            }
+        }
+    }
+
+    if (!bestEntry) {
+        _missCount++;
+        return nil;
+    }
+
+    _hitCount++;
+
+    // userIsWithin was calculated by the server for the original query location, it is recalculated on copies so
+    // the cached POIs keep answering for any later location
+    NSMutableArray<ACPPlacesPoi*>* pois = [[NSMutableArray alloc] initWithCapacity:bestEntry.pois.count];
+
+    for (ACPPlacesPoi* cachedPoi in bestEntry.pois) {
+        ACPPlacesPoi* poi = [self copyOfPoi:cachedPoi];
+        CLLocation* center = [[CLLocation alloc] initWithLatitude:poi.latitude longitude:poi.longitude];
+        poi.userIsWithin = [location distanceFromLocation:center] <= poi.radius;
+        [pois addObject:poi];
+    }
+
+    return pois;
+}
+
+- (void) cachePois: (NSArray<ACPPlacesPoi*>*) pois forLocation: (CLLocation*) location {
+    if (!location) {
+        return;
+    }
+
+    ACPPlacesPoiCacheEntry* entry = [[ACPPlacesPoiCacheEntry alloc] init];
+    entry.queryLocation = location;
+    entry.pois = pois ? : @[];
+
+    NSInteger row = [self rowForLatitude:location.coordinate.latitude];
+    NSInteger column = [self columnForLongitude:location.coordinate.longitude inRow:row];
+    NSString* key = [self keyForRow:row column:column];
+
+    if (!_cells[key] && _cells.count >= _capacity) {
+        [self evictOldestEntry];
+    }
+
+    _cells[key] = entry;
+}
+
+- (void) invalidate {
+    [_cells removeAllObjects];
+}
+
+#pragma mark - private methods
+- (ACPPlacesPoi*) copyOfPoi: (ACPPlacesPoi*) poi {
+    ACPPlacesPoi* copy = [[ACPPlacesPoi alloc] init];
+    copy.identifier = poi.identifier;
+    copy.name = poi.name;
+    copy.latitude = poi.latitude;
+    copy.longitude = poi.longitude;
+    copy.radius = poi.radius;
+    copy.userIsWithin = poi.userIsWithin;
+    copy.libraryId = poi.libraryId;
+    copy.weight = poi.weight;
+    copy.metaData = poi.metaData;
+    return copy;
+}
+
+- (NSInteger) rowForLatitude: (CLLocationDegrees) latitude {
+    return (NSInteger) floor(latitude * ACPPlacesPoiCacheMetersPerDegree / _cellSize);
+}
+
+- (NSInteger) columnForLongitude: (CLLocationDegrees) longitude inRow: (NSInteger) row {
+    // cells in a row share the width of the row's center so that they remain roughly square
+    double rowLatitude = (row + 0.5) * _cellSize / ACPPlacesPoiCacheMetersPerDegree;
+    double metersPerDegree = MAX(ACPPlacesPoiCacheMetersPerDegree * cos(rowLatitude * M_PI / 180.0), 1.0);
+
+    return (NSInteger) floor(longitude * metersPerDegree / _cellSize);
+}
+
+- (NSString*) keyForRow: (NSInteger) row column: (NSInteger) column {
+    return [NSString stringWithFormat:@"%ld:%ld", (long) row, (long) column];
+}
+
+- (void) evictOldestEntry {
+    NSString* oldestKey = nil;
+    NSDate* oldestDate = nil;
+
+    for (NSString* key in _cells) {
+        NSDate* date = _cells[key].queryLocation.timestamp;
+
+        if (!oldestDate || [date compare:oldestDate] == NSOrderedAscending) {
+            oldestDate = date;
+            oldestKey = key;
+        }
+    }
+
+    if (oldestKey) {
+        [_cells removeObjectForKey:oldestKey];
+    }
+}
+
+@end
@@ -0,0 +1,113 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiPack.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesPoi;
+
+/**
+ * @class ACPPlacesPoiPack
+ *
+ * @discussion An app-supplied set of POIs, answering nearby POI queries on the device.
+ *
+ * The pack is a file built ahead of time with the placesmonitor_build_poi_pack tool from an export of the POI
+ * library.  It holds a spatial index and is memory-mapped, so opening it and querying it read only the few pages a
+ * query touches.
+ *
+ * The pack is a snapshot and the POI library keeps changing, so nearby POI responses from the Places Query Service
+ * are layered over it as deltas.  A delta replaces the pack's POIs with the same identifier, adds the new ones, and
+ * removes the pack's POIs it should have returned but did not: those within the distance of its farthest POI, or
+ * within the search radius when it returned fewer POIs than were asked for.  An area needs a delta again once its
+ * newest one is older than refreshInterval.  Ages are measured using the timestamps of the provided CLLocations.
+ */
+@interface ACPPlacesPoiPack : NSObject
+
+/**
+ * @brief The path of the pack file
+ */
+@property(nonatomic, readonly, copy) NSString* path;
+
+/**
+ * @brief Number of POIs in the pack, not counting the deltas
+ */
+@property(nonatomic, readonly) NSUInteger count;
+
+/**
+ * @brief The revision the pack was built with
+ */
+@property(nonatomic, readonly) uint64_t revision;
+
+/**
+ * @brief The maximum age in seconds of the newest delta for an area before it needs a refresh
+ */
+@property(nonatomic, readonly) NSTimeInterval refreshInterval;
+
+/**
+ * @brief Number of deltas held, the oldest one is dropped once ACPPlacesMonitorPoiPackDeltaCapacity is reached
+ */
+@property(nonatomic, readonly) NSUInteger deltaCount;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+/**
+ * @brief Opens the pack using the default refresh interval defined in ACPPlacesMonitorConstants
+ */
+- (nullable instancetype) initWithPath: (NSString*) path;
+
+/**
+ * @brief Opens the pack at the path
+ *
+ * @param path the path of a pack file
+ * @param refreshInterval the maximum age in seconds of the newest delta for an area
+ * @return the pack, or nil if the file is missing or is not a valid pack
+ */
+- (nullable instancetype) initWithPath: (NSString*) path refreshInterval: (NSTimeInterval) refreshInterval NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Returns the POIs nearest to the location, with the deltas applied, nearest first
+ *
+ * @discussion The userIsWithin flag of each returned POI is calculated for the provided location.
+ *
+ * @param location the CLLocation of the device
+ * @param limit the maximum number of POIs returned
+ */
+- (NSArray<ACPPlacesPoi*>*) poisNearLocation: (CLLocation*) location limit: (NSUInteger) limit;
+
+/**
+ * @brief Returns YES if no recent enough delta was received near the location
+ */
+- (BOOL) needsRefreshNearLocation: (CLLocation*) location;
+
+/**
+ * @brief Layers a nearby POI response from the Places Query Service over the pack
+ *
+ * @param pois the POIs returned by the query, nil is treated as an empty response
+ * @param location the CLLocation used for the query
+ * @param limit the number of POIs the query asked for
+ */
+- (void) applyDelta: (nullable NSArray<ACPPlacesPoi*>*) pois forLocation: (CLLocation*) location limit: (NSUInteger) limit;
+
+/**
+ * @brief Drops every delta, queries are answered from the pack alone until new responses arrive
+ */
+- (void) discardDeltas;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,194 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiPack.mm
+//
+
+#import <ACPPlaces/ACPPlaces.h>
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesPoiPack.h"
+
+#include <optional>
+
+#include "placesmonitor/PoiPack.hpp"
+
+#pragma mark - ACPPlacesPoiPackDelta
+@interface ACPPlacesPoiPackDelta : NSObject
+@property(nonatomic, strong) CLLocation* queryLocation;
+@property(nonatomic, copy) NSArray<ACPPlacesPoi*>* pois;
+@property(nonatomic, strong) NSSet<NSString*>* identifiers;
+@property(nonatomic) CLLocationDistance coverage;
+@end
+
+@implementation ACPPlacesPoiPackDelta
+@end
+
+#pragma mark - ACPPlacesPoiPack private properties
+@interface ACPPlacesPoiPack() {
+    std::optional<placesmonitor::PoiPack> _pack;
+}
+@property(nonatomic, strong) NSMutableArray<ACPPlacesPoiPackDelta*>* deltas;
+@end
+
+@implementation ACPPlacesPoiPack
+
+- (instancetype) initWithPath: (NSString*) path {
+    return [self initWithPath:path refreshInterval:ACPPlacesMonitorPoiPackRefreshInterval];
+}
+
+- (instancetype) initWithPath: (NSString*) path refreshInterval: (NSTimeInterval) refreshInterval {
+    if (self = [super init]) {
+        _pack = placesmonitor::PoiPack::open(ACPPlacesCoreString(path));
+
+        if (!_pack) {
+            return nil;
+        }
+
+        _path = [path copy];
+        _refreshInterval = refreshInterval;
+        self.deltas = [[NSMutableArray alloc] init];
+    }
+
+    return self;
+}
+
+- (NSUInteger) count {
+    return _pack->size();
+}
+
+- (uint64_t) revision {
+    return _pack->revision();
+}
+
+- (NSUInteger) deltaCount {
+    return _deltas.count;
+}
+
+- (NSArray<ACPPlacesPoi*>*) poisNearLocation: (CLLocation*) location limit: (NSUInteger) limit {
+    if (!location || !limit) {
+        return @[];
+    }
+
+    NSMutableDictionary<NSString*, ACPPlacesPoi*>* pois = [[NSMutableDictionary alloc] init];
+
+    for (const placesmonitor::Poi& poi : _pack->nearest(ACPPlacesCoreCoordinate(location.coordinate), limit,
+                                                         ACPPlacesMonitorPoiPackSearchRadius)) {
+        pois[ACPPlacesNSString(poi.identifier)] = ACPPlacesPoiFromCorePoi(poi);
+    }
+
+    // deltas are applied oldest first, so the newest response has the last word on a POI
+    for (ACPPlacesPoiPackDelta* delta in _deltas) {
+        if ([delta.queryLocation distanceFromLocation:location] > delta.coverage + ACPPlacesMonitorPoiPackSearchRadius) {
+            continue;
+        }
+
+        for (NSString* identifier in pois.allKeys) {
+            if (![delta.identifiers containsObject:identifier] &&
+                [delta.queryLocation distanceFromLocation:[self centerOfPoi:pois[identifier]]] <= delta.coverage) {
+                [pois removeObjectForKey:identifier];
+            }
+        }
+
+        for (ACPPlacesPoi* poi in delta.pois) {
+            pois[poi.identifier] = poi;
+        }
+    }
+
+    NSMutableArray<ACPPlacesPoi*>* nearby = [[NSMutableArray alloc] initWithCapacity:pois.count];
+    NSMutableDictionary<NSString*, NSNumber*>* distances = [[NSMutableDictionary alloc] initWithCapacity:pois.count];
+
+    for (ACPPlacesPoi* poi in pois.allValues) {
+        CLLocationDistance distance = [location distanceFromLocation:[self centerOfPoi:poi]];
+
+        if (distance <= ACPPlacesMonitorPoiPackSearchRadius) {
+            distances[poi.identifier] = @(distance);
+            [nearby addObject:poi];
+        }
+    }
+
+    [nearby sortUsingComparator:^NSComparisonResult(ACPPlacesPoi* a, ACPPlacesPoi* b) {
+        NSComparisonResult result = [distances[a.identifier] compare:distances[b.identifier]];
+        return result != NSOrderedSame ? result : [a.identifier compare:b.identifier];
+    }];
+
+    if (nearby.count > limit) {
+        [nearby removeObjectsInRange:NSMakeRange(limit, nearby.count - limit)];
+    }
+
+    // userIsWithin of a delta was calculated by the server for its own query location
+    for (ACPPlacesPoi* poi in nearby) {
+        poi.userIsWithin = [distances[poi.identifier] doubleValue] <= poi.radius;
+    }
+
+    return nearby;
+}
+
+- (BOOL) needsRefreshNearLocation: (CLLocation*) location {
+    for (ACPPlacesPoiPackDelta* delta in _deltas) {
+        NSTimeInterval age = [location.timestamp timeIntervalSinceDate:delta.queryLocation.timestamp];
+
+        if (fabs(age) <= _refreshInterval &&
+            [location distanceFromLocation:delta.queryLocation] <= ACPPlacesMonitorPoiPackRefreshRadius) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (void) applyDelta: (NSArray<ACPPlacesPoi*>*) pois forLocation: (CLLocation*) location limit: (NSUInteger) limit {
+    if (!location) {
+        return;
+    }
+
+    ACPPlacesPoiPackDelta* delta = [[ACPPlacesPoiPackDelta alloc] init];
+    delta.queryLocation = location;
+    delta.pois = [pois ? : @[] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"identifier != nil"]];
+    NSMutableSet<NSString*>* identifiers = [[NSMutableSet alloc] initWithCapacity:delta.pois.count];
+    CLLocationDistance farthest = 0;
+
+    for (ACPPlacesPoi* poi in delta.pois) {
+        [identifiers addObject:poi.identifier];
+        farthest = MAX(farthest, [location distanceFromLocation:[self centerOfPoi:poi]]);
+    }
+
+    // a full response only speaks for the area up to its farthest POI, a short one for the whole search area
+    delta.identifiers = identifiers;
+    delta.coverage = delta.pois.count < limit ? ACPPlacesMonitorPoiPackSearchRadius : farthest;
+
+    // a newer response for the same area supersedes the older one
+    for (NSUInteger i = _deltas.count; i > 0; i--) {
+        if ([_deltas[i - 1].queryLocation distanceFromLocation:location] <= ACPPlacesMonitorPoiPackRefreshRadius &&
+            delta.coverage >= _deltas[i - 1].coverage) {
+            [_deltas removeObjectAtIndex:i - 1];
+        }
+    }
+
+    if (_deltas.count >= ACPPlacesMonitorPoiPackDeltaCapacity) {
+        [_deltas removeObjectAtIndex:0];
+    }
+
+    [_deltas addObject:delta];
+}
+
+- (void) discardDeltas {
+    [_deltas removeAllObjects];
+}
+
+#pragma mark - private methods
+- (CLLocation*) centerOfPoi: (ACPPlacesPoi*) poi {
+    return [[CLLocation alloc] initWithLatitude:poi.latitude longitude:poi.longitude];
+}
+
+@end
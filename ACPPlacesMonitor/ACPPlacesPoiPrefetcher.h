@@ -0,0 +1,125 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiPrefetcher.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+#import "ACPPlacesPoiRequestCoordinator.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesMetrics;
+@class ACPPlacesPoiCache;
+
+/**
+ * @protocol ACPPlacesTrajectoryPredictor
+ *
+ * @discussion Estimates where the device will be from its recent location fixes.  The predictor is asked for
+ * several points along the path every time a fix is added, so it must not keep state between calls.
+ */
+@protocol ACPPlacesTrajectoryPredictor <NSObject>
+
+/**
+ * @brief Predicts the location of the device some time after its newest fix
+ *
+ * @param seconds how far past the newest fix to predict
+ * @param history recent valid fixes, oldest first, never empty
+ * @return the predicted location, timestamped when the device is expected there, or nil if no prediction can be made
+ */
+- (nullable CLLocation*) predictLocationAfter: (NSTimeInterval) seconds fromHistory: (NSArray<CLLocation*>*) history;
+
+@end
+
+/**
+ * @class ACPPlacesPoiPrefetcher
+ *
+ * @discussion Fetches the POIs along the path a moving device is expected to take, so they are already in the POI
+ * cache when the device gets there.
+ *
+ * Every fix is added to a short history.  When the device is moving fast enough, points are placed along its
+ * predicted path and the POIs near each one are fetched, one request at a time, and stored in the cache as if the
+ * device had queried them from that point.  By default the newest fix is extrapolated at constant speed (dead
+ * reckoning); any ACPPlacesTrajectoryPredictor can be plugged in instead.  A prediction is a hit once a later fix
+ * lands close enough to it to be answered by the cached response, and a miss if the device never gets there.
+ */
+@interface ACPPlacesPoiPrefetcher : NSObject
+
+/**
+ * @brief The model used to predict the path, nil for dead reckoning
+ *
+ * @discussion Setting the predictor forgets the history and the pending predictions.
+ */
+@property(nonatomic, strong, nullable) id<ACPPlacesTrajectoryPredictor> predictor;
+
+/**
+ * @brief Receives the prefetch counters, optional
+ */
+@property(nonatomic, strong, nullable) ACPPlacesMetrics* metrics;
+
+/**
+ * @brief Returns NO while requests should be held back, fixes are still recorded and scored
+ */
+@property(nonatomic, copy) BOOL (^canFetch)(void);
+
+/**
+ * @brief Number of predicted points planned for prefetching
+ */
+@property(nonatomic, readonly) NSUInteger predictionCount;
+
+/**
+ * @brief Number of predictions the device later reached
+ */
+@property(nonatomic, readonly) NSUInteger hitCount;
+
+/**
+ * @brief Number of predictions the device never reached
+ */
+@property(nonatomic, readonly) NSUInteger missCount;
+
+/**
+ * @brief Share of the scored predictions that were hits
+ */
+@property(nonatomic, readonly) double hitRate;
+
+/**
+ * @brief Number of requests passed to the fetch block
+ */
+@property(nonatomic, readonly) NSUInteger issuedRequestCount;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+/**
+ * @brief Creates a prefetcher using the default values defined in ACPPlacesMonitorConstants
+ *
+ * @param cache the cache receiving the prefetched responses
+ * @param fetchBlock performs a nearby POI request, may complete synchronously or on any thread
+ */
+- (instancetype) initWithCache: (ACPPlacesPoiCache*) cache fetchBlock: (ACPPlacesPoiFetchBlock) fetchBlock NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Scores the earlier predictions against the fix and prefetches along the path predicted from it
+ *
+ * @param location the CLLocation of the device
+ */
+- (void) addLocation: (CLLocation*) location;
+
+/**
+ * @brief Drops the history, the pending predictions and the queued requests, and discards in-flight responses
+ */
+- (void) cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
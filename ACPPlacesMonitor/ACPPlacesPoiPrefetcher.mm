@@ -0,0 +1,257 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiPrefetcher.mm
+//
+
+#import <ACPCore/ACPCore.h>
+#import <ACPPlaces/ACPPlaces.h>
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesMetrics.h"
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesMonitorLog.h"
+#import "ACPPlacesPoiCache.h"
+#import "ACPPlacesPoiPrefetcher.h"
+
+#include <memory>
+
+#include "placesmonitor/TrajectoryPrefetcher.hpp"
+
+namespace {
+
+// lets an ACPPlacesTrajectoryPredictor drive the core prefetcher
+class ACPPlacesObjCTrajectoryPredictor final : public placesmonitor::TrajectoryPredictor {
+public:
+    explicit ACPPlacesObjCTrajectoryPredictor(id<ACPPlacesTrajectoryPredictor> predictor) : predictor_(predictor) {}
+
+    bool predict(const std::vector<placesmonitor::Location>& history,
+                 double seconds,
+                 placesmonitor::Location& predicted) const override {
+        NSMutableArray<CLLocation*>* fixes = [[NSMutableArray alloc] initWithCapacity:history.size()];
+
+        for (const placesmonitor::Location& fix : history) {
+            [fixes addObject:ACPPlacesCLLocation(fix)];
+        }
+
+        CLLocation* location = [predictor_ predictLocationAfter:seconds fromHistory:fixes];
+
+        if (!location) {
+            return false;
+        }
+
+        predicted = ACPPlacesCoreLocation(location);
+        return true;
+    }
+
+private:
+    id<ACPPlacesTrajectoryPredictor> predictor_;
+};
+
+}
+
+@interface ACPPlacesPoiPrefetcher() {
+    placesmonitor::TrajectoryPrefetcher _prefetcher;
+}
+@property(nonatomic, strong) ACPPlacesPoiCache* cache;
+@property(nonatomic, copy) ACPPlacesPoiFetchBlock fetchBlock;
+@property(nonatomic, strong) NSMutableArray<CLLocation*>* queuedLocations;
+@property(nonatomic) BOOL isRequestInFlight;
+@property(nonatomic) NSUInteger generation;
+@property(nonatomic, readwrite) NSUInteger issuedRequestCount;
+@end
+
+@implementation ACPPlacesPoiPrefetcher
+
+- (instancetype) initWithCache: (ACPPlacesPoiCache*) cache fetchBlock: (ACPPlacesPoiFetchBlock) fetchBlock {
+    if (self = [super init]) {
+        placesmonitor::PrefetchSettings settings;
+        settings.historySize = ACPPlacesMonitorPrefetchHistorySize;
+        settings.horizon = ACPPlacesMonitorPrefetchHorizon;
+        settings.minimumSpeed = ACPPlacesMonitorPrefetchMinimumSpeed;
+        settings.spacing = ACPPlacesMonitorPrefetchSpacing;
+        settings.maximumPoints = ACPPlacesMonitorPrefetchMaximumPoints;
+        settings.hitRadius = ACPPlacesMonitorPrefetchHitRadius;
+        _prefetcher = placesmonitor::TrajectoryPrefetcher([self defaultPredictor], settings);
+
+        self.cache = cache;
+        self.fetchBlock = fetchBlock;
+        self.queuedLocations = [[NSMutableArray alloc] init];
+        self.canFetch = ^BOOL {
+            return YES;
+        };
+    }
+
+    return self;
+}
+
+- (void) setPredictor: (id<ACPPlacesTrajectoryPredictor>) predictor {
+    @synchronized (self) {
+        _predictor = predictor;
+        _prefetcher.setPredictor(predictor ? std::make_shared<ACPPlacesObjCTrajectoryPredictor>(predictor) :
+                                 [self defaultPredictor]);
+    }
+}
+
+- (NSUInteger) predictionCount {
+    @synchronized (self) {
+        return (NSUInteger) _prefetcher.statistics().predictions;
+    }
+}
+
+- (NSUInteger) hitCount {
+    @synchronized (self) {
+        return (NSUInteger) _prefetcher.statistics().hits;
+    }
+}
+
+- (NSUInteger) missCount {
+    @synchronized (self) {
+        return (NSUInteger) _prefetcher.statistics().misses;
+    }
+}
+
+- (double) hitRate {
+    @synchronized (self) {
+        return _prefetcher.statistics().hitRate();
+    }
+}
+
+- (void) addLocation: (CLLocation*) location {
+    if (!location) {
+        return;
+    }
+
+    CLLocation* requestLocation = nil;
+    NSUInteger requestGeneration = 0;
+
+    @synchronized (self) {
+        const placesmonitor::PrefetchStatistics before = _prefetcher.statistics();
+        const std::vector<placesmonitor::Location> points = _prefetcher.onLocation(ACPPlacesCoreLocation(location));
+        const placesmonitor::PrefetchStatistics& after = _prefetcher.statistics();
+        [_metrics addValue:after.hits - before.hits toCounter:ACPPlacesMetricCounterPrefetchHits];
+        [_metrics addValue:after.misses - before.misses toCounter:ACPPlacesMetricCounterPrefetchMisses];
+
+        if (points.empty() || !_canFetch()) {
+            return;
+        }
+
+        // the responses are cached as if the device had queried them from the point at the time of this fix
+        for (const placesmonitor::Location& point : points) {
+            CLLocationCoordinate2D coordinate = CLLocationCoordinate2DMake(point.coordinate.latitude,
+                                                                           point.coordinate.longitude);
+            [_queuedLocations addObject:[[CLLocation alloc] initWithCoordinate:coordinate
+                                                                      altitude:0
+                                                            horizontalAccuracy:location.horizontalAccuracy
+                                                              verticalAccuracy:-1
+                                                                     timestamp:location.timestamp]];
+        }
+
+        // points of older plans are the ones the device has most likely passed already
+        NSUInteger maximumQueued = ACPPlacesMonitorPrefetchMaximumPoints;
+
+        if (_queuedLocations.count > maximumQueued) {
+            [_queuedLocations removeObjectsInRange:NSMakeRange(0, _queuedLocations.count - maximumQueued)];
+        }
+
+        ACPPlacesMonitorLogVerbose(@"Prefetching nearby POIs for %lu points ahead of the device (prediction hit rate %.2f)",
+                                   (unsigned long)points.size(), _prefetcher.statistics().hitRate());
+
+        if (!_isRequestInFlight) {
+            requestLocation = [self dequeueRequestWithGeneration:&requestGeneration];
+        }
+    }
+
+    if (requestLocation) {
+        [self issueRequestForLocation:requestLocation generation:requestGeneration];
+    }
+}
+
+- (void) cancel {
+    @synchronized (self) {
+        _prefetcher.reset();
+        [_queuedLocations removeAllObjects];
+
+        // a response carrying the previous generation is discarded when it arrives
+        _isRequestInFlight = NO;
+        _generation++;
+    }
+}
+
+#pragma mark - private methods
+- (std::shared_ptr<const placesmonitor::TrajectoryPredictor>) defaultPredictor {
+    return std::make_shared<placesmonitor::DeadReckoningPredictor>(ACPPlacesMonitorPrefetchHistoryWindow);
+}
+
+/**
+ * @brief Takes the next queued location and marks its request as outstanding, must be called while holding the lock
+ */
+- (CLLocation*) dequeueRequestWithGeneration: (NSUInteger*) requestGeneration {
+    CLLocation* location = _queuedLocations.firstObject;
+
+    if (!location) {
+        _isRequestInFlight = NO;
+        return nil;
+    }
+
+    [_queuedLocations removeObjectAtIndex:0];
+    _isRequestInFlight = YES;
+    _issuedRequestCount++;
+    *requestGeneration = ++_generation;
+    return location;
+}
+
+- (void) issueRequestForLocation: (CLLocation*) location generation: (NSUInteger) requestGeneration {
+    [_metrics incrementCounter:ACPPlacesMetricCounterPoiPrefetches];
+    __weak ACPPlacesPoiPrefetcher* weakSelf = self;
+    _fetchBlock(location, ^(NSArray<ACPPlacesPoi*>* _Nullable pois) {
+        [weakSelf handleResponse:pois forLocation:location generation:requestGeneration];
+    }, ^(ACPPlacesRequestError error) {
+        [weakSelf handleError:error generation:requestGeneration];
+    });
+}
+
+- (void) handleResponse: (NSArray<ACPPlacesPoi*>*) pois
+            forLocation: (CLLocation*) location
+             generation: (NSUInteger) requestGeneration {
+    CLLocation* nextLocation = nil;
+    NSUInteger nextGeneration = 0;
+
+    @synchronized (self) {
+        if (!_isRequestInFlight || requestGeneration != _generation) {
+            return;
+        }
+
+        [_cache cachePois:pois forLocation:location];
+        nextLocation = [self dequeueRequestWithGeneration:&nextGeneration];
+    }
+
+    if (nextLocation) {
+        [self issueRequestForLocation:nextLocation generation:nextGeneration];
+    }
+}
+
+- (void) handleError: (ACPPlacesRequestError) error generation: (NSUInteger) requestGeneration {
+    @synchronized (self) {
+        if (!_isRequestInFlight || requestGeneration != _generation) {
+            return;
+        }
+
+        // prefetching is opportunistic, the rest of the path is fetched normally once the device gets there
+        [_queuedLocations removeAllObjects];
+        _isRequestInFlight = NO;
+    }
+
+    ACPPlacesMonitorLogDebug(@"Prefetching nearby POIs failed (%ld), dropping the queued points", (long)error);
+}
+
+@end
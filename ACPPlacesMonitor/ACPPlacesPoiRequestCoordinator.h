@@ -0,0 +1,96 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiRequestCoordinator.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+#import <ACPPlaces/ACPPlaces.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^ACPPlacesPoiResponseBlock)(NSArray<ACPPlacesPoi*>* _Nullable pois);
+typedef void (^ACPPlacesPoiErrorBlock)(ACPPlacesRequestError error);
+
+/**
+ * @brief Performs a nearby POI request and calls exactly one of the provided blocks when it completes
+ */
+typedef void (^ACPPlacesPoiFetchBlock)(CLLocation* location, ACPPlacesPoiResponseBlock response,
+                                       ACPPlacesPoiErrorBlock error);
+
+/**
+ * @class ACPPlacesPoiRequestCoordinator
+ *
+ * @discussion Keeps at most one nearby POI request in flight.
+ *
+ * Locations requested while a request is outstanding are collapsed into a single follow-up request for the most
+ * recent location, which is issued once the outstanding request succeeds.  Every request is tagged with a
+ * generation number, and a response is only delivered if its generation is still current, so a response that
+ * was cancelled or superseded can never overwrite newer results.
+ */
+@interface ACPPlacesPoiRequestCoordinator : NSObject
+
+/**
+ * @brief Generation of the most recently issued request, or of the last cancellation
+ */
+@property(nonatomic, readonly) NSUInteger generation;
+
+/**
+ * @brief YES while a request is outstanding and its response will be delivered
+ */
+@property(nonatomic, readonly) BOOL isRequestInFlight;
+
+/**
+ * @brief Number of requests passed to the fetch block
+ */
+@property(nonatomic, readonly) NSUInteger issuedRequestCount;
+
+/**
+ * @brief Number of requested locations that were folded into another request instead of being fetched
+ */
+@property(nonatomic, readonly) NSUInteger avoidedRequestCount;
+
+/**
+ * @brief Number of responses dropped because their generation was no longer current
+ */
+@property(nonatomic, readonly) NSUInteger staleResponseCount;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+/**
+ * @brief Creates a coordinator
+ *
+ * @param fetchBlock performs the request, may complete synchronously or on any thread
+ * @param responseHandler called with the POIs and the location they were requested for
+ * @param errorHandler called with the error and the location of a current request that failed
+ */
+- (instancetype) initWithFetchBlock: (ACPPlacesPoiFetchBlock) fetchBlock
+                    responseHandler: (void (^)(NSArray<ACPPlacesPoi*>* _Nullable pois, CLLocation* location)) responseHandler
+                       errorHandler: (void (^)(ACPPlacesRequestError error, CLLocation* location)) errorHandler NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Requests the POIs near the location, or queues it as the follow-up if a request is in flight
+ *
+ * @param location the CLLocation of the device
+ */
+- (void) requestPoisNearLocation: (CLLocation*) location;
+
+/**
+ * @brief Drops the queued follow-up and makes the response of the outstanding request stale
+ */
+- (void) cancelOutstandingRequests;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,160 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiRequestCoordinator.m
+//
+
+#import <ACPCore/ACPCore.h>
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesMonitorLog.h"
+#import "ACPPlacesPoiRequestCoordinator.h"
+
+@interface ACPPlacesPoiRequestCoordinator()
+@property(nonatomic, copy) ACPPlacesPoiFetchBlock fetchBlock;
+@property(nonatomic, copy) void (^responseHandler)(NSArray<ACPPlacesPoi*>* _Nullable, CLLocation*);
+@property(nonatomic, copy) void (^errorHandler)(ACPPlacesRequestError, CLLocation*);
+@property(nonatomic, strong) CLLocation* pendingLocation;
+@property(nonatomic, readwrite) NSUInteger generation;
+@property(nonatomic, readwrite) BOOL isRequestInFlight;
+@property(nonatomic, readwrite) NSUInteger issuedRequestCount;
+@property(nonatomic, readwrite) NSUInteger avoidedRequestCount;
+@property(nonatomic, readwrite) NSUInteger staleResponseCount;
+@end
+
+@implementation ACPPlacesPoiRequestCoordinator
+
+- (instancetype) initWithFetchBlock: (ACPPlacesPoiFetchBlock) fetchBlock
+                    responseHandler: (void (^)(NSArray<ACPPlacesPoi*>* _Nullable, CLLocation*)) responseHandler
+                       errorHandler: (void (^)(ACPPlacesRequestError, CLLocation*)) errorHandler {
+    if (self = [super init]) {
+        self.fetchBlock = fetchBlock;
+        self.responseHandler = responseHandler;
+        self.errorHandler = errorHandler;
+    }
+
+    return self;
+}
+
+- (void) requestPoisNearLocation: (CLLocation*) location {
+    if (!location) {
+        return;
+    }
+
+    NSUInteger requestGeneration;
+
+    @synchronized (self) {
+        if (_isRequestInFlight) {
+            // only the newest location is worth a follow-up, an older one waiting here is never fetched
+            if (_pendingLocation) {
+                _avoidedRequestCount++;
+            }
+
+            _pendingLocation = location;
+            return;
+        }
+
+        requestGeneration = [self beginRequest];
+    }
+
+    [self issueRequestForLocation:location generation:requestGeneration];
+}
+
+- (void) cancelOutstandingRequests {
+    @synchronized (self) {
+        if (_pendingLocation) {
+            _avoidedRequestCount++;
+            _pendingLocation = nil;
+        }
+
+        // a response carrying the previous generation is discarded when it arrives
+        _isRequestInFlight = NO;
+        _generation++;
+    }
+}
+
+#pragma mark - private methods
+/**
+ * @brief Marks a request as outstanding and returns its generation, must be called while holding the lock
+ */
+- (NSUInteger) beginRequest {
+    _isRequestInFlight = YES;
+    _issuedRequestCount++;
+    return ++_generation;
+}
+
+- (void) issueRequestForLocation: (CLLocation*) location generation: (NSUInteger) requestGeneration {
+    __weak ACPPlacesPoiRequestCoordinator* weakSelf = self;
+    _fetchBlock(location, ^(NSArray<ACPPlacesPoi*>* _Nullable pois) {
+        [weakSelf handleResponse:pois forLocation:location generation:requestGeneration];
+    }, ^(ACPPlacesRequestError error) {
+        [weakSelf handleError:error forLocation:location generation:requestGeneration];
+    });
+}
+
+- (BOOL) completeRequestWithGeneration: (NSUInteger) requestGeneration {
+    if (!_isRequestInFlight || requestGeneration != _generation) {
+        _staleResponseCount++;
+        ACPPlacesMonitorLogDebug(@"Discarding a stale nearby POI response (generation %lu, current %lu)",
+                                 (unsigned long)requestGeneration, (unsigned long)_generation);
+        return NO;
+    }
+
+    _isRequestInFlight = NO;
+    return YES;
+}
+
+- (void) handleResponse: (NSArray<ACPPlacesPoi*>*) pois
+            forLocation: (CLLocation*) location
+             generation: (NSUInteger) requestGeneration {
+    CLLocation* followUpLocation = nil;
+    NSUInteger followUpGeneration = 0;
+
+    @synchronized (self) {
+        if (![self completeRequestWithGeneration:requestGeneration]) {
+            return;
+        }
+
+        if (_pendingLocation) {
+            followUpLocation = _pendingLocation;
+            _pendingLocation = nil;
+            followUpGeneration = [self beginRequest];
+        }
+    }
+
+    // deliver even when a follow-up is queued, otherwise a fast moving device would never see a result
+    _responseHandler(pois, location);
+
+    if (followUpLocation) {
+        [self issueRequestForLocation:followUpLocation generation:followUpGeneration];
+    }
+}
+
+- (void) handleError: (ACPPlacesRequestError) error
+         forLocation: (CLLocation*) location
+          generation: (NSUInteger) requestGeneration {
+    @synchronized (self) {
+        if (![self completeRequestWithGeneration:requestGeneration]) {
+            return;
+        }
+
+        // the follow-up would most likely fail the same way, the error handler decides when to try again
+        if (_pendingLocation) {
+            _avoidedRequestCount++;
+            _pendingLocation = nil;
+        }
+    }
+
+    _errorHandler(error, location);
+}
+
+@end
@@ -18,10 +18,43 @@
 
 @class ACPExtensionEvent;
 
+/**
+ * @class ACPPlacesQueue
+ *
+ * @discussion A fixed-capacity queue of monitor commands which coalesces redundant events as they are added.
+ *
+ * - an UpdateLocationNow event is dropped if one is already pending
+ * - a Start event is dropped if one is already pending
+ * - UpdateMonitorConfiguration and SetRequestAuthorizationLevel events replace a pending event of the same name,
+ *   keeping its position in the queue, so only the last value is applied
+ * - a Stop event cancels any pending Start event
+ *
+ * Events are only coalesced with events queued after the last pending Stop, so they are never moved across it.
+ *
+ * When the queue is full the oldest coalescible event is dropped to make room for the new one, then the oldest other
+ * event.  A Stop event is never dropped.
+ */
 @interface ACPPlacesQueue : NSObject
 
 /**
- * @brief Adds an event to the end queue
+ * @brief Number of events which were dropped, replaced or cancelled by coalescing
+ */
+@property(nonatomic, readonly) NSUInteger coalescedEventCount;
+
+/**
+ * @brief Creates a queue with the default capacity
+ */
+- (nonnull instancetype) init;
+
+/**
+ * @brief Creates a queue which holds at most capacity events
+ *
+ * @param capacity the maximum number of pending events, must be greater than zero
+ */
+- (nonnull instancetype) initWithCapacity: (NSUInteger) capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Adds an event to the end of the queue, coalescing it with any pending events
  *
  * @param event the ACPExtensionEvent to be added to the queue
  */
@@ -48,4 +81,9 @@
  */
 - (bool) hasNext;
 
+/**
+ * @brief Number of events currently in the queue
+ */
+- (NSUInteger) count;
+
 @end
@@ -0,0 +1,106 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesQueue.mm
+//
+
+#import <ACPCore/ACPCore.h>
+#import <ACPCore/ACPExtensionEvent.h>
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesMonitorLog.h"
+#import "ACPPlacesQueue.h"
+
+#include "placesmonitor/EventQueue.hpp"
+
+@interface ACPPlacesQueue() {
+    // the coalescing rules live in the portable core, the queue holds strong references to the events
+    placesmonitor::EventQueue<ACPExtensionEvent*> _queue;
+}
+@property(nonatomic, readonly) NSUInteger capacity;
+@end
+
+@implementation ACPPlacesQueue
+
+- (instancetype) init {
+    return [self initWithCapacity:ACPPlacesMonitorEventQueueCapacity];
+}
+
+- (instancetype) initWithCapacity: (NSUInteger) capacity {
+    if (self = [super init]) {
+        _queue = placesmonitor::EventQueue<ACPExtensionEvent*>(capacity);
+    }
+
+    return self;
+}
+
+- (void) add: (ACPExtensionEvent*) event {
+    if (!event) {
+        return;
+    }
+
+    auto result = _queue.add([ACPPlacesQueue kindOfEvent:event], event);
+
+    if (result.dropped) {
+        ACPPlacesMonitorLogWarning(@"Event queue is full, dropping an event (%@)", (*result.dropped).eventName);
+    }
+}
+
+- (ACPExtensionEvent*) poll {
+    auto event = _queue.poll();
+    return event ? *event : nil;
+}
+
+- (ACPExtensionEvent*) peek {
+    const auto* event = _queue.peek();
+    return event ? *event : nil;
+}
+
+- (bool) hasNext {
+    return _queue.hasNext();
+}
+
+- (NSUInteger) count {
+    return _queue.count();
+}
+
+- (NSUInteger) capacity {
+    return _queue.capacity();
+}
+
+- (NSUInteger) coalescedEventCount {
+    return _queue.coalescedCount();
+}
+
+#pragma mark - private methods
+/**
+ * @brief Maps the event to the kind used by the coalescing rules
+ */
++ (placesmonitor::EventKind) kindOfEvent: (ACPExtensionEvent*) event {
+    NSString* name = event.eventName;
+
+    if ([name isEqualToString:ACPPlacesMonitorEventNameStart]) {
+        return placesmonitor::EventKind::Start;
+    } else if ([name isEqualToString:ACPPlacesMonitorEventNameStop]) {
+        return placesmonitor::EventKind::Stop;
+    } else if ([name isEqualToString:ACPPlacesMonitorEventNameUpdateLocationNow]) {
+        return placesmonitor::EventKind::UpdateLocationNow;
+    } else if ([name isEqualToString:ACPPlacesMonitorEventNameUpdateMonitorConfiguration]) {
+        return placesmonitor::EventKind::UpdateMonitorConfiguration;
+    } else if ([name isEqualToString:ACPPlacesMonitorEventNameSetRequestAuthorizationLevel]) {
+        return placesmonitor::EventKind::SetRequestAuthorizationLevel;
+    }
+
+    return placesmonitor::EventKind::Other;
+}
+
+@end
@@ -0,0 +1,68 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionClusters.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesPoi;
+
+/**
+ * @class ACPPlacesRegionClusters
+ *
+ * @discussion Groups small POIs that overlap or nearly touch, like the shops of a food court, so that each group
+ * takes a single region monitoring slot.
+ *
+ * Each cluster is represented by a POI whose circle is the smallest one around its members.  The cluster POIs are
+ * never reported to the Places extension, the members the device is in are resolved from a location fix once the
+ * cluster region is entered.
+ */
+@interface ACPPlacesRegionClusters : NSObject
+
+/**
+ * @brief One POI per region, the POIs which were not clustered and a POI for each cluster, in the order of the
+ * provided POIs
+ */
+@property(nonatomic, readonly) NSArray<ACPPlacesPoi*>* regionPois;
+
+/**
+ * @brief Number of region slots saved compared to one region per POI
+ */
+@property(nonatomic, readonly) NSUInteger savedSlots;
+
+/**
+ * @brief Clusters the POIs
+ *
+ * @param pois the POIs to group
+ * @param maximumRadius the largest radius of a cluster region, no cluster is made if not positive
+ * @return a new ACPPlacesRegionClusters
+ */
++ (instancetype) clustersWithPois: (NSArray<ACPPlacesPoi*>*) pois maximumRadius: (CLLocationDistance) maximumRadius;
+
+/**
+ * @brief Indicates whether the region is a cluster region
+ */
++ (BOOL) isClusterRegion: (CLRegion*) region;
+
+/**
+ * @brief Returns the members of the cluster with the identifier, or nil if it is not one of these clusters
+ */
+- (nullable NSArray<ACPPlacesPoi*>*) membersOfClusterWithIdentifier: (NSString*) identifier;
+
+@end
+
+NS_ASSUME_NONNULL_END
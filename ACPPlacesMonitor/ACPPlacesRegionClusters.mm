@@ -0,0 +1,83 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionClusters.mm
+//
+
+#import <ACPPlaces/ACPPlaces.h>
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesRegionClusters.h"
+
+#include "placesmonitor/RegionClusters.hpp"
+
+@interface ACPPlacesRegionClusters()
+@property(nonatomic, readwrite) NSArray<ACPPlacesPoi*>* regionPois;
+@property(nonatomic, readwrite) NSUInteger savedSlots;
+@property(nonatomic, strong) NSDictionary<NSString*, NSArray<ACPPlacesPoi*>*>* members;
+@end
+
+@implementation ACPPlacesRegionClusters
+
++ (instancetype) clustersWithPois: (NSArray<ACPPlacesPoi*>*) pois maximumRadius: (CLLocationDistance) maximumRadius {
+    // the grouping is done by the portable core, which answers with indexes into the POIs
+    const placesmonitor::RegionClusters coreClusters =
+        placesmonitor::RegionClusters::build(ACPPlacesCorePois(pois), maximumRadius);
+
+    // each region takes the place of the first POI it covers
+    NSMutableArray<ACPPlacesPoi*>* regionPois = [NSMutableArray arrayWithArray:pois];
+    NSMutableIndexSet* clusteredIndexes = [[NSMutableIndexSet alloc] init];
+    NSMutableDictionary<NSString*, NSArray<ACPPlacesPoi*>*>* members = [[NSMutableDictionary alloc] init];
+
+    for (const placesmonitor::RegionClusters::Cluster& cluster : coreClusters.clusters()) {
+        ACPPlacesPoi* clusterPoi = [[ACPPlacesPoi alloc] init];
+        clusterPoi.identifier = ACPPlacesNSString(cluster.region.identifier);
+        clusterPoi.latitude = cluster.region.center.latitude;
+        clusterPoi.longitude = cluster.region.center.longitude;
+        clusterPoi.radius = (NSUInteger) ceil(cluster.region.radius);
+
+        NSMutableArray<ACPPlacesPoi*>* clusterMembers = [[NSMutableArray alloc] initWithCapacity:cluster.members.size()];
+
+        for (std::size_t index : cluster.members) {
+            [clusterMembers addObject:pois[index]];
+            [clusteredIndexes addIndex:index];
+        }
+
+        regionPois[cluster.members.front()] = clusterPoi;
+        [clusteredIndexes removeIndex:cluster.members.front()];
+        members[clusterPoi.identifier] = clusterMembers;
+    }
+
+    [regionPois removeObjectsAtIndexes:clusteredIndexes];
+
+    ACPPlacesRegionClusters* clusters = [[ACPPlacesRegionClusters alloc] init];
+    clusters.regionPois = regionPois;
+    clusters.savedSlots = coreClusters.savedSlots();
+    clusters.members = members;
+
+    return clusters;
+}
+
++ (BOOL) isClusterRegion: (CLRegion*) region {
+    return region.identifier && placesmonitor::RegionClusters::isClusterRegion(ACPPlacesCoreString(region.identifier));
+}
+
+- (NSArray<ACPPlacesPoi*>*) membersOfClusterWithIdentifier: (NSString*) identifier {
+    return identifier ? _members[identifier] : nil;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat:@"clusters: %lu, regions: %lu, saved slots: %lu", (unsigned long)_members.count,
+            (unsigned long)_regionPois.count, (unsigned long)_savedSlots];
+}
+
+@end
@@ -0,0 +1,146 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionEventDebouncer.h
+//
+
+#import <ACPPlaces/ACPPlaces.h>
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesMetrics;
+
+/**
+ * @class ACPPlacesRegionEvent
+ *
+ * @discussion An entry into or an exit from a region, as handed to the flush handler of an
+ * ACPPlacesRegionEventDebouncer.
+ */
+@interface ACPPlacesRegionEvent : NSObject
+
+@property(nonatomic, readonly) CLRegion* region;
+@property(nonatomic, readonly) ACPRegionEventType type;
+
+- (instancetype) initWithRegion: (CLRegion*) region type: (ACPRegionEventType) type;
+
+@end
+
+/**
+ * @class ACPPlacesRegionEventDebouncer
+ *
+ * @discussion Holds region events for a dwell time before handing them to the Places extension, so a device sitting
+ * on a fence edge with a noisy fix does not report every enter/exit/enter along the way.
+ *
+ * An event is pending until it has held for dwellTime seconds.  An event for a region with an opposite event pending
+ * cancels both of them, and an event repeating the pending event for the same region is dropped; neither is ever
+ * reported.  When the earliest pending event settles, every settled event is handed to the flush handler as a single
+ * batch, in the order the events were added.  With a dwell time of 0 events are handed over as soon as they are
+ * added.
+ *
+ * Pending events only live in memory.  While there are any, the debouncer holds a background task so the app is
+ * not suspended before they settle, and if the OS expires the task first every pending event is drained.
+ *
+ * The clock, timer and background task calls can be replaced for testing.
+ */
+@interface ACPPlacesRegionEventDebouncer : NSObject
+
+/**
+ * @brief Number of seconds an event must hold before it is reported
+ */
+@property(nonatomic) NSTimeInterval dwellTime;
+
+/**
+ * @brief Number of events which were cancelled by an opposite event or dropped as repeats
+ */
+@property(nonatomic, readonly) NSUInteger suppressedEventCount;
+
+/**
+ * @brief Number of batches handed to the flush handler
+ */
+@property(nonatomic, readonly) NSUInteger flushCount;
+
+/**
+ * @brief Number of events waiting for their dwell time to elapse
+ */
+@property(nonatomic, readonly) NSUInteger pendingCount;
+
+/**
+ * @brief Receives the suppressed event and batch counts, if set
+ */
+@property(nonatomic, strong, nullable) ACPPlacesMetrics* metrics;
+
+/**
+ * @brief Called with each batch of settled events, outside of the debouncer's lock
+ */
+@property(nonatomic, copy, nullable) void (^flushHandler)(NSArray<ACPPlacesRegionEvent*>* events);
+
+/**
+ * @brief Returns the current time in seconds, defaults to the system uptime
+ */
+@property(nonatomic, copy) NSTimeInterval (^clock)(void);
+
+/**
+ * @brief Runs the block after the delay, defaults to dispatch_after on a utility queue
+ */
+@property(nonatomic, copy) void (^dispatcher)(NSTimeInterval delay, dispatch_block_t block);
+
+/**
+ * @brief Begins a background task with the expiration handler, defaults to UIApplication's
+ * beginBackgroundTaskWithName:expirationHandler:
+ */
+@property(nonatomic, copy) UIBackgroundTaskIdentifier (^backgroundTaskStarter)(dispatch_block_t expirationHandler);
+
+/**
+ * @brief Ends a background task begun by backgroundTaskStarter, defaults to UIApplication's endBackgroundTask:
+ */
+@property(nonatomic, copy) void (^backgroundTaskEnder)(UIBackgroundTaskIdentifier task);
+
+/**
+ * @brief Creates a debouncer using the dwell time defined in ACPPlacesMonitorConstants
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates a debouncer which holds events for dwellTime seconds
+ */
+- (instancetype) initWithDwellTime: (NSTimeInterval) dwellTime NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Adds an event, cancelling it against a pending opposite event for the same region
+ *
+ * @param region the CLRegion which was entered or exited
+ * @param type an ACPRegionEventType representing whether the event was an entry or an exit
+ */
+- (void) addRegion: (CLRegion*) region eventType: (ACPRegionEventType) type;
+
+/**
+ * @brief Hands every settled event to the flush handler
+ */
+- (void) flush;
+
+/**
+ * @brief Hands every pending event to the flush handler, whether or not it has settled
+ */
+- (void) drain;
+
+/**
+ * @brief Drops every pending event without reporting it
+ */
+- (void) cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
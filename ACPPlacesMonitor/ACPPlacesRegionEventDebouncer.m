@@ -0,0 +1,268 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionEventDebouncer.m
+//
+
+#import <ACPCore/ACPCore.h>
+#import "ACPPlacesMetrics.h"
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesMonitorLog.h"
+#import "ACPPlacesRegionEventDebouncer.h"
+
+@implementation ACPPlacesRegionEvent
+
+- (instancetype) initWithRegion: (CLRegion*) region type: (ACPRegionEventType) type {
+    if (self = [super init]) {
+        _region = region;
+        _type = type;
+    }
+
+    return self;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat:@"%@ %@", _type == ACPRegionEventTypeEntry ? @"entry into" : @"exit from",
+            _region.identifier];
+}
+
+@end
+
+/**
+ * @brief An event waiting for its dwell time to elapse
+ */
+@interface ACPPlacesPendingRegionEvent : NSObject
+@property(nonatomic, strong) ACPPlacesRegionEvent* event;
+@property(nonatomic) NSTimeInterval addedAt;
+@end
+
+@implementation ACPPlacesPendingRegionEvent
+@end
+
+@interface ACPPlacesRegionEventDebouncer()
+@property(nonatomic, strong) NSMutableArray<ACPPlacesPendingRegionEvent*>* pendingEvents;
+@property(nonatomic, readwrite) NSUInteger suppressedEventCount;
+@property(nonatomic, readwrite) NSUInteger flushCount;
+@property(nonatomic) NSUInteger timerGeneration;
+@property(nonatomic) BOOL timerArmed;
+@property(nonatomic) UIBackgroundTaskIdentifier backgroundTask;
+@end
+
+@implementation ACPPlacesRegionEventDebouncer
+
+- (instancetype) init {
+    return [self initWithDwellTime:ACPPlacesMonitorRegionEventDwellTime];
+}
+
+- (instancetype) initWithDwellTime: (NSTimeInterval) dwellTime {
+    if (self = [super init]) {
+        _dwellTime = MAX(dwellTime, 0);
+        self.pendingEvents = [[NSMutableArray alloc] init];
+        _backgroundTask = UIBackgroundTaskInvalid;
+
+        self.clock = ^NSTimeInterval {
+            return [[NSProcessInfo processInfo] systemUptime];
+        };
+        self.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                           dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), block);
+        };
+        self.backgroundTaskStarter = ^UIBackgroundTaskIdentifier (dispatch_block_t expirationHandler) {
+            return [[UIApplication sharedApplication] beginBackgroundTaskWithName:@"ACPPlacesRegionEventDebouncer"
+                                                                expirationHandler:expirationHandler];
+        };
+        self.backgroundTaskEnder = ^(UIBackgroundTaskIdentifier task) {
+            [[UIApplication sharedApplication] endBackgroundTask:task];
+        };
+    }
+
+    return self;
+}
+
+- (void) setDwellTime: (NSTimeInterval) dwellTime {
+    @synchronized (self) {
+        _dwellTime = MAX(dwellTime, 0);
+
+        // a shorter dwell time may need an earlier timer than the one armed
+        _timerArmed = NO;
+        _timerGeneration++;
+    }
+
+    [self flush];
+}
+
+- (NSUInteger) pendingCount {
+    @synchronized (self) {
+        return _pendingEvents.count;
+    }
+}
+
+- (void) addRegion: (CLRegion*) region eventType: (ACPRegionEventType) type {
+    if (!region.identifier) {
+        return;
+    }
+
+    @synchronized (self) {
+        NSUInteger index = [_pendingEvents indexOfObjectPassingTest:^BOOL(ACPPlacesPendingRegionEvent* pending,
+                                                                         NSUInteger idx, BOOL* stop) {
+            return [pending.event.region.identifier isEqualToString:region.identifier];
+        }];
+
+        if (index != NSNotFound) {
+            ACPPlacesPendingRegionEvent* pending = _pendingEvents[index];
+
+            if (pending.event.type == type) {
+                // the transition is already waiting, its dwell time keeps running from the first event
+                [self recordSuppressedEvents:1];
+                return;
+            }
+
+            // the device went back before the transition settled, neither event is reported
+            ACPPlacesMonitorLogDebug(@"Cancelling the pending %@ against an opposite event", pending.event);
+            [_pendingEvents removeObjectAtIndex:index];
+            [self recordSuppressedEvents:2];
+            return;
+        }
+
+        ACPPlacesPendingRegionEvent* pending = [[ACPPlacesPendingRegionEvent alloc] init];
+        pending.event = [[ACPPlacesRegionEvent alloc] initWithRegion:region type:type];
+        pending.addedAt = _clock();
+        [_pendingEvents addObject:pending];
+    }
+
+    [self flush];
+}
+
+- (void) flush {
+    [self flushSettledEventsOnly:YES];
+}
+
+- (void) drain {
+    [self flushSettledEventsOnly:NO];
+}
+
+- (void) cancel {
+    @synchronized (self) {
+        [_pendingEvents removeAllObjects];
+        _timerArmed = NO;
+        _timerGeneration++;
+        [self updateBackgroundTask];
+    }
+}
+
+#pragma mark - private methods
+- (void) flushSettledEventsOnly: (BOOL) settledOnly {
+    NSMutableArray<ACPPlacesRegionEvent*>* batch = [[NSMutableArray alloc] init];
+
+    @synchronized (self) {
+        NSTimeInterval now = _clock();
+        NSMutableIndexSet* settledIndexes = [[NSMutableIndexSet alloc] init];
+        NSTimeInterval nextSettlesAt = DBL_MAX;
+
+        for (NSUInteger i = 0; i < _pendingEvents.count; i++) {
+            ACPPlacesPendingRegionEvent* pending = _pendingEvents[i];
+
+            // settling is measured against the current dwell time, which may have changed since the event was added
+            NSTimeInterval settlesAt = pending.addedAt + _dwellTime;
+
+            if (!settledOnly || settlesAt <= now) {
+                [batch addObject:pending.event];
+                [settledIndexes addIndex:i];
+            } else {
+                nextSettlesAt = MIN(nextSettlesAt, settlesAt);
+            }
+        }
+
+        [_pendingEvents removeObjectsAtIndexes:settledIndexes];
+
+        if (batch.count) {
+            _flushCount++;
+            [_metrics incrementCounter:ACPPlacesMetricCounterRegionEventBatches];
+        }
+
+        // a single timer covers the earliest pending event, later events are picked up when it fires
+        if (_pendingEvents.count && !_timerArmed) {
+            [self armTimerWithDelay:nextSettlesAt - now];
+        }
+    }
+
+    if (batch.count && _flushHandler) {
+        _flushHandler(batch);
+    }
+
+    // the task is only ended once the batch has been handed over
+    @synchronized (self) {
+        [self updateBackgroundTask];
+    }
+}
+
+- (void) armTimerWithDelay: (NSTimeInterval) delay {
+    _timerArmed = YES;
+    NSUInteger generation = ++_timerGeneration;
+    __weak ACPPlacesRegionEventDebouncer* weakSelf = self;
+    _dispatcher(MAX(delay, 0), ^{
+        [weakSelf timerFiredForGeneration:generation];
+    });
+}
+
+- (void) timerFiredForGeneration: (NSUInteger) generation {
+    @synchronized (self) {
+        if (generation != _timerGeneration || !_timerArmed) {
+            return;
+        }
+
+        _timerArmed = NO;
+    }
+
+    [self flush];
+}
+
+/**
+ * @brief Holds a background task while events are pending and ends it once there are none, must be called while
+ * holding the lock
+ */
+- (void) updateBackgroundTask {
+    if (_pendingEvents.count && _backgroundTask == UIBackgroundTaskInvalid) {
+        __weak ACPPlacesRegionEventDebouncer* weakSelf = self;
+        _backgroundTask = _backgroundTaskStarter(^{
+            [weakSelf backgroundTaskExpired];
+        });
+    } else if (!_pendingEvents.count && _backgroundTask != UIBackgroundTaskInvalid) {
+        _backgroundTaskEnder(_backgroundTask);
+        _backgroundTask = UIBackgroundTaskInvalid;
+    }
+}
+
+- (void) backgroundTaskExpired {
+    ACPPlacesMonitorLogDebug(@"Background time is running out, reporting %lu pending region events early",
+                             (unsigned long) self.pendingCount);
+    [self drain];
+
+    // a flush handler which added events back must not keep the expired task alive
+    @synchronized (self) {
+        if (_backgroundTask != UIBackgroundTaskInvalid) {
+            _backgroundTaskEnder(_backgroundTask);
+            _backgroundTask = UIBackgroundTaskInvalid;
+        }
+    }
+}
+
+/**
+ * @brief Must be called while holding the lock
+ */
+- (void) recordSuppressedEvents: (NSUInteger) count {
+    _suppressedEventCount += count;
+    [_metrics addValue:count toCounter:ACPPlacesMetricCounterSuppressedRegionEvents];
+}
+
+@end
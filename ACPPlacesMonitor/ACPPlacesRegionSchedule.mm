@@ -0,0 +1,65 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionSchedule.mm
+//
+
+#import <ACPPlaces/ACPPlaces.h>
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesRegionSchedule.h"
+
+#include "placesmonitor/RegionSchedule.hpp"
+
+@interface ACPPlacesRegionSchedule()
+@property(nonatomic, readwrite) NSArray<ACPPlacesPoi*>* selectedPois;
+@property(nonatomic, readwrite, nullable) CLCircularRegion* boundaryRegion;
+@property(nonatomic, readwrite) NSUInteger deferredCount;
+@end
+
+@implementation ACPPlacesRegionSchedule
+
++ (instancetype) scheduleWithCandidates: (NSArray<ACPPlacesPoi*>*) candidates
+                             atLocation: (CLLocation*) location
+                              slotCount: (NSUInteger) slotCount
+                          maximumRadius: (CLLocationDistance) maximumRadius {
+    // the ranking is done by the portable core, which answers with indexes into the candidates
+    const placesmonitor::RegionSchedule coreSchedule =
+        placesmonitor::RegionSchedule::build(ACPPlacesCorePois(candidates),
+                                             ACPPlacesCoreCoordinate(location.coordinate),
+                                             slotCount,
+                                             maximumRadius);
+
+    NSMutableArray<ACPPlacesPoi*>* selected = [[NSMutableArray alloc] initWithCapacity:coreSchedule.selected().size()];
+
+    for (std::size_t index : coreSchedule.selected()) {
+        [selected addObject:candidates[index]];
+    }
+
+    ACPPlacesRegionSchedule* schedule = [[ACPPlacesRegionSchedule alloc] init];
+    schedule.selectedPois = selected;
+    schedule.boundaryRegion = coreSchedule.boundary() ? ACPPlacesCircularRegion(*coreSchedule.boundary()) : nil;
+    schedule.deferredCount = coreSchedule.deferredCount();
+
+    return schedule;
+}
+
++ (BOOL) isBoundaryRegion: (CLRegion*) region {
+    return region.identifier && placesmonitor::RegionSchedule::isBoundaryRegion(ACPPlacesCoreString(region.identifier));
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat:@"selected: %lu, deferred: %lu, boundary radius: %.0f",
+            (unsigned long)_selectedPois.count, (unsigned long)_deferredCount, _boundaryRegion ? _boundaryRegion.radius : 0];
+}
+
+@end
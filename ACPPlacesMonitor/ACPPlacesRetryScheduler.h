@@ -0,0 +1,159 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRetryScheduler.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, ACPPlacesCircuitState) {
+    ACPPlacesCircuitStateClosed = 0,
+    ACPPlacesCircuitStateOpen,
+    ACPPlacesCircuitStateHalfOpen
+};
+
+/**
+ * @class ACPPlacesRetryScheduler
+ *
+ * @discussion Replays the location of a nearby POI request that failed for a transient reason.
+ *
+ * Only the most recent failed or deferred location is kept.  Retries are delayed with capped exponential backoff
+ * and full jitter, so a fleet of devices that failed at the same moment does not retry at the same moment.  After
+ * failureThreshold consecutive failures the circuit opens and no request is made for openDuration seconds; the
+ * first request after that is a single probe that either closes the circuit or opens it again.  A retry that comes
+ * due while the network is unreachable is postponed without using up an attempt, backing off further each time it
+ * finds the network still unreachable, and is made as soon as reachability reports the network is back.
+ *
+ * The clock, timer, random source and reachability check can be replaced for testing.
+ */
+@interface ACPPlacesRetryScheduler : NSObject
+
+@property(nonatomic, readonly) NSTimeInterval baseDelay;
+@property(nonatomic, readonly) NSTimeInterval maximumDelay;
+@property(nonatomic, readonly) NSUInteger maximumAttempts;
+@property(nonatomic, readonly) NSUInteger failureThreshold;
+@property(nonatomic, readonly) NSTimeInterval openDuration;
+
+@property(nonatomic, readonly) ACPPlacesCircuitState circuitState;
+
+/**
+ * @brief Number of retries of the current pending location that have been replayed
+ */
+@property(nonatomic, readonly) NSUInteger attempt;
+
+/**
+ * @brief The location that will be replayed, or nil if nothing is waiting
+ */
+@property(nonatomic, readonly, nullable) CLLocation* pendingLocation;
+
+/**
+ * @brief Number of locations handed back to the replay handler
+ */
+@property(nonatomic, readonly) NSUInteger replayCount;
+
+/**
+ * @brief Number of pending locations dropped after maximumAttempts retries
+ */
+@property(nonatomic, readonly) NSUInteger abandonedCount;
+
+/**
+ * @brief Called with the location to request again, on the thread of the dispatcher
+ */
+@property(nonatomic, copy, nullable) void (^replayHandler)(CLLocation* location);
+
+/**
+ * @brief Returns the current time in seconds, defaults to the system uptime
+ */
+@property(nonatomic, copy) NSTimeInterval (^clock)(void);
+
+/**
+ * @brief Runs the block after the delay, defaults to dispatch_after on a utility queue
+ */
+@property(nonatomic, copy) void (^dispatcher)(NSTimeInterval delay, dispatch_block_t block);
+
+/**
+ * @brief Returns a uniformly distributed value in [0, 1), defaults to arc4random
+ */
+@property(nonatomic, copy) double (^randomSource)(void);
+
+/**
+ * @brief Returns NO if requests currently cannot reach the network, defaults to SCNetworkReachability
+ */
+@property(nonatomic, copy) BOOL (^networkReachable)(void);
+
+/**
+ * @brief Creates a scheduler using the default values defined in ACPPlacesMonitorConstants
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates a scheduler with the provided backoff and circuit breaker settings
+ *
+ * @param baseDelay the backoff before the first retry, in seconds
+ * @param maximumDelay the cap for the backoff, in seconds
+ * @param maximumAttempts the number of retries for a location before it is abandoned
+ * @param failureThreshold the number of consecutive failures that opens the circuit
+ * @param openDuration how long the circuit stays open, in seconds
+ */
+- (instancetype) initWithBaseDelay: (NSTimeInterval) baseDelay
+                      maximumDelay: (NSTimeInterval) maximumDelay
+                   maximumAttempts: (NSUInteger) maximumAttempts
+                  failureThreshold: (NSUInteger) failureThreshold
+                      openDuration: (NSTimeInterval) openDuration NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Decides whether a request for the location must wait for a scheduled retry
+ *
+ * @discussion Returns YES while a retry is scheduled or the circuit is open.  The location then replaces the
+ * pending location and will be handed to the replay handler instead.
+ *
+ * @param location the CLLocation that needs nearby POIs
+ * @return YES if the caller must not make the request now
+ */
+- (BOOL) shouldDeferLocation: (CLLocation*) location;
+
+/**
+ * @brief Records a transient failure of the request for the location and schedules a retry
+ *
+ * @param location the CLLocation used for the failed request
+ */
+- (void) recordFailureForLocation: (CLLocation*) location;
+
+/**
+ * @brief Records a successful request, closing the circuit and resetting the backoff
+ */
+- (void) recordSuccess;
+
+/**
+ * @brief Cancels any scheduled retry and drops the pending location
+ */
+- (void) cancel;
+
+/**
+ * @brief Makes a retry postponed for an unreachable network right away if the network is now reachable
+ *
+ * @discussion Called by the SCNetworkReachability callback whenever the reachability flags change.
+ */
+- (void) networkReachabilityDidChange;
+
+/**
+ * @brief Returns the backoff for the attempt before jitter is applied
+ */
+- (NSTimeInterval) backoffForAttempt: (NSUInteger) attempt;
+
+@end
+
+NS_ASSUME_NONNULL_END
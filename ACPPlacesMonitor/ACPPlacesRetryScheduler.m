@@ -0,0 +1,289 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRetryScheduler.m
+//
+
+#import <netinet/in.h>
+#import <SystemConfiguration/SystemConfiguration.h>
+#import <ACPCore/ACPCore.h>
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesMonitorLog.h"
+#import "ACPPlacesRetryScheduler.h"
+
+@interface ACPPlacesRetryScheduler()
+@property(nonatomic, readwrite) ACPPlacesCircuitState circuitState;
+@property(nonatomic, readwrite) NSUInteger attempt;
+@property(nonatomic, readwrite, nullable) CLLocation* pendingLocation;
+@property(nonatomic, readwrite) NSUInteger replayCount;
+@property(nonatomic, readwrite) NSUInteger abandonedCount;
+@property(nonatomic) NSUInteger consecutiveFailures;
+@property(nonatomic) NSTimeInterval openUntil;
+@property(nonatomic) NSUInteger timerGeneration;
+@property(nonatomic) BOOL timerArmed;
+@property(nonatomic) NSUInteger offlinePostponements;
+@end
+
+static void ACPPlacesRetrySchedulerReachabilityChanged(SCNetworkReachabilityRef target,
+                                                       SCNetworkReachabilityFlags flags,
+                                                       void* info) {
+    void (^handler)(void) = (__bridge void (^)(void)) info;
+    handler();
+}
+
+@implementation ACPPlacesRetryScheduler {
+    SCNetworkReachabilityRef _reachability;
+}
+
+- (instancetype) init {
+    return [self initWithBaseDelay:ACPPlacesMonitorRetryBaseDelay
+                      maximumDelay:ACPPlacesMonitorRetryMaximumDelay
+                   maximumAttempts:ACPPlacesMonitorRetryMaximumAttempts
+                  failureThreshold:ACPPlacesMonitorCircuitBreakerFailureThreshold
+                      openDuration:ACPPlacesMonitorCircuitBreakerOpenDuration];
+}
+
+- (instancetype) initWithBaseDelay: (NSTimeInterval) baseDelay
+                      maximumDelay: (NSTimeInterval) maximumDelay
+                   maximumAttempts: (NSUInteger) maximumAttempts
+                  failureThreshold: (NSUInteger) failureThreshold
+                      openDuration: (NSTimeInterval) openDuration {
+    if (self = [super init]) {
+        _baseDelay = baseDelay;
+        _maximumDelay = MAX(maximumDelay, baseDelay);
+        _maximumAttempts = maximumAttempts;
+        _failureThreshold = MAX(failureThreshold, 1);
+        _openDuration = openDuration;
+
+        self.clock = ^NSTimeInterval {
+            return [[NSProcessInfo processInfo] systemUptime];
+        };
+        self.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                           dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), block);
+        };
+        self.randomSource = ^double {
+            return (double)arc4random() / ((double)UINT32_MAX + 1.0);
+        };
+
+        // reachability of the zero address reports whether any route to the internet is up
+        struct sockaddr_in zeroAddress;
+        memset(&zeroAddress, 0, sizeof(zeroAddress));
+        zeroAddress.sin_len = sizeof(zeroAddress);
+        zeroAddress.sin_family = AF_INET;
+        _reachability = SCNetworkReachabilityCreateWithAddress(kCFAllocatorDefault, (const struct sockaddr*)&zeroAddress);
+
+        __weak ACPPlacesRetryScheduler* weakSelf = self;
+        self.networkReachable = ^BOOL {
+            return [weakSelf systemReportsNetworkReachable];
+        };
+
+        // the context retains the handler, which only holds the scheduler weakly
+        if (_reachability) {
+            void (^handler)(void) = ^{
+                [weakSelf networkReachabilityDidChange];
+            };
+            SCNetworkReachabilityContext context = {0, (__bridge void*) handler, CFRetain, CFRelease, NULL};
+
+            if (SCNetworkReachabilitySetCallback(_reachability, ACPPlacesRetrySchedulerReachabilityChanged, &context)) {
+                SCNetworkReachabilitySetDispatchQueue(_reachability, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+            }
+        }
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    if (_reachability) {
+        SCNetworkReachabilitySetDispatchQueue(_reachability, NULL);
+        SCNetworkReachabilitySetCallback(_reachability, NULL, NULL);
+        CFRelease(_reachability);
+    }
+}
+
+- (BOOL) shouldDeferLocation: (CLLocation*) location {
+    @synchronized (self) {
+        if (_circuitState == ACPPlacesCircuitStateOpen && _clock() >= _openUntil && !_timerArmed) {
+            // let a single probe through, its outcome decides whether the circuit closes
+            _circuitState = ACPPlacesCircuitStateHalfOpen;
+        }
+
+        if (!_timerArmed && _circuitState != ACPPlacesCircuitStateOpen) {
+            return NO;
+        }
+
+        _pendingLocation = location;
+
+        if (!_timerArmed) {
+            [self armTimerWithDelay:_openUntil - _clock()];
+        }
+
+        return YES;
+    }
+}
+
+- (void) recordFailureForLocation: (CLLocation*) location {
+    @synchronized (self) {
+        _consecutiveFailures++;
+
+        if (_circuitState == ACPPlacesCircuitStateHalfOpen ||
+            (_circuitState == ACPPlacesCircuitStateClosed && _consecutiveFailures >= _failureThreshold)) {
+            _circuitState = ACPPlacesCircuitStateOpen;
+            _openUntil = _clock() + _openDuration;
+            ACPPlacesMonitorLogWarning(@"Nearby POI requests failed %lu times in a row, pausing requests for %.0f seconds",
+                                       (unsigned long)_consecutiveFailures, _openDuration);
+        }
+
+        // keep whichever location is newer, an older fix is never worth replaying
+        if (!_pendingLocation || [location.timestamp compare:_pendingLocation.timestamp] != NSOrderedAscending) {
+            _pendingLocation = location;
+        }
+
+        if (_attempt >= _maximumAttempts) {
+            ACPPlacesMonitorLogDebug(@"Giving up on the nearby POI request after %lu retries",
+                                     (unsigned long)_attempt);
+            _abandonedCount++;
+            [self resetRetry];
+            return;
+        }
+
+        if (!_timerArmed) {
+            [self armTimerWithDelay:[self delayForNextRetry]];
+        }
+    }
+}
+
+- (void) recordSuccess {
+    @synchronized (self) {
+        _consecutiveFailures = 0;
+        _attempt = 0;
+        _circuitState = ACPPlacesCircuitStateClosed;
+    }
+}
+
+- (void) cancel {
+    @synchronized (self) {
+        [self resetRetry];
+    }
+}
+
+- (NSTimeInterval) backoffForAttempt: (NSUInteger) attempt {
+    // 2^attempt overflows long before it matters, the cap applies well before that
+    return MIN(_maximumDelay, _baseDelay * pow(2.0, MIN(attempt, 32)));
+}
+
+- (void) networkReachabilityDidChange {
+    @synchronized (self) {
+        // only a retry postponed for connectivity is brought forward, a backoff for a failure is left alone
+        if (!_offlinePostponements || !_timerArmed || !_networkReachable()) {
+            return;
+        }
+
+        ACPPlacesMonitorLogDebug(@"The network is reachable again, retrying the nearby POI request");
+        [self armTimerWithDelay:0];
+    }
+}
+
+#pragma mark - private methods
+/**
+ * @brief Returns the jittered backoff for the next retry, never earlier than the end of an open circuit
+ */
+- (NSTimeInterval) delayForNextRetry {
+    // half of the backoff is fixed and half is random, so retries spread out without ever firing immediately
+    NSTimeInterval backoff = [self backoffForAttempt:_attempt + _offlinePostponements];
+    NSTimeInterval delay = backoff / 2.0 + _randomSource() * backoff / 2.0;
+
+    if (_circuitState == ACPPlacesCircuitStateOpen) {
+        delay = MAX(delay, _openUntil - _clock());
+    }
+
+    return delay;
+}
+
+- (void) armTimerWithDelay: (NSTimeInterval) delay {
+    _timerArmed = YES;
+    NSUInteger generation = ++_timerGeneration;
+    __weak ACPPlacesRetryScheduler* weakSelf = self;
+    _dispatcher(MAX(delay, 0), ^{
+        [weakSelf timerFiredForGeneration:generation];
+    });
+}
+
+- (void) timerFiredForGeneration: (NSUInteger) generation {
+    CLLocation* location = nil;
+
+    @synchronized (self) {
+        if (generation != _timerGeneration || !_timerArmed) {
+            return;
+        }
+
+        _timerArmed = NO;
+
+        if (!_pendingLocation) {
+            return;
+        }
+
+        if (!_networkReachable()) {
+            // waiting for connectivity doesn't count as an attempt, but each check backs off further until the
+            // reachability callback reports the network is back
+            ACPPlacesMonitorLogDebug(@"The network is unreachable, postponing the nearby POI retry");
+            _offlinePostponements++;
+            [self armTimerWithDelay:[self delayForNextRetry]];
+            return;
+        }
+
+        if (_circuitState == ACPPlacesCircuitStateOpen) {
+            if (_clock() < _openUntil) {
+                [self armTimerWithDelay:_openUntil - _clock()];
+                return;
+            }
+
+            _circuitState = ACPPlacesCircuitStateHalfOpen;
+        }
+
+        location = _pendingLocation;
+        _pendingLocation = nil;
+        _offlinePostponements = 0;
+        _attempt++;
+        _replayCount++;
+    }
+
+    if (_replayHandler) {
+        _replayHandler(location);
+    }
+}
+
+/**
+ * @brief Drops the pending location and invalidates any armed timer, must be called while holding the lock
+ */
+- (void) resetRetry {
+    _pendingLocation = nil;
+    _attempt = 0;
+    _offlinePostponements = 0;
+    _timerArmed = NO;
+    _timerGeneration++;
+}
+
+- (BOOL) systemReportsNetworkReachable {
+    SCNetworkReachabilityFlags flags = 0;
+
+    // if reachability can't be determined, let the request find out
+    if (!_reachability || !SCNetworkReachabilityGetFlags(_reachability, &flags)) {
+        return YES;
+    }
+
+    return (flags & kSCNetworkReachabilityFlagsReachable) && !(flags & kSCNetworkReachabilityFlagsConnectionRequired);
+}
+
+@end
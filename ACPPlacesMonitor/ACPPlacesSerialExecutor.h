@@ -0,0 +1,79 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesSerialExecutor.h
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @class ACPPlacesSerialExecutor
+ *
+ * @discussion Runs blocks one at a time, in the order they were submitted, on a private serial queue.
+ *
+ * State owned by the executor is only touched from its blocks, so it needs no locks.  A block submitted from a
+ * block that is already running on the executor runs right away instead of being queued, so code on the executor
+ * can call back into methods that submit work without deadlocking or reordering itself.
+ */
+@interface ACPPlacesSerialExecutor : NSObject
+
+/**
+ * @brief The label of the underlying dispatch queue
+ */
+@property(nonatomic, readonly, copy) NSString* label;
+
+/**
+ * @brief Returns YES if called from a block running on the executor
+ */
+@property(nonatomic, readonly) BOOL isCurrent;
+
+/**
+ * @brief Creates an executor labelled with the value defined in ACPPlacesMonitorConstants
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates an executor whose queue has the provided label
+ *
+ * @param label the label shown for the queue in debuggers and crash reports
+ */
+- (instancetype) initWithLabel: (NSString*) label NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Submits the block without waiting for it to run
+ *
+ * @discussion The block runs right away when called from the executor.
+ */
+- (void) execute: (dispatch_block_t) block;
+
+/**
+ * @brief Submits the block and waits for it to finish
+ *
+ * @discussion The block runs right away when called from the executor.  Must not be called from a thread the
+ * executor is waiting for.
+ */
+- (void) executeAndWait: (dispatch_block_t) block;
+
+/**
+ * @brief Submits the block after the delay has passed
+ *
+ * @param block the block to run
+ * @param delay the delay in seconds
+ */
+- (void) execute: (dispatch_block_t) block afterDelay: (NSTimeInterval) delay;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,72 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesSerialExecutor.m
+//
+
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesSerialExecutor.h"
+
+// the address is the key, the value is the executor whose queue the code is running on
+static void* ACPPlacesSerialExecutorQueueKey = &ACPPlacesSerialExecutorQueueKey;
+
+#pragma mark - ACPPlacesSerialExecutor private properties
+@interface ACPPlacesSerialExecutor()
+@property(nonatomic, strong) dispatch_queue_t queue;
+@end
+
+@implementation ACPPlacesSerialExecutor
+
+- (instancetype) init {
+    return [self initWithLabel:ACPPlacesMonitorExecutorLabel];
+}
+
+- (instancetype) initWithLabel: (NSString*) label {
+    if (self = [super init]) {
+        _label = [label copy];
+        self.queue = dispatch_queue_create(label.UTF8String, DISPATCH_QUEUE_SERIAL);
+
+        // not retained by the queue, the executor outlives every block it has running
+        dispatch_queue_set_specific(_queue, ACPPlacesSerialExecutorQueueKey, (__bridge void*) self, NULL);
+    }
+
+    return self;
+}
+
+- (BOOL) isCurrent {
+    return dispatch_get_specific(ACPPlacesSerialExecutorQueueKey) == (__bridge void*) self;
+}
+
+- (void) execute: (dispatch_block_t) block {
+    if ([self isCurrent]) {
+        block();
+        return;
+    }
+
+    dispatch_async(_queue, block);
+}
+
+- (void) executeAndWait: (dispatch_block_t) block {
+    if ([self isCurrent]) {
+        block();
+        return;
+    }
+
+    dispatch_sync(_queue, block);
+}
+
+- (void) execute: (dispatch_block_t) block afterDelay: (NSTimeInterval) delay {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MAX(delay, 0) * NSEC_PER_SEC)), _queue, block);
+}
+
+@end
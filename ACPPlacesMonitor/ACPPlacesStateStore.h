@@ -0,0 +1,95 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesStateStore.h
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @class ACPPlacesStateStore
+ *
+ * @discussion Keeps the monitor's state in a small versioned binary file instead of NSUserDefaults.
+ *
+ * When iOS relaunches the app in the background for a region event, reading a handful of values from NSUserDefaults
+ * loads the app's whole defaults domain.  The state file only holds what the monitor needs: the monitored regions,
+ * the regions the device is within, the monitor mode, the authorization level, whether monitoring was started and
+ * the location of the last nearby POI query.  It is memory-mapped and decoded in a single pass.
+ *
+ * Values are exchanged as a dictionary keyed by the ACPPlacesMonitorDefaults keys, plus
+ * ACPPlacesMonitorStateLastQueryLocation holding a CLLocation.  A missing file loads as nil.  A file that is corrupt
+ * or written by another format version is moved aside to backupURL and loads as no values, since its values were
+ * already moved out of NSUserDefaults.
+ */
+@interface ACPPlacesStateStore : NSObject
+
+/**
+ * @brief Location of the state file
+ */
+@property(nonatomic, readonly) NSURL* fileURL;
+
+/**
+ * @brief Location a corrupt state file is moved to by load
+ */
+@property(nonatomic, readonly) NSURL* backupURL;
+
+/**
+ * @brief Keys of the values kept in the state file
+ */
++ (NSSet<NSString*>*) storedKeys;
+
+/**
+ * @brief Creates a store for the state file in the application support directory
+ */
+- (instancetype) init;
+
+/**
+ * @brief Creates a store for the state file at the URL
+ */
+- (instancetype) initWithFileURL: (NSURL*) fileURL NS_DESIGNATED_INITIALIZER;
+
+/**
+ * @brief Returns the values in the state file, or nil if there is no state file
+ *
+ * @discussion A corrupt file is logged, moved to backupURL and returns an empty dictionary, so the caller does not
+ * migrate from NSUserDefaults again.
+ */
+- (nullable NSDictionary<NSString*, id>*) load;
+
+/**
+ * @brief Replaces the state file with the values, keys which are not stored keys are ignored
+ *
+ * @return NO if the file could not be written
+ */
+- (BOOL) writeValues: (NSDictionary<NSString*, id>*) values;
+
+/**
+ * @brief Moves the stored keys from NSUserDefaults into a new state file
+ *
+ * @discussion The keys are only removed from the user defaults once the state file was written, so a failed
+ * migration is tried again on the next launch.
+ *
+ * @return the values found in the user defaults
+ */
+- (NSDictionary<NSString*, id>*) migrateFromUserDefaults: (NSUserDefaults*) userDefaults;
+
+/**
+ * @brief Deletes the state file
+ */
+- (void) remove;
+
+@end
+
+NS_ASSUME_NONNULL_END
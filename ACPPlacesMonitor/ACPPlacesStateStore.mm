@@ -0,0 +1,218 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesStateStore.mm
+//
+
+#import <ACPCore/ACPCore.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesMonitorConstants.h"
+#import "ACPPlacesMonitorLog.h"
+#import "ACPPlacesStateStore.h"
+
+#include "placesmonitor/StateFile.hpp"
+
+static NSArray<NSString*>* ACPPlacesStringArray(const std::vector<std::string>& strings) {
+    NSMutableArray<NSString*>* array = [NSMutableArray arrayWithCapacity:strings.size()];
+
+    for (const auto& string : strings) {
+        NSString* value = ACPPlacesNSString(string);
+
+        if (value) {
+            [array addObject:value];
+        }
+    }
+
+    return array;
+}
+
+static std::vector<std::string> ACPPlacesCoreStrings(id value) {
+    std::vector<std::string> strings;
+
+    if (![value isKindOfClass:[NSArray class]]) {
+        return strings;
+    }
+
+    for (id string in (NSArray*) value) {
+        if ([string isKindOfClass:[NSString class]]) {
+            strings.push_back(ACPPlacesCoreString(string));
+        }
+    }
+
+    return strings;
+}
+
+@implementation ACPPlacesStateStore
+
++ (NSSet<NSString*>*) storedKeys {
+    static NSSet<NSString*>* keys;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        keys = [NSSet setWithObjects:ACPPlacesMonitorDefaultsMonitoredRegions, ACPPlacesMonitorDefaultsUserWithinRegions,
+                ACPPlacesMonitorDefaultsMonitorMode, ACPPlacesMonitorDefaultsRequestAuthorizationLevel,
+                ACPPlacesMonitorDefaultsIsMonitoringStarted, ACPPlacesMonitorStateLastQueryLocation, nil];
+    });
+
+    return keys;
+}
+
+- (instancetype) init {
+    NSURL* directory = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory
+                                                               inDomains:NSUserDomainMask] firstObject];
+    directory = [directory URLByAppendingPathComponent:ACPPlacesMonitorStateDirectoryName isDirectory:YES];
+    return [self initWithFileURL:[directory URLByAppendingPathComponent:ACPPlacesMonitorStateFileName]];
+}
+
+- (instancetype) initWithFileURL: (NSURL*) fileURL {
+    if (self = [super init]) {
+        _fileURL = fileURL;
+    }
+
+    return self;
+}
+
+- (NSURL*) backupURL {
+    const placesmonitor::StateFile file(_fileURL.fileSystemRepresentation);
+    return [NSURL fileURLWithFileSystemRepresentation:file.backupPath().c_str() isDirectory:NO relativeToURL:nil];
+}
+
+- (NSDictionary<NSString*, id>*) load {
+    const placesmonitor::StateFile file(_fileURL.fileSystemRepresentation);
+    const auto result = file.read();
+
+    if (result.status == placesmonitor::StateFile::ReadStatus::Missing) {
+        return nil;
+    }
+
+    if (result.status == placesmonitor::StateFile::ReadStatus::Corrupt) {
+        // the values were moved out of NSUserDefaults when the file was created, migrating again would find nothing
+        // and overwrite the file.  keep it for inspection and start from empty state instead
+        if (file.moveToBackup()) {
+            ACPPlacesMonitorLogWarning(@"The state file at %@ is corrupt, resetting the monitor state.  The file was "
+                                       @"moved to %@", _fileURL.path, self.backupURL.path);
+        } else {
+            ACPPlacesMonitorLogWarning(@"The state file at %@ is corrupt and could not be moved aside, resetting the "
+                                       @"monitor state", _fileURL.path);
+        }
+
+        return @{};
+    }
+
+    const auto& state = result.state;
+    NSMutableDictionary<NSString*, id>* values = [NSMutableDictionary dictionary];
+
+    if (state->monitorMode) {
+        values[ACPPlacesMonitorDefaultsMonitorMode] = @(*state->monitorMode);
+    }
+
+    if (state->authorizationLevel) {
+        values[ACPPlacesMonitorDefaultsRequestAuthorizationLevel] = @(*state->authorizationLevel);
+    }
+
+    if (state->monitoringStarted) {
+        values[ACPPlacesMonitorDefaultsIsMonitoringStarted] = @(*state->monitoringStarted);
+    }
+
+    if (!state->monitoredRegions.empty()) {
+        values[ACPPlacesMonitorDefaultsMonitoredRegions] = ACPPlacesStringArray(state->monitoredRegions);
+    }
+
+    if (!state->userWithinRegions.empty()) {
+        values[ACPPlacesMonitorDefaultsUserWithinRegions] = ACPPlacesStringArray(state->userWithinRegions);
+    }
+
+    if (state->lastQueryLocation) {
+        values[ACPPlacesMonitorStateLastQueryLocation] = ACPPlacesCLLocation(*state->lastQueryLocation);
+    }
+
+    return values;
+}
+
+- (BOOL) writeValues: (NSDictionary<NSString*, id>*) values {
+    placesmonitor::PersistedState state;
+    id monitorMode = values[ACPPlacesMonitorDefaultsMonitorMode];
+    id authorizationLevel = values[ACPPlacesMonitorDefaultsRequestAuthorizationLevel];
+    id monitoringStarted = values[ACPPlacesMonitorDefaultsIsMonitoringStarted];
+    id lastQueryLocation = values[ACPPlacesMonitorStateLastQueryLocation];
+
+    if ([monitorMode isKindOfClass:[NSNumber class]]) {
+        state.monitorMode = [monitorMode longLongValue];
+    }
+
+    if ([authorizationLevel isKindOfClass:[NSNumber class]]) {
+        state.authorizationLevel = [authorizationLevel longLongValue];
+    }
+
+    if ([monitoringStarted isKindOfClass:[NSNumber class]]) {
+        state.monitoringStarted = [monitoringStarted boolValue];
+    }
+
+    if ([lastQueryLocation isKindOfClass:[CLLocation class]]) {
+        state.lastQueryLocation = ACPPlacesCoreLocation(lastQueryLocation);
+    }
+
+    state.monitoredRegions = ACPPlacesCoreStrings(values[ACPPlacesMonitorDefaultsMonitoredRegions]);
+    state.userWithinRegions = ACPPlacesCoreStrings(values[ACPPlacesMonitorDefaultsUserWithinRegions]);
+
+    NSError* error = nil;
+
+    if (![[NSFileManager defaultManager] createDirectoryAtURL:[_fileURL URLByDeletingLastPathComponent]
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:&error]) {
+        ACPPlacesMonitorLogWarning(@"Unable to create the directory for the state file: %@",
+                                   error.localizedDescription ?: @"unknown error");
+        return NO;
+    }
+
+    // region events can relaunch the app before the device is unlocked, the file keeps the default protection class
+    // (complete until first user authentication) so it is readable then
+    if (!placesmonitor::StateFile(_fileURL.fileSystemRepresentation).write(state)) {
+        ACPPlacesMonitorLogWarning(@"Unable to write the state file at %@", _fileURL.path);
+        return NO;
+    }
+
+    return YES;
+}
+
+- (NSDictionary<NSString*, id>*) migrateFromUserDefaults: (NSUserDefaults*) userDefaults {
+    NSMutableDictionary<NSString*, id>* values = [NSMutableDictionary dictionary];
+
+    for (NSString* key in [ACPPlacesStateStore storedKeys]) {
+        id value = [userDefaults objectForKey:key];
+
+        if (value) {
+            values[key] = value;
+        }
+    }
+
+    if (![self writeValues:values]) {
+        return values;
+    }
+
+    for (NSString* key in values) {
+        [userDefaults removeObjectForKey:key];
+    }
+
+    ACPPlacesMonitorLogDebug(@"Migrated %lu values from NSUserDefaults to the state file",
+                             (unsigned long)values.count);
+
+    return values;
+}
+
+- (void) remove {
+    placesmonitor::StateFile(_fileURL.fileSystemRepresentation).remove();
+}
+
+@end
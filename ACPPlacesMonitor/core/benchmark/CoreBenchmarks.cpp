@@ -0,0 +1,295 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// CoreBenchmarks.cpp
+//
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "TestHelpers.hpp"
+#include "placesmonitor/BeaconTracker.hpp"
+#include "placesmonitor/ContainmentEngine.hpp"
+#include "placesmonitor/EventQueue.hpp"
+#include "placesmonitor/Geo.hpp"
+#include "placesmonitor/GeofenceDiff.hpp"
+#include "placesmonitor/PoiPack.hpp"
+#include "placesmonitor/RegionClusters.hpp"
+#include "placesmonitor/RegionSchedule.hpp"
+#include "placesmonitor/StateFile.hpp"
+#include "placesmonitor/TrajectoryPrefetcher.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::testing;
+
+namespace {
+
+const Coordinate kOrigin{40.0, -111.0};
+
+// candidates spread on a grid roughly 200 meters apart around the origin
+std::vector<Poi> gridPois(int count) {
+    std::vector<Poi> pois;
+
+    for (int i = 0; i < count; i++) {
+        const Coordinate center{kOrigin.latitude + (i % 10) * 0.0018, kOrigin.longitude + (i / 10) * 0.0024};
+        pois.push_back(makePoi("poi" + std::to_string(i), center, 50 + (i % 7) * 25));
+    }
+
+    return pois;
+}
+
+std::vector<Region> regionsFor(const std::vector<Poi>& pois) {
+    std::vector<Region> regions;
+
+    for (const Poi& poi : pois) {
+        Region region;
+        region.identifier = poi.identifier;
+        region.center = poi.center;
+        region.radius = poi.radius;
+        regions.push_back(region);
+    }
+
+    return regions;
+}
+
+}
+
+static void BM_RegionSchedule(benchmark::State& state) {
+    const std::vector<Poi> pois = gridPois(kCandidatePoiCount);
+
+    for (auto _ : state) {
+        RegionSchedule schedule = RegionSchedule::build(pois, kOrigin, kMaxMonitoredRegionCount, 10000);
+        benchmark::DoNotOptimize(schedule);
+    }
+}
+BENCHMARK(BM_RegionSchedule);
+
+// small shops scattered over a 400 by 400 meter retail park, reports the region slots clustering saves
+static void BM_RegionClusters(benchmark::State& state) {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> offset(0, 400);
+    std::uniform_real_distribution<double> radius(10, 40);
+    std::vector<Poi> pois;
+
+    for (int i = 0; i < state.range(0); i++) {
+        pois.push_back(makePoi("poi" + std::to_string(i),
+                               destination(destination(kOrigin, 0, offset(generator)), 90, offset(generator)),
+                               radius(generator)));
+    }
+
+    std::size_t savedSlots = 0;
+
+    for (auto _ : state) {
+        RegionClusters clusters = RegionClusters::build(pois);
+        savedSlots = clusters.savedSlots();
+        benchmark::DoNotOptimize(clusters);
+    }
+
+    state.counters["savedSlots"] = static_cast<double>(savedSlots);
+}
+BENCHMARK(BM_RegionClusters)->Arg(kCandidatePoiCount)->Arg(200);
+
+static void BM_BeaconTracker(benchmark::State& state) {
+    // a mall with one beacon per store, every store in range of the device is heard in each ranging round
+    const int count = static_cast<int>(state.range(0));
+    std::vector<BeaconPoi> pois;
+    std::vector<BeaconReading> readings;
+
+    for (int i = 0; i < count; i++) {
+        BeaconPoi poi;
+        poi.identifier = "store" + std::to_string(i);
+        poi.beacon.uuid = "F7826DA6-4FA2-4E98-8024-BC5B71E0893E";
+        poi.beacon.major = 1;
+        poi.beacon.minor = i;
+        pois.push_back(poi);
+
+        BeaconReading reading;
+        reading.beacon = poi.beacon;
+        reading.distance = 2.0 + i % 20;
+        readings.push_back(reading);
+    }
+
+    BeaconTracker tracker;
+    tracker.track(pois);
+    double now = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tracker.update(readings, now += 1));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_BeaconTracker)->Arg(kMaxMonitoredRegionCount)->Arg(kCandidatePoiCount);
+
+static void BM_GeofenceDiff(benchmark::State& state) {
+    // half of the monitored regions are replaced
+    const std::vector<Region> all = regionsFor(gridPois(30));
+    const std::vector<Region> monitored(all.begin(), all.begin() + 20);
+    const std::vector<Region> desired(all.begin() + 10, all.end());
+    std::unordered_set<std::string> owned;
+
+    for (const Region& region : monitored) {
+        owned.insert(region.identifier);
+    }
+
+    for (auto _ : state) {
+        GeofenceDiff diff = GeofenceDiff::compute(desired, monitored, owned);
+        benchmark::DoNotOptimize(diff);
+    }
+}
+BENCHMARK(BM_GeofenceDiff);
+
+static void BM_Containment(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    ContainmentEngine engine(kContainmentMinimumBand, kContainmentMaximumAccuracy);
+    engine.load(regionsFor(gridPois(static_cast<int>(count))));
+    const std::vector<bool> inside(count, false);
+    const Location location = makeLocation(Coordinate{kOrigin.latitude + 0.009, kOrigin.longitude + 0.012});
+    std::vector<std::size_t> entered;
+    std::vector<std::size_t> exited;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.evaluate(location, inside, entered, exited));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_Containment)->Arg(20)->Arg(100)->Arg(1000);
+
+static void BM_EventQueue(benchmark::State& state) {
+    EventQueue<int64_t> queue;
+
+    for (auto _ : state) {
+        queue.add(EventKind::UpdateLocationNow, 0);
+        queue.add(EventKind::UpdateLocationNow, 0);
+        queue.add(EventKind::Other, 0);
+        benchmark::DoNotOptimize(queue.poll());
+        benchmark::DoNotOptimize(queue.poll());
+    }
+}
+BENCHMARK(BM_EventQueue);
+
+// the state a monitor loads on a background relaunch, with the given number of monitored regions
+static PersistedState persistedState(int regionCount) {
+    PersistedState persisted;
+    persisted.monitorMode = MonitorModeSignificantChanges;
+    persisted.authorizationLevel = AuthorizationLevelAlways;
+    persisted.monitoringStarted = true;
+    persisted.lastQueryLocation = makeLocation(kOrigin);
+
+    for (int i = 0; i < regionCount; i++) {
+        persisted.monitoredRegions.push_back("3e9a6a8c-46c2-4b59-9a6f-" + std::to_string(100000000000 + i));
+    }
+
+    persisted.userWithinRegions.push_back(persisted.monitoredRegions.front());
+    return persisted;
+}
+
+// maps, validates and decodes the state file, what the monitor does on a cold start
+static void BM_StateFileRead(benchmark::State& state) {
+    const StateFile file("placesmonitorcore_benchmark_state.bin");
+    file.write(persistedState(static_cast<int>(state.range(0))));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(file.read());
+    }
+
+    file.remove();
+}
+BENCHMARK(BM_StateFileRead)->Arg(20)->Arg(1000);
+
+static void BM_StateFileWrite(benchmark::State& state) {
+    const StateFile file("placesmonitorcore_benchmark_state.bin");
+    const PersistedState persisted = persistedState(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(file.write(persisted));
+    }
+
+    file.remove();
+}
+BENCHMARK(BM_StateFileWrite)->Arg(20);
+
+// one significant location change on a drive without reported speed, the prefetch work added to every fix
+static void BM_TrajectoryPrefetch(benchmark::State& state) {
+    TrajectoryPrefetcher prefetcher;
+    double meters = 0;
+    double timestamp = 0;
+
+    for (auto _ : state) {
+        // a new 100km drive starts before the path runs off the map
+        if (meters >= 100000) {
+            meters = 0;
+            prefetcher.reset();
+        }
+
+        meters += 500;
+        timestamp += 25;
+        benchmark::DoNotOptimize(prefetcher.onLocation(makeLocation(offsetNorth(kOrigin, meters), 65, timestamp)));
+    }
+
+    state.counters["hitRate"] = prefetcher.statistics().hitRate();
+}
+BENCHMARK(BM_TrajectoryPrefetch);
+
+// a store network spread over roughly 200 by 200 km, written to a pack file
+static std::string writePoiPack(int count) {
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> offset(-1.0, 1.0);
+    std::vector<Poi> pois;
+
+    for (int i = 0; i < count; i++) {
+        const Coordinate center{kOrigin.latitude + offset(generator), kOrigin.longitude + offset(generator)};
+        pois.push_back(makePoi("3e9a6a8c-46c2-4b59-9a6f-" + std::to_string(100000000000 + i), center, 100));
+    }
+
+    const std::string path = "placesmonitorcore_benchmark.pack";
+    const std::vector<uint8_t> bytes = PoiPack::encode(pois, 1);
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()),
+                                                static_cast<std::streamsize>(bytes.size()));
+    return path;
+}
+
+// mapping a pack and validating its cell table, what setting a pack costs the monitor
+static void BM_PoiPackOpen(benchmark::State& state) {
+    const std::string path = writePoiPack(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PoiPack::open(path));
+    }
+
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_PoiPackOpen)->Arg(1000)->Arg(100000);
+
+// the nearest-N query answering a location update from the pack
+static void BM_PoiPackNearest(benchmark::State& state) {
+    const std::string path = writePoiPack(static_cast<int>(state.range(0)));
+    const auto pack = PoiPack::open(path);
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<double> offset(-1.0, 1.0);
+
+    for (auto _ : state) {
+        const Coordinate coordinate{kOrigin.latitude + offset(generator), kOrigin.longitude + offset(generator)};
+        benchmark::DoNotOptimize(pack->nearest(coordinate, kCandidatePoiCount));
+    }
+
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_PoiPackNearest)->Arg(1000)->Arg(100000);
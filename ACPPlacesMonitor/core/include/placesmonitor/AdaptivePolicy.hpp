@@ -0,0 +1,70 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// AdaptivePolicy.hpp
+//
+
+#pragma once
+
+#include "placesmonitor/Constants.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @brief The location strategies used by the adaptive monitor mode
+ *
+ * @discussion
+ *  - far - the device is away from every fence, only significant changes are used
+ *  - approaching - the device is near a fence boundary, continuous updates are used
+ *  - backed off - the device stayed near a fence longer than the continuous time limit, only significant changes
+ *    are used until the device moves away from the fence again
+ */
+enum class AdaptiveState {
+    Far = 0,
+    Approaching,
+    BackedOff
+};
+
+/**
+ * @class AdaptivePolicy
+ *
+ * @discussion The tunable rules deciding how closely the device's location needs to be tracked, based on its
+ * distance to the nearest fence boundary.
+ *
+ * The device starts approaching once it is within nearDistance meters of a boundary, and is only considered far
+ * again once it is at least farDistance meters away, so a device moving along the threshold does not flap between
+ * strategies.
+ */
+struct AdaptivePolicy {
+    double nearDistance = kAdaptiveNearDistance;
+    double farDistance = kAdaptiveFarDistance;
+    double continuousTimeLimit = kAdaptiveContinuousTimeLimit;
+
+    /**
+     * @brief Decides which strategy should be used next
+     *
+     * @param state the strategy currently in use
+     * @param distance the distance in meters from the device to the nearest fence boundary
+     * @param timeInState the number of seconds the current strategy has been in use
+     */
+    AdaptiveState nextState(AdaptiveState state, double distance, double timeInState) const;
+
+    /**
+     * @brief Indicates whether continuous location updates should be running for the state
+     */
+    static bool usesContinuousUpdates(AdaptiveState state) { return state == AdaptiveState::Approaching; }
+
+    static const char* name(AdaptiveState state);
+};
+
+}
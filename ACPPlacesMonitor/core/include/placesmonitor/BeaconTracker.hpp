@@ -0,0 +1,116 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// BeaconTracker.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "placesmonitor/Constants.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @brief A beacon, or a group of beacons when the major or minor is left out
+ */
+struct BeaconIdentity {
+    std::string uuid;
+    int major = -1;   // any major when negative
+    int minor = -1;   // any minor when negative
+
+    bool matches(const BeaconIdentity& beacon) const;
+};
+
+/**
+ * @brief A beacon heard while ranging
+ */
+struct BeaconReading {
+    BeaconIdentity beacon;
+    double distance = -1;   // estimated meters, negative when unknown
+};
+
+/**
+ * @brief A POI which is entered when its beacon is close
+ */
+struct BeaconPoi {
+    std::string identifier;
+    BeaconIdentity beacon;
+};
+
+/**
+ * @class BeaconTracker
+ *
+ * @discussion Turns beacon ranging readings into entries and exits of the POIs the beacons are placed in.
+ *
+ * Only the POIs whose geofence contains the device are tracked.  A POI is entered once one of its beacons is read
+ * within the entry distance.  It is exited once none of them has been read within the larger exit distance for the
+ * exit timeout, or when it stops being tracked.  Readings only arrive while ranging, so the timeout has to span the
+ * pause between two ranging windows.
+ */
+class BeaconTracker {
+public:
+    struct Transitions {
+        std::vector<std::string> entered;
+        std::vector<std::string> exited;
+    };
+
+    /**
+     * @param entryDistance a beacon closer than this many meters enters its POI
+     * @param exitDistance a beacon closer than this many meters keeps its POI entered
+     * @param exitTimeout seconds without a close enough reading before the POI is exited
+     */
+    explicit BeaconTracker(double entryDistance = kBeaconEntryDistance,
+                           double exitDistance = kBeaconExitDistance,
+                           double exitTimeout = kBeaconExitTimeout);
+
+    /**
+     * @brief Replaces the tracked POIs, the POIs which are kept keep their state
+     *
+     * @return the entered POIs which are no longer tracked, as exits
+     */
+    Transitions track(const std::vector<BeaconPoi>& pois);
+
+    /**
+     * @brief Updates the POIs from the readings of one ranging round
+     *
+     * @param readings every beacon heard in the round, possibly none
+     * @param now the time of the round in seconds
+     */
+    Transitions update(const std::vector<BeaconReading>& readings, double now);
+
+    /**
+     * @brief The distinct UUIDs of the tracked beacons, sorted, so each can be ranged as a single region
+     */
+    std::vector<std::string> uuids() const;
+
+    bool isInside(const std::string& identifier) const;
+    std::size_t count() const { return states_.size(); }
+
+private:
+    struct State {
+        BeaconPoi poi;
+        bool inside = false;
+        double lastCloseAt = 0;
+    };
+
+    double entryDistance_;
+    double exitDistance_;
+    double exitTimeout_;
+    std::vector<State> states_;
+};
+
+}
@@ -0,0 +1,70 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// Constants.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace placesmonitor {
+
+// the values mirror ACPPlacesMonitorConstants so both layers make the same decisions
+
+// region monitoring
+constexpr std::size_t kMaxMonitoredRegionCount = 20;
+constexpr std::size_t kCandidatePoiCount = 50;
+constexpr const char* kBoundaryRegionIdentifier = "acpplacesmonitor.boundary";
+constexpr double kBoundaryMinimumRadius = 100.0;
+
+// location tracking
+constexpr double kAdaptiveNearDistance = 500.0;
+constexpr double kAdaptiveFarDistance = 1000.0;
+constexpr double kAdaptiveContinuousTimeLimit = 300.0;
+
+// on-device containment
+constexpr double kContainmentMinimumBand = 10.0;
+constexpr double kContainmentMaximumAccuracy = 100.0;
+
+// geofence reconciliation tolerances
+constexpr double kGeofenceCenterTolerance = 0.000001;
+constexpr double kGeofenceRadiusTolerance = 0.5;
+
+// trajectory prefetch
+constexpr std::size_t kPrefetchHistorySize = 8;
+constexpr double kPrefetchHistoryWindow = 600.0;
+constexpr double kPrefetchHorizon = 300.0;
+constexpr double kPrefetchMinimumSpeed = 5.0;
+constexpr double kPrefetchSpacing = 1000.0;
+constexpr std::size_t kPrefetchMaximumPoints = 4;
+constexpr double kPrefetchHitRadius = 500.0;
+
+// region clustering
+constexpr double kClusterMaximumRadius = 200.0;
+constexpr double kClusterMaximumGap = 25.0;
+constexpr const char* kClusterRegionIdentifierPrefix = "acpplacesmonitor.cluster.";
+
+// beacon refinement
+constexpr double kBeaconEntryDistance = 3.0;
+constexpr double kBeaconExitDistance = 8.0;
+constexpr double kBeaconExitTimeout = 45.0;
+
+// offline poi pack
+constexpr double kPoiPackCellSize = 0.01;
+constexpr double kPoiPackSearchRadius = 50000.0;
+
+// event queue
+constexpr std::size_t kEventQueueCapacity = 32;
+
+}
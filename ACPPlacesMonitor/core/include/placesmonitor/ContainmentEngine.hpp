@@ -0,0 +1,82 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ContainmentEngine.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @class ContainmentEngine
+ *
+ * @discussion Detects geofence entries and exits on the device by testing location fixes against the loaded circles,
+ * without waiting for the platform's region callbacks.
+ *
+ * The circles are stored as parallel arrays so a fix can be tested against all of them in one tight loop.  To avoid
+ * flapping on noisy fixes, an entry requires the fix to be inside the circle by at least a hysteresis band, and an
+ * exit requires it to be outside the circle by at least the same band.  The band grows with the horizontal accuracy
+ * of the fix.
+ */
+class ContainmentEngine {
+public:
+    /**
+     * @param minimumBand the smallest hysteresis band in meters, used for very accurate fixes
+     * @param maximumAccuracy fixes with a horizontal accuracy worse than this many meters are ignored
+     */
+    explicit ContainmentEngine(double minimumBand = kContainmentMinimumBand,
+                               double maximumAccuracy = kContainmentMaximumAccuracy);
+
+    /**
+     * @brief Replaces the circles tested by the engine
+     */
+    void load(const std::vector<Region>& regions);
+
+    /**
+     * @brief Tests the location against every loaded circle
+     *
+     * @param location the location fix to test
+     * @param inside for each loaded circle, whether the device is currently known to be within it
+     * @param entered on return, indexes of the circles the device has entered
+     * @param exited on return, indexes of the circles the device has exited
+     * @return false if the fix was not accurate enough to be evaluated
+     */
+    bool evaluate(const Location& location,
+                  const std::vector<bool>& inside,
+                  std::vector<std::size_t>& entered,
+                  std::vector<std::size_t>& exited);
+
+    std::size_t count() const { return radii_.size(); }
+
+private:
+    void computeDistancesSquared(const Coordinate& coordinate);
+
+    double minimumBand_;
+    double maximumAccuracy_;
+
+    // circle geometry in a struct-of-arrays layout, angles in radians
+    std::vector<double> latitudes_;
+    std::vector<double> longitudes_;
+    std::vector<double> cosLatitudes_;
+    std::vector<double> radii_;
+    std::vector<double> distancesSquared_;
+};
+
+}
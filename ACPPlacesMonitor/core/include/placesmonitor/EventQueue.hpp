@@ -0,0 +1,285 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// EventQueue.hpp
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "placesmonitor/Constants.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @brief The kinds of requests handled by the monitor, other events are queued as Other
+ */
+enum class EventKind {
+    Start,
+    Stop,
+    UpdateLocationNow,
+    UpdateMonitorConfiguration,
+    SetRequestAuthorizationLevel,
+    Other
+};
+
+/**
+ * @class EventQueue
+ *
+ * @discussion A bounded FIFO queue of pending events which coalesces redundant requests as they are added.
+ *
+ *  - a repeated start or update location now request is dropped while an identical one is pending
+ *  - a monitor configuration or authorization level request replaces the pending one, keeping its position
+ *  - a stop request cancels every pending start request
+ *
+ * Requests are only coalesced with pending requests queued after the last stop, so the queue always ends in the
+ * same state as running every event in order.
+ *
+ * When the queue is full, the oldest coalescible request is dropped to make room, then the oldest other event.  A
+ * stop is never dropped: with only stops pending, a new event other than a stop is dropped instead, and a new stop
+ * is queued past the capacity.  The payload is opaque to the queue, so the platform layer can store its own event
+ * objects; it must be default constructible.
+ *
+ * The events are kept in a ring buffer allocated once for the capacity, so adding and polling never allocate.  Only
+ * a stop queued past the capacity grows the ring.  Coalescing and eviction shift the later events down in place,
+ * which is cheap at the small capacities the queue is used with.
+ */
+template <typename Payload>
+class EventQueue {
+public:
+    struct AddResult {
+        bool queued = false;
+        std::optional<Payload> dropped;
+    };
+
+    explicit EventQueue(std::size_t capacity = kEventQueueCapacity)
+        : slots_(std::max<std::size_t>(capacity, 1)), capacity_(slots_.size()) {}
+
+    /**
+     * @brief Adds the event unless a pending event absorbs it
+     *
+     * @return whether the event was queued, and the event which was dropped to make room, if any
+     */
+    AddResult add(EventKind kind, Payload payload) {
+        AddResult result;
+
+        if (coalesce(kind, payload)) {
+            coalescedCount_++;
+            return result;
+        }
+
+        if (count_ >= capacity_) {
+            const std::size_t evicted = evictionCandidate();
+
+            if (evicted != count_) {
+                result.dropped = std::move(at(evicted).payload);
+                erase(evicted);
+            } else if (kind != EventKind::Stop) {
+                result.dropped = std::move(payload);
+                return result;
+            }
+        }
+
+        if (count_ == slots_.size()) {
+            grow();
+        }
+
+        at(count_) = Entry{kind, std::move(payload)};
+        count_++;
+        result.queued = true;
+
+        return result;
+    }
+
+    /**
+     * @brief Returns the oldest pending event without removing it, or nullptr if the queue is empty
+     */
+    const Payload* peek() const {
+        return count_ ? &slots_[head_].payload : nullptr;
+    }
+
+    /**
+     * @brief Removes and returns the oldest pending event
+     */
+    std::optional<Payload> poll() {
+        if (!count_) {
+            return std::nullopt;
+        }
+
+        // the slot is reset so it doesn't keep the payload alive until it is reused
+        std::optional<Payload> payload(std::move(slots_[head_].payload));
+        slots_[head_] = Entry();
+        head_ = (head_ + 1) % slots_.size();
+        count_--;
+
+        return payload;
+    }
+
+    bool hasNext() const { return count_ > 0; }
+    std::size_t count() const { return count_; }
+    std::size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Number of events absorbed by or removed because of a later event
+     */
+    std::size_t coalescedCount() const { return coalescedCount_; }
+
+private:
+    struct Entry {
+        EventKind kind = EventKind::Other;
+        Payload payload{};
+    };
+
+    /**
+     * @brief Returns the pending event at the position, counted from the oldest
+     */
+    Entry& at(std::size_t index) {
+        return slots_[(head_ + index) % slots_.size()];
+    }
+
+    /**
+     * @return true if the event was fully absorbed by a pending event and must not be added to the queue
+     */
+    bool coalesce(EventKind kind, Payload& payload) {
+        switch (kind) {
+            case EventKind::Start:
+            case EventKind::UpdateLocationNow:
+                return findAfterLastStop(kind) != count_;
+
+            case EventKind::UpdateMonitorConfiguration:
+            case EventKind::SetRequestAuthorizationLevel: {
+                const std::size_t pending = findAfterLastStop(kind);
+
+                if (pending == count_) {
+                    return false;
+                }
+
+                at(pending).payload = std::move(payload);
+                return true;
+            }
+
+            case EventKind::Stop: {
+                // compacts the events which are not a start towards the oldest, keeping their order
+                std::size_t kept = 0;
+
+                for (std::size_t i = 0; i < count_; i++) {
+                    if (at(i).kind == EventKind::Start) {
+                        continue;
+                    }
+
+                    if (kept != i) {
+                        at(kept) = std::move(at(i));
+                    }
+
+                    kept++;
+                }
+
+                for (std::size_t i = kept; i < count_; i++) {
+                    at(i) = Entry();
+                }
+
+                coalescedCount_ += count_ - kept;
+                count_ = kept;
+                return false;
+            }
+
+            case EventKind::Other:
+                return false;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Finds the pending event of the kind, ignoring the events queued before the last stop
+     *
+     * @return the position of the event, or count() if there is none
+     */
+    std::size_t findAfterLastStop(EventKind kind) {
+        std::size_t first = count_;
+
+        while (first > 0 && at(first - 1).kind != EventKind::Stop) {
+            first--;
+        }
+
+        for (std::size_t i = first; i < count_; i++) {
+            if (at(i).kind == kind) {
+                return i;
+            }
+        }
+
+        return count_;
+    }
+
+    /**
+     * @brief Returns the position of the oldest coalescible request, or of the oldest event which is not a stop
+     *
+     * @return the position of the event, or count() if every pending event is a stop
+     */
+    std::size_t evictionCandidate() {
+        std::size_t other = count_;
+
+        for (std::size_t i = 0; i < count_; i++) {
+            const EventKind kind = at(i).kind;
+
+            if (kind != EventKind::Stop && kind != EventKind::Other) {
+                return i;
+            }
+
+            if (kind == EventKind::Other && other == count_) {
+                other = i;
+            }
+        }
+
+        return other;
+    }
+
+    /**
+     * @brief Removes the pending event at the position, shifting the newer events down
+     */
+    void erase(std::size_t index) {
+        for (std::size_t i = index; i + 1 < count_; i++) {
+            at(i) = std::move(at(i + 1));
+        }
+
+        at(count_ - 1) = Entry();
+        count_--;
+    }
+
+    /**
+     * @brief Doubles the ring, only needed for stops queued past the capacity
+     */
+    void grow() {
+        std::vector<Entry> slots(slots_.size() * 2);
+
+        for (std::size_t i = 0; i < count_; i++) {
+            slots[i] = std::move(at(i));
+        }
+
+        slots_ = std::move(slots);
+        head_ = 0;
+    }
+
+    std::vector<Entry> slots_;
+    std::size_t capacity_;
+    std::size_t head_ = 0;
+    std::size_t count_ = 0;
+    std::size_t coalescedCount_ = 0;
+};
+
+}
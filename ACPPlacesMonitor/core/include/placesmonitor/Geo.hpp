@@ -0,0 +1,46 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// Geo.hpp
+//
+
+#pragma once
+
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+// mean radius of the earth in meters
+constexpr double kEarthRadius = 6371008.8;
+
+/**
+ * @brief Great-circle distance in meters between two coordinates
+ */
+double distanceBetween(const Coordinate& from, const Coordinate& to);
+
+/**
+ * @brief Distance in meters from the coordinate to the edge of the circle, negative when the coordinate is inside
+ */
+double edgeDistance(const Coordinate& from, const Coordinate& center, double radius);
+
+/**
+ * @brief Initial bearing in degrees clockwise from north, in [0, 360), of the great circle from one coordinate to another
+ */
+double bearingBetween(const Coordinate& from, const Coordinate& to);
+
+/**
+ * @brief The coordinate reached by travelling the distance in meters along the great circle with the initial bearing
+ */
+Coordinate destination(const Coordinate& from, double bearing, double distance);
+
+}
@@ -0,0 +1,83 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// GeofenceDiff.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @class GeofenceDiff
+ *
+ * @discussion Compares the geofences the monitor wants registered with the regions it currently has registered,
+ * producing the minimal set of start and stop operations needed to reconcile them.
+ *
+ * A desired region that is already registered with the same center and radius is kept untouched.  A region that is
+ * registered with a different center or radius is stopped and started again with its new geometry.  Only regions
+ * whose identifiers are owned by the monitor are ever stopped, so regions registered elsewhere in the app are safe.
+ */
+class GeofenceDiff {
+public:
+    /**
+     * @brief Calculates the operations needed to move from the monitored regions to the desired regions
+     *
+     * @param desired the regions that should be registered after reconciliation
+     * @param monitored the regions currently registered with the platform
+     * @param owned identifiers of the regions registered by the monitor
+     */
+    static GeofenceDiff compute(const std::vector<Region>& desired,
+                                const std::vector<Region>& monitored,
+                                const std::unordered_set<std::string>& owned);
+
+    /**
+     * @brief Indexes into the desired regions of the regions to register, including updated regions
+     */
+    const std::vector<std::size_t>& toStart() const { return toStart_; }
+
+    /**
+     * @brief Indexes into the monitored regions of the regions to unregister, including the old geometry of updated
+     * regions
+     */
+    const std::vector<std::size_t>& toStop() const { return toStop_; }
+
+    /**
+     * @brief Indexes into the desired regions of the regions which are already registered and need no changes
+     */
+    const std::vector<std::size_t>& kept() const { return kept_; }
+
+    std::size_t addedCount() const { return addedCount_; }
+    std::size_t removedCount() const { return removedCount_; }
+    std::size_t updatedCount() const { return updatedCount_; }
+    std::size_t keptCount() const { return kept_.size(); }
+
+    static bool hasSameGeometry(const Region& region, const Region& other);
+
+private:
+    std::vector<std::size_t> toStart_;
+    std::vector<std::size_t> toStop_;
+    std::vector<std::size_t> kept_;
+    std::size_t addedCount_ = 0;
+    std::size_t removedCount_ = 0;
+    std::size_t updatedCount_ = 0;
+};
+
+}
@@ -0,0 +1,60 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// MappedFile.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace placesmonitor {
+
+/**
+ * @class MappedFile
+ *
+ * @discussion Maps a whole file read-only into memory.  Pages are only read from disk when they are touched, so
+ * opening a file costs a couple of system calls regardless of its size.  The mapping is released when the object
+ * is destroyed, pointers into it must not outlive it.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps the file at the path, check isOpen() for the result
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Returns false if the file is missing, unreadable or empty
+     */
+    bool isOpen() const { return data_ != nullptr; }
+
+    const uint8_t* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void release();
+
+    const uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}
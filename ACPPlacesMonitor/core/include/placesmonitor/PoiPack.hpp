@@ -0,0 +1,126 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// PoiPack.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/MappedFile.hpp"
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @class PoiPack
+ *
+ * @discussion A read-only set of POIs shipped with the app, with a spatial index built ahead of time so it can be
+ * queried straight from a memory-mapped file without being parsed.
+ *
+ * The file is a 40 byte header (magic, format version, POI and cell counts, the revision of the dataset, the cell
+ * size in degrees and the size of the string table), the cell table, the POI records and the string table.  POIs
+ * are bucketed in a grid of cellSize degree cells and stored grouped by cell.  Each cell entry holds its row and
+ * column and the range of its records, sorted so a cell is found with a binary search.  A record is 40 bytes: the
+ * center, the radius, and the offsets and lengths of the identifier and name in the string table.  Numbers are
+ * little-endian.
+ *
+ * Opening a pack checks the header and the cell table, which is small, and nothing else, so only the pages a query
+ * touches are ever read.  A record whose strings fall outside the string table is skipped by queries.
+ */
+class PoiPack {
+public:
+    static constexpr uint16_t kVersion = 1;
+    static constexpr std::size_t kHeaderSize = 40;
+    static constexpr std::size_t kCellSize = 16;
+    static constexpr std::size_t kRecordSize = 40;
+
+    /**
+     * @brief Maps the pack at the path, or returns nothing if it is missing or not a valid pack
+     */
+    static std::optional<PoiPack> open(const std::string& path);
+
+    /**
+     * @brief Reads a pack from memory, for packs that are not stored in a file
+     */
+    static std::optional<PoiPack> decode(std::vector<uint8_t> bytes);
+
+    /**
+     * @brief Builds a pack from the POIs
+     *
+     * @param revision identifies the dataset, packs built from the same export should use the same revision
+     * @param cellSize the side of a grid cell in degrees, a query touches fewer records with smaller cells and
+     * fewer cells with larger ones
+     */
+    static std::vector<uint8_t> encode(const std::vector<Poi>& pois, uint64_t revision, double cellSize = kPoiPackCellSize);
+
+    PoiPack(PoiPack&&) noexcept = default;
+    PoiPack& operator=(PoiPack&&) noexcept = default;
+
+    /**
+     * @brief The POIs nearest to the coordinate, nearest first
+     *
+     * @discussion The grid is searched in rings of cells around the coordinate until no unvisited cell can hold a
+     * POI nearer than the farthest one found, so a query reads a handful of cells however large the pack is.  The
+     * userIsWithin flag of each POI is set for the coordinate.
+     *
+     * @param count the maximum number of POIs returned
+     * @param maximumDistance POIs whose center is farther than this many meters are not returned
+     */
+    std::vector<Poi> nearest(const Coordinate& coordinate,
+                             std::size_t count,
+                             double maximumDistance = kPoiPackSearchRadius) const;
+
+    /**
+     * @brief The POI stored at the index, or nothing if the index is out of range or the record is corrupt
+     */
+    std::optional<Poi> poiAt(std::size_t index) const;
+
+    std::size_t size() const { return poiCount_; }
+    std::size_t cellCount() const { return cellCount_; }
+    uint64_t revision() const { return revision_; }
+    double cellSize() const { return cellSize_; }
+
+private:
+    PoiPack() = default;
+
+    static std::optional<PoiPack> validate(PoiPack pack);
+
+    std::size_t firstCellAtOrAfter(uint32_t row, uint32_t column) const;
+    bool readRecord(std::size_t index, Poi& poi) const;
+    Coordinate recordCenter(std::size_t index) const;
+
+    std::optional<MappedFile> file_;
+    std::vector<uint8_t> bytes_;
+    const uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    std::size_t poiCount_ = 0;
+    std::size_t cellCount_ = 0;
+    uint64_t revision_ = 0;
+    double cellSize_ = 0;
+    uint32_t rows_ = 0;
+    uint32_t columns_ = 0;
+    const uint8_t* cells_ = nullptr;
+    const uint8_t* records_ = nullptr;
+    const uint8_t* strings_ = nullptr;
+    std::size_t stringsSize_ = 0;
+};
+
+}
@@ -0,0 +1,87 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// RegionClusters.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @class RegionClusters
+ *
+ * @discussion Groups small POIs that overlap or nearly touch, like the shops of a food court, so that each group
+ * takes a single region monitoring slot.
+ *
+ * Two POIs are linked when the gap between their circles is at most the maximum gap.  Linked groups are merged
+ * greedily, the pair with the smallest enclosing circle first, for as long as that circle stays within the maximum
+ * radius.  A cluster is registered as one region, the smallest circle around its members, and the members the device
+ * is in are resolved on the device once the cluster is entered.  POIs which could not be merged with any other keep
+ * their own region.
+ */
+class RegionClusters {
+public:
+    /**
+     * @brief A group of POIs sharing one region
+     */
+    struct Cluster {
+        Region region;
+        std::vector<std::size_t> members;
+    };
+
+    /**
+     * @brief Clusters the POIs
+     *
+     * @param pois the POIs to group
+     * @param maximumRadius the largest radius of a cluster region in meters, no cluster is made if not positive
+     * @param maximumGap the largest distance in meters between the circles of two linked POIs
+     */
+    static RegionClusters build(const std::vector<Poi>& pois,
+                                double maximumRadius = kClusterMaximumRadius,
+                                double maximumGap = kClusterMaximumGap);
+
+    /**
+     * @brief Indicates whether the identifier belongs to a cluster region
+     */
+    static bool isClusterRegion(const std::string& identifier);
+
+    /**
+     * @brief The clusters, each with at least two members, ordered by their first member
+     */
+    const std::vector<Cluster>& clusters() const { return clusters_; }
+
+    /**
+     * @brief Indexes into the POIs of the ones which keep their own region, in their original order
+     */
+    const std::vector<std::size_t>& unclustered() const { return unclustered_; }
+
+    /**
+     * @brief Number of region slots saved compared to one region per POI
+     */
+    std::size_t savedSlots() const { return poiCount_ - clusters_.size() - unclustered_.size(); }
+
+private:
+    std::vector<Cluster> clusters_;
+    std::vector<std::size_t> unclustered_;
+    std::size_t poiCount_ = 0;
+};
+
+}
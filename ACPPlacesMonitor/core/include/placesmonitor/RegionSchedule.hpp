@@ -0,0 +1,79 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// RegionSchedule.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @class RegionSchedule
+ *
+ * @discussion Decides which POIs get one of the limited region monitoring slots offered by the OS.
+ *
+ * Candidates are ranked by their edge distance, the distance from the device to the POI's center minus its radius.
+ * If every candidate fits in the available slots they are all selected.  Otherwise, all but one slot are filled with
+ * the best ranked candidates, and the last slot holds a boundary region centered on the device.  The boundary radius
+ * is the edge distance of the closest candidate left out, so the device cannot enter any of them without first
+ * leaving the boundary, which triggers a refresh of the schedule.
+ */
+class RegionSchedule {
+public:
+    /**
+     * @brief Builds a schedule for the candidates
+     *
+     * @param candidates the POIs near the device
+     * @param location the location of the device
+     * @param slotCount the number of regions which can be monitored, including the boundary region
+     * @param maximumRadius the largest radius the platform accepts for a region, ignored if not positive
+     */
+    static RegionSchedule build(const std::vector<Poi>& candidates,
+                                const Coordinate& location,
+                                std::size_t slotCount,
+                                double maximumRadius);
+
+    /**
+     * @brief Indicates whether the identifier belongs to a boundary region created by a schedule
+     */
+    static bool isBoundaryRegion(const std::string& identifier);
+
+    /**
+     * @brief Indexes into the candidates of the POIs which should be monitored, ordered by edge distance
+     */
+    const std::vector<std::size_t>& selected() const { return selected_; }
+
+    /**
+     * @brief The boundary region to monitor, empty if every candidate was selected
+     */
+    const std::optional<Region>& boundary() const { return boundary_; }
+
+    /**
+     * @brief Number of candidates which did not get a slot
+     */
+    std::size_t deferredCount() const { return deferredCount_; }
+
+private:
+    std::vector<std::size_t> selected_;
+    std::optional<Region> boundary_;
+    std::size_t deferredCount_ = 0;
+};
+
+}
@@ -0,0 +1,117 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// StateFile.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @brief Everything the monitor needs to pick up where it left off after being relaunched
+ *
+ * @discussion Values that were never written are empty, so callers can fall back to their own defaults.  The
+ * timestamp of the last query location is in seconds since 1970, so it stays meaningful across launches.
+ */
+struct PersistedState {
+    std::optional<int64_t> monitorMode;
+    std::optional<int64_t> authorizationLevel;
+    std::optional<bool> monitoringStarted;
+    std::vector<std::string> monitoredRegions;
+    std::vector<std::string> userWithinRegions;
+    std::optional<Location> lastQueryLocation;
+};
+
+/**
+ * @class StateFile
+ *
+ * @discussion Keeps a PersistedState in a small versioned binary file.
+ *
+ * The file is a 16 byte header (magic, format version, payload size and a CRC-32 of the payload) followed by the
+ * payload.  Numbers are little-endian, strings are length-prefixed UTF-8.  Reading maps the file and decodes it in a
+ * single pass, which on a background relaunch is much cheaper than loading the app's whole user defaults domain.
+ *
+ * A file with another magic or version, a bad checksum or a truncated payload reads as corrupt, which callers must
+ * tell apart from a missing file: the state is gone either way, but only a missing file means there never was any.
+ * Writes go to a temporary file which is synced and renamed over the old one, so a crash leaves either the old or
+ * the new state.
+ */
+class StateFile {
+public:
+    static constexpr uint16_t kVersion = 1;
+    static constexpr std::size_t kHeaderSize = 16;
+
+    enum class ReadStatus {
+        Loaded,
+        Missing,
+        Corrupt
+    };
+
+    struct ReadResult {
+        ReadStatus status = ReadStatus::Missing;
+        std::optional<PersistedState> state;
+    };
+
+    explicit StateFile(std::string path);
+
+    const std::string& path() const { return path_; }
+
+    /**
+     * @brief Returns the persisted state, or why there is none
+     *
+     * @discussion An empty or unreadable file is corrupt, only a file which does not exist is missing.
+     */
+    ReadResult read() const;
+
+    /**
+     * @brief Replaces the file with the state, returns false if it could not be written
+     */
+    bool write(const PersistedState& state) const;
+
+    /**
+     * @brief Deletes the file, returns false if there was a file and it could not be deleted
+     */
+    bool remove() const;
+
+    /**
+     * @brief Path a corrupt file is kept at by moveToBackup()
+     */
+    std::string backupPath() const { return path_ + ".corrupt"; }
+
+    /**
+     * @brief Moves the file to backupPath(), replacing an earlier backup, returns false if it could not be moved
+     */
+    bool moveToBackup() const;
+
+    static std::vector<uint8_t> encode(const PersistedState& state);
+    static std::optional<PersistedState> decode(const uint8_t* data, std::size_t size);
+
+    /**
+     * @brief The CRC-32 (IEEE 802.3) of the bytes
+     */
+    static uint32_t checksum(const uint8_t* data, std::size_t size);
+
+private:
+    std::string path_;
+};
+
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// TrajectoryPredictor.hpp
+//
+
+#pragma once
+
+#include <vector>
+
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @class TrajectoryPredictor
+ *
+ * @discussion Estimates where the device will be from its recent location fixes.  Implementations must not keep
+ * state between calls, so one predictor can be shared and swapped freely.
+ */
+class TrajectoryPredictor {
+public:
+    virtual ~TrajectoryPredictor() = default;
+
+    /**
+     * @brief Predicts the location of the device some time after its newest fix
+     *
+     * @param history recent valid fixes, oldest first, never empty
+     * @param seconds how far past the newest fix to predict
+     * @param predicted on return, the predicted location with the timestamp at which the device is expected there
+     * @return false if the history does not allow a prediction
+     */
+    virtual bool predict(const std::vector<Location>& history, double seconds, Location& predicted) const = 0;
+};
+
+/**
+ * @class DeadReckoningPredictor
+ *
+ * @discussion Extrapolates the newest fix along a great circle at constant speed.
+ *
+ * The speed and course reported with the newest fix are used when both are valid.  Otherwise, which is common for
+ * significant location changes, the average velocity between the oldest fix within the history window and the
+ * newest fix is used instead.
+ */
+class DeadReckoningPredictor final : public TrajectoryPredictor {
+public:
+    /**
+     * @param historyWindow fixes older than this many seconds before the newest fix are not used to derive a velocity
+     */
+    explicit DeadReckoningPredictor(double historyWindow = kPrefetchHistoryWindow);
+
+    bool predict(const std::vector<Location>& history, double seconds, Location& predicted) const override;
+
+private:
+    double historyWindow_;
+};
+
+}
@@ -0,0 +1,137 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// TrajectoryPrefetcher.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/TrajectoryPredictor.hpp"
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+
+/**
+ * @class LocationHistory
+ *
+ * @discussion A fixed-size ring buffer of the most recent valid fixes, in the order they were taken.  Invalid fixes
+ * and fixes that are not newer than the newest fix in the buffer are ignored.
+ */
+class LocationHistory {
+public:
+    explicit LocationHistory(std::size_t capacity = kPrefetchHistorySize);
+
+    /**
+     * @return false if the fix was ignored
+     */
+    bool add(const Location& location);
+
+    /**
+     * @brief The buffered fixes, oldest first
+     */
+    std::vector<Location> fixes() const;
+
+    void clear();
+    std::size_t size() const { return count_; }
+    std::size_t capacity() const { return buffer_.size(); }
+
+private:
+    std::vector<Location> buffer_;
+    std::size_t next_ = 0;
+    std::size_t count_ = 0;
+};
+
+/**
+ * @brief Tuning for TrajectoryPrefetcher, the defaults mirror ACPPlacesMonitorConstants
+ *
+ * @discussion Prefetch points are spaced along the predicted path, up to horizon seconds ahead, and a prediction is
+ * a hit when a later fix lands within hitRadius meters of it, which is when a response cached for the point can
+ * answer that fix.
+ */
+struct PrefetchSettings {
+    std::size_t historySize = kPrefetchHistorySize;
+    double horizon = kPrefetchHorizon;
+    double minimumSpeed = kPrefetchMinimumSpeed;
+    double spacing = kPrefetchSpacing;
+    std::size_t maximumPoints = kPrefetchMaximumPoints;
+    double hitRadius = kPrefetchHitRadius;
+};
+
+/**
+ * @brief How well the predictor anticipated where the device went
+ */
+struct PrefetchStatistics {
+    std::uint64_t predictions = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+
+    /**
+     * @brief Share of the scored predictions that were hits, 0 before any prediction was scored
+     */
+    double hitRate() const { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0; }
+};
+
+/**
+ * @class TrajectoryPrefetcher
+ *
+ * @discussion Decides which locations ahead of a moving device should have their nearby POIs fetched before the
+ * device gets there.
+ *
+ * Every fix is added to a short history which the predictor extrapolates.  When the device is moving faster than
+ * the minimum speed, points are placed every spacing meters along the path it is expected to cover within the
+ * horizon, skipping points already covered by an earlier prediction.  Predictions stay pending until a fix lands
+ * within the hit radius (a hit) or the device is still elsewhere horizon seconds after it was expected there (a
+ * miss).
+ */
+class TrajectoryPrefetcher {
+public:
+    explicit TrajectoryPrefetcher(std::shared_ptr<const TrajectoryPredictor> predictor =
+                                      std::make_shared<DeadReckoningPredictor>(),
+                                  PrefetchSettings settings = PrefetchSettings());
+
+    /**
+     * @brief Scores the pending predictions against the fix, adds it to the history and plans the next prefetches
+     *
+     * @return the predicted locations to prefetch, nearest first, empty if nothing new needs to be fetched
+     */
+    std::vector<Location> onLocation(const Location& location);
+
+    /**
+     * @brief Forgets the history and the pending predictions without scoring them, the statistics are kept
+     */
+    void reset();
+
+    void setPredictor(std::shared_ptr<const TrajectoryPredictor> predictor);
+
+    const PrefetchStatistics& statistics() const { return statistics_; }
+    const PrefetchSettings& settings() const { return settings_; }
+    std::size_t pendingCount() const { return pending_.size(); }
+
+private:
+    void score(const Location& location);
+    bool isCovered(const Coordinate& coordinate) const;
+
+    std::shared_ptr<const TrajectoryPredictor> predictor_;
+    PrefetchSettings settings_;
+    LocationHistory history_;
+    std::vector<Location> pending_;
+    PrefetchStatistics statistics_;
+};
+
+}
@@ -0,0 +1,85 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// Types.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace placesmonitor {
+
+/**
+ * @brief A point on the earth, in degrees
+ */
+struct Coordinate {
+    double latitude = 0;
+    double longitude = 0;
+};
+
+/**
+ * @brief A location fix delivered by the platform
+ *
+ * @discussion A negative horizontal accuracy means the fix is invalid, matching CLLocation.  The timestamp is in
+ * seconds and only needs to be monotonic within one run.
+ */
+struct Location {
+    Coordinate coordinate;
+    double horizontalAccuracy = 0;
+    double speed = -1;
+    double course = -1;
+    double timestamp = 0;
+};
+
+/**
+ * @brief A point of interest returned by the POI source
+ */
+struct Poi {
+    std::string identifier;
+    Coordinate center;
+    double radius = 0;
+    bool userIsWithin = false;
+    std::string name;
+};
+
+/**
+ * @brief A circular region registered with the platform
+ */
+struct Region {
+    std::string identifier;
+    Coordinate center;
+    double radius = 0;
+    bool notifyOnEntry = true;
+    bool notifyOnExit = true;
+};
+
+/**
+ * @brief Location strategies, the values match ACPPlacesMonitorMode
+ */
+enum MonitorMode : unsigned {
+    MonitorModeContinuous = 1 << 0,
+    MonitorModeSignificantChanges = 1 << 1,
+    MonitorModeAdaptive = 1 << 2
+};
+
+/**
+ * @brief Location authorization levels, the values match ACPPlacesMonitorRequestAuthorizationLevel
+ */
+enum AuthorizationLevel : unsigned {
+    AuthorizationLevelWhenInUse = 1 << 0,
+    AuthorizationLevelAlways = 1 << 1
+};
+
+}
@@ -0,0 +1,55 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// AdaptivePolicy.cpp
+//
+
+#include "placesmonitor/AdaptivePolicy.hpp"
+
+namespace placesmonitor {
+
+AdaptiveState AdaptivePolicy::nextState(AdaptiveState state, double distance, double timeInState) const {
+    switch (state) {
+        case AdaptiveState::Far:
+            return distance <= nearDistance ? AdaptiveState::Approaching : AdaptiveState::Far;
+
+        case AdaptiveState::Approaching:
+            if (distance >= farDistance) {
+                return AdaptiveState::Far;
+            }
+
+            return timeInState >= continuousTimeLimit ? AdaptiveState::BackedOff : AdaptiveState::Approaching;
+
+        case AdaptiveState::BackedOff:
+            return distance >= farDistance ? AdaptiveState::Far : AdaptiveState::BackedOff;
+    }
+
+    return AdaptiveState::Far;
+}
+
+const char* AdaptivePolicy::name(AdaptiveState state) {
+    switch (state) {
+        case AdaptiveState::Far:
+            return "far";
+
+        case AdaptiveState::Approaching:
+            return "approaching";
+
+        case AdaptiveState::BackedOff:
+            return "backed off";
+    }
+
+    return "unknown";
+}
+
+}
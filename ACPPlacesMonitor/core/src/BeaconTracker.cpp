@@ -0,0 +1,113 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// BeaconTracker.cpp
+//
+
+#include "placesmonitor/BeaconTracker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace placesmonitor {
+
+bool BeaconIdentity::matches(const BeaconIdentity& beacon) const {
+    return uuid == beacon.uuid && (major < 0 || major == beacon.major) && (minor < 0 || minor == beacon.minor);
+}
+
+BeaconTracker::BeaconTracker(double entryDistance, double exitDistance, double exitTimeout)
+    : entryDistance_(entryDistance), exitDistance_(std::max(entryDistance, exitDistance)), exitTimeout_(exitTimeout) {}
+
+BeaconTracker::Transitions BeaconTracker::track(const std::vector<BeaconPoi>& pois) {
+    std::vector<State> states;
+    states.reserve(pois.size());
+
+    for (const BeaconPoi& poi : pois) {
+        auto existing = std::find_if(states_.begin(), states_.end(), [&poi](const State& state) {
+            return state.poi.identifier == poi.identifier;
+        });
+        State state;
+
+        // a POI whose beacon changed starts over
+        if (existing != states_.end() && existing->poi.beacon.uuid == poi.beacon.uuid &&
+            existing->poi.beacon.major == poi.beacon.major && existing->poi.beacon.minor == poi.beacon.minor) {
+            state = *existing;
+
+            // carried over, so it is not reported as exited below
+            existing->inside = false;
+        }
+
+        state.poi = poi;
+        states.push_back(state);
+    }
+
+    Transitions transitions;
+
+    for (const State& state : states_) {
+        if (state.inside) {
+            transitions.exited.push_back(state.poi.identifier);
+        }
+    }
+
+    states_ = std::move(states);
+    return transitions;
+}
+
+BeaconTracker::Transitions BeaconTracker::update(const std::vector<BeaconReading>& readings, double now) {
+    Transitions transitions;
+
+    for (State& state : states_) {
+        double closest = std::numeric_limits<double>::max();
+
+        for (const BeaconReading& reading : readings) {
+            if (reading.distance >= 0 && state.poi.beacon.matches(reading.beacon)) {
+                closest = std::min(closest, reading.distance);
+            }
+        }
+
+        if (!state.inside) {
+            if (closest <= entryDistance_) {
+                state.inside = true;
+                state.lastCloseAt = now;
+                transitions.entered.push_back(state.poi.identifier);
+            }
+        } else if (closest <= exitDistance_) {
+            state.lastCloseAt = now;
+        } else if (now - state.lastCloseAt >= exitTimeout_) {
+            state.inside = false;
+            transitions.exited.push_back(state.poi.identifier);
+        }
+    }
+
+    return transitions;
+}
+
+std::vector<std::string> BeaconTracker::uuids() const {
+    std::vector<std::string> uuids;
+
+    for (const State& state : states_) {
+        uuids.push_back(state.poi.beacon.uuid);
+    }
+
+    std::sort(uuids.begin(), uuids.end());
+    uuids.erase(std::unique(uuids.begin(), uuids.end()), uuids.end());
+    return uuids;
+}
+
+bool BeaconTracker::isInside(const std::string& identifier) const {
+    return std::any_of(states_.begin(), states_.end(), [&identifier](const State& state) {
+        return state.inside && state.poi.identifier == identifier;
+    });
+}
+
+}
@@ -0,0 +1,116 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ContainmentEngine.cpp
+//
+
+#include "placesmonitor/ContainmentEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "placesmonitor/Geo.hpp"
+
+namespace placesmonitor {
+
+namespace {
+
+constexpr double kRadiansPerDegree = M_PI / 180.0;
+
+}
+
+ContainmentEngine::ContainmentEngine(double minimumBand, double maximumAccuracy)
+    : minimumBand_(minimumBand), maximumAccuracy_(maximumAccuracy) {}
+
+void ContainmentEngine::load(const std::vector<Region>& regions) {
+    const std::size_t count = regions.size();
+    latitudes_.resize(count);
+    longitudes_.resize(count);
+    cosLatitudes_.resize(count);
+    radii_.resize(count);
+    distancesSquared_.resize(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        latitudes_[i] = regions[i].center.latitude * kRadiansPerDegree;
+        longitudes_[i] = regions[i].center.longitude * kRadiansPerDegree;
+        cosLatitudes_[i] = std::cos(latitudes_[i]);
+        radii_[i] = regions[i].radius;
+    }
+}
+
+bool ContainmentEngine::evaluate(const Location& location,
+                                 const std::vector<bool>& inside,
+                                 std::vector<std::size_t>& entered,
+                                 std::vector<std::size_t>& exited) {
+    entered.clear();
+    exited.clear();
+
+    const double accuracy = location.horizontalAccuracy;
+
+    if (accuracy < 0 || accuracy > maximumAccuracy_) {
+        return false;
+    }
+
+    computeDistancesSquared(location.coordinate);
+
+    const double band = std::max(minimumBand_, accuracy);
+    const std::size_t count = radii_.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (i >= inside.size() || !inside[i]) {
+            // a fix must be well inside the circle before it counts as an entry
+            const double enterDistance = radii_[i] - band;
+
+            if (enterDistance > 0 && distancesSquared_[i] <= enterDistance * enterDistance) {
+                entered.push_back(i);
+            }
+        } else {
+            const double exitDistance = radii_[i] + band;
+
+            if (distancesSquared_[i] >= exitDistance * exitDistance) {
+                exited.push_back(i);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @discussion The loop is branch free over contiguous arrays so the compiler can vectorize it.  The equirectangular
+ * approximation is well within a meter of the haversine distance at the scale of a geofence.
+ */
+void ContainmentEngine::computeDistancesSquared(const Coordinate& coordinate) {
+    const double latitude = coordinate.latitude * kRadiansPerDegree;
+    const double longitude = coordinate.longitude * kRadiansPerDegree;
+    const double radiusSquared = kEarthRadius * kEarthRadius;
+    const double* latitudes = latitudes_.data();
+    const double* longitudes = longitudes_.data();
+    const double* cosLatitudes = cosLatitudes_.data();
+    double* distancesSquared = distancesSquared_.data();
+    const std::size_t count = radii_.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        double deltaLongitude = longitude - longitudes[i];
+
+        // wrap across the antimeridian
+        deltaLongitude = deltaLongitude > M_PI ? deltaLongitude - 2 * M_PI : deltaLongitude;
+        deltaLongitude = deltaLongitude < -M_PI ? deltaLongitude + 2 * M_PI : deltaLongitude;
+
+        const double x = deltaLongitude * cosLatitudes[i];
+        const double y = latitude - latitudes[i];
+        distancesSquared[i] = (x * x + y * y) * radiusSquared;
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// Geo.cpp
+//
+
+#include "placesmonitor/Geo.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace placesmonitor {
+
+namespace {
+
+constexpr double kRadiansPerDegree = M_PI / 180.0;
+
+}
+
+double distanceBetween(const Coordinate& from, const Coordinate& to) {
+    const double fromLatitude = from.latitude * kRadiansPerDegree;
+    const double toLatitude = to.latitude * kRadiansPerDegree;
+    const double sinHalfLatitude = std::sin((toLatitude - fromLatitude) / 2);
+    const double sinHalfLongitude = std::sin((to.longitude - from.longitude) * kRadiansPerDegree / 2);
+    const double a = sinHalfLatitude * sinHalfLatitude +
+                     std::cos(fromLatitude) * std::cos(toLatitude) * sinHalfLongitude * sinHalfLongitude;
+
+    return 2 * kEarthRadius * std::asin(std::sqrt(std::min(1.0, a)));
+}
+
+double edgeDistance(const Coordinate& from, const Coordinate& center, double radius) {
+    return distanceBetween(from, center) - radius;
+}
+
+double bearingBetween(const Coordinate& from, const Coordinate& to) {
+    const double fromLatitude = from.latitude * kRadiansPerDegree;
+    const double toLatitude = to.latitude * kRadiansPerDegree;
+    const double deltaLongitude = (to.longitude - from.longitude) * kRadiansPerDegree;
+    const double y = std::sin(deltaLongitude) * std::cos(toLatitude);
+    const double x = std::cos(fromLatitude) * std::sin(toLatitude) -
+                     std::sin(fromLatitude) * std::cos(toLatitude) * std::cos(deltaLongitude);
+
+    return std::fmod(std::atan2(y, x) / kRadiansPerDegree + 360, 360);
+}
+
+Coordinate destination(const Coordinate& from, double bearing, double distance) {
+    const double latitude = from.latitude * kRadiansPerDegree;
+    const double longitude = from.longitude * kRadiansPerDegree;
+    const double angle = bearing * kRadiansPerDegree;
+    const double arc = distance / kEarthRadius;
+    const double toLatitude = std::asin(std::sin(latitude) * std::cos(arc) +
+                                        std::cos(latitude) * std::sin(arc) * std::cos(angle));
+    const double toLongitude = longitude + std::atan2(std::sin(angle) * std::sin(arc) * std::cos(latitude),
+                                                      std::cos(arc) - std::sin(latitude) * std::sin(toLatitude));
+
+    // normalized to [-180, 180) so paths across the antimeridian stay valid coordinates
+    return Coordinate{toLatitude / kRadiansPerDegree,
+                      std::fmod(toLongitude / kRadiansPerDegree + 540, 360) - 180};
+}
+
+}
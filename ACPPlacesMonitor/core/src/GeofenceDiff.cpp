@@ -0,0 +1,82 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// GeofenceDiff.cpp
+//
+
+#include "placesmonitor/GeofenceDiff.hpp"
+
+#include <cmath>
+#include <unordered_map>
+
+#include "placesmonitor/Constants.hpp"
+
+namespace placesmonitor {
+
+GeofenceDiff GeofenceDiff::compute(const std::vector<Region>& desired,
+                                   const std::vector<Region>& monitored,
+                                   const std::unordered_set<std::string>& owned) {
+    GeofenceDiff diff;
+
+    // index the regions we own by identifier
+    std::unordered_map<std::string, std::size_t> registered;
+    registered.reserve(monitored.size());
+
+    for (std::size_t i = 0; i < monitored.size(); i++) {
+        if (owned.count(monitored[i].identifier)) {
+            registered.emplace(monitored[i].identifier, i);
+        }
+    }
+
+    std::unordered_set<std::string> desiredIdentifiers;
+    desiredIdentifiers.reserve(desired.size());
+
+    for (std::size_t i = 0; i < desired.size(); i++) {
+        if (!desiredIdentifiers.insert(desired[i].identifier).second) {
+            continue;
+        }
+
+        const auto current = registered.find(desired[i].identifier);
+
+        if (current == registered.end()) {
+            diff.toStart_.push_back(i);
+            diff.addedCount_++;
+        } else if (hasSameGeometry(monitored[current->second], desired[i])) {
+            diff.kept_.push_back(i);
+        } else {
+            diff.toStop_.push_back(current->second);
+            diff.toStart_.push_back(i);
+            diff.updatedCount_++;
+        }
+    }
+
+    // walk the monitored regions rather than the map so the stop order is stable
+    for (std::size_t i = 0; i < monitored.size(); i++) {
+        const auto current = registered.find(monitored[i].identifier);
+
+        if (current != registered.end() && current->second == i && !desiredIdentifiers.count(monitored[i].identifier)) {
+            diff.toStop_.push_back(i);
+            diff.removedCount_++;
+        }
+    }
+
+    return diff;
+}
+
+bool GeofenceDiff::hasSameGeometry(const Region& region, const Region& other) {
+    return std::fabs(region.center.latitude - other.center.latitude) < kGeofenceCenterTolerance &&
+           std::fabs(region.center.longitude - other.center.longitude) < kGeofenceCenterTolerance &&
+           std::fabs(region.radius - other.radius) < kGeofenceRadiusTolerance;
+}
+
+}
@@ -0,0 +1,428 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// PoiPack.cpp
+//
+
+#include "placesmonitor/PoiPack.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include "placesmonitor/Geo.hpp"
+
+namespace placesmonitor {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'P', 'M', 'P', 'K'};
+
+// cells smaller than about 10 meters or larger than about 1000 km make no sense for region monitoring
+constexpr double kMinimumCellSize = 0.0001;
+constexpr double kMaximumCellSize = 10.0;
+
+constexpr double kRadiansPerDegree = M_PI / 180.0;
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+uint64_t load(const uint8_t* data, int byteCount) {
+    uint64_t value = 0;
+
+    for (int i = 0; i < byteCount; i++) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+
+    return value;
+}
+
+uint16_t loadU16(const uint8_t* data) { return static_cast<uint16_t>(load(data, 2)); }
+uint32_t loadU32(const uint8_t* data) { return static_cast<uint32_t>(load(data, 4)); }
+uint64_t loadU64(const uint8_t* data) { return load(data, 8); }
+
+double loadF64(const uint8_t* data) {
+    const uint64_t bits = load(data, 8);
+    double value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void store(std::vector<uint8_t>& bytes, uint64_t value, int byteCount) {
+    for (int i = 0; i < byteCount; i++) {
+        bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void storeF64(std::vector<uint8_t>& bytes, double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    store(bytes, bits, 8);
+}
+
+uint32_t gridLength(double degrees, double cellSize) {
+    return static_cast<uint32_t>(std::ceil(degrees / cellSize));
+}
+
+uint32_t rowOf(double latitude, double cellSize, uint32_t rows) {
+    const double row = std::floor((std::clamp(latitude, -90.0, 90.0) + 90) / cellSize);
+    return std::min(static_cast<uint32_t>(std::max(row, 0.0)), rows - 1);
+}
+
+uint32_t columnOf(double longitude, double cellSize, uint32_t columns) {
+    const double normalized = std::fmod(std::fmod(longitude + 180, 360) + 360, 360);
+    return std::min(static_cast<uint32_t>(normalized / cellSize), columns - 1);
+}
+
+// a record that did not make it into the result yet, ordered so the farthest one is on top of the heap
+using Candidate = std::pair<double, std::size_t>;
+
+}
+
+std::optional<PoiPack> PoiPack::open(const std::string& path) {
+    MappedFile file(path);
+
+    if (!file.isOpen()) {
+        return std::nullopt;
+    }
+
+    PoiPack pack;
+    pack.data_ = file.data();
+    pack.size_ = file.size();
+    pack.file_.emplace(std::move(file));
+    return validate(std::move(pack));
+}
+
+std::optional<PoiPack> PoiPack::decode(std::vector<uint8_t> bytes) {
+    PoiPack pack;
+    pack.bytes_ = std::move(bytes);
+    pack.data_ = pack.bytes_.data();
+    pack.size_ = pack.bytes_.size();
+    return validate(std::move(pack));
+}
+
+std::optional<PoiPack> PoiPack::validate(PoiPack pack) {
+    const uint8_t* data = pack.data_;
+
+    if (!data || pack.size_ < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0 ||
+        loadU16(data + 4) != kVersion) {
+        return std::nullopt;
+    }
+
+    const uint64_t poiCount = loadU32(data + 8);
+    const uint64_t cellCount = loadU32(data + 12);
+    const uint64_t stringsSize = loadU32(data + 32);
+    pack.revision_ = loadU64(data + 16);
+    pack.cellSize_ = loadF64(data + 24);
+
+    if (!(pack.cellSize_ >= kMinimumCellSize && pack.cellSize_ <= kMaximumCellSize) ||
+        kHeaderSize + cellCount * kCellSize + poiCount * kRecordSize + stringsSize != pack.size_) {
+        return std::nullopt;
+    }
+
+    pack.poiCount_ = static_cast<std::size_t>(poiCount);
+    pack.cellCount_ = static_cast<std::size_t>(cellCount);
+    pack.rows_ = gridLength(180, pack.cellSize_);
+    pack.columns_ = gridLength(360, pack.cellSize_);
+    pack.cells_ = data + kHeaderSize;
+    pack.records_ = pack.cells_ + cellCount * kCellSize;
+    pack.strings_ = pack.records_ + poiCount * kRecordSize;
+    pack.stringsSize_ = static_cast<std::size_t>(stringsSize);
+
+    // cells must be sorted, in range, and cover every record exactly once for the searches to be safe
+    uint64_t previousKey = 0;
+    uint64_t nextRecord = 0;
+
+    for (std::size_t i = 0; i < pack.cellCount_; i++) {
+        const uint8_t* cell = pack.cells_ + i * kCellSize;
+        const uint32_t row = loadU32(cell);
+        const uint32_t column = loadU32(cell + 4);
+        const uint64_t key = (static_cast<uint64_t>(row) << 32 | column) + 1;
+
+        if (row >= pack.rows_ || column >= pack.columns_ || key <= previousKey || loadU32(cell + 8) != nextRecord ||
+            loadU32(cell + 12) == 0) {
+            return std::nullopt;
+        }
+
+        previousKey = key;
+        nextRecord += loadU32(cell + 12);
+    }
+
+    if (nextRecord != poiCount) {
+        return std::nullopt;
+    }
+
+    return pack;
+}
+
+std::vector<uint8_t> PoiPack::encode(const std::vector<Poi>& pois, uint64_t revision, double cellSize) {
+    cellSize = std::clamp(std::isfinite(cellSize) ? cellSize : kPoiPackCellSize, kMinimumCellSize, kMaximumCellSize);
+    const uint32_t rows = gridLength(180, cellSize);
+    const uint32_t columns = gridLength(360, cellSize);
+
+    // POIs without a usable center could never be returned by a query
+    struct Entry {
+        uint32_t row;
+        uint32_t column;
+        const Poi* poi;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(pois.size());
+
+    for (const Poi& poi : pois) {
+        if (std::isfinite(poi.center.latitude) && std::isfinite(poi.center.longitude) &&
+            std::abs(poi.center.latitude) <= 90) {
+            entries.push_back(Entry{rowOf(poi.center.latitude, cellSize, rows),
+                                    columnOf(poi.center.longitude, cellSize, columns), &poi});
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.row != b.row ? a.row < b.row : a.column < b.column;
+    });
+
+    std::vector<uint8_t> cells;
+    std::vector<uint8_t> records;
+    std::vector<uint8_t> strings;
+    uint32_t cellCount = 0;
+
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        const Entry& entry = entries[i];
+
+        if (i == 0 || entry.row != entries[i - 1].row || entry.column != entries[i - 1].column) {
+            std::size_t end = i;
+
+            while (end < entries.size() && entries[end].row == entry.row && entries[end].column == entry.column) {
+                end++;
+            }
+
+            store(cells, entry.row, 4);
+            store(cells, entry.column, 4);
+            store(cells, i, 4);
+            store(cells, end - i, 4);
+            cellCount++;
+        }
+
+        const Poi& poi = *entry.poi;
+        storeF64(records, poi.center.latitude);
+        storeF64(records, poi.center.longitude);
+        storeF64(records, poi.radius);
+        store(records, strings.size(), 4);
+        store(records, poi.identifier.size(), 4);
+        strings.insert(strings.end(), poi.identifier.begin(), poi.identifier.end());
+        store(records, strings.size(), 4);
+        store(records, poi.name.size(), 4);
+        strings.insert(strings.end(), poi.name.begin(), poi.name.end());
+    }
+
+    std::vector<uint8_t> bytes(std::begin(kMagic), std::end(kMagic));
+    bytes.reserve(kHeaderSize + cells.size() + records.size() + strings.size());
+    store(bytes, kVersion, 2);
+    store(bytes, 0, 2);
+    store(bytes, entries.size(), 4);
+    store(bytes, cellCount, 4);
+    store(bytes, revision, 8);
+    storeF64(bytes, cellSize);
+    store(bytes, strings.size(), 4);
+    store(bytes, 0, 4);
+    bytes.insert(bytes.end(), cells.begin(), cells.end());
+    bytes.insert(bytes.end(), records.begin(), records.end());
+    bytes.insert(bytes.end(), strings.begin(), strings.end());
+
+    return bytes;
+}
+
+std::vector<Poi> PoiPack::nearest(const Coordinate& coordinate, std::size_t count, double maximumDistance) const {
+    if (!poiCount_ || !count || !std::isfinite(coordinate.latitude) || !std::isfinite(coordinate.longitude)) {
+        return {};
+    }
+
+    const double latitude = std::clamp(coordinate.latitude, -90.0, 90.0);
+    const double longitude = std::fmod(std::fmod(coordinate.longitude + 180, 360) + 360, 360) - 180;
+    const Coordinate origin{latitude, longitude};
+    const int64_t originRow = rowOf(latitude, cellSize_, rows_);
+    const int64_t originColumn = columnOf(longitude, cellSize_, columns_);
+    const int64_t columns = columns_;
+    std::priority_queue<Candidate> candidates;
+    std::size_t visitedCells = 0;
+
+    const auto visitCell = [&](std::size_t cellIndex) {
+        visitedCells++;
+        const uint8_t* cell = cells_ + cellIndex * kCellSize;
+        const std::size_t first = loadU32(cell + 8);
+        const std::size_t last = first + loadU32(cell + 12);
+
+        for (std::size_t index = first; index < last; index++) {
+            const double distance = distanceBetween(origin, recordCenter(index));
+
+            if (!(distance <= maximumDistance)) {
+                continue;
+            }
+
+            if (candidates.size() < count) {
+                candidates.emplace(distance, index);
+            } else if (Candidate(distance, index) < candidates.top()) {
+                candidates.pop();
+                candidates.emplace(distance, index);
+            }
+        }
+    };
+
+    // the cells of one row within a range of columns, which sit next to each other in the sorted cell table
+    const auto visitColumns = [&](uint32_t row, int64_t fromColumn, int64_t width) {
+        width = std::min(width, columns);
+        const int64_t start = ((fromColumn % columns) + columns) % columns;
+        const int64_t segments[2][2] = {{start, std::min(start + width, columns)},
+                                        {0, std::max<int64_t>(start + width - columns, 0)}};
+
+        for (const auto& segment : segments) {
+            if (segment[0] >= segment[1]) {
+                continue;
+            }
+
+            for (std::size_t i = firstCellAtOrAfter(row, static_cast<uint32_t>(segment[0])); i < cellCount_; i++) {
+                const uint8_t* cell = cells_ + i * kCellSize;
+
+                if (loadU32(cell) != row || loadU32(cell + 4) >= segment[1]) {
+                    break;
+                }
+
+                visitCell(i);
+            }
+        }
+    };
+
+    const double latitudeRadians = latitude * kRadiansPerDegree;
+
+    for (int64_t ring = 0;; ring++) {
+        for (int64_t row = originRow - ring; row <= originRow + ring; row++) {
+            if (row < 0 || row >= rows_) {
+                continue;
+            }
+
+            if (row == originRow - ring || row == originRow + ring) {
+                visitColumns(static_cast<uint32_t>(row), originColumn - ring, 2 * ring + 1);
+            } else if (2 * ring - 1 < columns) {
+                // the rows in between only gain the two columns at the sides, which are one cell once they meet
+                visitColumns(static_cast<uint32_t>(row), originColumn - ring, 1);
+
+                if ((2 * ring) % columns != 0) {
+                    visitColumns(static_cast<uint32_t>(row), originColumn + ring, 1);
+                }
+            }
+        }
+
+        // a lower bound on the distance to any cell outside the rings searched so far
+        const double southEdge = -90 + (originRow - ring) * cellSize_;
+        const double northEdge = -90 + (originRow + ring + 1) * cellSize_;
+        const double latitudeBound = std::min(originRow - ring > 0 ? latitude - southEdge : kInfinity,
+                                              originRow + ring + 1 < rows_ ? northEdge - latitude : kInfinity) *
+                                     kRadiansPerDegree * kEarthRadius;
+        double longitudeBound = kInfinity;
+
+        if (2 * ring + 1 < columns) {
+            const double westEdge = -180 + (originColumn - ring) * cellSize_;
+            const double eastEdge = -180 + (originColumn + ring + 1) * cellSize_;
+            const double gap = std::min(longitude - westEdge, eastEdge - longitude) * kRadiansPerDegree;
+            const double widestLatitude = std::min(std::max(std::abs(southEdge), std::abs(northEdge)), 90.0);
+            const double cosines = std::cos(latitudeRadians) * std::cos(widestLatitude * kRadiansPerDegree);
+            longitudeBound = 2 * kEarthRadius * std::asin(std::min(1.0, std::sqrt(std::max(cosines, 0.0)) *
+                                                                        std::sin(std::min(gap, M_PI) / 2)));
+        }
+
+        const double bound = std::min(latitudeBound, longitudeBound);
+
+        if (bound > maximumDistance || bound == kInfinity || visitedCells == cellCount_ ||
+            (candidates.size() == count && bound >= candidates.top().first)) {
+            break;
+        }
+    }
+
+    std::vector<Candidate> nearest;
+    nearest.reserve(candidates.size());
+
+    while (!candidates.empty()) {
+        nearest.push_back(candidates.top());
+        candidates.pop();
+    }
+
+    std::vector<Poi> pois;
+    pois.reserve(nearest.size());
+
+    for (auto candidate = nearest.rbegin(); candidate != nearest.rend(); ++candidate) {
+        Poi poi;
+
+        if (readRecord(candidate->second, poi)) {
+            poi.userIsWithin = candidate->first <= poi.radius;
+            pois.push_back(std::move(poi));
+        }
+    }
+
+    return pois;
+}
+
+std::optional<Poi> PoiPack::poiAt(std::size_t index) const {
+    Poi poi;
+
+    if (index >= poiCount_ || !readRecord(index, poi)) {
+        return std::nullopt;
+    }
+
+    return poi;
+}
+
+std::size_t PoiPack::firstCellAtOrAfter(uint32_t row, uint32_t column) const {
+    const uint64_t key = static_cast<uint64_t>(row) << 32 | column;
+    std::size_t low = 0;
+    std::size_t high = cellCount_;
+
+    while (low < high) {
+        const std::size_t middle = low + (high - low) / 2;
+        const uint8_t* cell = cells_ + middle * kCellSize;
+
+        if ((static_cast<uint64_t>(loadU32(cell)) << 32 | loadU32(cell + 4)) < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+bool PoiPack::readRecord(std::size_t index, Poi& poi) const {
+    const uint8_t* record = records_ + index * kRecordSize;
+    const uint64_t identifierOffset = loadU32(record + 24);
+    const uint64_t identifierLength = loadU32(record + 28);
+    const uint64_t nameOffset = loadU32(record + 32);
+    const uint64_t nameLength = loadU32(record + 36);
+
+    if (identifierOffset + identifierLength > stringsSize_ || nameOffset + nameLength > stringsSize_) {
+        return false;
+    }
+
+    poi.identifier.assign(reinterpret_cast<const char*>(strings_ + identifierOffset), identifierLength);
+    poi.name.assign(reinterpret_cast<const char*>(strings_ + nameOffset), nameLength);
+    poi.center = recordCenter(index);
+    poi.radius = loadF64(record + 16);
+    poi.userIsWithin = false;
+    return true;
+}
+
+Coordinate PoiPack::recordCenter(std::size_t index) const {
+    const uint8_t* record = records_ + index * kRecordSize;
+    return Coordinate{loadF64(record), loadF64(record + 8)};
+}
+
+}
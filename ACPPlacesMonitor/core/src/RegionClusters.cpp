@@ -0,0 +1,272 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// RegionClusters.cpp
+//
+
+#include "placesmonitor/RegionClusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "placesmonitor/Geo.hpp"
+
+namespace placesmonitor {
+
+namespace {
+
+constexpr double kRadiansPerDegree = M_PI / 180.0;
+
+// points closer than this are treated as being on the circle
+constexpr double kContainmentTolerance = 0.000001;
+
+struct Point {
+    double x = 0;
+    double y = 0;
+};
+
+struct Circle {
+    Point center;
+    double radius = 0;
+};
+
+// equirectangular projection in meters around the reference, cluster sized areas are distorted by well under a meter
+Point project(const Coordinate& reference, const Coordinate& coordinate) {
+    return Point{(coordinate.longitude - reference.longitude) * kRadiansPerDegree * kEarthRadius *
+                 std::cos(reference.latitude * kRadiansPerDegree),
+                 (coordinate.latitude - reference.latitude) * kRadiansPerDegree * kEarthRadius};
+}
+
+Coordinate unproject(const Coordinate& reference, const Point& point) {
+    return Coordinate{reference.latitude + point.y / kEarthRadius / kRadiansPerDegree,
+                      reference.longitude + point.x / (kEarthRadius * std::cos(reference.latitude * kRadiansPerDegree)) /
+                                            kRadiansPerDegree};
+}
+
+double distance(const Point& from, const Point& to) {
+    return std::hypot(to.x - from.x, to.y - from.y);
+}
+
+bool contains(const Circle& circle, const Point& point) {
+    return distance(circle.center, point) <= circle.radius + kContainmentTolerance;
+}
+
+// the smallest circle enclosing two circles
+Circle enclose(const Circle& first, const Circle& second) {
+    const double between = distance(first.center, second.center);
+
+    if (between + second.radius <= first.radius) {
+        return first;
+    }
+
+    if (between + first.radius <= second.radius) {
+        return second;
+    }
+
+    const double radius = (between + first.radius + second.radius) / 2;
+    const double t = (radius - first.radius) / between;
+
+    return Circle{Point{first.center.x + (second.center.x - first.center.x) * t,
+                        first.center.y + (second.center.y - first.center.y) * t}, radius};
+}
+
+Circle circleThrough(const Point& first, const Point& second) {
+    const Point center{(first.x + second.x) / 2, (first.y + second.y) / 2};
+    return Circle{center, distance(center, first)};
+}
+
+Circle circleThrough(const Point& first, const Point& second, const Point& third) {
+    const double bx = second.x - first.x;
+    const double by = second.y - first.y;
+    const double cx = third.x - first.x;
+    const double cy = third.y - first.y;
+    const double d = 2 * (bx * cy - by * cx);
+
+    // collinear points, the circle through the two farthest apart encloses the third
+    if (std::fabs(d) < kContainmentTolerance) {
+        Circle widest = circleThrough(first, second);
+
+        for (const Circle& candidate : {circleThrough(first, third), circleThrough(second, third)}) {
+            if (candidate.radius > widest.radius) {
+                widest = candidate;
+            }
+        }
+
+        return widest;
+    }
+
+    const double b = bx * bx + by * by;
+    const double c = cx * cx + cy * cy;
+    const Point center{first.x + (cy * b - by * c) / d, first.y + (bx * c - cx * b) / d};
+
+    return Circle{center, distance(center, first)};
+}
+
+// Welzl's minimum enclosing circle, written iteratively, the member lists are small
+Circle enclosePoints(const std::vector<Point>& points) {
+    Circle circle{points[0], 0};
+
+    for (std::size_t i = 1; i < points.size(); i++) {
+        if (contains(circle, points[i])) {
+            continue;
+        }
+
+        circle = Circle{points[i], 0};
+
+        for (std::size_t j = 0; j < i; j++) {
+            if (contains(circle, points[j])) {
+                continue;
+            }
+
+            circle = circleThrough(points[i], points[j]);
+
+            for (std::size_t k = 0; k < j; k++) {
+                if (!contains(circle, points[k])) {
+                    circle = circleThrough(points[i], points[j], points[k]);
+                }
+            }
+        }
+    }
+
+    return circle;
+}
+
+struct Group {
+    std::vector<std::size_t> members;
+    Circle circle;
+    bool merged = false;
+};
+
+}
+
+RegionClusters RegionClusters::build(const std::vector<Poi>& pois, double maximumRadius, double maximumGap) {
+    RegionClusters result;
+    result.poiCount_ = pois.size();
+
+    const std::size_t count = pois.size();
+    std::vector<Group> groups(count);
+    std::vector<Circle> circles(count);
+    const Coordinate reference = count ? pois.front().center : Coordinate{};
+
+    for (std::size_t i = 0; i < count; i++) {
+        circles[i] = Circle{project(reference, pois[i].center), pois[i].radius};
+        groups[i].members.push_back(i);
+        groups[i].circle = circles[i];
+    }
+
+    // links between groups, a POI larger than a cluster may be is never linked
+    std::vector<bool> links(count * count, false);
+
+    for (std::size_t i = 0; maximumRadius > 0 && i < count; i++) {
+        for (std::size_t j = i + 1; j < count; j++) {
+            const bool linked = pois[i].radius <= maximumRadius && pois[j].radius <= maximumRadius &&
+                                distanceBetween(pois[i].center, pois[j].center) - pois[i].radius - pois[j].radius <= maximumGap;
+            links[i * count + j] = linked;
+            links[j * count + i] = linked;
+        }
+    }
+
+    while (true) {
+        std::size_t bestFirst = count;
+        std::size_t bestSecond = count;
+        Circle best;
+
+        for (std::size_t i = 0; i < count; i++) {
+            for (std::size_t j = i + 1; !groups[i].merged && j < count; j++) {
+                if (groups[j].merged || !links[i * count + j]) {
+                    continue;
+                }
+
+                const Circle candidate = enclose(groups[i].circle, groups[j].circle);
+
+                if (candidate.radius <= maximumRadius && (bestFirst == count || candidate.radius < best.radius)) {
+                    bestFirst = i;
+                    bestSecond = j;
+                    best = candidate;
+                }
+            }
+        }
+
+        if (bestFirst == count) {
+            break;
+        }
+
+        Group& group = groups[bestFirst];
+        group.members.insert(group.members.end(), groups[bestSecond].members.begin(), groups[bestSecond].members.end());
+        groups[bestSecond].merged = true;
+
+        for (std::size_t k = 0; k < count; k++) {
+            const bool linked = links[bestFirst * count + k] || links[bestSecond * count + k];
+            links[bestFirst * count + k] = linked;
+            links[k * count + bestFirst] = linked;
+        }
+
+        // the circle around the member centers, grown to cover their radii, is usually tighter than the pairwise one
+        std::vector<Point> centers;
+
+        for (std::size_t member : group.members) {
+            centers.push_back(circles[member].center);
+        }
+
+        Circle tight = enclosePoints(centers);
+        tight.radius = 0;
+
+        for (std::size_t member : group.members) {
+            tight.radius = std::max(tight.radius, distance(tight.center, circles[member].center) + circles[member].radius);
+        }
+
+        group.circle = tight.radius < best.radius ? tight : best;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        Group& group = groups[i];
+
+        if (group.merged) {
+            continue;
+        }
+
+        if (group.members.size() == 1) {
+            result.unclustered_.push_back(i);
+            continue;
+        }
+
+        std::sort(group.members.begin(), group.members.end());
+
+        Cluster cluster;
+        cluster.members = group.members;
+        cluster.region.center = unproject(reference, group.circle.center);
+
+        // named after its smallest member identifier, so a refresh with the same members keeps the same region
+        std::string name = pois[group.members.front()].identifier;
+
+        for (std::size_t member : group.members) {
+            name = std::min(name, pois[member].identifier);
+
+            // measured on the sphere, so the region is sure to contain every member
+            cluster.region.radius = std::max(cluster.region.radius,
+                                             distanceBetween(cluster.region.center, pois[member].center) + pois[member].radius);
+        }
+
+        cluster.region.identifier = kClusterRegionIdentifierPrefix + name;
+        result.clusters_.push_back(std::move(cluster));
+    }
+
+    return result;
+}
+
+bool RegionClusters::isClusterRegion(const std::string& identifier) {
+    const std::string prefix = kClusterRegionIdentifierPrefix;
+    return identifier.size() > prefix.size() && identifier.compare(0, prefix.size(), prefix) == 0;
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// RegionSchedule.cpp
+//
+
+#include "placesmonitor/RegionSchedule.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/Geo.hpp"
+
+namespace placesmonitor {
+
+RegionSchedule RegionSchedule::build(const std::vector<Poi>& candidates,
+                                     const Coordinate& location,
+                                     std::size_t slotCount,
+                                     double maximumRadius) {
+    RegionSchedule schedule;
+
+    // without room for both a POI and the boundary, fall back to registering what fits
+    if (candidates.size() <= slotCount || slotCount < 2) {
+        const std::size_t count = std::min(candidates.size(), slotCount);
+        schedule.selected_.resize(count);
+        std::iota(schedule.selected_.begin(), schedule.selected_.end(), 0);
+        schedule.deferredCount_ = candidates.size() - count;
+        return schedule;
+    }
+
+    // calculate each edge distance once, a negative value means the device is inside the POI
+    std::vector<double> edgeDistances(candidates.size());
+    std::vector<std::size_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    for (std::size_t i = 0; i < candidates.size(); i++) {
+        edgeDistances[i] = edgeDistance(location, candidates[i].center, candidates[i].radius);
+    }
+
+    // only the best slotCount candidates need to be in order, the last one decides the boundary
+    const std::size_t poiSlots = slotCount - 1;
+    std::partial_sort(order.begin(), order.begin() + slotCount, order.end(), [&](std::size_t first, std::size_t second) {
+        return edgeDistances[first] < edgeDistances[second] ||
+               (edgeDistances[first] == edgeDistances[second] && first < second);
+    });
+
+    schedule.selected_.assign(order.begin(), order.begin() + poiSlots);
+
+    // the device has to travel at least this far before it can enter a POI that did not get a slot
+    double radius = std::max(edgeDistances[order[poiSlots]], kBoundaryMinimumRadius);
+
+    if (maximumRadius > 0) {
+        radius = std::min(radius, maximumRadius);
+    }
+
+    Region boundary;
+    boundary.identifier = kBoundaryRegionIdentifier;
+    boundary.center = location;
+    boundary.radius = radius;
+    boundary.notifyOnEntry = false;
+    boundary.notifyOnExit = true;
+
+    schedule.boundary_ = boundary;
+    schedule.deferredCount_ = candidates.size() - poiSlots;
+
+    return schedule;
+}
+
+bool RegionSchedule::isBoundaryRegion(const std::string& identifier) {
+    return identifier == kBoundaryRegionIdentifier;
+}
+
+}
@@ -0,0 +1,343 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// StateFile.cpp
+//
+
+#include "placesmonitor/StateFile.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "placesmonitor/MappedFile.hpp"
+
+namespace placesmonitor {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'P', 'M', 'S', 'T'};
+
+// which optional values are present in the payload
+enum FieldFlag : uint8_t {
+    FieldMonitorMode = 1 << 0,
+    FieldAuthorizationLevel = 1 << 1,
+    FieldMonitoringStarted = 1 << 2,
+    FieldLastQueryLocation = 1 << 3
+};
+
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t>& bytes) : bytes_(bytes) {}
+
+    void u8(uint8_t value) { bytes_.push_back(value); }
+
+    void u16(uint16_t value) { integer(value, 2); }
+
+    void u32(uint32_t value) { integer(value, 4); }
+
+    void i64(int64_t value) { integer(static_cast<uint64_t>(value), 8); }
+
+    void f64(double value) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        integer(bits, 8);
+    }
+
+    void strings(const std::vector<std::string>& values) {
+        u32(static_cast<uint32_t>(values.size()));
+
+        for (const auto& value : values) {
+            u32(static_cast<uint32_t>(value.size()));
+            bytes_.insert(bytes_.end(), value.begin(), value.end());
+        }
+    }
+
+private:
+    void integer(uint64_t value, int byteCount) {
+        for (int i = 0; i < byteCount; i++) {
+            bytes_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    std::vector<uint8_t>& bytes_;
+};
+
+// every read is bounds checked, once a read fails the reader stays failed
+class Reader {
+public:
+    Reader(const uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return offset_ == size_; }
+
+    uint8_t u8() { return static_cast<uint8_t>(integer(1)); }
+    uint16_t u16() { return static_cast<uint16_t>(integer(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(integer(4)); }
+    int64_t i64() { return static_cast<int64_t>(integer(8)); }
+
+    double f64() {
+        const uint64_t bits = integer(8);
+        double value = 0;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::vector<std::string> strings() {
+        std::vector<std::string> values;
+        const uint32_t count = u32();
+
+        // each string takes at least its length prefix, a count larger than that is corrupt
+        if (!ok_ || count > (size_ - offset_) / 4) {
+            ok_ = false;
+            return values;
+        }
+
+        values.reserve(count);
+
+        for (uint32_t i = 0; i < count && ok_; i++) {
+            const uint32_t length = u32();
+
+            if (!ok_ || length > size_ - offset_) {
+                ok_ = false;
+                break;
+            }
+
+            values.emplace_back(reinterpret_cast<const char*>(data_ + offset_), length);
+            offset_ += length;
+        }
+
+        return values;
+    }
+
+private:
+    uint64_t integer(std::size_t byteCount) {
+        if (!ok_ || byteCount > size_ - offset_) {
+            ok_ = false;
+            return 0;
+        }
+
+        uint64_t value = 0;
+
+        for (std::size_t i = 0; i < byteCount; i++) {
+            value |= static_cast<uint64_t>(data_[offset_ + i]) << (8 * i);
+        }
+
+        offset_ += byteCount;
+        return value;
+    }
+
+    const uint8_t* data_;
+    std::size_t size_;
+    std::size_t offset_ = 0;
+    bool ok_ = true;
+};
+
+std::array<uint32_t, 256> makeChecksumTable() {
+    std::array<uint32_t, 256> table {};
+
+    for (uint32_t i = 0; i < table.size(); i++) {
+        uint32_t value = i;
+
+        for (int bit = 0; bit < 8; bit++) {
+            value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+        }
+
+        table[i] = value;
+    }
+
+    return table;
+}
+
+bool writeAll(int descriptor, const uint8_t* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t written = ::write(descriptor, data, size);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+
+    return true;
+}
+
+}
+
+StateFile::StateFile(std::string path) : path_(std::move(path)) {
+}
+
+StateFile::ReadResult StateFile::read() const {
+    const MappedFile file(path_);
+    ReadResult result;
+
+    if (!file.isOpen()) {
+        struct stat info;
+        const bool exists = ::stat(path_.c_str(), &info) == 0 || errno != ENOENT;
+        result.status = exists ? ReadStatus::Corrupt : ReadStatus::Missing;
+        return result;
+    }
+
+    result.state = decode(file.data(), file.size());
+    result.status = result.state ? ReadStatus::Loaded : ReadStatus::Corrupt;
+    return result;
+}
+
+bool StateFile::write(const PersistedState& state) const {
+    const std::vector<uint8_t> bytes = encode(state);
+    const std::string temporaryPath = path_ + ".tmp";
+    const int descriptor = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+
+    if (descriptor < 0) {
+        return false;
+    }
+
+    const bool written = writeAll(descriptor, bytes.data(), bytes.size()) && ::fsync(descriptor) == 0;
+
+    if (::close(descriptor) != 0 || !written || std::rename(temporaryPath.c_str(), path_.c_str()) != 0) {
+        ::unlink(temporaryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool StateFile::remove() const {
+    return ::unlink(path_.c_str()) == 0 || errno == ENOENT;
+}
+
+bool StateFile::moveToBackup() const {
+    return std::rename(path_.c_str(), backupPath().c_str()) == 0;
+}
+
+std::vector<uint8_t> StateFile::encode(const PersistedState& state) {
+    std::vector<uint8_t> payload;
+    Writer writer(payload);
+
+    uint8_t fields = 0;
+    fields |= state.monitorMode ? FieldMonitorMode : 0;
+    fields |= state.authorizationLevel ? FieldAuthorizationLevel : 0;
+    fields |= state.monitoringStarted ? FieldMonitoringStarted : 0;
+    fields |= state.lastQueryLocation ? FieldLastQueryLocation : 0;
+
+    writer.u8(fields);
+    writer.u8(state.monitoringStarted.value_or(false) ? 1 : 0);
+    writer.i64(state.monitorMode.value_or(0));
+    writer.i64(state.authorizationLevel.value_or(0));
+
+    const Location location = state.lastQueryLocation.value_or(Location {});
+    writer.f64(location.coordinate.latitude);
+    writer.f64(location.coordinate.longitude);
+    writer.f64(location.horizontalAccuracy);
+    writer.f64(location.timestamp);
+
+    writer.strings(state.monitoredRegions);
+    writer.strings(state.userWithinRegions);
+
+    std::vector<uint8_t> bytes;
+    bytes.reserve(kHeaderSize + payload.size());
+    Writer header(bytes);
+
+    for (const uint8_t byte : kMagic) {
+        header.u8(byte);
+    }
+
+    header.u16(kVersion);
+    header.u16(0);
+    header.u32(static_cast<uint32_t>(payload.size()));
+    header.u32(checksum(payload.data(), payload.size()));
+    bytes.insert(bytes.end(), payload.begin(), payload.end());
+
+    return bytes;
+}
+
+std::optional<PersistedState> StateFile::decode(const uint8_t* data, std::size_t size) {
+    if (!data || size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        return std::nullopt;
+    }
+
+    Reader header(data + sizeof(kMagic), kHeaderSize - sizeof(kMagic));
+    const uint16_t version = header.u16();
+    header.u16();
+    const uint32_t payloadSize = header.u32();
+    const uint32_t payloadChecksum = header.u32();
+    const uint8_t* payload = data + kHeaderSize;
+
+    // an older or newer format is dropped rather than guessed at, the monitor rebuilds its state on the next query
+    if (version != kVersion || payloadSize != size - kHeaderSize || checksum(payload, payloadSize) != payloadChecksum) {
+        return std::nullopt;
+    }
+
+    Reader reader(payload, payloadSize);
+    PersistedState state;
+    const uint8_t fields = reader.u8();
+    const bool monitoringStarted = reader.u8() != 0;
+    const int64_t monitorMode = reader.i64();
+    const int64_t authorizationLevel = reader.i64();
+
+    Location location;
+    location.coordinate.latitude = reader.f64();
+    location.coordinate.longitude = reader.f64();
+    location.horizontalAccuracy = reader.f64();
+    location.timestamp = reader.f64();
+
+    state.monitoredRegions = reader.strings();
+    state.userWithinRegions = reader.strings();
+
+    if (!reader.ok() || !reader.atEnd()) {
+        return std::nullopt;
+    }
+
+    if (fields & FieldMonitorMode) {
+        state.monitorMode = monitorMode;
+    }
+
+    if (fields & FieldAuthorizationLevel) {
+        state.authorizationLevel = authorizationLevel;
+    }
+
+    if (fields & FieldMonitoringStarted) {
+        state.monitoringStarted = monitoringStarted;
+    }
+
+    if (fields & FieldLastQueryLocation) {
+        state.lastQueryLocation = location;
+    }
+
+    return state;
+}
+
+uint32_t StateFile::checksum(const uint8_t* data, std::size_t size) {
+    static const std::array<uint32_t, 256> table = makeChecksumTable();
+    uint32_t value = 0xFFFFFFFFu;
+
+    for (std::size_t i = 0; i < size; i++) {
+        value = table[(value ^ data[i]) & 0xFF] ^ (value >> 8);
+    }
+
+    return value ^ 0xFFFFFFFFu;
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// TrajectoryPredictor.cpp
+//
+
+#include "placesmonitor/TrajectoryPredictor.hpp"
+
+#include "placesmonitor/Geo.hpp"
+
+namespace placesmonitor {
+
+DeadReckoningPredictor::DeadReckoningPredictor(double historyWindow) : historyWindow_(historyWindow) {}
+
+bool DeadReckoningPredictor::predict(const std::vector<Location>& history, double seconds, Location& predicted) const {
+    if (history.empty() || seconds < 0) {
+        return false;
+    }
+
+    const Location& newest = history.back();
+    double speed = newest.speed;
+    double course = newest.course;
+
+    if (speed < 0 || course < 0) {
+        const Location* oldest = nullptr;
+
+        for (const Location& fix : history) {
+            if (newest.timestamp - fix.timestamp <= historyWindow_) {
+                oldest = &fix;
+                break;
+            }
+        }
+
+        const double elapsed = newest.timestamp - oldest->timestamp;
+
+        if (elapsed <= 0) {
+            return false;
+        }
+
+        speed = distanceBetween(oldest->coordinate, newest.coordinate) / elapsed;
+        course = bearingBetween(oldest->coordinate, newest.coordinate);
+    }
+
+    predicted = newest;
+    predicted.coordinate = destination(newest.coordinate, course, speed * seconds);
+    predicted.speed = speed;
+    predicted.course = course;
+    predicted.timestamp = newest.timestamp + seconds;
+    return true;
+}
+
+}
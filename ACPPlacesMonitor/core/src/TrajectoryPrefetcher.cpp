@@ -0,0 +1,148 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// TrajectoryPrefetcher.cpp
+//
+
+#include "placesmonitor/TrajectoryPrefetcher.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "placesmonitor/Geo.hpp"
+
+namespace placesmonitor {
+
+LocationHistory::LocationHistory(std::size_t capacity) : buffer_(std::max<std::size_t>(capacity, 1)) {}
+
+bool LocationHistory::add(const Location& location) {
+    if (location.horizontalAccuracy < 0) {
+        return false;
+    }
+
+    if (count_ && location.timestamp <= buffer_[(next_ + buffer_.size() - 1) % buffer_.size()].timestamp) {
+        return false;
+    }
+
+    buffer_[next_] = location;
+    next_ = (next_ + 1) % buffer_.size();
+    count_ = std::min(count_ + 1, buffer_.size());
+    return true;
+}
+
+std::vector<Location> LocationHistory::fixes() const {
+    std::vector<Location> fixes;
+    fixes.reserve(count_);
+    const std::size_t first = (next_ + buffer_.size() - count_) % buffer_.size();
+
+    for (std::size_t i = 0; i < count_; ++i) {
+        fixes.push_back(buffer_[(first + i) % buffer_.size()]);
+    }
+
+    return fixes;
+}
+
+void LocationHistory::clear() {
+    next_ = 0;
+    count_ = 0;
+}
+
+TrajectoryPrefetcher::TrajectoryPrefetcher(std::shared_ptr<const TrajectoryPredictor> predictor,
+                                           PrefetchSettings settings)
+    : predictor_(std::move(predictor)), settings_(settings), history_(settings.historySize) {}
+
+std::vector<Location> TrajectoryPrefetcher::onLocation(const Location& location) {
+    std::vector<Location> points;
+
+    if (!history_.add(location)) {
+        return points;
+    }
+
+    score(location);
+
+    const std::vector<Location> fixes = history_.fixes();
+    Location end;
+
+    if (!predictor_ || settings_.spacing <= 0 || !predictor_->predict(fixes, settings_.horizon, end)) {
+        return points;
+    }
+
+    // how far the device is expected to travel decides both whether it is moving and how many points are needed
+    const double distance = distanceBetween(location.coordinate, end.coordinate);
+
+    if (distance < settings_.minimumSpeed * settings_.horizon) {
+        return points;
+    }
+
+    const std::size_t count = std::min(settings_.maximumPoints,
+                                       static_cast<std::size_t>(std::floor(distance / settings_.spacing)));
+
+    for (std::size_t i = 1; i <= count; ++i) {
+        Location point;
+
+        if (!predictor_->predict(fixes, settings_.horizon * i * settings_.spacing / distance, point) ||
+            isCovered(point.coordinate)) {
+            continue;
+        }
+
+        pending_.push_back(point);
+        points.push_back(point);
+        statistics_.predictions++;
+    }
+
+    // a device that keeps changing direction leaves predictions behind faster than they expire
+    const std::size_t maximumPending = std::max<std::size_t>(settings_.maximumPoints * history_.capacity(), 1);
+
+    if (pending_.size() > maximumPending) {
+        statistics_.misses += pending_.size() - maximumPending;
+        pending_.erase(pending_.begin(), pending_.end() - static_cast<std::ptrdiff_t>(maximumPending));
+    }
+
+    return points;
+}
+
+void TrajectoryPrefetcher::reset() {
+    history_.clear();
+    pending_.clear();
+}
+
+void TrajectoryPrefetcher::setPredictor(std::shared_ptr<const TrajectoryPredictor> predictor) {
+    predictor_ = std::move(predictor);
+    reset();
+}
+
+void TrajectoryPrefetcher::score(const Location& location) {
+    auto scored = std::remove_if(pending_.begin(), pending_.end(), [&](const Location& prediction) {
+        if (distanceBetween(location.coordinate, prediction.coordinate) <= settings_.hitRadius) {
+            statistics_.hits++;
+            return true;
+        }
+
+        if (location.timestamp > prediction.timestamp + settings_.horizon) {
+            statistics_.misses++;
+            return true;
+        }
+
+        return false;
+    });
+    pending_.erase(scored, pending_.end());
+}
+
+bool TrajectoryPrefetcher::isCovered(const Coordinate& coordinate) const {
+    return std::any_of(pending_.begin(), pending_.end(), [&](const Location& prediction) {
+        return distanceBetween(coordinate, prediction.coordinate) <= settings_.hitRadius;
+    });
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// AdaptivePolicyTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <string>
+
+#include "placesmonitor/AdaptivePolicy.hpp"
+
+using namespace placesmonitor;
+
+TEST(AdaptivePolicyTests, Defaults) {
+    AdaptivePolicy policy;
+    EXPECT_EQ(kAdaptiveNearDistance, policy.nearDistance);
+    EXPECT_EQ(kAdaptiveFarDistance, policy.farDistance);
+    EXPECT_EQ(kAdaptiveContinuousTimeLimit, policy.continuousTimeLimit);
+}
+
+TEST(AdaptivePolicyTests, FarStaysFarAwayFromFences) {
+    AdaptivePolicy policy;
+    EXPECT_EQ(AdaptiveState::Far, policy.nextState(AdaptiveState::Far, 800, 0));
+}
+
+TEST(AdaptivePolicyTests, FarStaysFarWithoutFences) {
+    AdaptivePolicy policy;
+    EXPECT_EQ(AdaptiveState::Far, policy.nextState(AdaptiveState::Far, std::numeric_limits<double>::max(), 0));
+}
+
+TEST(AdaptivePolicyTests, FarToApproachingNearFence) {
+    AdaptivePolicy policy;
+    EXPECT_EQ(AdaptiveState::Approaching, policy.nextState(AdaptiveState::Far, 400, 0));
+}
+
+TEST(AdaptivePolicyTests, ApproachingUsesHysteresis) {
+    // between the near and far distances the state is kept
+    AdaptivePolicy policy;
+    EXPECT_EQ(AdaptiveState::Approaching, policy.nextState(AdaptiveState::Approaching, 800, 10));
+    EXPECT_EQ(AdaptiveState::Far, policy.nextState(AdaptiveState::Approaching, 1200, 10));
+}
+
+TEST(AdaptivePolicyTests, ApproachingBacksOffAfterTimeLimit) {
+    AdaptivePolicy policy;
+    EXPECT_EQ(AdaptiveState::BackedOff, policy.nextState(AdaptiveState::Approaching, 100, policy.continuousTimeLimit));
+}
+
+TEST(AdaptivePolicyTests, BackedOffStaysUntilFar) {
+    AdaptivePolicy policy;
+    EXPECT_EQ(AdaptiveState::BackedOff, policy.nextState(AdaptiveState::BackedOff, 100, 1000));
+    EXPECT_EQ(AdaptiveState::Far, policy.nextState(AdaptiveState::BackedOff, 1500, 1000));
+}
+
+TEST(AdaptivePolicyTests, TunedPolicy) {
+    // setup
+    AdaptivePolicy policy;
+    policy.nearDistance = 50;
+
+    // verify
+    EXPECT_EQ(AdaptiveState::Far, policy.nextState(AdaptiveState::Far, 100, 0));
+}
+
+TEST(AdaptivePolicyTests, UsesContinuousUpdates) {
+    EXPECT_TRUE(AdaptivePolicy::usesContinuousUpdates(AdaptiveState::Approaching));
+    EXPECT_FALSE(AdaptivePolicy::usesContinuousUpdates(AdaptiveState::Far));
+    EXPECT_FALSE(AdaptivePolicy::usesContinuousUpdates(AdaptiveState::BackedOff));
+}
+
+TEST(AdaptivePolicyTests, Name) {
+    EXPECT_EQ(std::string("far"), AdaptivePolicy::name(AdaptiveState::Far));
+    EXPECT_EQ(std::string("approaching"), AdaptivePolicy::name(AdaptiveState::Approaching));
+    EXPECT_EQ(std::string("backed off"), AdaptivePolicy::name(AdaptiveState::BackedOff));
+}
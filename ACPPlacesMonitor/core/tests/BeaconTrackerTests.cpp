@@ -0,0 +1,133 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// BeaconTrackerTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "placesmonitor/BeaconTracker.hpp"
+
+using namespace placesmonitor;
+
+namespace {
+
+const char* kStoreUuid = "F7826DA6-4FA2-4E98-8024-BC5B71E0893E";
+const char* kOtherUuid = "2F234454-CF6D-4A0F-ADF2-F4911BA9FFA6";
+
+BeaconIdentity makeBeacon(const std::string& uuid, int major = -1, int minor = -1) {
+    BeaconIdentity beacon;
+    beacon.uuid = uuid;
+    beacon.major = major;
+    beacon.minor = minor;
+    return beacon;
+}
+
+BeaconReading makeReading(const std::string& uuid, int major, int minor, double distance) {
+    BeaconReading reading;
+    reading.beacon = makeBeacon(uuid, major, minor);
+    reading.distance = distance;
+    return reading;
+}
+
+BeaconPoi makePoi(const std::string& identifier, const BeaconIdentity& beacon) {
+    BeaconPoi poi;
+    poi.identifier = identifier;
+    poi.beacon = beacon;
+    return poi;
+}
+
+class BeaconTrackerTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tracker.track({makePoi("shoes", makeBeacon(kStoreUuid, 1, 1)), makePoi("books", makeBeacon(kStoreUuid, 1, 2))});
+    }
+
+    BeaconTracker tracker{3, 8, 45};
+};
+
+}
+
+TEST(BeaconIdentityTests, MissingMajorAndMinorMatchAnyBeacon) {
+    EXPECT_TRUE(makeBeacon(kStoreUuid).matches(makeBeacon(kStoreUuid, 4, 5)));
+    EXPECT_TRUE(makeBeacon(kStoreUuid, 4).matches(makeBeacon(kStoreUuid, 4, 5)));
+    EXPECT_FALSE(makeBeacon(kStoreUuid, 4).matches(makeBeacon(kStoreUuid, 3, 5)));
+    EXPECT_FALSE(makeBeacon(kStoreUuid, 4, 6).matches(makeBeacon(kStoreUuid, 4, 5)));
+    EXPECT_FALSE(makeBeacon(kOtherUuid).matches(makeBeacon(kStoreUuid, 4, 5)));
+}
+
+TEST_F(BeaconTrackerTests, CloseBeaconEntersItsPoi) {
+    BeaconTracker::Transitions transitions = tracker.update({makeReading(kStoreUuid, 1, 2, 1.5),
+                                                             makeReading(kStoreUuid, 1, 1, 6)}, 10);
+
+    ASSERT_EQ(1u, transitions.entered.size());
+    EXPECT_EQ("books", transitions.entered[0]);
+    EXPECT_TRUE(transitions.exited.empty());
+    EXPECT_TRUE(tracker.isInside("books"));
+    EXPECT_FALSE(tracker.isInside("shoes"));
+}
+
+TEST_F(BeaconTrackerTests, UnknownDistanceIsIgnored) {
+    BeaconTracker::Transitions transitions = tracker.update({makeReading(kStoreUuid, 1, 1, -1)}, 10);
+
+    EXPECT_TRUE(transitions.entered.empty());
+}
+
+TEST_F(BeaconTrackerTests, ExitWaitsForTimeout) {
+    tracker.update({makeReading(kStoreUuid, 1, 1, 2)}, 10);
+
+    // farther than the entry distance but within the exit distance keeps the POI entered
+    EXPECT_TRUE(tracker.update({makeReading(kStoreUuid, 1, 1, 6)}, 50).exited.empty());
+    EXPECT_TRUE(tracker.update({}, 90).exited.empty());
+
+    BeaconTracker::Transitions transitions = tracker.update({makeReading(kStoreUuid, 1, 1, 12)}, 95);
+
+    ASSERT_EQ(1u, transitions.exited.size());
+    EXPECT_EQ("shoes", transitions.exited[0]);
+    EXPECT_FALSE(tracker.isInside("shoes"));
+}
+
+TEST_F(BeaconTrackerTests, EnteredPoiIsNotEnteredAgain) {
+    tracker.update({makeReading(kStoreUuid, 1, 1, 2)}, 10);
+
+    EXPECT_TRUE(tracker.update({makeReading(kStoreUuid, 1, 1, 1)}, 20).entered.empty());
+}
+
+TEST_F(BeaconTrackerTests, UntrackedPoiIsExited) {
+    tracker.update({makeReading(kStoreUuid, 1, 1, 2), makeReading(kStoreUuid, 1, 2, 2)}, 10);
+
+    BeaconTracker::Transitions transitions = tracker.track({makePoi("books", makeBeacon(kStoreUuid, 1, 2))});
+
+    ASSERT_EQ(1u, transitions.exited.size());
+    EXPECT_EQ("shoes", transitions.exited[0]);
+    EXPECT_TRUE(tracker.isInside("books"));
+    EXPECT_EQ(1u, tracker.count());
+}
+
+TEST_F(BeaconTrackerTests, PoiWithNewBeaconStartsOver) {
+    tracker.update({makeReading(kStoreUuid, 1, 1, 2)}, 10);
+
+    BeaconTracker::Transitions transitions = tracker.track({makePoi("shoes", makeBeacon(kStoreUuid, 7, 1))});
+
+    ASSERT_EQ(1u, transitions.exited.size());
+    EXPECT_FALSE(tracker.isInside("shoes"));
+}
+
+TEST_F(BeaconTrackerTests, BeaconsAreRangedOncePerUuid) {
+    tracker.track({makePoi("shoes", makeBeacon(kStoreUuid, 1, 1)),
+                   makePoi("books", makeBeacon(kStoreUuid, 1, 2)),
+                   makePoi("cafe", makeBeacon(kOtherUuid))});
+
+    std::vector<std::string> expected{kOtherUuid, kStoreUuid};
+    EXPECT_EQ(expected, tracker.uuids());
+}
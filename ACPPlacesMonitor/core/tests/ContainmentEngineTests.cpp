@@ -0,0 +1,149 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ContainmentEngineTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "TestHelpers.hpp"
+#include "placesmonitor/ContainmentEngine.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::testing;
+
+namespace {
+
+const Coordinate kCenter{40.0, -111.0};
+
+Region makeRegion(const std::string& identifier, const Coordinate& center, double radius) {
+    Region region;
+    region.identifier = identifier;
+    region.center = center;
+    region.radius = radius;
+    return region;
+}
+
+class ContainmentEngineTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        engine.load({makeRegion("poi", kCenter, 200)});
+    }
+
+    // creates a fix north of the poi center
+    Location metersNorth(double meters, double accuracy) {
+        return makeLocation(offsetNorth(kCenter, meters), accuracy);
+    }
+
+    ContainmentEngine engine{10, 100};
+    std::vector<std::size_t> entered;
+    std::vector<std::size_t> exited;
+};
+
+}
+
+TEST_F(ContainmentEngineTests, Load) {
+    EXPECT_EQ(1u, engine.count());
+    engine.load({});
+    EXPECT_EQ(0u, engine.count());
+}
+
+TEST_F(ContainmentEngineTests, EntryWellInside) {
+    // test
+    bool evaluated = engine.evaluate(metersNorth(100, 5), {false}, entered, exited);
+
+    // verify
+    EXPECT_TRUE(evaluated);
+    EXPECT_EQ((std::vector<std::size_t>{0}), entered);
+    EXPECT_TRUE(exited.empty());
+}
+
+TEST_F(ContainmentEngineTests, NoEntryInsideHysteresisBand) {
+    // test - inside the circle, but by less than the accuracy of the fix
+    engine.evaluate(metersNorth(170, 50), {false}, entered, exited);
+
+    // verify
+    EXPECT_TRUE(entered.empty());
+}
+
+TEST_F(ContainmentEngineTests, NoExitInsideHysteresisBand) {
+    // test - just outside the circle
+    engine.evaluate(metersNorth(205, 5), {true}, entered, exited);
+
+    // verify
+    EXPECT_TRUE(exited.empty());
+    EXPECT_TRUE(entered.empty());
+}
+
+TEST_F(ContainmentEngineTests, ExitWellOutside) {
+    // test
+    engine.evaluate(metersNorth(300, 5), {true}, entered, exited);
+
+    // verify
+    EXPECT_EQ((std::vector<std::size_t>{0}), exited);
+    EXPECT_TRUE(entered.empty());
+}
+
+TEST_F(ContainmentEngineTests, AlreadyInsideIsNotEnteredAgain) {
+    // test
+    engine.evaluate(metersNorth(0, 5), {true}, entered, exited);
+
+    // verify
+    EXPECT_TRUE(entered.empty());
+    EXPECT_TRUE(exited.empty());
+}
+
+TEST_F(ContainmentEngineTests, InaccurateFixIsIgnored) {
+    // test
+    bool poorFix = engine.evaluate(metersNorth(0, 500), {false}, entered, exited);
+    bool invalidFix = engine.evaluate(metersNorth(0, -1), {false}, entered, exited);
+
+    // verify
+    EXPECT_FALSE(poorFix);
+    EXPECT_FALSE(invalidFix);
+    EXPECT_TRUE(entered.empty());
+}
+
+TEST_F(ContainmentEngineTests, Antimeridian) {
+    // setup
+    engine.load({makeRegion("dateline", Coordinate{0, 179.9995}, 200)});
+
+    // test - the fix is about 111 meters from the center across the antimeridian
+    engine.evaluate(makeLocation(Coordinate{0, -179.9995}), {false}, entered, exited);
+
+    // verify
+    EXPECT_EQ(1u, entered.size());
+}
+
+TEST_F(ContainmentEngineTests, ManyRegions) {
+    // setup
+    std::vector<Region> regions;
+    for (int i = 0; i < 100; i++) {
+        regions.push_back(makeRegion("poi" + std::to_string(i), Coordinate{40.0 + i * 0.01, -111.0}, 100));
+    }
+    engine.load(regions);
+
+    // test
+    engine.evaluate(makeLocation(Coordinate{40.5, -111.0}), std::vector<bool>(100, false), entered, exited);
+
+    // verify
+    EXPECT_EQ((std::vector<std::size_t>{50}), entered);
+}
+
+TEST_F(ContainmentEngineTests, MissingInsideFlagsMeanOutside) {
+    // test
+    engine.evaluate(metersNorth(0, 5), {}, entered, exited);
+
+    // verify
+    EXPECT_EQ(1u, entered.size());
+}
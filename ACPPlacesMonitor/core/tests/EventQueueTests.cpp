@@ -0,0 +1,362 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// EventQueueTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "placesmonitor/EventQueue.hpp"
+
+using namespace placesmonitor;
+
+using StringQueue = EventQueue<std::string>;
+
+TEST(EventQueueTests, Init) {
+    StringQueue queue;
+    EXPECT_EQ(0u, queue.count());
+    EXPECT_EQ(kEventQueueCapacity, queue.capacity());
+    EXPECT_FALSE(queue.hasNext());
+}
+
+TEST(EventQueueTests, CapacityIsAtLeastOne) {
+    StringQueue queue(0);
+    EXPECT_EQ(1u, queue.capacity());
+}
+
+TEST(EventQueueTests, Add) {
+    // setup
+    StringQueue queue;
+
+    // test
+    StringQueue::AddResult result = queue.add(EventKind::Other, "event");
+
+    // verify
+    EXPECT_TRUE(result.queued);
+    EXPECT_FALSE(result.dropped.has_value());
+    EXPECT_EQ(1u, queue.count());
+    EXPECT_TRUE(queue.hasNext());
+}
+
+TEST(EventQueueTests, Poll) {
+    // setup
+    StringQueue queue;
+    queue.add(EventKind::Other, "event");
+
+    // test
+    std::optional<std::string> result = queue.poll();
+
+    // verify
+    EXPECT_EQ("event", result.value());
+    EXPECT_EQ(0u, queue.count());
+}
+
+TEST(EventQueueTests, PollWithEmptyQueue) {
+    StringQueue queue;
+    EXPECT_FALSE(queue.poll().has_value());
+}
+
+TEST(EventQueueTests, PollKeepsOrder) {
+    // setup
+    StringQueue queue;
+    queue.add(EventKind::Other, "first");
+    queue.add(EventKind::Other, "second");
+
+    // verify
+    EXPECT_EQ("first", queue.poll().value());
+    EXPECT_EQ("second", queue.poll().value());
+    EXPECT_FALSE(queue.poll().has_value());
+}
+
+TEST(EventQueueTests, Peek) {
+    // setup
+    StringQueue queue;
+    queue.add(EventKind::Other, "event");
+
+    // test
+    const std::string* result = queue.peek();
+
+    // verify
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ("event", *result);
+    EXPECT_EQ(1u, queue.count());
+}
+
+TEST(EventQueueTests, PeekWithEmptyQueue) {
+    StringQueue queue;
+    EXPECT_EQ(nullptr, queue.peek());
+}
+
+TEST(EventQueueTests, FullQueueDropsOldestEvent) {
+    // setup
+    StringQueue queue(2);
+
+    // test
+    queue.add(EventKind::Other, "first");
+    queue.add(EventKind::Other, "second");
+    StringQueue::AddResult result = queue.add(EventKind::Other, "third");
+
+    // verify
+    EXPECT_TRUE(result.queued);
+    EXPECT_EQ("first", result.dropped.value());
+    EXPECT_EQ(2u, queue.count());
+    EXPECT_EQ("second", queue.poll().value());
+    EXPECT_EQ("third", queue.poll().value());
+}
+
+TEST(EventQueueTests, WrapsAroundCapacity) {
+    // setup
+    StringQueue queue(2);
+
+    // test
+    for (int i = 0; i < 5; i++) {
+        const std::string event = "event" + std::to_string(i);
+        queue.add(EventKind::Other, event);
+        EXPECT_EQ(event, queue.poll().value());
+    }
+
+    // verify
+    EXPECT_FALSE(queue.hasNext());
+}
+
+TEST(EventQueueTests, StopCancelsStartsAcrossTheEndOfTheRing) {
+    // setup - the oldest pending event sits at the end of the ring, so the events wrap around it
+    StringQueue queue(4);
+    queue.add(EventKind::Other, "first");
+    queue.add(EventKind::Other, "second");
+    queue.add(EventKind::Other, "third");
+    queue.poll();
+    queue.poll();
+    queue.poll();
+    queue.add(EventKind::Other, "other");
+    queue.add(EventKind::Start, "start");
+    queue.add(EventKind::UpdateLocationNow, "update");
+
+    // test
+    queue.add(EventKind::Stop, "stop");
+
+    // verify
+    EXPECT_EQ(3u, queue.count());
+    EXPECT_EQ("other", queue.poll().value());
+    EXPECT_EQ("update", queue.poll().value());
+    EXPECT_EQ("stop", queue.poll().value());
+    EXPECT_FALSE(queue.hasNext());
+}
+
+TEST(EventQueueTests, StopsPastTheCapacityKeepOrder) {
+    // setup
+    StringQueue queue(2);
+    queue.add(EventKind::Stop, "stop1");
+    queue.poll();
+    queue.add(EventKind::Stop, "stop2");
+    queue.add(EventKind::Stop, "stop3");
+
+    // test
+    queue.add(EventKind::Stop, "stop4");
+    queue.add(EventKind::Stop, "stop5");
+
+    // verify
+    EXPECT_EQ(4u, queue.count());
+    EXPECT_EQ(2u, queue.capacity());
+    EXPECT_EQ("stop2", queue.poll().value());
+    EXPECT_EQ("stop3", queue.poll().value());
+    EXPECT_EQ("stop4", queue.poll().value());
+    EXPECT_EQ("stop5", queue.poll().value());
+}
+
+TEST(EventQueueTests, DuplicateUpdateLocationNowIsDropped) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::UpdateLocationNow, "first");
+    for (int i = 0; i < 4; i++) {
+        EXPECT_FALSE(queue.add(EventKind::UpdateLocationNow, "duplicate").queued);
+    }
+
+    // verify
+    EXPECT_EQ(1u, queue.count());
+    EXPECT_EQ("first", *queue.peek());
+    EXPECT_EQ(4u, queue.coalescedCount());
+}
+
+TEST(EventQueueTests, DuplicateStartIsDropped) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::Start, "start");
+    queue.add(EventKind::Start, "start");
+
+    // verify
+    EXPECT_EQ(1u, queue.count());
+}
+
+TEST(EventQueueTests, LastMonitorConfigurationWins) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::UpdateMonitorConfiguration, "continuous");
+    queue.add(EventKind::Start, "start");
+    queue.add(EventKind::UpdateMonitorConfiguration, "significant");
+
+    // verify - the latest value keeps the position of the pending event
+    EXPECT_EQ(2u, queue.count());
+    EXPECT_EQ("significant", queue.poll().value());
+    EXPECT_EQ("start", queue.poll().value());
+    EXPECT_EQ(1u, queue.coalescedCount());
+}
+
+TEST(EventQueueTests, LastRequestAuthorizationLevelWins) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::SetRequestAuthorizationLevel, "when in use");
+    queue.add(EventKind::SetRequestAuthorizationLevel, "always");
+
+    // verify
+    EXPECT_EQ(1u, queue.count());
+    EXPECT_EQ("always", *queue.peek());
+}
+
+TEST(EventQueueTests, StopCancelsPendingStart) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::Start, "start");
+    queue.add(EventKind::UpdateLocationNow, "update location");
+    queue.add(EventKind::Stop, "stop");
+
+    // verify
+    EXPECT_EQ(2u, queue.count());
+    EXPECT_EQ("update location", queue.poll().value());
+    EXPECT_EQ("stop", queue.poll().value());
+    EXPECT_EQ(1u, queue.coalescedCount());
+}
+
+TEST(EventQueueTests, StartAfterStopIsQueued) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::Stop, "stop");
+    queue.add(EventKind::Start, "start");
+
+    // verify
+    EXPECT_EQ(2u, queue.count());
+    EXPECT_EQ("stop", queue.poll().value());
+    EXPECT_EQ("start", queue.poll().value());
+}
+
+TEST(EventQueueTests, MonitorConfigurationIsNotMovedAcrossStop) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::UpdateMonitorConfiguration, "continuous");
+    queue.add(EventKind::Stop, "stop and clear");
+    queue.add(EventKind::UpdateMonitorConfiguration, "significant");
+
+    // verify - the update after the stop still runs after it
+    EXPECT_EQ(3u, queue.count());
+    EXPECT_EQ("continuous", queue.poll().value());
+    EXPECT_EQ("stop and clear", queue.poll().value());
+    EXPECT_EQ("significant", queue.poll().value());
+    EXPECT_EQ(0u, queue.coalescedCount());
+}
+
+TEST(EventQueueTests, RequestAuthorizationLevelIsNotMovedAcrossStop) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::SetRequestAuthorizationLevel, "when in use");
+    queue.add(EventKind::Stop, "stop");
+    queue.add(EventKind::SetRequestAuthorizationLevel, "always");
+    queue.add(EventKind::SetRequestAuthorizationLevel, "when in use again");
+
+    // verify - coalesced with the pending update queued after the stop only
+    EXPECT_EQ(3u, queue.count());
+    EXPECT_EQ("when in use", queue.poll().value());
+    EXPECT_EQ("stop", queue.poll().value());
+    EXPECT_EQ("when in use again", queue.poll().value());
+}
+
+TEST(EventQueueTests, UpdateLocationNowAfterStopIsQueued) {
+    // setup
+    StringQueue queue;
+
+    // test
+    queue.add(EventKind::UpdateLocationNow, "before");
+    queue.add(EventKind::Stop, "stop");
+    queue.add(EventKind::UpdateLocationNow, "after");
+
+    // verify
+    EXPECT_EQ(3u, queue.count());
+}
+
+TEST(EventQueueTests, FullQueueDropsCoalescibleEventFirst) {
+    // setup
+    StringQueue queue(3);
+    queue.add(EventKind::Other, "other");
+    queue.add(EventKind::Stop, "stop");
+    queue.add(EventKind::UpdateMonitorConfiguration, "configuration");
+
+    // test
+    StringQueue::AddResult result = queue.add(EventKind::Other, "new");
+
+    // verify
+    EXPECT_TRUE(result.queued);
+    EXPECT_EQ("configuration", result.dropped.value());
+    EXPECT_EQ("other", queue.poll().value());
+    EXPECT_EQ("stop", queue.poll().value());
+    EXPECT_EQ("new", queue.poll().value());
+}
+
+TEST(EventQueueTests, FullQueueNeverDropsStop) {
+    // setup
+    StringQueue queue(2);
+    queue.add(EventKind::Stop, "stop");
+    queue.add(EventKind::Other, "other");
+
+    // test
+    StringQueue::AddResult result = queue.add(EventKind::Other, "new");
+
+    // verify
+    EXPECT_EQ("other", result.dropped.value());
+    EXPECT_EQ("stop", queue.poll().value());
+    EXPECT_EQ("new", queue.poll().value());
+}
+
+TEST(EventQueueTests, FullQueueOfStopsDropsNewEvent) {
+    // setup
+    StringQueue queue(2);
+    queue.add(EventKind::Stop, "stop");
+    queue.add(EventKind::Stop, "stop and clear");
+
+    // test
+    StringQueue::AddResult dropped = queue.add(EventKind::Start, "start");
+    StringQueue::AddResult stop = queue.add(EventKind::Stop, "another stop");
+
+    // verify - a stop is queued past the capacity rather than lost
+    EXPECT_FALSE(dropped.queued);
+    EXPECT_EQ("start", dropped.dropped.value());
+    EXPECT_TRUE(stop.queued);
+    EXPECT_FALSE(stop.dropped.has_value());
+    EXPECT_EQ(3u, queue.count());
+}
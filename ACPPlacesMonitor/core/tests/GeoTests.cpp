@@ -0,0 +1,70 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// GeoTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "placesmonitor/Geo.hpp"
+
+using namespace placesmonitor;
+
+TEST(GeoTests, DistanceToSelfIsZero) {
+    const Coordinate coordinate{40.0, -111.0};
+    EXPECT_DOUBLE_EQ(0, distanceBetween(coordinate, coordinate));
+}
+
+TEST(GeoTests, DistanceOfOneDegreeOfLatitude) {
+    EXPECT_NEAR(111195, distanceBetween(Coordinate{0, 0}, Coordinate{1, 0}), 1);
+}
+
+TEST(GeoTests, DistanceIsSymmetric) {
+    const Coordinate first{40.0, -111.0};
+    const Coordinate second{40.3, -111.4};
+    EXPECT_DOUBLE_EQ(distanceBetween(first, second), distanceBetween(second, first));
+}
+
+TEST(GeoTests, DistanceAcrossAntimeridian) {
+    EXPECT_NEAR(111.2, distanceBetween(Coordinate{0, 179.9995}, Coordinate{0, -179.9995}), 0.1);
+}
+
+TEST(GeoTests, BearingToCardinalDirections) {
+    const Coordinate origin{0, 0};
+    EXPECT_NEAR(0, bearingBetween(origin, Coordinate{1, 0}), 1e-9);
+    EXPECT_NEAR(90, bearingBetween(origin, Coordinate{0, 1}), 1e-9);
+    EXPECT_NEAR(180, bearingBetween(origin, Coordinate{-1, 0}), 1e-9);
+    EXPECT_NEAR(270, bearingBetween(origin, Coordinate{0, -1}), 1e-9);
+}
+
+TEST(GeoTests, DestinationRoundTrip) {
+    const Coordinate from{40.0, -111.0};
+    const Coordinate to = destination(from, 63, 2500);
+
+    EXPECT_NEAR(2500, distanceBetween(from, to), 0.01);
+    EXPECT_NEAR(63, bearingBetween(from, to), 0.01);
+}
+
+TEST(GeoTests, DestinationAcrossAntimeridian) {
+    const Coordinate to = destination(Coordinate{0, 179.9995}, 90, 111.2);
+    EXPECT_NEAR(-179.9995, to.longitude, 1e-6);
+}
+
+TEST(GeoTests, EdgeDistance) {
+    const Coordinate center{0, 0};
+
+    // negative inside the circle, positive outside
+    EXPECT_NEAR(-100, edgeDistance(center, center, 100), 1e-9);
+    EXPECT_NEAR(1195, edgeDistance(Coordinate{1, 0}, center, 110000), 1);
+    EXPECT_NEAR(-805, edgeDistance(Coordinate{1, 0}, center, 112000), 1);
+}
@@ -0,0 +1,128 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// GeofenceDiffTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "placesmonitor/GeofenceDiff.hpp"
+
+using namespace placesmonitor;
+
+namespace {
+
+Region makeRegion(const std::string& identifier, double latitude, double radius) {
+    Region region;
+    region.identifier = identifier;
+    region.center = Coordinate{latitude, -111.0};
+    region.radius = radius;
+    return region;
+}
+
+class GeofenceDiffTests : public ::testing::Test {
+protected:
+    Region regionA = makeRegion("a", 40.0, 100);
+    Region regionB = makeRegion("b", 40.1, 100);
+    Region regionC = makeRegion("c", 40.2, 100);
+};
+
+}
+
+TEST_F(GeofenceDiffTests, NothingMonitored) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({regionA, regionB}, {}, {});
+
+    // verify
+    EXPECT_EQ(2u, diff.toStart().size());
+    EXPECT_EQ(0u, diff.toStop().size());
+    EXPECT_EQ(2u, diff.addedCount());
+    EXPECT_EQ(0u, diff.keptCount());
+}
+
+TEST_F(GeofenceDiffTests, IdenticalRegionsAreKept) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({makeRegion("a", 40.0, 100)}, {regionA}, {"a"});
+
+    // verify
+    EXPECT_EQ(0u, diff.toStart().size());
+    EXPECT_EQ(0u, diff.toStop().size());
+    EXPECT_EQ((std::vector<std::size_t>{0}), diff.kept());
+}
+
+TEST_F(GeofenceDiffTests, AddRemoveAndKeep) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({regionB, regionC}, {regionA, regionB}, {"a", "b"});
+
+    // verify
+    EXPECT_EQ(1u, diff.addedCount());
+    EXPECT_EQ(1u, diff.removedCount());
+    EXPECT_EQ(1u, diff.keptCount());
+    EXPECT_EQ(0u, diff.updatedCount());
+    EXPECT_EQ((std::vector<std::size_t>{1}), diff.toStart());
+    EXPECT_EQ((std::vector<std::size_t>{0}), diff.toStop());
+}
+
+TEST_F(GeofenceDiffTests, ChangedRadiusIsUpdated) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({makeRegion("a", 40.0, 200)}, {regionA}, {"a"});
+
+    // verify
+    EXPECT_EQ(1u, diff.updatedCount());
+    EXPECT_EQ(0u, diff.addedCount());
+    EXPECT_EQ(0u, diff.removedCount());
+    EXPECT_EQ((std::vector<std::size_t>{0}), diff.toStop());
+    EXPECT_EQ((std::vector<std::size_t>{0}), diff.toStart());
+}
+
+TEST_F(GeofenceDiffTests, ChangedCenterIsUpdated) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({makeRegion("a", 40.001, 100)}, {regionA}, {"a"});
+
+    // verify
+    EXPECT_EQ(1u, diff.updatedCount());
+}
+
+TEST_F(GeofenceDiffTests, RegionsNotOwnedAreNeverStopped) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({}, {regionB}, {"a"});
+
+    // verify
+    EXPECT_EQ(0u, diff.toStop().size());
+    EXPECT_EQ(0u, diff.removedCount());
+}
+
+TEST_F(GeofenceDiffTests, OwnedRegionMissingFromPlatformIsStartedAgain) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({regionA}, {}, {"a"});
+
+    // verify
+    EXPECT_EQ(1u, diff.addedCount());
+    EXPECT_EQ((std::vector<std::size_t>{0}), diff.toStart());
+}
+
+TEST_F(GeofenceDiffTests, DuplicateDesiredRegionsAreStartedOnce) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({regionA, regionA}, {}, {});
+
+    // verify
+    EXPECT_EQ(1u, diff.toStart().size());
+}
+
+TEST_F(GeofenceDiffTests, RemovalsFollowMonitoredOrder) {
+    // test
+    GeofenceDiff diff = GeofenceDiff::compute({}, {regionC, regionA, regionB}, {"a", "b", "c"});
+
+    // verify
+    EXPECT_EQ((std::vector<std::size_t>{0, 1, 2}), diff.toStop());
+}
@@ -0,0 +1,98 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// PoiExportTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "PoiExport.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::tools;
+
+TEST(PoiExportTests, ReadsCsvColumnsByName) {
+    const PoiExport result = readCsvExport("Radius,Longitude,Latitude,Name,ID\r\n"
+                                           "150,-111.9,40.7,\"Main St, North\",store-1\r\n"
+                                           "75,-111.8,40.6,\"The \"\"Depot\"\"\",store-2\r\n");
+
+    ASSERT_TRUE(result.error.empty());
+    ASSERT_EQ(2u, result.pois.size());
+    EXPECT_EQ("store-1", result.pois[0].identifier);
+    EXPECT_EQ("Main St, North", result.pois[0].name);
+    EXPECT_DOUBLE_EQ(40.7, result.pois[0].center.latitude);
+    EXPECT_DOUBLE_EQ(-111.9, result.pois[0].center.longitude);
+    EXPECT_DOUBLE_EQ(150, result.pois[0].radius);
+    EXPECT_EQ("The \"Depot\"", result.pois[1].name);
+}
+
+TEST(PoiExportTests, ReadsTheBenchmarkPois) {
+    const PoiExport result = readCsvExport("identifier,latitude,longitude,radius\n"
+                                           "poi-00,40.707593,-111.965623,150\n"
+                                           "poi-01,40.705464,-111.946997,75\n");
+
+    ASSERT_EQ(2u, result.pois.size());
+    EXPECT_EQ("", result.pois[1].name);
+    EXPECT_DOUBLE_EQ(75, result.pois[1].radius);
+}
+
+TEST(PoiExportTests, SkipsInvalidAndRepeatedRows) {
+    const PoiExport result = readCsvExport("identifier,latitude,longitude,radius\n"
+                                           "a,40,-111,100\n"
+                                           ",40,-111,100\n"
+                                           "b,91,-111,100\n"
+                                           "c,forty,-111,100\n"
+                                           "d,40,-111,-5\n"
+                                           "a,41,-111,100\n"
+                                           "e,40,-111\n");
+
+    EXPECT_EQ(2u, result.pois.size());
+    EXPECT_EQ(5u, result.skipped);
+    EXPECT_DOUBLE_EQ(40, result.pois[0].center.latitude);
+    EXPECT_DOUBLE_EQ(0, result.pois[1].radius);
+}
+
+TEST(PoiExportTests, CsvErrors) {
+    EXPECT_FALSE(readCsvExport("").error.empty());
+    EXPECT_FALSE(readCsvExport("name,latitude,longitude\nx,1,2\n").error.empty());
+    EXPECT_FALSE(readCsvExport("identifier,latitude,longitude\n\"a,1,2\n").error.empty());
+}
+
+TEST(PoiExportTests, ReadsJsonArray) {
+    const PoiExport result = readJsonExport(R"([
+        {"id": "store-1", "name": "Café 😀", "lat": 40.7, "lng": -111.9, "radius": 150},
+        {"identifier": 2, "latitude": "40.6", "longitude": "-111.8", "tags": ["a", {"b": null}], "open": true}
+    ])");
+
+    ASSERT_TRUE(result.error.empty());
+    ASSERT_EQ(2u, result.pois.size());
+    EXPECT_EQ("store-1", result.pois[0].identifier);
+    EXPECT_EQ("Caf\xC3\xA9 \xF0\x9F\x98\x80", result.pois[0].name);
+    EXPECT_DOUBLE_EQ(150, result.pois[0].radius);
+    EXPECT_EQ("2", result.pois[1].identifier);
+    EXPECT_DOUBLE_EQ(40.6, result.pois[1].center.latitude);
+}
+
+TEST(PoiExportTests, ReadsJsonObjectWithPois) {
+    const PoiExport result = readJsonExport(R"({"version": 3, "pois": [{"id": "a", "lat": 1, "lon": 2}]})");
+
+    ASSERT_EQ(1u, result.pois.size());
+    EXPECT_DOUBLE_EQ(2, result.pois[0].center.longitude);
+}
+
+TEST(PoiExportTests, JsonErrors) {
+    EXPECT_FALSE(readJsonExport("").error.empty());
+    EXPECT_FALSE(readJsonExport("[{\"id\": \"a\"").error.empty());
+    EXPECT_FALSE(readJsonExport("{\"places\": []}").error.empty());
+    EXPECT_FALSE(readJsonExport("[1] 2").error.empty());
+}
@@ -0,0 +1,244 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// PoiPackTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include "TestHelpers.hpp"
+#include "placesmonitor/Geo.hpp"
+#include "placesmonitor/PoiPack.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::testing;
+
+namespace {
+
+const Coordinate kOrigin{40.0, -111.0};
+
+// POIs scattered over roughly 40 by 40 km around the origin
+std::vector<Poi> scatteredPois(int count, unsigned seed = 7) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> offset(-0.2, 0.2);
+    std::vector<Poi> pois;
+
+    for (int i = 0; i < count; i++) {
+        Poi poi = makePoi("poi" + std::to_string(i),
+                          Coordinate{kOrigin.latitude + offset(generator), kOrigin.longitude + offset(generator)},
+                          50 + i % 5 * 50);
+        poi.name = "Store " + std::to_string(i);
+        pois.push_back(poi);
+    }
+
+    return pois;
+}
+
+// what the pack must answer, found by measuring the distance to every POI
+std::vector<std::string> bruteForceNearest(const std::vector<Poi>& pois, const Coordinate& coordinate,
+                                           std::size_t count, double maximumDistance) {
+    std::vector<std::pair<double, std::size_t>> distances;
+
+    for (std::size_t i = 0; i < pois.size(); i++) {
+        const double distance = distanceBetween(coordinate, pois[i].center);
+
+        if (distance <= maximumDistance) {
+            distances.emplace_back(distance, i);
+        }
+    }
+
+    std::sort(distances.begin(), distances.end());
+    std::vector<std::string> identifiers;
+
+    for (std::size_t i = 0; i < distances.size() && i < count; i++) {
+        identifiers.push_back(pois[distances[i].second].identifier);
+    }
+
+    return identifiers;
+}
+
+std::vector<std::string> identifiersOf(const std::vector<Poi>& pois) {
+    std::vector<std::string> identifiers;
+
+    for (const Poi& poi : pois) {
+        identifiers.push_back(poi.identifier);
+    }
+
+    return identifiers;
+}
+
+PoiPack packOf(const std::vector<Poi>& pois, double cellSize = kPoiPackCellSize) {
+    auto pack = PoiPack::decode(PoiPack::encode(pois, 42, cellSize));
+    EXPECT_TRUE(pack.has_value());
+    return std::move(*pack);
+}
+
+}
+
+TEST(PoiPackTests, RoundTrip) {
+    Poi poi = makePoi("store-1", kOrigin, 150);
+    poi.name = "Main Street";
+    const PoiPack pack = packOf({poi});
+
+    EXPECT_EQ(1u, pack.size());
+    EXPECT_EQ(1u, pack.cellCount());
+    EXPECT_EQ(42u, pack.revision());
+    EXPECT_DOUBLE_EQ(kPoiPackCellSize, pack.cellSize());
+
+    const auto stored = pack.poiAt(0);
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_EQ("store-1", stored->identifier);
+    EXPECT_EQ("Main Street", stored->name);
+    EXPECT_DOUBLE_EQ(kOrigin.latitude, stored->center.latitude);
+    EXPECT_DOUBLE_EQ(kOrigin.longitude, stored->center.longitude);
+    EXPECT_DOUBLE_EQ(150, stored->radius);
+    EXPECT_FALSE(pack.poiAt(1).has_value());
+}
+
+TEST(PoiPackTests, NearestIsOrderedByDistance) {
+    const PoiPack pack = packOf({makePoi("far", offsetNorth(kOrigin, 900), 100),
+                                 makePoi("near", offsetNorth(kOrigin, 100), 100),
+                                 makePoi("middle", offsetNorth(kOrigin, 400), 100)});
+
+    const std::vector<Poi> nearest = pack.nearest(kOrigin, 2);
+
+    EXPECT_EQ((std::vector<std::string>{"near", "middle"}), identifiersOf(nearest));
+}
+
+TEST(PoiPackTests, NearestSetsUserIsWithin) {
+    const PoiPack pack = packOf({makePoi("inside", offsetNorth(kOrigin, 50), 100),
+                                 makePoi("outside", offsetNorth(kOrigin, 300), 100)});
+
+    const std::vector<Poi> nearest = pack.nearest(kOrigin, 10);
+
+    ASSERT_EQ(2u, nearest.size());
+    EXPECT_TRUE(nearest[0].userIsWithin);
+    EXPECT_FALSE(nearest[1].userIsWithin);
+}
+
+TEST(PoiPackTests, NearestMatchesBruteForce) {
+    const std::vector<Poi> pois = scatteredPois(2000);
+    const PoiPack pack = packOf(pois);
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> offset(-0.25, 0.25);
+
+    for (int i = 0; i < 50; i++) {
+        const Coordinate coordinate{kOrigin.latitude + offset(generator), kOrigin.longitude + offset(generator)};
+
+        EXPECT_EQ(bruteForceNearest(pois, coordinate, 20, kPoiPackSearchRadius),
+                  identifiersOf(pack.nearest(coordinate, 20)));
+    }
+}
+
+TEST(PoiPackTests, NearestHonorsMaximumDistance) {
+    const PoiPack pack = packOf({makePoi("near", offsetNorth(kOrigin, 500), 100),
+                                 makePoi("far", offsetNorth(kOrigin, 5000), 100)});
+
+    EXPECT_EQ((std::vector<std::string>{"near"}), identifiersOf(pack.nearest(kOrigin, 10, 1000)));
+    EXPECT_TRUE(pack.nearest(offsetNorth(kOrigin, 100000), 10).empty());
+}
+
+TEST(PoiPackTests, NearestSearchesAcrossTheAntimeridian) {
+    const PoiPack pack = packOf({makePoi("east", Coordinate{0, 179.999}, 100),
+                                 makePoi("west", Coordinate{0, -179.998}, 100),
+                                 makePoi("elsewhere", Coordinate{0, 170}, 100)});
+
+    const std::vector<Poi> nearest = pack.nearest(Coordinate{0, 180}, 2);
+
+    EXPECT_EQ((std::vector<std::string>{"east", "west"}), identifiersOf(nearest));
+}
+
+TEST(PoiPackTests, NearestWithLargeAndSmallCells) {
+    const std::vector<Poi> pois = scatteredPois(500);
+
+    for (const double cellSize : {0.001, 0.5}) {
+        const PoiPack pack = packOf(pois, cellSize);
+
+        EXPECT_EQ(bruteForceNearest(pois, kOrigin, 10, kPoiPackSearchRadius),
+                  identifiersOf(pack.nearest(kOrigin, 10)));
+    }
+}
+
+TEST(PoiPackTests, EmptyPack) {
+    const PoiPack pack = packOf({});
+
+    EXPECT_EQ(0u, pack.size());
+    EXPECT_TRUE(pack.nearest(kOrigin, 10).empty());
+}
+
+TEST(PoiPackTests, InvalidCentersAreNotStored) {
+    const PoiPack pack = packOf({makePoi("valid", kOrigin, 100),
+                                 makePoi("pole", Coordinate{95, 0}, 100),
+                                 makePoi("nan", Coordinate{NAN, 0}, 100)});
+
+    EXPECT_EQ(1u, pack.size());
+}
+
+TEST(PoiPackTests, RejectsCorruptPacks) {
+    const std::vector<uint8_t> bytes = PoiPack::encode(scatteredPois(10), 1);
+
+    std::vector<uint8_t> badMagic = bytes;
+    badMagic[0] = 'X';
+    EXPECT_FALSE(PoiPack::decode(badMagic).has_value());
+
+    std::vector<uint8_t> badVersion = bytes;
+    badVersion[4] = PoiPack::kVersion + 1;
+    EXPECT_FALSE(PoiPack::decode(badVersion).has_value());
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+    EXPECT_FALSE(PoiPack::decode(truncated).has_value());
+
+    // a cell claiming more records than the pack holds
+    std::vector<uint8_t> badCell = bytes;
+    badCell[PoiPack::kHeaderSize + 12] = 0xFF;
+    EXPECT_FALSE(PoiPack::decode(badCell).has_value());
+
+    EXPECT_FALSE(PoiPack::decode({}).has_value());
+}
+
+TEST(PoiPackTests, RecordWithBadStringsIsSkipped) {
+    std::vector<uint8_t> bytes = PoiPack::encode({makePoi("only", kOrigin, 100)}, 1);
+
+    // the identifier length of the only record points past the string table
+    bytes[PoiPack::kHeaderSize + PoiPack::kCellSize + 28] = 0xFF;
+    const auto pack = PoiPack::decode(bytes);
+
+    ASSERT_TRUE(pack.has_value());
+    EXPECT_FALSE(pack->poiAt(0).has_value());
+    EXPECT_TRUE(pack->nearest(kOrigin, 10).empty());
+}
+
+TEST(PoiPackTests, OpensMappedFile) {
+    const std::string path = ::testing::TempDir() + "poipack_tests.pack";
+    const std::vector<uint8_t> bytes = PoiPack::encode(scatteredPois(100), 7);
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()),
+                                                static_cast<std::streamsize>(bytes.size()));
+
+    auto pack = PoiPack::open(path);
+
+    ASSERT_TRUE(pack.has_value());
+    EXPECT_EQ(100u, pack->size());
+    EXPECT_EQ(7u, pack->revision());
+
+    // the pack keeps its mapping when it is moved
+    PoiPack moved = std::move(*pack);
+    EXPECT_EQ(10u, moved.nearest(kOrigin, 10).size());
+
+    std::remove(path.c_str());
+    EXPECT_FALSE(PoiPack::open(path).has_value());
+}
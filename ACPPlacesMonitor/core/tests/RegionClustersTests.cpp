@@ -0,0 +1,220 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// RegionClustersTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "TestHelpers.hpp"
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/Geo.hpp"
+#include "placesmonitor/RegionClusters.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::testing;
+
+namespace {
+
+const Coordinate kOrigin{40.0, -111.0};
+
+// creates a poi east of the origin, metersEast away from it
+Poi poiEast(const std::string& identifier, double metersEast, double radius) {
+    return makePoi(identifier, destination(kOrigin, 90, metersEast), radius);
+}
+
+void expectEnclosesMembers(const RegionClusters::Cluster& cluster, const std::vector<Poi>& pois) {
+    for (std::size_t member : cluster.members) {
+        EXPECT_LE(distanceBetween(cluster.region.center, pois[member].center) + pois[member].radius,
+                  cluster.region.radius + 0.000001);
+    }
+}
+
+}
+
+TEST(RegionClustersTests, NoPois) {
+    // test
+    RegionClusters clusters = RegionClusters::build({});
+
+    // verify
+    EXPECT_TRUE(clusters.clusters().empty());
+    EXPECT_TRUE(clusters.unclustered().empty());
+    EXPECT_EQ(0u, clusters.savedSlots());
+}
+
+TEST(RegionClustersTests, DistantPoisKeepTheirOwnRegions) {
+    // setup
+    std::vector<Poi> pois = {poiEast("a", 0, 50), poiEast("b", 500, 50), poiEast("c", 1000, 50)};
+
+    // test
+    RegionClusters clusters = RegionClusters::build(pois);
+
+    // verify
+    EXPECT_TRUE(clusters.clusters().empty());
+    EXPECT_EQ((std::vector<std::size_t>{0, 1, 2}), clusters.unclustered());
+    EXPECT_EQ(0u, clusters.savedSlots());
+}
+
+TEST(RegionClustersTests, OverlappingPoisShareOneRegion) {
+    // setup - a food court, plus a store across the road
+    std::vector<Poi> pois = {poiEast("burgers", 0, 20), poiEast("store", 400, 50),
+                             poiEast("tacos", 30, 20), poiEast("noodles", 60, 20)};
+
+    // test
+    RegionClusters clusters = RegionClusters::build(pois);
+
+    // verify
+    ASSERT_EQ(1u, clusters.clusters().size());
+    const RegionClusters::Cluster& cluster = clusters.clusters()[0];
+    EXPECT_EQ((std::vector<std::size_t>{0, 2, 3}), cluster.members);
+    EXPECT_EQ((std::vector<std::size_t>{1}), clusters.unclustered());
+    EXPECT_EQ(2u, clusters.savedSlots());
+    EXPECT_NEAR(50, cluster.region.radius, 0.01);
+    EXPECT_NEAR(30, distanceBetween(kOrigin, cluster.region.center), 0.01);
+    EXPECT_TRUE(cluster.region.notifyOnEntry);
+    EXPECT_TRUE(cluster.region.notifyOnExit);
+    expectEnclosesMembers(cluster, pois);
+}
+
+TEST(RegionClustersTests, GapDecidesWhetherPoisAreLinked) {
+    // setup - the circles are 20 and 30 meters apart
+    std::vector<Poi> near = {poiEast("a", 0, 20), poiEast("b", 60, 20)};
+    std::vector<Poi> far = {poiEast("a", 0, 20), poiEast("b", 70, 20)};
+
+    // verify
+    EXPECT_EQ(1u, RegionClusters::build(near).clusters().size());
+    EXPECT_TRUE(RegionClusters::build(far).clusters().empty());
+}
+
+TEST(RegionClustersTests, ClusterRadiusIsBounded) {
+    // setup - a row of touching shops, longer than a single cluster may be
+    std::vector<Poi> pois;
+
+    for (int i = 0; i < 12; i++) {
+        pois.push_back(poiEast("shop" + std::to_string(i), i * 40, 20));
+    }
+
+    // test
+    RegionClusters clusters = RegionClusters::build(pois, 100);
+
+    // verify
+    EXPECT_GT(clusters.clusters().size(), 1u);
+    std::vector<int> seen(pois.size(), 0);
+
+    for (const RegionClusters::Cluster& cluster : clusters.clusters()) {
+        EXPECT_LE(cluster.region.radius, 100 + 0.01);
+        expectEnclosesMembers(cluster, pois);
+
+        for (std::size_t member : cluster.members) {
+            seen[member]++;
+        }
+    }
+
+    for (std::size_t index : clusters.unclustered()) {
+        seen[index]++;
+    }
+
+    EXPECT_EQ(std::vector<int>(pois.size(), 1), seen);
+}
+
+TEST(RegionClustersTests, LargePoisAreNotClustered) {
+    // setup
+    std::vector<Poi> pois = {poiEast("mall", 0, 300), poiEast("kiosk", 10, 10)};
+
+    // test
+    RegionClusters clusters = RegionClusters::build(pois);
+
+    // verify
+    EXPECT_TRUE(clusters.clusters().empty());
+    EXPECT_EQ(2u, clusters.unclustered().size());
+}
+
+TEST(RegionClustersTests, NoClustersWithoutMaximumRadius) {
+    // setup
+    std::vector<Poi> pois = {poiEast("a", 0, 20), poiEast("b", 30, 20)};
+
+    // verify
+    EXPECT_TRUE(RegionClusters::build(pois, 0).clusters().empty());
+}
+
+TEST(RegionClustersTests, EnclosingCircleIsMinimal) {
+    // setup - three shops on a triangle around the origin
+    std::vector<Poi> pois = {makePoi("a", destination(kOrigin, 0, 40), 10),
+                             makePoi("b", destination(kOrigin, 120, 40), 10),
+                             makePoi("c", destination(kOrigin, 240, 40), 10)};
+
+    // test
+    RegionClusters clusters = RegionClusters::build(pois, kClusterMaximumRadius, 100);
+
+    // verify
+    ASSERT_EQ(1u, clusters.clusters().size());
+    EXPECT_NEAR(50, clusters.clusters()[0].region.radius, 0.05);
+    EXPECT_NEAR(0, distanceBetween(kOrigin, clusters.clusters()[0].region.center), 0.05);
+}
+
+TEST(RegionClustersTests, IdentifierDoesNotDependOnOrder) {
+    // setup
+    std::vector<Poi> pois = {poiEast("b", 0, 20), poiEast("a", 30, 20)};
+    std::vector<Poi> reversed = {pois[1], pois[0]};
+
+    // test
+    RegionClusters clusters = RegionClusters::build(pois);
+
+    // verify
+    ASSERT_EQ(1u, clusters.clusters().size());
+    const std::string identifier = clusters.clusters()[0].region.identifier;
+    EXPECT_EQ(std::string(kClusterRegionIdentifierPrefix) + "a", identifier);
+    EXPECT_EQ(identifier, RegionClusters::build(reversed).clusters()[0].region.identifier);
+    EXPECT_TRUE(RegionClusters::isClusterRegion(identifier));
+    EXPECT_FALSE(RegionClusters::isClusterRegion("a"));
+    EXPECT_FALSE(RegionClusters::isClusterRegion(kBoundaryRegionIdentifier));
+}
+
+TEST(RegionClustersTests, RandomRetailParkIsCovered) {
+    // setup - 60 small POIs scattered over a 400 meter square
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> offset(0, 400);
+    std::uniform_real_distribution<double> radius(10, 40);
+    std::vector<Poi> pois;
+
+    for (int i = 0; i < 60; i++) {
+        pois.push_back(makePoi("poi" + std::to_string(i),
+                               destination(destination(kOrigin, 0, offset(generator)), 90, offset(generator)),
+                               radius(generator)));
+    }
+
+    // test
+    RegionClusters clusters = RegionClusters::build(pois);
+
+    // verify
+    std::vector<int> seen(pois.size(), 0);
+
+    for (const RegionClusters::Cluster& cluster : clusters.clusters()) {
+        EXPECT_GE(cluster.members.size(), 2u);
+        EXPECT_LE(cluster.region.radius, kClusterMaximumRadius + 0.5);
+        expectEnclosesMembers(cluster, pois);
+
+        for (std::size_t member : cluster.members) {
+            seen[member]++;
+        }
+    }
+
+    for (std::size_t index : clusters.unclustered()) {
+        seen[index]++;
+    }
+
+    EXPECT_EQ(std::vector<int>(pois.size(), 1), seen);
+    EXPECT_GT(clusters.savedSlots(), 30u);
+}
@@ -0,0 +1,122 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// RegionScheduleTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "TestHelpers.hpp"
+#include "placesmonitor/Constants.hpp"
+#include "placesmonitor/RegionSchedule.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::testing;
+
+namespace {
+
+const Coordinate kLocation{40.0, -111.0};
+
+// creates a poi north of the test location, metersAway from it
+Poi poiAway(const std::string& identifier, double metersAway, double radius) {
+    return makePoi(identifier, offsetNorth(kLocation, metersAway), radius);
+}
+
+}
+
+TEST(RegionScheduleTests, AllCandidatesFit) {
+    // setup
+    std::vector<Poi> candidates = {poiAway("a", 1000, 100), poiAway("b", 500, 100)};
+
+    // test
+    RegionSchedule schedule = RegionSchedule::build(candidates, kLocation, 2, 1000);
+
+    // verify
+    EXPECT_EQ((std::vector<std::size_t>{0, 1}), schedule.selected());
+    EXPECT_FALSE(schedule.boundary());
+    EXPECT_EQ(0u, schedule.deferredCount());
+}
+
+TEST(RegionScheduleTests, RanksByEdgeDistance) {
+    // setup - "big" has the farthest center but the closest edge
+    std::vector<Poi> candidates = {poiAway("farther", 3000, 100), poiAway("far", 2000, 100),
+                                   poiAway("near", 600, 100), poiAway("big", 900, 800)};
+
+    // test
+    RegionSchedule schedule = RegionSchedule::build(candidates, kLocation, 3, 10000);
+
+    // verify
+    EXPECT_EQ((std::vector<std::size_t>{3, 2}), schedule.selected());
+    EXPECT_EQ(2u, schedule.deferredCount());
+}
+
+TEST(RegionScheduleTests, BoundaryReachesClosestDeferredCandidate) {
+    // setup
+    std::vector<Poi> candidates = {poiAway("a", 500, 100), poiAway("b", 2000, 100), poiAway("c", 3000, 100)};
+
+    // test
+    RegionSchedule schedule = RegionSchedule::build(candidates, kLocation, 2, 10000);
+
+    // verify
+    ASSERT_TRUE(schedule.boundary());
+    const Region& boundary = *schedule.boundary();
+    EXPECT_EQ(kBoundaryRegionIdentifier, boundary.identifier);
+    EXPECT_NEAR(1900, boundary.radius, 1);
+    EXPECT_DOUBLE_EQ(kLocation.latitude, boundary.center.latitude);
+    EXPECT_TRUE(boundary.notifyOnExit);
+    EXPECT_FALSE(boundary.notifyOnEntry);
+}
+
+TEST(RegionScheduleTests, BoundaryRadiusIsClamped) {
+    // setup
+    std::vector<Poi> candidates = {poiAway("a", 10, 100), poiAway("b", 20, 100), poiAway("c", 5000, 100),
+                                   poiAway("d", 6000, 100)};
+
+    // test
+    RegionSchedule small = RegionSchedule::build(candidates, kLocation, 2, 10000);
+    RegionSchedule large = RegionSchedule::build(candidates, kLocation, 3, 1000);
+
+    // verify - the device is inside "b" so its edge distance is negative
+    ASSERT_TRUE(small.boundary() && large.boundary());
+    EXPECT_EQ(kBoundaryMinimumRadius, small.boundary()->radius);
+    EXPECT_EQ(1000, large.boundary()->radius);
+}
+
+TEST(RegionScheduleTests, SingleSlotHasNoBoundary) {
+    // setup
+    std::vector<Poi> candidates = {poiAway("a", 500, 100), poiAway("b", 2000, 100)};
+
+    // test
+    RegionSchedule schedule = RegionSchedule::build(candidates, kLocation, 1, 10000);
+
+    // verify
+    EXPECT_EQ(1u, schedule.selected().size());
+    EXPECT_FALSE(schedule.boundary());
+    EXPECT_EQ(1u, schedule.deferredCount());
+}
+
+TEST(RegionScheduleTests, TiesKeepCandidateOrder) {
+    // setup
+    std::vector<Poi> candidates = {poiAway("a", 500, 100), poiAway("b", 500, 100), poiAway("c", 500, 100)};
+
+    // test
+    RegionSchedule schedule = RegionSchedule::build(candidates, kLocation, 2, 0);
+
+    // verify
+    EXPECT_EQ((std::vector<std::size_t>{0}), schedule.selected());
+}
+
+TEST(RegionScheduleTests, IsBoundaryRegion) {
+    EXPECT_TRUE(RegionSchedule::isBoundaryRegion(kBoundaryRegionIdentifier));
+    EXPECT_FALSE(RegionSchedule::isBoundaryRegion("poi"));
+}
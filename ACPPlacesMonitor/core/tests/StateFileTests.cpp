@@ -0,0 +1,279 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// StateFileTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "placesmonitor/MappedFile.hpp"
+#include "placesmonitor/StateFile.hpp"
+
+using namespace placesmonitor;
+
+namespace {
+
+PersistedState sampleState() {
+    PersistedState state;
+    state.monitorMode = MonitorModeContinuous | MonitorModeSignificantChanges;
+    state.authorizationLevel = AuthorizationLevelAlways;
+    state.monitoringStarted = true;
+    state.monitoredRegions = {"region a", "region b", ""};
+    state.userWithinRegions = {"region a"};
+
+    Location location;
+    location.coordinate = Coordinate{40.4, -111.9};
+    location.horizontalAccuracy = 12.5;
+    location.timestamp = 1700000000.25;
+    state.lastQueryLocation = location;
+
+    return state;
+}
+
+std::string temporaryPath(const std::string& name) {
+    return ::testing::TempDir() + name;
+}
+
+std::vector<uint8_t> readBytes(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+}
+
+TEST(StateFileTests, RoundTrip) {
+    const PersistedState state = sampleState();
+    const std::vector<uint8_t> bytes = StateFile::encode(state);
+    const auto decoded = StateFile::decode(bytes.data(), bytes.size());
+
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(state.monitorMode, decoded->monitorMode);
+    EXPECT_EQ(state.authorizationLevel, decoded->authorizationLevel);
+    EXPECT_EQ(state.monitoringStarted, decoded->monitoringStarted);
+    EXPECT_EQ(state.monitoredRegions, decoded->monitoredRegions);
+    EXPECT_EQ(state.userWithinRegions, decoded->userWithinRegions);
+    ASSERT_TRUE(decoded->lastQueryLocation.has_value());
+    EXPECT_DOUBLE_EQ(40.4, decoded->lastQueryLocation->coordinate.latitude);
+    EXPECT_DOUBLE_EQ(-111.9, decoded->lastQueryLocation->coordinate.longitude);
+    EXPECT_DOUBLE_EQ(12.5, decoded->lastQueryLocation->horizontalAccuracy);
+    EXPECT_DOUBLE_EQ(1700000000.25, decoded->lastQueryLocation->timestamp);
+}
+
+TEST(StateFileTests, MissingValuesStayEmpty) {
+    const std::vector<uint8_t> bytes = StateFile::encode(PersistedState {});
+    const auto decoded = StateFile::decode(bytes.data(), bytes.size());
+
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_FALSE(decoded->monitorMode.has_value());
+    EXPECT_FALSE(decoded->authorizationLevel.has_value());
+    EXPECT_FALSE(decoded->monitoringStarted.has_value());
+    EXPECT_FALSE(decoded->lastQueryLocation.has_value());
+    EXPECT_TRUE(decoded->monitoredRegions.empty());
+    EXPECT_TRUE(decoded->userWithinRegions.empty());
+}
+
+TEST(StateFileTests, FalseIsNotMissing) {
+    PersistedState state;
+    state.monitoringStarted = false;
+    state.monitorMode = 0;
+    const std::vector<uint8_t> bytes = StateFile::encode(state);
+    const auto decoded = StateFile::decode(bytes.data(), bytes.size());
+
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(std::optional<bool>(false), decoded->monitoringStarted);
+    EXPECT_EQ(std::optional<int64_t>(0), decoded->monitorMode);
+}
+
+TEST(StateFileTests, HeaderLayout) {
+    const std::vector<uint8_t> bytes = StateFile::encode(PersistedState {});
+
+    ASSERT_GE(bytes.size(), StateFile::kHeaderSize);
+    EXPECT_EQ('P', bytes[0]);
+    EXPECT_EQ('M', bytes[1]);
+    EXPECT_EQ('S', bytes[2]);
+    EXPECT_EQ('T', bytes[3]);
+    EXPECT_EQ(StateFile::kVersion, bytes[4] | (bytes[5] << 8));
+    EXPECT_EQ(bytes.size() - StateFile::kHeaderSize, static_cast<std::size_t>(bytes[8] | (bytes[9] << 8)));
+}
+
+TEST(StateFileTests, ChecksumMatchesCrc32) {
+    const std::string text = "123456789";
+    EXPECT_EQ(0xCBF43926u, StateFile::checksum(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+}
+
+TEST(StateFileTests, RejectsBadMagic) {
+    std::vector<uint8_t> bytes = StateFile::encode(sampleState());
+    bytes[0] = 'X';
+
+    EXPECT_FALSE(StateFile::decode(bytes.data(), bytes.size()).has_value());
+}
+
+TEST(StateFileTests, RejectsOtherVersion) {
+    std::vector<uint8_t> bytes = StateFile::encode(sampleState());
+    bytes[4] = StateFile::kVersion + 1;
+
+    EXPECT_FALSE(StateFile::decode(bytes.data(), bytes.size()).has_value());
+}
+
+TEST(StateFileTests, RejectsCorruptPayload) {
+    std::vector<uint8_t> bytes = StateFile::encode(sampleState());
+    bytes.back() ^= 0xFF;
+
+    EXPECT_FALSE(StateFile::decode(bytes.data(), bytes.size()).has_value());
+}
+
+TEST(StateFileTests, RejectsTruncatedFile) {
+    const std::vector<uint8_t> bytes = StateFile::encode(sampleState());
+
+    for (std::size_t size = 0; size < bytes.size(); size++) {
+        EXPECT_FALSE(StateFile::decode(bytes.data(), size).has_value()) << "size " << size;
+    }
+}
+
+TEST(StateFileTests, RejectsImpossibleStringCount) {
+    PersistedState state;
+    state.monitoredRegions = {"a"};
+    std::vector<uint8_t> bytes = StateFile::encode(state);
+
+    // point the monitored regions count at far more strings than the payload can hold, then fix up the checksum
+    const std::size_t countOffset = StateFile::kHeaderSize + 2 + 8 + 8 + 4 * 8;
+    bytes[countOffset + 3] = 0x7F;
+    const uint32_t checksum = StateFile::checksum(bytes.data() + StateFile::kHeaderSize,
+                                                  bytes.size() - StateFile::kHeaderSize);
+
+    for (int i = 0; i < 4; i++) {
+        bytes[12 + i] = static_cast<uint8_t>(checksum >> (8 * i));
+    }
+
+    EXPECT_FALSE(StateFile::decode(bytes.data(), bytes.size()).has_value());
+}
+
+TEST(StateFileTests, WriteAndRead) {
+    const StateFile file(temporaryPath("statefile_write_and_read.bin"));
+    ASSERT_TRUE(file.write(sampleState()));
+
+    const auto result = file.read();
+
+    ASSERT_EQ(StateFile::ReadStatus::Loaded, result.status);
+    ASSERT_TRUE(result.state.has_value());
+    EXPECT_EQ(sampleState().monitoredRegions, result.state->monitoredRegions);
+    EXPECT_EQ(readBytes(file.path()), StateFile::encode(sampleState()));
+    EXPECT_TRUE(file.remove());
+}
+
+TEST(StateFileTests, WriteReplacesPreviousState) {
+    const StateFile file(temporaryPath("statefile_replace.bin"));
+    ASSERT_TRUE(file.write(sampleState()));
+
+    PersistedState state;
+    state.monitoredRegions = {"only"};
+    ASSERT_TRUE(file.write(state));
+
+    const auto read = file.read().state;
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(std::vector<std::string>{"only"}, read->monitoredRegions);
+    EXPECT_FALSE(read->monitorMode.has_value());
+    EXPECT_FALSE(MappedFile(file.path() + ".tmp").isOpen());
+    EXPECT_TRUE(file.remove());
+}
+
+TEST(StateFileTests, MissingFileReadsAsMissing) {
+    const StateFile file(temporaryPath("statefile_missing.bin"));
+    file.remove();
+
+    const auto result = file.read();
+
+    EXPECT_EQ(StateFile::ReadStatus::Missing, result.status);
+    EXPECT_FALSE(result.state.has_value());
+    EXPECT_TRUE(file.remove());
+}
+
+TEST(StateFileTests, CorruptFileReadsAsCorrupt) {
+    const StateFile file(temporaryPath("statefile_corrupt.bin"));
+    writeBytes(file.path(), {'n', 'o', 't', ' ', 'a', ' ', 's', 't', 'a', 't', 'e', ' ', 'f', 'i', 'l', 'e', '!'});
+
+    const auto result = file.read();
+
+    EXPECT_EQ(StateFile::ReadStatus::Corrupt, result.status);
+    EXPECT_FALSE(result.state.has_value());
+    EXPECT_TRUE(file.remove());
+}
+
+TEST(StateFileTests, EmptyFileReadsAsCorrupt) {
+    const StateFile file(temporaryPath("statefile_empty.bin"));
+    writeBytes(file.path(), {});
+
+    EXPECT_EQ(StateFile::ReadStatus::Corrupt, file.read().status);
+    EXPECT_TRUE(file.remove());
+}
+
+TEST(StateFileTests, MoveToBackupKeepsTheFile) {
+    const StateFile file(temporaryPath("statefile_backup.bin"));
+    const std::vector<uint8_t> bytes = {'n', 'o', 't', ' ', 'a', ' ', 's', 't', 'a', 't', 'e'};
+    writeBytes(file.path(), bytes);
+
+    ASSERT_TRUE(file.moveToBackup());
+
+    EXPECT_EQ(StateFile::ReadStatus::Missing, file.read().status);
+    EXPECT_EQ(bytes, readBytes(file.backupPath()));
+    std::remove(file.backupPath().c_str());
+}
+
+TEST(StateFileTests, WriteFailsInMissingDirectory) {
+    const StateFile file(temporaryPath("missing_directory/state.bin"));
+
+    EXPECT_FALSE(file.write(sampleState()));
+}
+
+TEST(MappedFileTests, MapsFileContents) {
+    const std::string path = temporaryPath("mappedfile_contents.bin");
+    writeBytes(path, {1, 2, 3, 4});
+
+    const MappedFile file(path);
+
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(4u, file.size());
+    EXPECT_EQ(3, file.data()[2]);
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTests, MissingOrEmptyFileIsNotOpen) {
+    const std::string path = temporaryPath("mappedfile_empty.bin");
+    writeBytes(path, {});
+
+    EXPECT_FALSE(MappedFile(path).isOpen());
+    EXPECT_FALSE(MappedFile(temporaryPath("mappedfile_missing.bin")).isOpen());
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTests, MoveTransfersMapping) {
+    const std::string path = temporaryPath("mappedfile_move.bin");
+    writeBytes(path, {9});
+
+    MappedFile first(path);
+    MappedFile second(std::move(first));
+
+    EXPECT_FALSE(first.isOpen());
+    ASSERT_TRUE(second.isOpen());
+    EXPECT_EQ(9, second.data()[0]);
+    std::remove(path.c_str());
+}
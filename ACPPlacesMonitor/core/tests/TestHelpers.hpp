@@ -0,0 +1,49 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// TestHelpers.hpp
+//
+
+#pragma once
+
+#include <string>
+
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+namespace testing {
+
+// coordinate helpers, roughly 111km per degree of latitude
+
+inline Coordinate offsetNorth(const Coordinate& origin, double meters) {
+    return Coordinate{origin.latitude + meters / 111195.0, origin.longitude};
+}
+
+inline Poi makePoi(const std::string& identifier, const Coordinate& center, double radius) {
+    Poi poi;
+    poi.identifier = identifier;
+    poi.center = center;
+    poi.radius = radius;
+    return poi;
+}
+
+inline Location makeLocation(const Coordinate& coordinate, double accuracy = 5, double timestamp = 0) {
+    Location location;
+    location.coordinate = coordinate;
+    location.horizontalAccuracy = accuracy;
+    location.timestamp = timestamp;
+    return location;
+}
+
+}
+}
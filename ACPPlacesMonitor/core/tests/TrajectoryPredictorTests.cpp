@@ -0,0 +1,102 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// TrajectoryPredictorTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "TestHelpers.hpp"
+#include "placesmonitor/Geo.hpp"
+#include "placesmonitor/TrajectoryPredictor.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::testing;
+
+namespace {
+
+const Coordinate kOrigin{40.0, -111.0};
+
+Location movingFix(const Coordinate& coordinate, double timestamp, double speed, double course) {
+    Location location = makeLocation(coordinate, 10, timestamp);
+    location.speed = speed;
+    location.course = course;
+    return location;
+}
+
+}
+
+TEST(TrajectoryPredictorTests, UsesReportedSpeedAndCourse) {
+    DeadReckoningPredictor predictor;
+    Location predicted;
+
+    ASSERT_TRUE(predictor.predict({movingFix(kOrigin, 100, 20, 90)}, 60, predicted));
+
+    EXPECT_NEAR(1200, distanceBetween(kOrigin, predicted.coordinate), 0.01);
+    EXPECT_NEAR(90, bearingBetween(kOrigin, predicted.coordinate), 0.01);
+    EXPECT_DOUBLE_EQ(160, predicted.timestamp);
+    EXPECT_DOUBLE_EQ(20, predicted.speed);
+}
+
+TEST(TrajectoryPredictorTests, DerivesVelocityFromHistory) {
+    DeadReckoningPredictor predictor;
+    Location predicted;
+
+    // significant location changes don't report a speed or course
+    const std::vector<Location> history{movingFix(kOrigin, 0, -1, -1),
+                                        movingFix(offsetNorth(kOrigin, 500), 50, -1, -1),
+                                        movingFix(offsetNorth(kOrigin, 1000), 100, -1, -1)};
+
+    ASSERT_TRUE(predictor.predict(history, 100, predicted));
+
+    EXPECT_NEAR(2000, distanceBetween(kOrigin, predicted.coordinate), 1);
+    EXPECT_NEAR(0, bearingBetween(kOrigin, predicted.coordinate), 0.01);
+    EXPECT_NEAR(10, predicted.speed, 0.01);
+}
+
+TEST(TrajectoryPredictorTests, IgnoresFixesOutsideHistoryWindow) {
+    DeadReckoningPredictor predictor(60);
+    Location predicted;
+
+    // the device was parked for an hour before it started moving
+    const std::vector<Location> history{movingFix(kOrigin, 0, -1, -1),
+                                        movingFix(kOrigin, 3600, -1, -1),
+                                        movingFix(offsetNorth(kOrigin, 600), 3630, -1, -1)};
+
+    ASSERT_TRUE(predictor.predict(history, 30, predicted));
+
+    EXPECT_NEAR(1200, distanceBetween(kOrigin, predicted.coordinate), 1);
+}
+
+TEST(TrajectoryPredictorTests, SingleFixWithoutVelocity) {
+    DeadReckoningPredictor predictor;
+    Location predicted;
+
+    EXPECT_FALSE(predictor.predict({movingFix(kOrigin, 0, -1, -1)}, 60, predicted));
+}
+
+TEST(TrajectoryPredictorTests, EmptyHistory) {
+    DeadReckoningPredictor predictor;
+    Location predicted;
+
+    EXPECT_FALSE(predictor.predict({}, 60, predicted));
+}
+
+TEST(TrajectoryPredictorTests, StationaryDeviceStaysPut) {
+    DeadReckoningPredictor predictor;
+    Location predicted;
+
+    ASSERT_TRUE(predictor.predict({movingFix(kOrigin, 0, 0, 0)}, 300, predicted));
+
+    EXPECT_NEAR(0, distanceBetween(kOrigin, predicted.coordinate), 1e-6);
+}
@@ -0,0 +1,225 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// TrajectoryPrefetcherTests.cpp
+//
+
+#include <gtest/gtest.h>
+
+#include "TestHelpers.hpp"
+#include "placesmonitor/Geo.hpp"
+#include "placesmonitor/TrajectoryPrefetcher.hpp"
+
+using namespace placesmonitor;
+using namespace placesmonitor::testing;
+
+namespace {
+
+const Coordinate kOrigin{40.0, -111.0};
+
+// a fix on a road heading north from the origin, at 20 meters per second
+Location drivingFix(double meters, double timestamp) {
+    Location location = makeLocation(offsetNorth(kOrigin, meters), 10, timestamp);
+    location.speed = 20;
+    location.course = 0;
+    return location;
+}
+
+// predicts the device always ends up at the same place, whatever its history
+class FixedPredictor : public TrajectoryPredictor {
+public:
+    explicit FixedPredictor(const Coordinate& target) : target_(target) {}
+
+    bool predict(const std::vector<Location>& history, double seconds, Location& predicted) const override {
+        predicted = history.back();
+        predicted.coordinate = target_;
+        predicted.timestamp += seconds;
+        return true;
+    }
+
+private:
+    Coordinate target_;
+};
+
+}
+
+TEST(LocationHistoryTests, KeepsNewestFixesInOrder) {
+    LocationHistory history(3);
+
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(history.add(makeLocation(kOrigin, 5, i)));
+    }
+
+    const std::vector<Location> fixes = history.fixes();
+    ASSERT_EQ(3u, fixes.size());
+    EXPECT_DOUBLE_EQ(2, fixes[0].timestamp);
+    EXPECT_DOUBLE_EQ(3, fixes[1].timestamp);
+    EXPECT_DOUBLE_EQ(4, fixes[2].timestamp);
+}
+
+TEST(LocationHistoryTests, IgnoresInvalidAndStaleFixes) {
+    LocationHistory history(3);
+
+    EXPECT_TRUE(history.add(makeLocation(kOrigin, 5, 10)));
+    EXPECT_FALSE(history.add(makeLocation(kOrigin, -1, 11)));
+    EXPECT_FALSE(history.add(makeLocation(kOrigin, 5, 10)));
+    EXPECT_FALSE(history.add(makeLocation(kOrigin, 5, 9)));
+    EXPECT_EQ(1u, history.size());
+
+    history.clear();
+    EXPECT_EQ(0u, history.size());
+    EXPECT_TRUE(history.fixes().empty());
+}
+
+TEST(TrajectoryPrefetcherTests, PlansPointsAlongPath) {
+    TrajectoryPrefetcher prefetcher;
+
+    const std::vector<Location> points = prefetcher.onLocation(drivingFix(0, 0));
+
+    // 6km are covered within the horizon, the number of points is capped
+    ASSERT_EQ(kPrefetchMaximumPoints, points.size());
+
+    for (std::size_t i = 0; i < points.size(); i++) {
+        EXPECT_NEAR((i + 1) * kPrefetchSpacing, distanceBetween(kOrigin, points[i].coordinate), 1);
+        EXPECT_NEAR((i + 1) * kPrefetchSpacing / 20, points[i].timestamp, 0.01);
+    }
+
+    EXPECT_EQ(kPrefetchMaximumPoints, prefetcher.statistics().predictions);
+    EXPECT_EQ(kPrefetchMaximumPoints, prefetcher.pendingCount());
+}
+
+TEST(TrajectoryPrefetcherTests, SlowDeviceIsNotPrefetched) {
+    TrajectoryPrefetcher prefetcher;
+    Location walking = drivingFix(0, 0);
+    walking.speed = 1.5;
+
+    EXPECT_TRUE(prefetcher.onLocation(walking).empty());
+    EXPECT_EQ(0u, prefetcher.statistics().predictions);
+}
+
+TEST(TrajectoryPrefetcherTests, InvalidFixIsIgnored) {
+    TrajectoryPrefetcher prefetcher;
+    Location invalid = drivingFix(0, 0);
+    invalid.horizontalAccuracy = -1;
+
+    EXPECT_TRUE(prefetcher.onLocation(invalid).empty());
+}
+
+TEST(TrajectoryPrefetcherTests, CoveredPointsAreNotPlannedAgain) {
+    TrajectoryPrefetcher prefetcher;
+    prefetcher.onLocation(drivingFix(0, 0));
+
+    // every point of the next plan is still covered by a pending prediction
+    EXPECT_TRUE(prefetcher.onLocation(drivingFix(100, 5)).empty());
+
+    // once the device moved on, only the newly reachable point is fetched
+    const std::vector<Location> points = prefetcher.onLocation(drivingFix(1000, 50));
+    ASSERT_EQ(1u, points.size());
+    EXPECT_NEAR(5000, distanceBetween(kOrigin, points[0].coordinate), 1);
+}
+
+TEST(TrajectoryPrefetcherTests, ReachingPredictionIsHit) {
+    TrajectoryPrefetcher prefetcher;
+    prefetcher.onLocation(drivingFix(0, 0));
+
+    prefetcher.onLocation(drivingFix(1100, 55));
+    prefetcher.onLocation(drivingFix(2050, 102));
+
+    EXPECT_EQ(2u, prefetcher.statistics().hits);
+    EXPECT_EQ(0u, prefetcher.statistics().misses);
+    EXPECT_DOUBLE_EQ(1, prefetcher.statistics().hitRate());
+}
+
+TEST(TrajectoryPrefetcherTests, TurningAwayIsMiss) {
+    PrefetchSettings settings;
+    settings.maximumPoints = 2;
+    TrajectoryPrefetcher prefetcher(std::make_shared<DeadReckoningPredictor>(), settings);
+    prefetcher.onLocation(drivingFix(0, 0));
+
+    // the device turned east and stopped, long after it was expected at the predictions
+    Location parked = makeLocation(destination(kOrigin, 90, 3000), 10, 1000);
+    parked.speed = 0;
+    parked.course = 90;
+    prefetcher.onLocation(parked);
+
+    EXPECT_EQ(0u, prefetcher.statistics().hits);
+    EXPECT_EQ(2u, prefetcher.statistics().misses);
+    EXPECT_DOUBLE_EQ(0, prefetcher.statistics().hitRate());
+    EXPECT_EQ(0u, prefetcher.pendingCount());
+}
+
+TEST(TrajectoryPrefetcherTests, PendingPredictionIsNotScoredEarly) {
+    TrajectoryPrefetcher prefetcher;
+    prefetcher.onLocation(drivingFix(0, 0));
+
+    // the device is stuck in traffic, but could still reach the predictions
+    Location stopped = drivingFix(200, 100);
+    stopped.speed = 0;
+    prefetcher.onLocation(stopped);
+
+    EXPECT_EQ(0u, prefetcher.statistics().misses);
+    EXPECT_EQ(kPrefetchMaximumPoints, prefetcher.pendingCount());
+}
+
+TEST(TrajectoryPrefetcherTests, PredictorIsPluggable) {
+    const Coordinate airport = destination(kOrigin, 45, 8000);
+    TrajectoryPrefetcher prefetcher(std::make_shared<FixedPredictor>(airport));
+
+    const std::vector<Location> points = prefetcher.onLocation(drivingFix(0, 0));
+
+    // every point the predictor was asked for is at the airport, so one fetch covers them all
+    ASSERT_EQ(1u, points.size());
+    EXPECT_NEAR(0, distanceBetween(airport, points[0].coordinate), 1e-6);
+}
+
+TEST(TrajectoryPrefetcherTests, SettingPredictorForgetsHistory) {
+    TrajectoryPrefetcher prefetcher;
+    prefetcher.onLocation(drivingFix(0, 0));
+
+    prefetcher.setPredictor(std::make_shared<FixedPredictor>(kOrigin));
+
+    EXPECT_EQ(0u, prefetcher.pendingCount());
+    EXPECT_EQ(kPrefetchMaximumPoints, prefetcher.statistics().predictions);
+}
+
+TEST(TrajectoryPrefetcherTests, ResetKeepsStatistics) {
+    TrajectoryPrefetcher prefetcher;
+    prefetcher.onLocation(drivingFix(0, 0));
+    prefetcher.onLocation(drivingFix(1000, 50));
+
+    prefetcher.reset();
+
+    EXPECT_EQ(0u, prefetcher.pendingCount());
+    EXPECT_EQ(1u, prefetcher.statistics().hits);
+
+    // an older fix is accepted again after a reset
+    EXPECT_FALSE(prefetcher.onLocation(drivingFix(0, 0)).empty());
+}
+
+TEST(TrajectoryPrefetcherTests, PendingPredictionsAreBounded) {
+    PrefetchSettings settings;
+    settings.historySize = 2;
+    settings.maximumPoints = 2;
+    TrajectoryPrefetcher prefetcher(std::make_shared<DeadReckoningPredictor>(), settings);
+
+    // every fix heads in a new direction, so no prediction is ever reached or covered
+    for (int i = 0; i < 10; i++) {
+        Location location = makeLocation(kOrigin, 10, i);
+        location.speed = 20;
+        location.course = i * 36;
+        prefetcher.onLocation(location);
+    }
+
+    EXPECT_EQ(4u, prefetcher.pendingCount());
+    EXPECT_EQ(prefetcher.statistics().predictions - 4, prefetcher.statistics().misses);
+}
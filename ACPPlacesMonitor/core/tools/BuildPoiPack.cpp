@@ -0,0 +1,105 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// BuildPoiPack.cpp
+//
+
+// Builds a POI pack for +[ACPPlacesMonitor setPoiPackPath:] from a CSV or JSON export of a POI library.
+//
+// usage: placesmonitor_build_poi_pack [--revision N] [--cell-size DEGREES] EXPORT PACK
+//
+// The export is read as JSON when its name ends in .json and as CSV otherwise, see PoiExport.hpp for the columns.
+// The revision defaults to the time the pack is built, in seconds since 1970.
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "PoiExport.hpp"
+#include "placesmonitor/PoiPack.hpp"
+
+using namespace placesmonitor;
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr, "usage: placesmonitor_build_poi_pack [--revision N] [--cell-size DEGREES] EXPORT PACK\n");
+    return 2;
+}
+
+bool endsWith(const std::string& value, const std::string& suffix) {
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    uint64_t revision = static_cast<uint64_t>(std::time(nullptr));
+    double cellSize = kPoiPackCellSize;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--revision" && i + 1 < argc) {
+            revision = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--cell-size" && i + 1 < argc) {
+            cellSize = std::strtod(argv[++i], nullptr);
+        } else if (argument.rfind("--", 0) == 0) {
+            return usage();
+        } else {
+            paths.push_back(argument);
+        }
+    }
+
+    if (paths.size() != 2 || !(cellSize > 0)) {
+        return usage();
+    }
+
+    std::ifstream input(paths[0], std::ios::binary);
+
+    if (!input) {
+        std::fprintf(stderr, "unable to read %s\n", paths[0].c_str());
+        return 1;
+    }
+
+    const std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    const tools::PoiExport poiExport = endsWith(paths[0], ".json") ? tools::readJsonExport(text)
+                                                                   : tools::readCsvExport(text);
+
+    if (!poiExport.error.empty()) {
+        std::fprintf(stderr, "unable to read %s: %s\n", paths[0].c_str(), poiExport.error.c_str());
+        return 1;
+    }
+
+    const std::vector<uint8_t> bytes = PoiPack::encode(poiExport.pois, revision, cellSize);
+    std::ofstream output(paths[1], std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    output.close();
+
+    // reading the pack back catches a truncated write before the pack ships with an app
+    const auto pack = PoiPack::open(paths[1]);
+
+    if (!output || !pack || pack->size() != poiExport.pois.size()) {
+        std::fprintf(stderr, "unable to write %s\n", paths[1].c_str());
+        return 1;
+    }
+
+    std::printf("%zu POIs in %zu cells, %zu bytes, revision %llu (%zu rows skipped)\n", pack->size(),
+                pack->cellCount(), bytes.size(), static_cast<unsigned long long>(revision), poiExport.skipped);
+    return 0;
+}
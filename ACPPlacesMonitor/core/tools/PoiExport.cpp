@@ -0,0 +1,505 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// PoiExport.cpp
+//
+
+#include "PoiExport.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <unordered_set>
+
+namespace placesmonitor {
+namespace tools {
+
+namespace {
+
+enum class Field {
+    Identifier,
+    Name,
+    Latitude,
+    Longitude,
+    Radius,
+    Unknown
+};
+
+Field fieldNamed(std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    if (name == "identifier" || name == "id") {
+        return Field::Identifier;
+    } else if (name == "name") {
+        return Field::Name;
+    } else if (name == "latitude" || name == "lat") {
+        return Field::Latitude;
+    } else if (name == "longitude" || name == "lon" || name == "lng") {
+        return Field::Longitude;
+    } else if (name == "radius") {
+        return Field::Radius;
+    }
+
+    return Field::Unknown;
+}
+
+std::optional<double> parseNumber(const std::string& text) {
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    const double value = std::strtod(begin, &end);
+
+    while (end && std::isspace(static_cast<unsigned char>(*end))) {
+        end++;
+    }
+
+    if (end == begin || !end || *end != '\0' || !std::isfinite(value)) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+// the values read for one POI, before they are checked
+struct Row {
+    std::string identifier;
+    std::string name;
+    std::optional<double> latitude;
+    std::optional<double> longitude;
+    std::optional<double> radius;
+
+    void set(Field field, const std::string& value) {
+        switch (field) {
+            case Field::Identifier: identifier = value; break;
+            case Field::Name: name = value; break;
+            case Field::Latitude: latitude = parseNumber(value); break;
+            case Field::Longitude: longitude = parseNumber(value); break;
+            case Field::Radius: radius = parseNumber(value); break;
+            case Field::Unknown: break;
+        }
+    }
+};
+
+class Collector {
+public:
+    explicit Collector(PoiExport& result) : result_(result) {}
+
+    void add(const Row& row) {
+        const bool valid = !row.identifier.empty() && row.latitude && row.longitude &&
+                           std::abs(*row.latitude) <= 90 && std::abs(*row.longitude) <= 180 &&
+                           row.radius.value_or(0) >= 0;
+
+        if (!valid || !identifiers_.insert(row.identifier).second) {
+            result_.skipped++;
+            return;
+        }
+
+        Poi poi;
+        poi.identifier = row.identifier;
+        poi.name = row.name;
+        poi.center = Coordinate{*row.latitude, *row.longitude};
+        poi.radius = row.radius.value_or(0);
+        result_.pois.push_back(std::move(poi));
+    }
+
+private:
+    PoiExport& result_;
+    std::unordered_set<std::string> identifiers_;
+};
+
+std::vector<std::vector<std::string>> csvRows(const std::string& text, bool& unterminated) {
+    std::vector<std::vector<std::string>> rows;
+    std::vector<std::string> row;
+    std::string field;
+    bool quoted = false;
+    bool rowHasContent = false;
+
+    for (std::size_t i = 0; i < text.size(); i++) {
+        const char c = text[i];
+
+        if (quoted) {
+            if (c == '"' && i + 1 < text.size() && text[i + 1] == '"') {
+                field += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+            rowHasContent = true;
+        } else if (c == ',') {
+            row.push_back(field);
+            field.clear();
+            rowHasContent = true;
+        } else if (c == '\n' || c == '\r') {
+            if (rowHasContent || !field.empty()) {
+                row.push_back(field);
+                rows.push_back(row);
+            }
+
+            row.clear();
+            field.clear();
+            rowHasContent = false;
+        } else {
+            field += c;
+        }
+    }
+
+    if (rowHasContent || !field.empty()) {
+        row.push_back(field);
+        rows.push_back(row);
+    }
+
+    unterminated = quoted;
+    return rows;
+}
+
+std::string trimmed(const std::string& value) {
+    const auto begin = std::find_if_not(value.begin(), value.end(), [](unsigned char c) { return std::isspace(c); });
+    const auto end = std::find_if_not(value.rbegin(), value.rend(), [](unsigned char c) { return std::isspace(c); });
+    return begin < end.base() ? std::string(begin, end.base()) : std::string();
+}
+
+// just enough of JSON to read an export: values are parsed into a small tree, strings are kept as UTF-8
+struct JsonValue {
+    enum class Type { Null, Boolean, Number, String, Array, Object } type = Type::Null;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> elements;
+    std::vector<std::pair<std::string, JsonValue>> members;
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+
+    std::optional<JsonValue> parse() {
+        JsonValue value;
+
+        if (!parseValue(value, 0)) {
+            return std::nullopt;
+        }
+
+        skipSpace();
+        return offset_ == text_.size() ? std::optional<JsonValue>(std::move(value)) : std::nullopt;
+    }
+
+private:
+    static constexpr int kMaximumDepth = 64;
+
+    void skipSpace() {
+        while (offset_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[offset_]))) {
+            offset_++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+
+        if (offset_ < text_.size() && text_[offset_] == c) {
+            offset_++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool literal(const char* word) {
+        const std::size_t length = std::char_traits<char>::length(word);
+
+        if (text_.compare(offset_, length, word) != 0) {
+            return false;
+        }
+
+        offset_ += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        skipSpace();
+
+        if (offset_ >= text_.size() || depth > kMaximumDepth) {
+            return false;
+        }
+
+        const char c = text_[offset_];
+
+        if (c == '{') {
+            offset_++;
+            value.type = JsonValue::Type::Object;
+
+            if (consume('}')) {
+                return true;
+            }
+
+            do {
+                std::string name;
+                JsonValue member;
+
+                skipSpace();
+
+                if (!parseString(name) || !consume(':') || !parseValue(member, depth + 1)) {
+                    return false;
+                }
+
+                value.members.emplace_back(std::move(name), std::move(member));
+            } while (consume(','));
+
+            return consume('}');
+        } else if (c == '[') {
+            offset_++;
+            value.type = JsonValue::Type::Array;
+
+            if (consume(']')) {
+                return true;
+            }
+
+            do {
+                JsonValue element;
+
+                if (!parseValue(element, depth + 1)) {
+                    return false;
+                }
+
+                value.elements.push_back(std::move(element));
+            } while (consume(','));
+
+            return consume(']');
+        } else if (c == '"') {
+            value.type = JsonValue::Type::String;
+            return parseString(value.string);
+        } else if (literal("true") || literal("false")) {
+            value.type = JsonValue::Type::Boolean;
+            return true;
+        } else if (literal("null")) {
+            return true;
+        }
+
+        const char* begin = text_.c_str() + offset_;
+        char* end = nullptr;
+        value.type = JsonValue::Type::Number;
+        value.number = std::strtod(begin, &end);
+
+        if (end == begin) {
+            return false;
+        }
+
+        offset_ += static_cast<std::size_t>(end - begin);
+        return true;
+    }
+
+    bool parseString(std::string& string) {
+        if (offset_ >= text_.size() || text_[offset_] != '"') {
+            return false;
+        }
+
+        offset_++;
+
+        while (offset_ < text_.size()) {
+            const char c = text_[offset_++];
+
+            if (c == '"') {
+                return true;
+            } else if (c != '\\') {
+                string += c;
+                continue;
+            }
+
+            if (offset_ >= text_.size()) {
+                return false;
+            }
+
+            const char escaped = text_[offset_++];
+
+            switch (escaped) {
+                case 'b': string += '\b'; break;
+                case 'f': string += '\f'; break;
+                case 'n': string += '\n'; break;
+                case 'r': string += '\r'; break;
+                case 't': string += '\t'; break;
+                case 'u': {
+                    uint32_t codePoint = 0;
+
+                    if (!hex(codePoint)) {
+                        return false;
+                    }
+
+                    // a high surrogate is followed by the low half of the pair
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                        uint32_t low = 0;
+
+                        if (!literal("\\u") || !hex(low) || low < 0xDC00 || low >= 0xE000) {
+                            return false;
+                        }
+
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+
+                    appendUtf8(string, codePoint);
+                    break;
+                }
+                default: string += escaped; break;
+            }
+        }
+
+        return false;
+    }
+
+    bool hex(uint32_t& value) {
+        if (offset_ + 4 > text_.size()) {
+            return false;
+        }
+
+        for (int i = 0; i < 4; i++) {
+            const char c = text_[offset_++];
+            const int digit = std::isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                            : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                            : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+
+            if (digit < 0) {
+                return false;
+            }
+
+            value = value << 4 | static_cast<uint32_t>(digit);
+        }
+
+        return true;
+    }
+
+    static void appendUtf8(std::string& string, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            string += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            string += static_cast<char>(0xC0 | codePoint >> 6);
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            string += static_cast<char>(0xE0 | codePoint >> 12);
+            string += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            string += static_cast<char>(0xF0 | codePoint >> 18);
+            string += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    const std::string& text_;
+    std::size_t offset_ = 0;
+};
+
+std::string jsonText(const JsonValue& value) {
+    switch (value.type) {
+        case JsonValue::Type::String: return value.string;
+        case JsonValue::Type::Number: {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", value.number);
+            return buffer;
+        }
+        default: return std::string();
+    }
+}
+
+}
+
+PoiExport readCsvExport(const std::string& text) {
+    PoiExport result;
+    bool unterminated = false;
+    const std::vector<std::vector<std::string>> rows = csvRows(text, unterminated);
+
+    if (unterminated) {
+        result.error = "a quoted field is never closed";
+        return result;
+    }
+
+    if (rows.empty()) {
+        result.error = "the export is empty";
+        return result;
+    }
+
+    std::vector<Field> fields;
+
+    for (const std::string& name : rows.front()) {
+        fields.push_back(fieldNamed(trimmed(name)));
+    }
+
+    for (const Field required : {Field::Identifier, Field::Latitude, Field::Longitude}) {
+        if (std::find(fields.begin(), fields.end(), required) == fields.end()) {
+            result.error = "the header must name the identifier, latitude and longitude columns";
+            return result;
+        }
+    }
+
+    Collector collector(result);
+
+    for (std::size_t i = 1; i < rows.size(); i++) {
+        Row row;
+
+        for (std::size_t column = 0; column < rows[i].size() && column < fields.size(); column++) {
+            row.set(fields[column], fields[column] == Field::Name ? rows[i][column] : trimmed(rows[i][column]));
+        }
+
+        collector.add(row);
+    }
+
+    return result;
+}
+
+PoiExport readJsonExport(const std::string& text) {
+    PoiExport result;
+    const std::optional<JsonValue> root = JsonParser(text).parse();
+
+    if (!root) {
+        result.error = "the export is not valid JSON";
+        return result;
+    }
+
+    const JsonValue* list = &*root;
+
+    if (root->type == JsonValue::Type::Object) {
+        list = nullptr;
+
+        for (const auto& member : root->members) {
+            if (member.first == "pois") {
+                list = &member.second;
+            }
+        }
+    }
+
+    if (!list || list->type != JsonValue::Type::Array) {
+        result.error = "the export must be an array of POIs or an object with a \"pois\" array";
+        return result;
+    }
+
+    Collector collector(result);
+
+    for (const JsonValue& element : list->elements) {
+        Row row;
+
+        for (const auto& member : element.members) {
+            row.set(fieldNamed(member.first), jsonText(member.second));
+        }
+
+        collector.add(row);
+    }
+
+    return result;
+}
+
+}
+}
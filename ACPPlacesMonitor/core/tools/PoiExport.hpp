@@ -0,0 +1,57 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// PoiExport.hpp
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "placesmonitor/Types.hpp"
+
+namespace placesmonitor {
+namespace tools {
+
+/**
+ * @brief The POIs read from an export of a POI library
+ *
+ * @discussion A POI needs an identifier, a latitude and a longitude, the name and radius are optional.  Rows or
+ * objects missing one of the required values, with coordinates out of range, or repeating an identifier already
+ * read are skipped and counted.  The error is set, and no POI is returned, when the export can't be read at all.
+ */
+struct PoiExport {
+    std::vector<Poi> pois;
+    std::size_t skipped = 0;
+    std::string error;
+};
+
+/**
+ * @brief Reads a CSV export, the first row names the columns
+ *
+ * @discussion The columns are found by name: identifier (or id), name, latitude (or lat), longitude (or lon, lng)
+ * and radius, in any order and case.  Fields may be quoted, with quotes inside written twice.
+ */
+PoiExport readCsvExport(const std::string& text);
+
+/**
+ * @brief Reads a JSON export, an array of POI objects either at the top level or under a "pois" key
+ *
+ * @discussion The members are named like the CSV columns, numbers may also be given as strings.
+ */
+PoiExport readJsonExport(const std::string& text);
+
+}
+}
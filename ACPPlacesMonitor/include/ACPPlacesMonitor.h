@@ -28,10 +28,15 @@
  *    updates when the device has moved a significant distance from the last time its location was processed.
  *    Using this monitoring strategy consumes far less power than continuous monitoring.  For more information, see:
  *    https://developer.apple.com/documentation/corelocation/cllocationmanager/1423531-startmonitoringsignificantlocati
+ *  - adaptive (ACPPlacesMonitorModeAdaptive) - the monitor uses significant changes while the device is far from every
+ *    monitored point of interest.  As the device nears the boundary of one, it tightens the location accuracy and uses
+ *    continuous updates for a limited time, then backs off to significant changes again.  When set, this mode takes
+ *    precedence over the other modes.
  */
 typedef NS_OPTIONS(NSInteger, ACPPlacesMonitorMode) {
     ACPPlacesMonitorModeContinuous = 1 << 0,           /*!< Enum value ACPPlacesMonitorModeContinuous */
-    ACPPlacesMonitorModeSignificantChanges = 1 << 1    /*!< Enum value ACPPlacesMonitorModeSignificantChanges */
+    ACPPlacesMonitorModeSignificantChanges = 1 << 1,   /*!< Enum value ACPPlacesMonitorModeSignificantChanges */
+    ACPPlacesMonitorModeAdaptive = 1 << 2              /*!< Enum value ACPPlacesMonitorModeAdaptive */
 };
 
 /**
@@ -141,4 +146,53 @@ typedef NS_OPTIONS(NSInteger, ACPPlacesMonitorRequestAuthorizationLevel) {
  */
 + (void) updateLocationNow;
 
+/**
+ * @brief Gets a snapshot of the metrics collected by the Places Monitor
+ *
+ * @discussion The snapshot contains counters for location updates, POI queries, region registrations and
+ * region events, histograms for the time from a location fix to updated geofences, for the POI query latency
+ * and for the event queue depth, and derived rates such as region registrations per hour.
+ *
+ * @param callback called with the metrics snapshot, or nil if the snapshot could not be retrieved
+ */
++ (void) getMetrics: (nonnull void (^) (NSDictionary* _Nullable metrics)) callback;
+
+/**
+ * @brief Sets how often the Places Monitor dispatches its metrics snapshot as an event
+ *
+ * @discussion Every interval, an event named "places monitor metrics" carrying the snapshot under the "metrics"
+ * key is dispatched to the Event Hub, where rules or other extensions can pick it up.  Reporting is off by default.
+ *
+ * @param interval the number of seconds between two metrics events, pass 0 to stop reporting
+ */
++ (void) setMetricsReportingInterval: (NSTimeInterval) interval;
+
+/**
+ * @brief Sets how long an entry or exit must hold before it is reported to the Places extension
+ *
+ * @discussion A device sitting on the edge of a region can see it entered and exited several times in a row.  With a
+ * dwell time set, an event is only reported once it held for that many seconds, and an entry followed by an exit of
+ * the same region within the dwell time (or the other way around) is not reported at all.  Keep the dwell time to a
+ * few seconds.  The monitor asks for background time while events are pending, and reports them early if that time
+ * runs out before they settle.  The dwell time is 0 by default.
+ *
+ * @param dwellTime the number of seconds an event must hold, pass 0 to report every event as soon as it happens
+ */
++ (void) setRegionEventDwellTime: (NSTimeInterval) dwellTime;
+
+/**
+ * @brief Sets a POI pack to answer nearby POI queries on the device
+ *
+ * @discussion A POI pack is a file holding the POIs of a library and a spatial index, built with the
+ * placesmonitor_build_poi_pack tool from a CSV or JSON export of the library and shipped with the app.  While a pack
+ * is set, every location update is answered from the pack right away, even without network coverage.  A regular
+ * nearby POI query is made at most once a day for each area and its response is layered over the pack.
+ *
+ * The pack is not persisted, set it every time the app launches.  A path to a missing or invalid file leaves the
+ * monitor without a pack.
+ *
+ * @param path the path of the pack file, pass nil to stop using a pack
+ */
++ (void) setPoiPackPath: (nullable NSString*) path;
+
 @end
@@ -0,0 +1,110 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesAdaptivePolicyTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlacesAdaptivePolicy.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+
+@interface ACPPlacesAdaptivePolicyTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesAdaptivePolicy *policy;
+@end
+
+@implementation ACPPlacesAdaptivePolicyTests
+
+- (void) setUp {
+    _policy = [[ACPPlacesAdaptivePolicy alloc] init];
+}
+
+- (void) testInitDefaults {
+    XCTAssertEqual(ACPPlacesMonitorAdaptiveNearDistance_Test, _policy.nearDistance);
+    XCTAssertEqual(ACPPlacesMonitorAdaptiveFarDistance_Test, _policy.farDistance);
+    XCTAssertEqual(ACPPlacesMonitorAdaptiveContinuousTimeLimit_Test, _policy.continuousTimeLimit);
+    XCTAssertEqual(ACPPlacesMonitorAdaptiveNearDistanceFilter_Test, _policy.nearDistanceFilter);
+    XCTAssertEqual(ACPPlacesMonitorDefaultDistanceFilter_Test, _policy.farDistanceFilter);
+}
+
+- (void) testFarStaysFarAwayFromFences {
+    XCTAssertEqual(ACPPlacesAdaptiveStateFar, [_policy nextStateFromState:ACPPlacesAdaptiveStateFar
+                                                         distanceToFence:800
+                                                             timeInState:0]);
+}
+
+- (void) testFarStaysFarWithoutFences {
+    XCTAssertEqual(ACPPlacesAdaptiveStateFar, [_policy nextStateFromState:ACPPlacesAdaptiveStateFar
+                                                         distanceToFence:CLLocationDistanceMax
+                                                             timeInState:0]);
+}
+
+- (void) testFarToApproachingNearFence {
+    XCTAssertEqual(ACPPlacesAdaptiveStateApproaching, [_policy nextStateFromState:ACPPlacesAdaptiveStateFar
+                                                                 distanceToFence:400
+                                                                     timeInState:0]);
+}
+
+- (void) testApproachingUsesHysteresis {
+    // between the near and far distances the state is kept
+    XCTAssertEqual(ACPPlacesAdaptiveStateApproaching, [_policy nextStateFromState:ACPPlacesAdaptiveStateApproaching
+                                                                 distanceToFence:800
+                                                                     timeInState:10]);
+    XCTAssertEqual(ACPPlacesAdaptiveStateFar, [_policy nextStateFromState:ACPPlacesAdaptiveStateApproaching
+                                                         distanceToFence:1200
+                                                             timeInState:10]);
+}
+
+- (void) testApproachingBacksOffAfterTimeLimit {
+    XCTAssertEqual(ACPPlacesAdaptiveStateBackedOff, [_policy nextStateFromState:ACPPlacesAdaptiveStateApproaching
+                                                               distanceToFence:100
+                                                                   timeInState:_policy.continuousTimeLimit]);
+}
+
+- (void) testBackedOffStaysUntilFar {
+    XCTAssertEqual(ACPPlacesAdaptiveStateBackedOff, [_policy nextStateFromState:ACPPlacesAdaptiveStateBackedOff
+                                                               distanceToFence:100
+                                                                   timeInState:1000]);
+    XCTAssertEqual(ACPPlacesAdaptiveStateFar, [_policy nextStateFromState:ACPPlacesAdaptiveStateBackedOff
+                                                         distanceToFence:1500
+                                                             timeInState:1000]);
+}
+
+- (void) testTunedPolicy {
+    // setup
+    _policy.nearDistance = 50;
+
+    // verify
+    XCTAssertEqual(ACPPlacesAdaptiveStateFar, [_policy nextStateFromState:ACPPlacesAdaptiveStateFar
+                                                         distanceToFence:100
+                                                             timeInState:0]);
+}
+
+- (void) testSettingsForState {
+    XCTAssertTrue([_policy usesContinuousUpdatesInState:ACPPlacesAdaptiveStateApproaching]);
+    XCTAssertFalse([_policy usesContinuousUpdatesInState:ACPPlacesAdaptiveStateFar]);
+    XCTAssertFalse([_policy usesContinuousUpdatesInState:ACPPlacesAdaptiveStateBackedOff]);
+    XCTAssertEqual(kCLLocationAccuracyNearestTenMeters, [_policy desiredAccuracyForState:ACPPlacesAdaptiveStateApproaching]);
+    XCTAssertEqual(kCLLocationAccuracyHundredMeters, [_policy desiredAccuracyForState:ACPPlacesAdaptiveStateFar]);
+    XCTAssertEqual(_policy.nearDistanceFilter, [_policy distanceFilterForState:ACPPlacesAdaptiveStateApproaching]);
+    XCTAssertEqual(_policy.farDistanceFilter, [_policy distanceFilterForState:ACPPlacesAdaptiveStateBackedOff]);
+}
+
+- (void) testNameForState {
+    XCTAssertEqualObjects(@"far", [ACPPlacesAdaptivePolicy nameForState:ACPPlacesAdaptiveStateFar]);
+    XCTAssertEqualObjects(@"approaching", [ACPPlacesAdaptivePolicy nameForState:ACPPlacesAdaptiveStateApproaching]);
+    XCTAssertEqualObjects(@"backed off", [ACPPlacesAdaptivePolicy nameForState:ACPPlacesAdaptiveStateBackedOff]);
+}
+
+@end
@@ -0,0 +1,282 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesBeaconRangerTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import "OCMock.h"
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesBeaconRanger.h"
+#import "ACPPlacesMetrics.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+
+static NSString* const ACPPlacesBeaconRangerTestsUuid = @"E2C56DB5-DFFB-48D2-B060-D0F5A71096E0";
+static NSString* const ACPPlacesBeaconRangerTestsOtherUuid = @"B9407F30-F5F8-466E-AFF9-25556B57FE6D";
+
+@interface ACPPlacesBeaconRangerTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesBeaconRanger *ranger;
+@property (nonatomic, strong) ACPPlacesMetrics *metrics;
+@property (nonatomic, strong) id locationManagerMock;
+@property (nonatomic) NSTimeInterval now;
+@property (nonatomic, strong) NSMutableArray<NSNumber*> *timerDelays;
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *timerBlocks;
+@property (nonatomic, strong) NSMutableArray<CLBeaconRegion*> *entries;
+@property (nonatomic, strong) NSMutableArray<CLBeaconRegion*> *exits;
+@end
+
+@implementation ACPPlacesBeaconRangerTests
+
+- (void) setUp {
+    _now = 1000;
+    _timerDelays = [NSMutableArray array];
+    _timerBlocks = [NSMutableArray array];
+    _entries = [NSMutableArray array];
+    _exits = [NSMutableArray array];
+    _metrics = [[ACPPlacesMetrics alloc] init];
+    _locationManagerMock = OCMClassMock([CLLocationManager class]);
+
+    _ranger = [[ACPPlacesBeaconRanger alloc] initWithRangingWindow:4 interval:20];
+    _ranger.metrics = _metrics;
+    [self setUpFakesForRanger:_ranger];
+}
+
+// advances the fake clock to the last armed timer and fires it
+- (void) fireLastTimer {
+    _now += [_timerDelays.lastObject doubleValue];
+    _timerBlocks.lastObject();
+}
+
+- (void) testDefaults {
+    // test
+    ACPPlacesBeaconRanger *ranger = [[ACPPlacesBeaconRanger alloc] init];
+
+    // verify
+    XCTAssertEqual(ACPPlacesMonitorBeaconRangingWindow_Test, ranger.rangingWindow);
+    XCTAssertEqual(ACPPlacesMonitorBeaconRangingInterval_Test, ranger.rangingInterval);
+    XCTAssertFalse(ranger.isActive);
+    XCTAssertFalse(ranger.isRanging);
+}
+
+- (void) testBeaconRegionForPoi {
+    // test
+    CLBeaconRegion *region = [ACPPlacesBeaconRanger beaconRegionForPoi:[self poiWithIdentifier:@"shoes" uuid:ACPPlacesBeaconRangerTestsUuid major:@"7" minor:@"42"]];
+
+    // verify
+    XCTAssertEqualObjects(@"shoes", region.identifier);
+    XCTAssertEqualObjects(ACPPlacesBeaconRangerTestsUuid, region.proximityUUID.UUIDString);
+    XCTAssertEqualObjects(@(7), region.major);
+    XCTAssertEqualObjects(@(42), region.minor);
+}
+
+- (void) testBeaconRegionForPoiWithoutMajorMatchesAnyBeaconWithTheUuid {
+    // test
+    CLBeaconRegion *region = [ACPPlacesBeaconRanger beaconRegionForPoi:[self poiWithIdentifier:@"shoes" uuid:[ACPPlacesBeaconRangerTestsUuid lowercaseString] major:nil minor:@"42"]];
+
+    // verify
+    XCTAssertEqualObjects(ACPPlacesBeaconRangerTestsUuid, region.proximityUUID.UUIDString);
+    XCTAssertNil(region.major);
+    XCTAssertNil(region.minor);
+}
+
+- (void) testBeaconRegionForPoiWithoutValidUuidIsNil {
+    // verify
+    XCTAssertNil([ACPPlacesBeaconRanger beaconRegionForPoi:[self poiWithIdentifier:@"shoes" uuid:nil major:@"7" minor:@"42"]]);
+    XCTAssertNil([ACPPlacesBeaconRanger beaconRegionForPoi:[self poiWithIdentifier:@"shoes" uuid:@"not a uuid" major:nil minor:nil]]);
+}
+
+- (void) testRangePoisRangesOneRegionPerUuid {
+    // test
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:@"1" minor:nil],
+                         [self poiWithIdentifier:@"b" uuid:ACPPlacesBeaconRangerTestsUuid major:@"2" minor:nil],
+                         [self poiWithIdentifier:@"c" uuid:ACPPlacesBeaconRangerTestsOtherUuid major:nil minor:nil]]];
+
+    // verify
+    XCTAssertTrue(_ranger.isActive);
+    XCTAssertTrue(_ranger.isRanging);
+    XCTAssertEqual(3, _ranger.count);
+    XCTAssertEqualObjects(@(4), _timerDelays.lastObject);
+    OCMVerify([_locationManagerMock startRangingBeaconsInRegion:[OCMArg checkWithBlock:^BOOL(CLBeaconRegion *region) {
+        return [region.proximityUUID.UUIDString isEqualToString:ACPPlacesBeaconRangerTestsUuid] && !region.major;
+    }]]);
+    OCMVerify([_locationManagerMock startRangingBeaconsInRegion:[OCMArg checkWithBlock:^BOOL(CLBeaconRegion *region) {
+        return [region.proximityUUID.UUIDString isEqualToString:ACPPlacesBeaconRangerTestsOtherUuid];
+    }]]);
+}
+
+- (void) testRangePoisIgnoresPoisWithoutBeacon {
+    // setup
+    OCMReject([_locationManagerMock startRangingBeaconsInRegion:[OCMArg any]]);
+
+    // test
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:nil major:nil minor:nil]]];
+
+    // verify
+    XCTAssertFalse(_ranger.isActive);
+    XCTAssertEqual(0, _timerBlocks.count);
+}
+
+- (void) testRangingIsDutyCycled {
+    // setup
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:nil minor:nil]]];
+
+    // test
+    [self fireLastTimer];
+
+    // verify - the window closed, and the next one opens at the end of the interval
+    XCTAssertFalse(_ranger.isRanging);
+    XCTAssertTrue(_ranger.isActive);
+    XCTAssertEqualObjects(@(16), _timerDelays.lastObject);
+    XCTAssertEqual(4, [_metrics valueOfCounter:ACPPlacesMetricCounterBeaconRangingSeconds]);
+    OCMVerify([_locationManagerMock stopRangingBeaconsInRegion:[OCMArg any]]);
+
+    [self fireLastTimer];
+    XCTAssertTrue(_ranger.isRanging);
+    XCTAssertEqualObjects(@(4), _timerDelays.lastObject);
+}
+
+- (void) testCloseBeaconEntersPoi {
+    // setup
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:@"1" minor:nil]]];
+    _now += 12;
+
+    // test
+    [_ranger processBeacons:@[[self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:1 minor:9 accuracy:1.5]]];
+
+    // verify
+    XCTAssertEqual(1, _entries.count);
+    XCTAssertEqualObjects(@"a", _entries[0].identifier);
+    XCTAssertEqual(1, [_metrics valueOfCounter:ACPPlacesMetricCounterBeaconEntries]);
+    XCTAssertEqual(1, [_metrics sampleCountOfHistogram:ACPPlacesMetricHistogramBeaconEntryLatency]);
+    XCTAssertEqualObjects(@(12), [_metrics snapshot][@"histograms"][@"beaconEntryLatencySeconds"][@"sum"]);
+}
+
+- (void) testFarOrOtherBeaconDoesNotEnterPoi {
+    // setup
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:@"1" minor:nil]]];
+
+    // test
+    [_ranger processBeacons:@[[self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:1 minor:9 accuracy:6],
+                              [self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:2 minor:9 accuracy:0.5],
+                              [self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:1 minor:9 accuracy:-1]]];
+
+    // verify
+    XCTAssertEqual(0, _entries.count);
+}
+
+- (void) testBeaconOutOfRangeExitsPoiAfterTimeout {
+    // setup
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:nil minor:nil]]];
+    [_ranger processBeacons:@[[self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:1 minor:1 accuracy:1]]];
+
+    // test
+    _now += ACPPlacesMonitorBeaconExitTimeout_Test - 1;
+    [_ranger processBeacons:@[]];
+    XCTAssertEqual(0, _exits.count);
+    _now += 1;
+    [_ranger processBeacons:@[]];
+
+    // verify
+    XCTAssertEqual(1, _exits.count);
+    XCTAssertEqualObjects(@"a", _exits[0].identifier);
+}
+
+- (void) testRangePoisWithoutEnteredPoiExitsIt {
+    // setup
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:nil minor:nil]]];
+    [_ranger processBeacons:@[[self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:1 minor:1 accuracy:1]]];
+
+    // test
+    [_ranger rangePois:@[]];
+
+    // verify
+    XCTAssertEqual(1, _exits.count);
+    XCTAssertEqualObjects(@"a", _exits[0].identifier);
+    XCTAssertFalse(_ranger.isActive);
+    XCTAssertFalse(_ranger.isRanging);
+    OCMVerify([_locationManagerMock stopRangingBeaconsInRegion:[OCMArg any]]);
+}
+
+- (void) testStopDoesNotReportExits {
+    // setup
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:nil minor:nil]]];
+    [_ranger processBeacons:@[[self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:1 minor:1 accuracy:1]]];
+    dispatch_block_t windowTimer = _timerBlocks.lastObject;
+
+    // test
+    [_ranger stop];
+    windowTimer();
+
+    // verify
+    XCTAssertEqual(0, _exits.count);
+    XCTAssertFalse(_ranger.isActive);
+    XCTAssertFalse(_ranger.isRanging);
+    OCMVerify([_locationManagerMock stopRangingBeaconsInRegion:[OCMArg any]]);
+}
+
+- (void) testRangedBeaconsAreProcessed {
+    // setup
+    [_ranger rangePois:@[[self poiWithIdentifier:@"a" uuid:ACPPlacesBeaconRangerTestsUuid major:nil minor:nil]]];
+
+    // test
+    [_ranger locationManager:_locationManagerMock
+             didRangeBeacons:@[[self beaconWithUuid:ACPPlacesBeaconRangerTestsUuid major:1 minor:1 accuracy:1]]
+                    inRegion:[[CLBeaconRegion alloc] initWithProximityUUID:[[NSUUID alloc] initWithUUIDString:ACPPlacesBeaconRangerTestsUuid]
+                                                                identifier:@"ranged"]];
+
+    // verify
+    XCTAssertEqual(1, _entries.count);
+}
+
+#pragma mark - helpers
+- (ACPPlacesPoi*) poiWithIdentifier: (NSString*) identifier uuid: (NSString*) uuid major: (NSString*) major minor: (NSString*) minor {
+    NSMutableDictionary *metaData = [NSMutableDictionary dictionary];
+    metaData[ACPPlacesMonitorPoiMetadataBeaconUuid_Test] = uuid;
+    metaData[ACPPlacesMonitorPoiMetadataBeaconMajor_Test] = major;
+    metaData[ACPPlacesMonitorPoiMetadataBeaconMinor_Test] = minor;
+
+    ACPPlacesPoi *poi = [[ACPPlacesPoi alloc] init];
+    poi.identifier = identifier;
+    poi.metaData = metaData;
+    return poi;
+}
+
+- (CLBeacon*) beaconWithUuid: (NSString*) uuid major: (int) major minor: (int) minor accuracy: (CLLocationAccuracy) accuracy {
+    id beacon = OCMClassMock([CLBeacon class]);
+    OCMStub([beacon proximityUUID]).andReturn([[NSUUID alloc] initWithUUIDString:uuid]);
+    OCMStub([beacon major]).andReturn(@(major));
+    OCMStub([beacon minor]).andReturn(@(minor));
+    OCMStub([beacon accuracy]).andReturn(accuracy);
+    return beacon;
+}
+
+- (void) setUpFakesForRanger: (ACPPlacesBeaconRanger*) ranger {
+    __weak ACPPlacesBeaconRangerTests *weakSelf = self;
+    ranger.clock = ^NSTimeInterval {
+        return weakSelf.now;
+    };
+    ranger.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {
+        [weakSelf.timerDelays addObject:@(delay)];
+        [weakSelf.timerBlocks addObject:block];
+    };
+    ranger.locationManagerFactory = ^CLLocationManager* {
+        return weakSelf.locationManagerMock;
+    };
+    ranger.transitionHandler = ^(CLBeaconRegion *region, ACPRegionEventType type) {
+        [type == ACPRegionEventTypeEntry ? weakSelf.entries : weakSelf.exits addObject:region];
+    };
+}
+
+@end
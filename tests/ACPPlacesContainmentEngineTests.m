@@ -0,0 +1,208 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesContainmentEngineTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesContainmentEngine.h"
+
+@interface ACPPlacesContainmentEngineTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesContainmentEngine *engine;
+@property (nonatomic, strong) ACPPlacesPoi *poi;
+@end
+
+@implementation ACPPlacesContainmentEngineTests
+
+- (void) setUp {
+    _engine = [[ACPPlacesContainmentEngine alloc] initWithMinimumBand:10 maximumAccuracy:100];
+    _poi = [[ACPPlacesPoi alloc] init];
+    _poi.identifier = @"poi";
+    _poi.latitude = 40.0;
+    _poi.longitude = -111.0;
+    _poi.radius = 200;
+    [_engine loadPois:@[_poi]];
+}
+
+// creates a fix north of the poi center
+- (CLLocation*) locationMetersNorth: (double) meters accuracy: (double) accuracy {
+    return [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(40.0 + meters / 111195.0, -111.0)
+                                         altitude:0
+                               horizontalAccuracy:accuracy
+                                 verticalAccuracy:-1
+                                        timestamp:[NSDate date]];
+}
+
+- (void) testLoadPois {
+    XCTAssertEqual(1, _engine.count);
+    [_engine loadPois:@[]];
+    XCTAssertEqual(0, _engine.count);
+}
+
+- (void) testEntryWellInside {
+    // setup
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test
+    BOOL evaluated = [_engine evaluateLocation:[self locationMetersNorth:100 accuracy:5]
+                             insideIdentifiers:[NSSet set]
+                                       entered:&entered
+                                        exited:&exited];
+
+    // verify
+    XCTAssertTrue(evaluated);
+    XCTAssertEqual(1, entered.count);
+    XCTAssertEqualObjects(@"poi", [entered[0] identifier]);
+    XCTAssertEqual(0, exited.count);
+}
+
+- (void) testNoEntryInsideHysteresisBand {
+    // setup
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test - inside the circle, but by less than the accuracy of the fix
+    [_engine evaluateLocation:[self locationMetersNorth:170 accuracy:50]
+            insideIdentifiers:[NSSet set]
+                      entered:&entered
+                       exited:&exited];
+
+    // verify
+    XCTAssertEqual(0, entered.count);
+}
+
+- (void) testNoExitInsideHysteresisBand {
+    // setup
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test - just outside the circle
+    [_engine evaluateLocation:[self locationMetersNorth:205 accuracy:5]
+            insideIdentifiers:[NSSet setWithObject:@"poi"]
+                      entered:&entered
+                       exited:&exited];
+
+    // verify
+    XCTAssertEqual(0, exited.count);
+    XCTAssertEqual(0, entered.count);
+}
+
+- (void) testExitWellOutside {
+    // setup
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test
+    [_engine evaluateLocation:[self locationMetersNorth:300 accuracy:5]
+            insideIdentifiers:[NSSet setWithObject:@"poi"]
+                      entered:&entered
+                       exited:&exited];
+
+    // verify
+    XCTAssertEqual(1, exited.count);
+    XCTAssertEqual(0, entered.count);
+}
+
+- (void) testAlreadyInsideIsNotEnteredAgain {
+    // setup
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test
+    [_engine evaluateLocation:[self locationMetersNorth:0 accuracy:5]
+            insideIdentifiers:[NSSet setWithObject:@"poi"]
+                      entered:&entered
+                       exited:&exited];
+
+    // verify
+    XCTAssertEqual(0, entered.count);
+    XCTAssertEqual(0, exited.count);
+}
+
+- (void) testInaccurateFixIsIgnored {
+    // setup
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test
+    BOOL poorFix = [_engine evaluateLocation:[self locationMetersNorth:0 accuracy:500]
+                           insideIdentifiers:[NSSet set]
+                                     entered:&entered
+                                      exited:&exited];
+    BOOL invalidFix = [_engine evaluateLocation:[self locationMetersNorth:0 accuracy:-1]
+                              insideIdentifiers:[NSSet set]
+                                        entered:&entered
+                                         exited:&exited];
+
+    // verify
+    XCTAssertFalse(poorFix);
+    XCTAssertFalse(invalidFix);
+    XCTAssertNil(entered);
+}
+
+- (void) testAntimeridian {
+    // setup
+    ACPPlacesPoi *datelinePoi = [[ACPPlacesPoi alloc] init];
+    datelinePoi.identifier = @"dateline";
+    datelinePoi.latitude = 0;
+    datelinePoi.longitude = 179.9995;
+    datelinePoi.radius = 200;
+    [_engine loadPois:@[datelinePoi]];
+    CLLocation *location = [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(0, -179.9995)
+                                                         altitude:0
+                                               horizontalAccuracy:5
+                                                 verticalAccuracy:-1
+                                                        timestamp:[NSDate date]];
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test - the fix is about 111 meters from the center across the antimeridian
+    [_engine evaluateLocation:location insideIdentifiers:[NSSet set] entered:&entered exited:&exited];
+
+    // verify
+    XCTAssertEqual(1, entered.count);
+}
+
+- (void) testManyPois {
+    // setup
+    NSMutableArray *pois = [NSMutableArray array];
+    for (int i = 0; i < 100; i++) {
+        ACPPlacesPoi *poi = [[ACPPlacesPoi alloc] init];
+        poi.identifier = [NSString stringWithFormat:@"poi%d", i];
+        poi.latitude = 40.0 + i * 0.01;
+        poi.longitude = -111.0;
+        poi.radius = 100;
+        [pois addObject:poi];
+    }
+    [_engine loadPois:pois];
+    CLLocation *location = [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(40.5, -111.0)
+                                                         altitude:0
+                                               horizontalAccuracy:5
+                                                 verticalAccuracy:-1
+                                                        timestamp:[NSDate date]];
+    NSArray *entered = nil;
+    NSArray *exited = nil;
+
+    // test
+    [_engine evaluateLocation:location insideIdentifiers:[NSSet set] entered:&entered exited:&exited];
+
+    // verify
+    XCTAssertEqual(1, entered.count);
+    XCTAssertEqualObjects(@"poi50", [entered[0] identifier]);
+}
+
+@end
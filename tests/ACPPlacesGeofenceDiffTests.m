@@ -0,0 +1,148 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesGeofenceDiffTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlacesGeofenceDiff.h"
+
+@interface ACPPlacesGeofenceDiffTests : XCTestCase
+@property (nonatomic, strong) CLCircularRegion *regionA;
+@property (nonatomic, strong) CLCircularRegion *regionB;
+@property (nonatomic, strong) CLCircularRegion *regionC;
+@end
+
+@implementation ACPPlacesGeofenceDiffTests
+
+- (void) setUp {
+    _regionA = [self regionWithIdentifier:@"a" latitude:40.0 radius:100];
+    _regionB = [self regionWithIdentifier:@"b" latitude:40.1 radius:100];
+    _regionC = [self regionWithIdentifier:@"c" latitude:40.2 radius:100];
+}
+
+- (CLCircularRegion*) regionWithIdentifier: (NSString*) identifier latitude: (double) latitude radius: (double) radius {
+    return [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(latitude, -111.0)
+                                             radius:radius
+                                         identifier:identifier];
+}
+
+- (void) testNothingMonitored {
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[_regionA, _regionB]
+                                                               monitoredRegions:nil
+                                                               ownedIdentifiers:[NSSet set]];
+
+    // verify
+    XCTAssertEqual(2, diff.regionsToStart.count);
+    XCTAssertEqual(0, diff.regionsToStop.count);
+    XCTAssertEqual(2, diff.addedCount);
+    XCTAssertEqual(0, diff.keptCount);
+}
+
+- (void) testIdenticalRegionsAreKept {
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[[self regionWithIdentifier:@"a" latitude:40.0 radius:100]]
+                                                               monitoredRegions:[NSSet setWithObject:_regionA]
+                                                               ownedIdentifiers:[NSSet setWithObject:@"a"]];
+
+    // verify
+    XCTAssertEqual(0, diff.regionsToStart.count);
+    XCTAssertEqual(0, diff.regionsToStop.count);
+    XCTAssertEqual(1, diff.keptCount);
+    XCTAssertEqualObjects(@"a", diff.keptIdentifiers[0]);
+}
+
+- (void) testAddRemoveAndKeep {
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[_regionB, _regionC]
+                                                               monitoredRegions:[NSSet setWithObjects:_regionA, _regionB, nil]
+                                                               ownedIdentifiers:[NSSet setWithObjects:@"a", @"b", nil]];
+
+    // verify
+    XCTAssertEqual(1, diff.addedCount);
+    XCTAssertEqual(1, diff.removedCount);
+    XCTAssertEqual(1, diff.keptCount);
+    XCTAssertEqual(0, diff.updatedCount);
+    XCTAssertEqual(_regionC, diff.regionsToStart[0]);
+    XCTAssertEqual(_regionA, diff.regionsToStop[0]);
+}
+
+- (void) testChangedRadiusIsUpdated {
+    // setup
+    CLCircularRegion *biggerA = [self regionWithIdentifier:@"a" latitude:40.0 radius:200];
+
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[biggerA]
+                                                               monitoredRegions:[NSSet setWithObject:_regionA]
+                                                               ownedIdentifiers:[NSSet setWithObject:@"a"]];
+
+    // verify
+    XCTAssertEqual(1, diff.updatedCount);
+    XCTAssertEqual(0, diff.addedCount);
+    XCTAssertEqual(0, diff.removedCount);
+    XCTAssertEqual(_regionA, diff.regionsToStop[0]);
+    XCTAssertEqual(biggerA, diff.regionsToStart[0]);
+}
+
+- (void) testChangedCenterIsUpdated {
+    // setup
+    CLCircularRegion *movedA = [self regionWithIdentifier:@"a" latitude:40.001 radius:100];
+
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[movedA]
+                                                               monitoredRegions:[NSSet setWithObject:_regionA]
+                                                               ownedIdentifiers:[NSSet setWithObject:@"a"]];
+
+    // verify
+    XCTAssertEqual(1, diff.updatedCount);
+}
+
+- (void) testRegionsNotOwnedAreNeverStopped {
+    // setup
+    CLBeaconRegion *beaconRegion = [[CLBeaconRegion alloc] initWithProximityUUID:[NSUUID UUID] identifier:@"a"];
+
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[]
+                                                               monitoredRegions:[NSSet setWithObjects:_regionB, beaconRegion, nil]
+                                                               ownedIdentifiers:[NSSet setWithObject:@"a"]];
+
+    // verify
+    XCTAssertEqual(0, diff.regionsToStop.count);
+    XCTAssertEqual(0, diff.removedCount);
+}
+
+- (void) testOwnedRegionMissingFromLocationManagerIsStartedAgain {
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[_regionA]
+                                                               monitoredRegions:[NSSet set]
+                                                               ownedIdentifiers:[NSSet setWithObject:@"a"]];
+
+    // verify
+    XCTAssertEqual(1, diff.addedCount);
+    XCTAssertEqual(_regionA, diff.regionsToStart[0]);
+}
+
+- (void) testDuplicateDesiredRegionsAreStartedOnce {
+    // test
+    ACPPlacesGeofenceDiff *diff = [ACPPlacesGeofenceDiff diffWithDesiredRegions:@[_regionA, _regionA]
+                                                               monitoredRegions:nil
+                                                               ownedIdentifiers:[NSSet set]];
+
+    // verify
+    XCTAssertEqual(1, diff.regionsToStart.count);
+}
+
+@end
@@ -0,0 +1,190 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesMetricsTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import "ACPPlacesMetrics.h"
+
+@interface ACPPlacesMetricsTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesMetrics *metrics;
+@end
+
+@implementation ACPPlacesMetricsTests
+
+- (void) setUp {
+    _metrics = [[ACPPlacesMetrics alloc] init];
+}
+
+- (NSDictionary*) histogramNamed: (NSString*) name {
+    return [_metrics snapshot][@"histograms"][name];
+}
+
+- (void) testInit {
+    XCTAssertEqual(0, [_metrics valueOfCounter:ACPPlacesMetricCounterLocationUpdates]);
+    XCTAssertEqual(0, [_metrics sampleCountOfHistogram:ACPPlacesMetricHistogramPoiQueryLatency]);
+}
+
+- (void) testIncrementCounter {
+    // test
+    [_metrics incrementCounter:ACPPlacesMetricCounterPoiQueries];
+    [_metrics incrementCounter:ACPPlacesMetricCounterPoiQueries];
+    [_metrics addValue:5 toCounter:ACPPlacesMetricCounterRegionsStarted];
+
+    // verify
+    XCTAssertEqual(2, [_metrics valueOfCounter:ACPPlacesMetricCounterPoiQueries]);
+    XCTAssertEqual(5, [_metrics valueOfCounter:ACPPlacesMetricCounterRegionsStarted]);
+    XCTAssertEqual(0, [_metrics valueOfCounter:ACPPlacesMetricCounterExitEvents]);
+}
+
+- (void) testInvalidCounterIsIgnored {
+    // test
+    [_metrics incrementCounter:ACPPlacesMetricCounterCount];
+
+    // verify
+    XCTAssertEqual(0, [_metrics valueOfCounter:ACPPlacesMetricCounterCount]);
+}
+
+- (void) testRecordValueUsesFirstBucketThatFits {
+    // test
+    [_metrics recordValue:0 inHistogram:ACPPlacesMetricHistogramPoiQueryLatency];
+    [_metrics recordValue:10 inHistogram:ACPPlacesMetricHistogramPoiQueryLatency];
+    [_metrics recordValue:10.5 inHistogram:ACPPlacesMetricHistogramPoiQueryLatency];
+    [_metrics recordValue:400 inHistogram:ACPPlacesMetricHistogramPoiQueryLatency];
+
+    // verify
+    NSDictionary *histogram = [self histogramNamed:@"poiQueryLatencyMs"];
+    NSArray *counts = histogram[@"counts"];
+    XCTAssertEqualObjects(@(2), counts[0]);
+    XCTAssertEqualObjects(@(1), counts[1]);
+    XCTAssertEqualObjects(@(1), counts[5]);
+    XCTAssertEqualObjects(@(4), histogram[@"count"]);
+    XCTAssertEqualObjects(@(421), histogram[@"sum"]);
+}
+
+- (void) testRecordValueAboveLastBoundGoesToOverflowBucket {
+    // test
+    [_metrics recordValue:60000 inHistogram:ACPPlacesMetricHistogramFixToFencesLatency];
+
+    // verify
+    NSDictionary *histogram = [self histogramNamed:@"fixToFencesLatencyMs"];
+    NSArray *bounds = histogram[@"bounds"];
+    NSArray *counts = histogram[@"counts"];
+    XCTAssertEqual(bounds.count + 1, counts.count);
+    XCTAssertEqualObjects(@(1), counts.lastObject);
+}
+
+- (void) testRecordNegativeValueIsIgnored {
+    // test
+    [_metrics recordValue:-1 inHistogram:ACPPlacesMetricHistogramEventQueueDepth];
+    [_metrics recordValue:NAN inHistogram:ACPPlacesMetricHistogramEventQueueDepth];
+
+    // verify
+    XCTAssertEqual(0, [_metrics sampleCountOfHistogram:ACPPlacesMetricHistogramEventQueueDepth]);
+}
+
+- (void) testQueueDepthBuckets {
+    // test
+    [_metrics recordValue:3 inHistogram:ACPPlacesMetricHistogramEventQueueDepth];
+
+    // verify
+    NSDictionary *histogram = [self histogramNamed:@"eventQueueDepth"];
+    NSArray *expectedBounds = @[@0, @1, @2, @4, @8, @16, @32];
+    XCTAssertEqualObjects(expectedBounds, histogram[@"bounds"]);
+    XCTAssertEqualObjects(@(1), histogram[@"counts"][3]);
+}
+
+- (void) testStartupLatencyBuckets {
+    // test
+    [_metrics recordValue:0.4 inHistogram:ACPPlacesMetricHistogramRegistrationLatency];
+    [_metrics recordValue:7 inHistogram:ACPPlacesMetricHistogramLocationManagerReadyLatency];
+
+    // verify
+    NSArray *expectedBounds = @[@1, @2, @5, @10, @25, @50, @100, @250, @500, @1000];
+    XCTAssertEqualObjects(expectedBounds, [self histogramNamed:@"registrationLatencyMs"][@"bounds"]);
+    XCTAssertEqualObjects(@(1), [self histogramNamed:@"registrationLatencyMs"][@"counts"][0]);
+    XCTAssertEqualObjects(@(1), [self histogramNamed:@"locationManagerReadyLatencyMs"][@"counts"][3]);
+}
+
+- (void) testBeaconEntryLatencyBuckets {
+    // test
+    [_metrics recordValue:25 inHistogram:ACPPlacesMetricHistogramBeaconEntryLatency];
+
+    // verify
+    NSArray *expectedBounds = @[@1, @2, @5, @10, @20, @30, @60, @120, @300, @600];
+    XCTAssertEqualObjects(expectedBounds, [self histogramNamed:@"beaconEntryLatencySeconds"][@"bounds"]);
+    XCTAssertEqualObjects(@(1), [self histogramNamed:@"beaconEntryLatencySeconds"][@"counts"][5]);
+}
+
+- (void) testSnapshot {
+    // setup
+    [_metrics incrementCounter:ACPPlacesMetricCounterSuppressedEntryEvents];
+
+    // test
+    NSDictionary *snapshot = [_metrics snapshot];
+
+    // verify
+    XCTAssertEqualObjects(@(1), snapshot[@"counters"][@"suppressedEntryEvents"]);
+    XCTAssertEqual(ACPPlacesMetricCounterCount, [snapshot[@"counters"] count]);
+    XCTAssertEqual(ACPPlacesMetricHistogramCount, [snapshot[@"histograms"] count]);
+    XCTAssertEqualObjects(@(0), snapshot[@"counters"][@"suppressedRegionEvents"]);
+    XCTAssertEqualObjects(@(0), snapshot[@"counters"][@"regionEventBatches"]);
+    XCTAssertEqualObjects(@(0), snapshot[@"counters"][@"avoidedSharedStateLookups"]);
+    XCTAssertNotNil(snapshot[@"periodStart"]);
+    XCTAssertTrue([snapshot[@"periodSeconds"] doubleValue] >= 0);
+    XCTAssertNotNil(snapshot[@"rates"][@"regionRegistrationsPerHour"]);
+    XCTAssertEqualObjects(@(0), snapshot[@"rates"][@"prefetchHitRate"]);
+    XCTAssertTrue([NSPropertyListSerialization propertyList:snapshot isValidForFormat:NSPropertyListBinaryFormat_v1_0]);
+}
+
+- (void) testPrefetchHitRate {
+    // setup
+    [_metrics addValue:3 toCounter:ACPPlacesMetricCounterPrefetchHits];
+    [_metrics incrementCounter:ACPPlacesMetricCounterPrefetchMisses];
+
+    // test
+    NSDictionary *snapshot = [_metrics snapshot];
+
+    // verify
+    XCTAssertEqualObjects(@(0.75), snapshot[@"rates"][@"prefetchHitRate"]);
+}
+
+- (void) testReset {
+    // setup
+    [_metrics incrementCounter:ACPPlacesMetricCounterEntryEvents];
+    [_metrics recordValue:5 inHistogram:ACPPlacesMetricHistogramPoiQueryLatency];
+
+    // test
+    [_metrics reset];
+
+    // verify
+    XCTAssertEqual(0, [_metrics valueOfCounter:ACPPlacesMetricCounterEntryEvents]);
+    XCTAssertEqual(0, [_metrics sampleCountOfHistogram:ACPPlacesMetricHistogramPoiQueryLatency]);
+    XCTAssertEqualObjects(@(0), [self histogramNamed:@"poiQueryLatencyMs"][@"sum"]);
+}
+
+- (void) testConcurrentIncrementsAreNotLost {
+    // test
+    dispatch_apply(1000, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        [self.metrics incrementCounter:ACPPlacesMetricCounterLocationUpdates];
+        [self.metrics recordValue:iteration % 50 inHistogram:ACPPlacesMetricHistogramEventQueueDepth];
+    });
+
+    // verify
+    XCTAssertEqual(1000, [_metrics valueOfCounter:ACPPlacesMetricCounterLocationUpdates]);
+    XCTAssertEqual(1000, [_metrics sampleCountOfHistogram:ACPPlacesMetricHistogramEventQueueDepth]);
+}
+
+@end
@@ -20,22 +20,75 @@
 #import <CoreLocation/CoreLocation.h>
 #import "ACPCore.h"
 #import "ACPPlaces.h"
+#import "ACPPlacesAdaptivePolicy.h"
+#import "ACPPlacesBeaconRanger.h"
+#import "ACPPlacesContainmentEngine.h"
+#import "ACPPlacesGeofenceDiff.h"
+#import "ACPPlacesMetrics.h"
 #import "ACPPlacesMonitor.h"
 #import "ACPPlacesMonitorConstantsTests.h"
 #import "ACPPlacesMonitorInternal.h"
 #import "ACPPlacesMonitorLocationDelegate.h"
+#import "ACPPlacesPersistence.h"
+#import "ACPPlacesPoiCache.h"
+#import "ACPPlacesPoiPack.h"
+#import "ACPPlacesPoiPrefetcher.h"
+#import "ACPPlacesPoiRequestCoordinator.h"
+#import "ACPPlacesRegionClusters.h"
+#import "ACPPlacesRegionEventDebouncer.h"
+#import "ACPPlacesRetryScheduler.h"
+#import "ACPPlacesSerialExecutor.h"
+#import "ACPPlacesStateStore.h"
 #import "ACPPlacesQueue.h"
 
+// runs every block right away on the calling thread, so tests can check the monitor state as soon as a call returns
+@interface ACPPlacesInlineExecutor : ACPPlacesSerialExecutor
+@end
+
+@implementation ACPPlacesInlineExecutor
+- (BOOL) isCurrent {
+    return YES;
+}
+@end
+
 // private properties and methods exposed for testing
 @interface ACPPlacesMonitorInternal()
+@property(nonatomic, strong) ACPPlacesSerialExecutor* executor;
 @property(nonatomic, strong) ACPPlacesQueue* eventQueue;
 @property(nonatomic, strong) ACPPlacesMonitorLocationDelegate* locationDelegate;
-@property(nonatomic, strong) CLLocationManager* locationManager;
+@property(atomic, strong) CLLocationManager* locationManager;
+@property(nonatomic) BOOL locationManagerRequested;
+@property(nonatomic, strong) ACPPlacesPoiCache* poiCache;
+@property(nonatomic, strong) ACPPlacesPoiPack* poiPack;
+@property(nonatomic, strong) ACPPlacesGeofenceDiff* lastGeofenceDiff;
+@property(nonatomic, strong) CLCircularRegion* boundaryRegion;
+@property(nonatomic, strong) ACPPlacesRegionClusters* regionClusters;
+@property(nonatomic) BOOL clusterResolutionPending;
+@property(nonatomic, strong) ACPPlacesBeaconRanger* beaconRanger;
+@property(nonatomic, strong) NSDictionary<NSString*, ACPPlacesPoi*>* beaconPois;
+@property(nonatomic) NSTimeInterval continuousLocationStartedAt;
+@property(nonatomic, strong) ACPPlacesContainmentEngine* containmentEngine;
+@property(nonatomic, strong) ACPPlacesPoiRequestCoordinator* poiRequests;
+@property(nonatomic, strong) ACPPlacesPoiPrefetcher* poiPrefetcher;
+@property(nonatomic, strong) ACPPlacesRetryScheduler* retryScheduler;
+@property(nonatomic, strong) ACPPlacesRegionEventDebouncer* regionEventDebouncer;
+@property(nonatomic) NSInteger continuousLocationState;
 @property(nonatomic, strong) NSMutableArray<NSString*>* currentlyMonitoredRegions;
 @property(nonatomic, strong) NSMutableArray<NSString*>* userWithinRegions;
 @property(nonatomic) ACPPlacesMonitorMode monitorMode;
 @property(nonatomic) ACPPlacesMonitorRequestAuthorizationLevel requestAuthorizationLevel;
 @property(nonatomic) bool isMonitoringStarted;
+@property(nonatomic, strong) ACPPlacesPersistence* persistence;
+@property(nonatomic, strong) NSDictionary* configurationSnapshot;
+@property(nonatomic) NSUInteger configurationVersion;
+@property(nonatomic, strong) ACPPlacesAdaptivePolicy* adaptivePolicy;
+@property(nonatomic) ACPPlacesAdaptiveState adaptiveState;
+@property(nonatomic, strong) NSDate* adaptiveStateChangedAt;
+@property(nonatomic) NSUInteger adaptiveTimerGeneration;
+@property(nonatomic, strong) ACPPlacesMetrics* metrics;
+@property(nonatomic, strong) CLLocation* lastQueryLocation;
+@property(nonatomic) NSTimeInterval metricsReportingInterval;
+@property(nonatomic) NSUInteger metricsTimerGeneration;
 
 
 - (BOOL) backgroundLocationUpdatesEnabledInBundle;
@@ -43,13 +96,16 @@
 - (void) clearMonitorData;
 - (void) handlePlacesRequestError:(ACPPlacesRequestError) error;
 - (void) loadPersistedValues;
+- (BOOL) prepareLocationManager;
+- (void) processNearbyPois: (NSArray<ACPPlacesPoi*>*) nearbyPoi;
 - (void) removeNonMonitoredRegionsFromUserWithinRegions;
+- (void) reportMetricsForGeneration: (NSUInteger) generation;
 - (void) resetMonitoredGeofences;
 - (void) updateMonitorMode: (ACPPlacesMonitorMode) monitorMode;
 - (void) updateRequestAuthorizationLevel: (ACPPlacesMonitorRequestAuthorizationLevel) requestAuthorizationLevel;
 - (void) startMonitoring;
 - (void) startMonitoringContinuousLocationChanges;
-- (void) startMonitoringGeoFences: (NSArray*) newGeoFences;
+- (BOOL) startMonitoringGeoFences: (NSArray*) newGeoFences;
 - (void) startMonitoringSignificantLocationChanges;
 - (void) stopMonitoringContinuousLocationChanges;
 - (void) stopMonitoringGeoFences;
@@ -58,6 +114,12 @@
 - (void) updateUserWithinRegionsInPersistence;
 - (BOOL) userHasDeclinedLocationPermission: (CLAuthorizationStatus) status;
 - (void) persistMonitoringStatus;
+- (void) scheduleNearbyPois: (NSArray<ACPPlacesPoi*>*) nearbyPoi forLocation: (CLLocation*) location;
+- (void) detectRegionChangesForLocation: (CLLocation*) location;
+- (void) requestNearbyPoisForLocation: (CLLocation*) location;
+- (void) updateAdaptiveTrackingForLocation: (CLLocation*) location;
+- (void) adaptiveTimeLimitReachedForGeneration: (NSUInteger) generation;
+- (CLLocationDistance) distanceToNearestFenceFromLocation: (CLLocation*) location;
 
 @end
 
@@ -78,11 +140,16 @@
 
 - (void) setUp {
     _validPlacesConfig = @{@"validConfig":@"not actually used by this extension"};
+    [[[ACPPlacesStateStore alloc] init] remove];
     
     ACPPlacesMonitorInternal *tempMonitor = [[ACPPlacesMonitorInternal alloc] init];
+    tempMonitor.executor = [[ACPPlacesInlineExecutor alloc] init];
+    // the location manager is normally created on first use, most tests drive it directly
+    [tempMonitor prepareLocationManager];
     _monitor = OCMPartialMock(tempMonitor);
     _placesMock = OCMClassMock([ACPPlaces class]);
     _coreMock = OCMClassMock([ACPCore class]);
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelVerbose);
     _extensionApiMock = OCMClassMock([ACPExtensionApi class]);
     NSError *error = nil;
     OCMStub([_extensionApiMock getSharedEventState:ACPPlacesMonitorConfigurationSharedState_Test
@@ -103,12 +170,49 @@
 }
 
 - (void) tearDown {
+    [_monitor.persistence flush];
     [[NSUserDefaults standardUserDefaults] removeObjectForKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
     [[NSUserDefaults standardUserDefaults] removeObjectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
     [[NSUserDefaults standardUserDefaults] removeObjectForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
     [[NSUserDefaults standardUserDefaults] removeObjectForKey:ACPPlacesMonitorDefaultsIsMonitoringStarted_Test];
     [[NSUserDefaults standardUserDefaults] removeObjectForKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test];
     [[NSUserDefaults standardUserDefaults] synchronize];
+    [[[ACPPlacesStateStore alloc] init] remove];
+}
+
+// a food court of small shops a few meters apart, sharing one cluster region
+- (NSArray<ACPPlacesPoi*>*) foodCourtPoisWithPrefix: (NSString*) prefix atLatitude: (double) latitude count: (int) count {
+    NSMutableArray *pois = [NSMutableArray array];
+    for (int i = 0; i < count; i++) {
+        ACPPlacesPoi *poi = [[ACPPlacesPoi alloc] init];
+        poi.identifier = [NSString stringWithFormat:@"%@%d", prefix, i];
+        poi.latitude = latitude + i * 0.0001;
+        poi.longitude = 23.45;
+        poi.radius = 20;
+        [pois addObject:poi];
+    }
+    return pois;
+}
+
+// a POI with a beacon, ranged by a ranger which never fires its timers
+- (ACPPlacesPoi*) beaconPoiWithLocationManager: (id) locationManager {
+    _fakePoi.metaData = @{ACPPlacesMonitorPoiMetadataBeaconUuid_Test: @"E2C56DB5-DFFB-48D2-B060-D0F5A71096E0"};
+    _monitor.beaconRanger.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {};
+    _monitor.beaconRanger.locationManagerFactory = ^CLLocationManager* {
+        return locationManager;
+    };
+    return _fakePoi;
+}
+
+// values the monitor wrote to the state file
+- (id) persistedValueForKey: (NSString*) key {
+    return [[[ACPPlacesStateStore alloc] init] load][key];
+}
+
+// writes the state file and reloads the monitor's persistence from it, as if the app was relaunched
+- (void) persistValues: (NSDictionary*) values {
+    [[[ACPPlacesStateStore alloc] init] writeValues:values];
+    _monitor.persistence = [[ACPPlacesPersistence alloc] init];
 }
 
 - (void) testGetName {
@@ -133,17 +237,16 @@
     // verify
     XCTAssertNotNil(monitor);
     XCTAssertNotNil(monitor.eventQueue);
+    XCTAssertNotNil(monitor.poiCache);
     XCTAssertEqual(ACPPlacesMonitorModeSignificantChanges, monitor.monitorMode);
     XCTAssertNotNil(monitor.currentlyMonitoredRegions);
     XCTAssertEqual(0, monitor.currentlyMonitoredRegions.count);
     XCTAssertNotNil(monitor.userWithinRegions);
     XCTAssertEqual(0, monitor.userWithinRegions.count);
-    XCTAssertNotNil(monitor.locationManager);
-    XCTAssertNotNil(monitor.locationManager.delegate);
-    XCTAssertTrue([monitor.locationManager.delegate isKindOfClass:ACPPlacesMonitorLocationDelegate.class]);
-    XCTAssertEqual(100, monitor.locationManager.distanceFilter);
-    XCTAssertEqual(kCLLocationAccuracyBest, monitor.locationManager.desiredAccuracy);
+    XCTAssertNil(monitor.locationManager);
+    XCTAssertFalse(monitor.locationManagerRequested);
     XCTAssertEqual(monitor, monitor.locationDelegate.parent);
+    XCTAssertEqual(1, [monitor.metrics sampleCountOfHistogram:ACPPlacesMetricHistogramRegistrationLatency]);
 }
 
 - (void) testInitFromBackgroundThread {
@@ -154,26 +257,28 @@
                                     eventSource:[OCMArg any]
                                           error:[OCMArg setTo:error]]).andReturn(YES);
     
-    // test
+    // test - the main thread is blocked for the whole registration, which used to deadlock
     __block ACPPlacesMonitorInternal *monitor;
-    dispatch_sync(dispatch_queue_create("testqueue", 0), ^{
+    dispatch_semaphore_t initialized = dispatch_semaphore_create(0);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
         monitor = [[ACPPlacesMonitorInternal alloc] init];
+        dispatch_semaphore_signal(initialized);
     });
+    XCTAssertEqual(0, dispatch_semaphore_wait(initialized, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(5 * NSEC_PER_SEC))));
     
     // verify
     XCTAssertNotNil(monitor);
     XCTAssertNotNil(monitor.eventQueue);
+    XCTAssertNotNil(monitor.poiCache);
     XCTAssertEqual(ACPPlacesMonitorModeSignificantChanges, monitor.monitorMode);
     XCTAssertNotNil(monitor.currentlyMonitoredRegions);
     XCTAssertEqual(0, monitor.currentlyMonitoredRegions.count);
     XCTAssertNotNil(monitor.userWithinRegions);
     XCTAssertEqual(0, monitor.userWithinRegions.count);
-    XCTAssertNotNil(monitor.locationManager);
-    XCTAssertNotNil(monitor.locationManager.delegate);
-    XCTAssertTrue([monitor.locationManager.delegate isKindOfClass:ACPPlacesMonitorLocationDelegate.class]);
-    XCTAssertEqual(100, monitor.locationManager.distanceFilter);
-    XCTAssertEqual(kCLLocationAccuracyBest, monitor.locationManager.desiredAccuracy);
+    XCTAssertNil(monitor.locationManager);
+    XCTAssertFalse(monitor.locationManagerRequested);
     XCTAssertEqual(monitor, monitor.locationDelegate.parent);
+    XCTAssertEqual(1, [monitor.metrics sampleCountOfHistogram:ACPPlacesMetricHistogramRegistrationLatency]);
 }
 
 - (void) testInitValuesInPersistence {
@@ -188,8 +293,9 @@
                                               forKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
     [[NSUserDefaults standardUserDefaults] setObject:persistedUserWithinRegions
                                               forKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
+    [[[ACPPlacesStateStore alloc] init] remove];
     
-    // test
+    // test - values written by a version which kept them in NSUserDefaults are migrated to the state file
     ACPPlacesMonitorInternal *monitor = [[ACPPlacesMonitorInternal alloc] init];
     
     // verify
@@ -203,12 +309,106 @@
     XCTAssertNotNil(monitor.userWithinRegions);
     XCTAssertEqual(1, monitor.userWithinRegions.count);
     XCTAssertTrue([monitor.userWithinRegions containsObject:@"regionid1"]);
+    XCTAssertNil([[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertEqualObjects(persistedMonitoredRegions, [self persistedValueForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertNil(monitor.locationManager);
+    XCTAssertFalse(monitor.locationManagerRequested);
+    XCTAssertEqual(monitor, monitor.locationDelegate.parent);
+    XCTAssertEqual(1, [monitor.metrics sampleCountOfHistogram:ACPPlacesMetricHistogramRegistrationLatency]);
+}
+
+- (void) testPrepareLocationManagerOnMainThread {
+    // setup
+    ACPPlacesMonitorInternal *monitor = [[ACPPlacesMonitorInternal alloc] init];
+    OCMReject([_coreMock dispatchEvent:[OCMArg any] error:[OCMArg anyObjectRef]]);
+
+    // test
+    BOOL ready = [monitor prepareLocationManager];
+
+    // verify
+    XCTAssertTrue(ready);
     XCTAssertNotNil(monitor.locationManager);
     XCTAssertNotNil(monitor.locationManager.delegate);
     XCTAssertTrue([monitor.locationManager.delegate isKindOfClass:ACPPlacesMonitorLocationDelegate.class]);
     XCTAssertEqual(100, monitor.locationManager.distanceFilter);
     XCTAssertEqual(kCLLocationAccuracyBest, monitor.locationManager.desiredAccuracy);
-    XCTAssertEqual(monitor, monitor.locationDelegate.parent);
+    XCTAssertEqual(1, [monitor.metrics sampleCountOfHistogram:ACPPlacesMetricHistogramLocationManagerReadyLatency]);
+}
+
+- (void) testPrepareLocationManagerCreatesOneManager {
+    // setup
+    ACPPlacesMonitorInternal *monitor = [[ACPPlacesMonitorInternal alloc] init];
+    [monitor prepareLocationManager];
+    CLLocationManager *first = monitor.locationManager;
+
+    // test
+    [monitor prepareLocationManager];
+
+    // verify
+    XCTAssertEqual(first, monitor.locationManager);
+    XCTAssertEqual(1, [monitor.metrics sampleCountOfHistogram:ACPPlacesMetricHistogramLocationManagerReadyLatency]);
+}
+
+- (void) testProcessEventsFromBackgroundThreadHoldsEventsUntilLocationManagerIsReady {
+    // setup
+    ACPPlacesMonitorInternal *monitor = [[ACPPlacesMonitorInternal alloc] init];
+    ACPExtensionEvent* event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameStart_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:nil
+                                                                   error:nil];
+    [monitor.eventQueue add:event];
+
+    // test
+    dispatch_sync(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        [monitor processEvents];
+    });
+    [monitor.executor executeAndWait:^{}];
+
+    // verify - nothing is processed until the main thread created the manager
+    XCTAssertEqual(event, [monitor.eventQueue peek]);
+    XCTAssertTrue(monitor.locationManagerRequested);
+    XCTAssertNil(monitor.locationManager);
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"location manager created"];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertNotNil(monitor.locationManager);
+    OCMVerify([_coreMock dispatchEvent:[OCMArg checkWithBlock:^BOOL(id obj) {
+        ACPExtensionEvent *readyEvent = (ACPExtensionEvent*)obj;
+        XCTAssertEqualObjects(ACPPlacesMonitorEventNameLocationManagerReady_Test, readyEvent.eventName);
+        return YES;
+    }] error:[OCMArg anyObjectRef]]);
+}
+
+- (void) testProcessEventsEmptyQueueDoesNotCreateLocationManager {
+    // setup
+    ACPPlacesMonitorInternal *monitor = [[ACPPlacesMonitorInternal alloc] init];
+
+    // test
+    [monitor processEvents];
+    [monitor.executor executeAndWait:^{}];
+
+    // verify
+    XCTAssertNil(monitor.locationManager);
+    XCTAssertFalse(monitor.locationManagerRequested);
+}
+
+- (void) testQueueEventLocationManagerReadyIsNotQueued {
+    // setup
+    ACPExtensionEvent* event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameLocationManagerReady_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:nil
+                                                                   error:nil];
+
+    // test
+    [_monitor queueEvent:event];
+
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
 }
 
 - (void) testOnUnregister {
@@ -251,6 +451,132 @@
     XCTAssertNil([_monitor.eventQueue peek]);
 }
 
+- (void) testQueueEventRecordsQueueDepth {
+    // test
+    [_monitor queueEvent:[[ACPExtensionEvent alloc] init]];
+
+    // verify
+    XCTAssertEqual(1, [_monitor.metrics sampleCountOfHistogram:ACPPlacesMetricHistogramEventQueueDepth]);
+}
+
+- (void) testQueueEventGetMetricsRespondsWithoutQueueing {
+    // setup
+    ACPExtensionEvent *event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameGetMetrics_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:@{}
+                                                                   error:nil];
+    [_monitor.metrics incrementCounter:ACPPlacesMetricCounterLocationUpdates];
+
+    // test
+    [_monitor queueEvent:event];
+
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
+    OCMVerify([_coreMock dispatchResponseEvent:[OCMArg checkWithBlock:^BOOL(id obj) {
+        ACPExtensionEvent *response = (ACPExtensionEvent*)obj;
+        XCTAssertEqualObjects(ACPPlacesMonitorEventNameMetrics_Test, response.eventName);
+        NSDictionary *metrics = response.eventData[ACPPlacesMonitorEventDataMetrics_Test];
+        XCTAssertEqualObjects(@(1), metrics[@"counters"][@"locationUpdates"]);
+        return YES;
+    }] requestEvent:event error:[OCMArg anyObjectRef]]);
+}
+
+- (void) testQueueEventSetMetricsReportingInterval {
+    // setup
+    ACPExtensionEvent *event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameSetMetricsReportingInterval_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:@{ACPPlacesMonitorEventDataMetricsReportingInterval_Test:@(60)}
+                                                                   error:nil];
+    NSUInteger generation = _monitor.metricsTimerGeneration;
+
+    // test
+    [_monitor queueEvent:event];
+
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
+    XCTAssertEqual(60, _monitor.metricsReportingInterval);
+    XCTAssertEqual(generation + 1, _monitor.metricsTimerGeneration);
+}
+
+- (void) testQueueEventSetRegionEventDwellTime {
+    // setup
+    ACPExtensionEvent *event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameSetRegionEventDwellTime_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:@{ACPPlacesMonitorEventDataRegionEventDwellTime_Test:@(3)}
+                                                                   error:nil];
+
+    // test
+    [_monitor queueEvent:event];
+
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
+    XCTAssertEqual(3, _monitor.regionEventDebouncer.dwellTime);
+}
+
+- (void) testQueueEventSetPoiPackWithInvalidPath {
+    // setup
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    ACPExtensionEvent *event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameSetPoiPack_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:@{ACPPlacesMonitorEventDataPoiPackPath_Test:path}
+                                                                   error:nil];
+
+    // test
+    [_monitor queueEvent:event];
+
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
+    XCTAssertNil(_monitor.poiPack);
+}
+
+- (void) testQueueEventSetPoiPackWithoutPathUnloadsPack {
+    // setup
+    _monitor.poiPack = OCMClassMock([ACPPlacesPoiPack class]);
+    ACPExtensionEvent *event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameSetPoiPack_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:@{}
+                                                                   error:nil];
+
+    // test
+    [_monitor queueEvent:event];
+
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
+    XCTAssertNil(_monitor.poiPack);
+}
+
+- (void) testReportMetricsDispatchesSnapshot {
+    // setup
+    _monitor.metricsReportingInterval = 60;
+    _monitor.metricsTimerGeneration = 3;
+
+    // test
+    [_monitor reportMetricsForGeneration:3];
+
+    // verify
+    OCMVerify([_coreMock dispatchEvent:[OCMArg checkWithBlock:^BOOL(id obj) {
+        ACPExtensionEvent *event = (ACPExtensionEvent*)obj;
+        XCTAssertEqualObjects(ACPPlacesMonitorEventNameMetrics_Test, event.eventName);
+        XCTAssertNotNil(event.eventData[ACPPlacesMonitorEventDataMetrics_Test]);
+        return YES;
+    }] error:[OCMArg anyObjectRef]]);
+}
+
+- (void) testReportMetricsIgnoresRetiredTimer {
+    // setup
+    _monitor.metricsReportingInterval = 60;
+    _monitor.metricsTimerGeneration = 3;
+    OCMReject([_coreMock dispatchEvent:[OCMArg any] error:[OCMArg anyObjectRef]]);
+
+    // test
+    [_monitor reportMetricsForGeneration:2];
+}
+
 - (void) testProcessEventsEmptyQueue {
     // test
     [_monitor processEvents];
@@ -262,9 +588,11 @@
 - (void) testProcessEventsNoConfig {
     // setup
     ACPPlacesMonitorInternal *tempMonitor = [[ACPPlacesMonitorInternal alloc] init];
+    tempMonitor.executor = [[ACPPlacesInlineExecutor alloc] init];
     _monitor = OCMPartialMock(tempMonitor);
     _placesMock = OCMClassMock([ACPPlaces class]);
     _coreMock = OCMClassMock([ACPCore class]);
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelVerbose);
     _extensionApiMock = OCMClassMock([ACPExtensionApi class]);
     NSError *error = nil;
     OCMStub([_extensionApiMock getSharedEventState:ACPPlacesMonitorConfigurationSharedState_Test
@@ -290,9 +618,11 @@
 - (void) testProcessEventsErrorFromGetSharedState {
     // setup
     ACPPlacesMonitorInternal *tempMonitor = [[ACPPlacesMonitorInternal alloc] init];
+    tempMonitor.executor = [[ACPPlacesInlineExecutor alloc] init];
     _monitor = OCMPartialMock(tempMonitor);
     _placesMock = OCMClassMock([ACPPlaces class]);
     _coreMock = OCMClassMock([ACPCore class]);
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelVerbose);
     _extensionApiMock = OCMClassMock([ACPExtensionApi class]);
     NSError *error = [[NSError alloc] initWithDomain:NSCocoaErrorDomain
                                                 code:kCLErrorLocationUnknown
@@ -335,6 +665,29 @@
     OCMVerify([_monitor startMonitoring]);
 }
 
+- (void) testProcessEventsCoalescesRepeatedUpdateLocationNow {
+    // setup
+    NSError* eventCreationError = nil;
+    for (int i = 0; i < 5; i++) {
+        [_monitor queueEvent:[ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameUpdateLocationNow_Test
+                                                                  type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                  data:nil
+                                                                 error:&eventCreationError]];
+    }
+    __block int updateCount = 0;
+    OCMStub([_monitor updateLocationNow]).andDo(^(NSInvocation *invocation) {
+        updateCount++;
+    });
+    
+    // test
+    [_monitor processEvents];
+    
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
+    XCTAssertEqual(1, updateCount);
+}
+
 - (void) testProcessEventsStopEventWithClear {
     // setup
     NSError* eventCreationError = nil;
@@ -468,9 +821,11 @@
     // verify
     OCMVerify([_placesMock clear]);
     OCMVerify([_monitor clearMonitorData]);
+    XCTAssertNil([_monitor.poiCache poisNearLocation:_fakeLocation]);
     OCMVerify([_monitor stopMonitoringContinuousLocationChanges]);
     OCMVerify([_monitor stopMonitoringSignificantLocationChanges]);
     OCMVerify([_monitor stopMonitoringGeoFences]);
+    XCTAssertFalse([_monitor.persistence hasPendingWrites]);
 }
 
 - (void) testStopAllMonitoringWithoutClear {
@@ -510,60 +865,103 @@
     OCMVerify([_monitor updateUserWithinRegionsInPersistence]);
 }
 
+- (void) testAddDeviceToRegionIfAbsentOnlyAddsOnce {
+    // test
+    BOOL first = [_monitor addDeviceToRegionIfAbsent:_fakeRegion];
+    BOOL second = [_monitor addDeviceToRegionIfAbsent:_fakeRegion];
+
+    // verify
+    XCTAssertTrue(first);
+    XCTAssertFalse(second);
+    XCTAssertEqual(1, _monitor.userWithinRegions.count);
+}
+
+- (void) testRemoveDeviceFromRegionIfPresentOnlyRemovesOnce {
+    // setup
+    [_monitor.userWithinRegions addObject:_fakeRegion.identifier];
+
+    // test
+    BOOL first = [_monitor removeDeviceFromRegionIfPresent:_fakeRegion];
+    BOOL second = [_monitor removeDeviceFromRegionIfPresent:_fakeRegion];
+
+    // verify
+    XCTAssertTrue(first);
+    XCTAssertFalse(second);
+    XCTAssertEqual(0, _monitor.userWithinRegions.count);
+}
+
+- (void) testConcurrentEntriesAreRecordedOnce {
+    // setup
+    __block NSUInteger added = 0;
+
+    // test - CoreLocation's callbacks and location updates record the same entry at once
+    dispatch_apply(64, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        if ([self.monitor addDeviceToRegionIfAbsent:self.fakeRegion]) {
+            @synchronized (self) {
+                added++;
+            }
+        }
+    });
+
+    // verify
+    XCTAssertEqual(1, added);
+    XCTAssertEqual(1, _monitor.userWithinRegions.count);
+}
+
 - (void) testUpdateUserWithinRegionsInPersistence {
     // setup
     _monitor.userWithinRegions[0] = _fakeRegion.identifier;
-    XCTAssertFalse([[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test]);
+    XCTAssertFalse([self persistedValueForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test]);
     
     // test
     [_monitor updateUserWithinRegionsInPersistence];
+    [_monitor.persistence flush];
     
     // verify
-    NSArray *listFromDefaults = [[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
-    XCTAssertEqual(1, listFromDefaults.count);
-    XCTAssertTrue([_fakeRegion.identifier isEqualToString:listFromDefaults[0]]);
+    NSArray *persistedList = [self persistedValueForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
+    XCTAssertEqual(1, persistedList.count);
+    XCTAssertTrue([_fakeRegion.identifier isEqualToString:persistedList[0]]);
 }
 
 - (void) testUpdateUserWithinRegionsInPersistenceEmptyRegions {
     // setup
-    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
-    [defaults setObject:@[_fakeRegion.identifier] forKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
-    [defaults synchronize];
+    [self persistValues:@{ACPPlacesMonitorDefaultsUserWithinRegions_Test: @[_fakeRegion.identifier]}];
     
     // test
     [_monitor updateUserWithinRegionsInPersistence];
+    [_monitor.persistence flush];
     
     // verify
-    NSArray *listFromDefaults = [[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
-    XCTAssertEqual(0, listFromDefaults.count);
+    NSArray *persistedList = [self persistedValueForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
+    XCTAssertEqual(0, persistedList.count);
 }
 
 - (void) testUpdateCurrentlyMonitoredRegionsInPersistence {
     // setup
     _monitor.currentlyMonitoredRegions[0] = _fakeRegion.identifier;
-    XCTAssertFalse([[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertFalse([self persistedValueForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
     
     // test
     [_monitor updateCurrentlyMonitoredRegionsInPersistence];
+    [_monitor.persistence flush];
     
     // verify
-    NSArray *listFromDefaults = [[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
-    XCTAssertEqual(1, listFromDefaults.count);
-    XCTAssertTrue([_fakeRegion.identifier isEqualToString:listFromDefaults[0]]);
+    NSArray *persistedList = [self persistedValueForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
+    XCTAssertEqual(1, persistedList.count);
+    XCTAssertTrue([_fakeRegion.identifier isEqualToString:persistedList[0]]);
 }
 
 - (void) testUpdateCurrentlyMonitoredRegionsInPersistenceEmptyRegions {
     // setup
-    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
-    [defaults setObject:@[_fakeRegion.identifier] forKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
-    [defaults synchronize];
+    [self persistValues:@{ACPPlacesMonitorDefaultsMonitoredRegions_Test: @[_fakeRegion.identifier]}];
     
     // test
     [_monitor updateCurrentlyMonitoredRegionsInPersistence];
+    [_monitor.persistence flush];
     
     // verify
-    NSArray *listFromDefaults = [[NSUserDefaults standardUserDefaults] objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
-    XCTAssertEqual(0, listFromDefaults.count);
+    NSArray *persistedList = [self persistedValueForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
+    XCTAssertEqual(0, persistedList.count);
 }
 
 - (void) testDeviceIsWithinRegionTrue {
@@ -591,7 +989,7 @@
 - (void) testPostLocationUpdateNoPois {
     // setup
     OCMStub([_placesMock getNearbyPointsOfInterest:_fakeLocation
-                                             limit:ACPPlacesMonitorDefaultMaxMonitoredRegionCount_Test
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
                                           callback:[OCMArg any]
                                      errorCallback:[OCMArg any]]).andDo(^(NSInvocation *invocation) {
         // get a reference to the Places callback
@@ -601,7 +999,7 @@
         testableCallback(nil);
         
         // verify after callback processes
-        OCMVerify([self.monitor resetMonitoredGeofences]);
+        OCMVerify([self.monitor startMonitoringGeoFences:@[]]);
         OCMVerify([self.coreMock log:ACPMobileLogLevelDebug
                              tag:ACPPlacesMonitorExtensionName_Test
                          message:@"There are no POIs near the device location."]);
@@ -615,7 +1013,7 @@
 - (void) testPostLocationUpdate {
     // setup
     OCMStub([_placesMock getNearbyPointsOfInterest:_fakeLocation
-                                             limit:ACPPlacesMonitorDefaultMaxMonitoredRegionCount_Test
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
                                           callback:[OCMArg any]
                                      errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
         // get a reference to the Places callback
@@ -628,7 +1026,6 @@
         testableCallback(poiArray);
         
         // verify after callback processes
-        OCMVerify([self.monitor resetMonitoredGeofences]);
         OCMVerify([self.coreMock log:ACPMobileLogLevelDebug
                                  tag:ACPPlacesMonitorExtensionName_Test
                              message:message]);
@@ -638,12 +1035,16 @@
     
     // test
     [_monitor postLocationUpdate:_fakeLocation];
+
+    // verify
+    XCTAssertEqual(_fakeLocation, _monitor.lastQueryLocation);
+    XCTAssertEqual(_fakeLocation, [_monitor.persistence objectForKey:ACPPlacesMonitorStateLastQueryLocation_Test]);
 }
 
 - (void) testPostLocationUpdateConnectivityError {
     // setup
     OCMStub([_placesMock getNearbyPointsOfInterest:_fakeLocation
-                                             limit:ACPPlacesMonitorDefaultMaxMonitoredRegionCount_Test
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
                                           callback:[OCMArg any]
                                      errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
         // get a reference to the Places callback
@@ -660,101 +1061,893 @@
     [_monitor postLocationUpdate:_fakeLocation];
 }
 
-- (void) testHandlePlacesRequestErrorNone {
+- (void) testPostLocationUpdateCachesResponse {
+    // setup
+    OCMStub([_placesMock getNearbyPointsOfInterest:_fakeLocation
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                          callback:[OCMArg any]
+                                     errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
+        void (^testableCallback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+        [invocation getArgument:&testableCallback atIndex:4];
+        testableCallback(@[self.fakePoi]);
+    }));
+    
     // test
-    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorNone];
+    [_monitor postLocationUpdate:_fakeLocation];
     
     // verify
-    OCMReject([self.coreMock log:ACPMobileLogLevelWarning
-                             tag:ACPPlacesMonitorExtensionName_Test
-                         message:[OCMArg any]]);
+    XCTAssertEqual(1, _monitor.poiCache.missCount);
+    NSArray *cachedPois = [_monitor.poiCache poisNearLocation:_fakeLocation];
+    XCTAssertEqual(1, cachedPois.count);
+    XCTAssertEqualObjects(_fakePoi.identifier, [cachedPois[0] identifier]);
 }
 
-- (void) testHandlePlacesRequestErrorConfiguration {
+- (void) testPostLocationUpdateCacheHit {
+    // setup
+    [_monitor.poiCache cachePois:@[_fakePoi] forLocation:_fakeLocation];
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+    OCMReject([_placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                               limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                            callback:[OCMArg any]
+                                       errorCallback:[OCMArg any]]);
+    
     // test
-    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorConfigurationError];
+    [_monitor postLocationUpdate:_fakeLocation];
     
     // verify
-    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: Missing Places configuration.";
-    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
-                             tag:ACPPlacesMonitorExtensionName_Test
-                         message:errorString]);
-    OCMVerify([_monitor stopAllMonitoring:YES]);
+    OCMVerify([_monitor processNearbyPois:[OCMArg checkWithBlock:^BOOL(NSArray<ACPPlacesPoi*> *pois) {
+        return pois.count == 1 && [pois[0].identifier isEqualToString:self.fakePoi.identifier];
+    }]]);
+    XCTAssertEqual(1, _monitor.poiCache.hitCount);
 }
 
-- (void) testHandlePlacesRequestErrorConnectivity {
+- (void) testPostLocationUpdateAnsweredFromPoiPack {
+    // setup
+    id packMock = OCMClassMock([ACPPlacesPoiPack class]);
+    OCMStub([packMock poisNearLocation:_fakeLocation limit:ACPPlacesMonitorCandidatePoiCount_Test]).andReturn(@[_fakePoi]);
+    OCMStub([packMock needsRefreshNearLocation:_fakeLocation]).andReturn(NO);
+    _monitor.poiPack = packMock;
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+    OCMReject([_placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                               limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                            callback:[OCMArg any]
+                                       errorCallback:[OCMArg any]]);
+
     // test
-    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorConnectivityError];
+    [_monitor postLocationUpdate:_fakeLocation];
+
+    // verify
+    OCMVerify([_monitor processNearbyPois:@[_fakePoi]]);
+    XCTAssertEqual(1, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterPoiPackQueries]);
+    XCTAssertEqual(0, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterPoiQueries]);
+    XCTAssertEqual(0, _monitor.poiCache.missCount);
+}
+
+- (void) testPostLocationUpdateAppliesDeltaToPoiPack {
+    // setup
+    id packMock = OCMClassMock([ACPPlacesPoiPack class]);
+    OCMStub([packMock poisNearLocation:_fakeLocation limit:ACPPlacesMonitorCandidatePoiCount_Test]).andReturn(@[_fakePoi]);
+    OCMStub([packMock needsRefreshNearLocation:_fakeLocation]).andReturn(YES);
+    _monitor.poiPack = packMock;
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+    OCMStub([_placesMock getNearbyPointsOfInterest:_fakeLocation
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                          callback:[OCMArg any]
+                                     errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
+        void (^testableCallback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+        [invocation getArgument:&testableCallback atIndex:4];
+        testableCallback(@[self.fakePoi]);
+    }));
+
+    // test
+    [_monitor postLocationUpdate:_fakeLocation];
+
+    // verify - the response is layered over the pack instead of being cached
+    OCMVerify([packMock applyDelta:@[_fakePoi] forLocation:_fakeLocation limit:ACPPlacesMonitorCandidatePoiCount_Test]);
+    OCMVerify([_monitor processNearbyPois:@[_fakePoi]]);
+    XCTAssertNil([_monitor.poiCache poisNearLocation:_fakeLocation]);
+}
+
+- (void) testPoiPackDisablesPrefetching {
+    // setup
+    _monitor.poiPack = OCMClassMock([ACPPlacesPoiPack class]);
+
+    // verify
+    XCTAssertFalse(_monitor.poiPrefetcher.canFetch());
+}
+
+- (void) testProcessNearbyPoisResetsGeofencesWhenMonitoringNotPossible {
+    // setup
+    OCMStub([_monitor startMonitoringGeoFences:[OCMArg any]]).andReturn(NO);
+    
+    // test
+    [_monitor processNearbyPois:@[_fakePoi]];
     
     // verify
-    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: No network connectivity.";
-    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
-                             tag:ACPPlacesMonitorExtensionName_Test
-                         message:errorString]);
+    OCMVerify([_monitor resetMonitoredGeofences]);
+    OCMVerify([_monitor removeNonMonitoredRegionsFromUserWithinRegions]);
 }
 
-- (void) testHandlePlacesRequestErrorInvalidLatLon {
+- (void) testProcessNearbyPoisDoesNotResetGeofences {
+    // setup
+    OCMStub([_monitor startMonitoringGeoFences:[OCMArg any]]).andReturn(YES);
+    OCMReject([_monitor resetMonitoredGeofences]);
+    
     // test
-    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorInvalidLatLongError];
+    [_monitor processNearbyPois:@[_fakePoi]];
     
     // verify
-    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: An invalid latitude and/or longitude was provided.  Valid values are -90 to 90 (lat) and -180 to 180 (lon).";
-    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
-                             tag:ACPPlacesMonitorExtensionName_Test
-                         message:errorString]);
+    OCMVerify([_monitor startMonitoringGeoFences:@[_fakePoi]]);
 }
 
-- (void) testHandlePlacesRequestErrorQueryServiceUnavailable {
+- (void) testConfigurationDidChangeInvalidatesPoiCache {
+    // setup
+    [_monitor.poiCache cachePois:@[_fakePoi] forLocation:_fakeLocation];
+    
+    // test
+    [_monitor configurationDidChange];
+    
+    // verify
+    XCTAssertNil([_monitor.poiCache poisNearLocation:_fakeLocation]);
+}
+
+- (void) testConfigurationDidChangeDiscardsPoiPackDeltas {
+    // setup
+    id packMock = OCMClassMock([ACPPlacesPoiPack class]);
+    _monitor.poiPack = packMock;
+
+    // test
+    [_monitor configurationDidChange];
+
+    // verify
+    OCMVerify([packMock discardDeltas]);
+}
+
+- (void) testConfigurationDidChangeCancelsPrefetch {
+    // setup
+    id prefetcherMock = OCMPartialMock(_monitor.poiPrefetcher);
+    
+    // test
+    [_monitor configurationDidChange];
+    
+    // verify
+    OCMVerify([prefetcherMock cancel]);
+}
+
+- (void) testPostLocationUpdateFeedsPrefetcher {
+    // setup
+    id prefetcherMock = OCMPartialMock(_monitor.poiPrefetcher);
+    
+    // test
+    [_monitor postLocationUpdate:_fakeLocation];
+    
+    // verify
+    OCMVerify([prefetcherMock addLocation:_fakeLocation]);
+}
+
+- (void) testConfigurationDidChangeDropsConfigurationSnapshot {
+    // setup
+    _monitor.configurationSnapshot = _validPlacesConfig;
+    NSUInteger version = _monitor.configurationVersion;
+    
+    // test
+    [_monitor configurationDidChange];
+    
+    // verify
+    XCTAssertNil(_monitor.configurationSnapshot);
+    XCTAssertEqual(version + 1, _monitor.configurationVersion);
+}
+
+- (void) testProcessEventsResolvesConfigurationOncePerBatch {
+    // setup
+    NSError* eventCreationError = nil;
+    NSArray *names = @[ACPPlacesMonitorEventNameStart_Test, ACPPlacesMonitorEventNameUpdateLocationNow_Test,
+                       ACPPlacesMonitorEventNameUpdateMonitorConfiguration_Test];
+    for (NSString *name in names) {
+        [_monitor queueEvent:[ACPExtensionEvent extensionEventWithName:name
+                                                                  type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                  data:nil
+                                                                 error:&eventCreationError]];
+    }
+    
+    // test
+    [_monitor processEvents];
+    
+    // verify
+    XCTAssertNil([_monitor.eventQueue peek]);
+    XCTAssertEqual(_validPlacesConfig, _monitor.configurationSnapshot);
+    XCTAssertEqual(2, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterAvoidedSharedStateLookups]);
+    XCTAssertEqualObjects(@(2), [_monitor.metrics snapshot][@"counters"][@"avoidedSharedStateLookups"]);
+}
+
+- (void) testHandlePlacesRequestErrorNone {
+    // test
+    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorNone];
+    
+    // verify
+    OCMReject([self.coreMock log:ACPMobileLogLevelWarning
+                             tag:ACPPlacesMonitorExtensionName_Test
+                         message:[OCMArg any]]);
+}
+
+- (void) testHandlePlacesRequestErrorConfiguration {
+    // test
+    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorConfigurationError];
+    
+    // verify
+    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: Missing Places configuration.";
+    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
+                             tag:ACPPlacesMonitorExtensionName_Test
+                         message:errorString]);
+    OCMVerify([_monitor stopAllMonitoring:YES]);
+}
+
+- (void) testHandlePlacesRequestErrorConnectivity {
+    // test
+    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorConnectivityError];
+    
+    // verify
+    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: No network connectivity.";
+    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
+                             tag:ACPPlacesMonitorExtensionName_Test
+                         message:errorString]);
+}
+
+- (void) testHandlePlacesRequestErrorInvalidLatLon {
+    // test
+    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorInvalidLatLongError];
+    
+    // verify
+    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: An invalid latitude and/or longitude was provided.  Valid values are -90 to 90 (lat) and -180 to 180 (lon).";
+    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
+                             tag:ACPPlacesMonitorExtensionName_Test
+                         message:errorString]);
+}
+
+- (void) testHandlePlacesRequestErrorQueryServiceUnavailable {
+    // test
+    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorQueryServiceUnavailable];
+    
+    // verify
+    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: The Places Query Service is unavailable. Try again later.";
+    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
+                             tag:ACPPlacesMonitorExtensionName_Test
+                         message:errorString]);
+}
+
+- (void) testHandlePlacesRequestErrorServerResponseError {
+    // test
+    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorServerResponseError];
+    
+    // verify
+    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: There is an error in the response from the server.";
+    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
+                             tag:ACPPlacesMonitorExtensionName_Test
+                         message:errorString]);
+}
+
+- (void) testHandlePlacesRequestErrorUnknownError {
+    // test
+    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorUnknownError];
+    
+    // verify
+    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: Unknown error.";
+    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
+                             tag:ACPPlacesMonitorExtensionName_Test
+                         message:errorString]);
+}
+
+- (void) testUpdateLocationNow {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    _monitor.locationManager = locationManagerMock;
+    
+    // test
+    [_monitor updateLocationNow];
+    
+    // verify
+    OCMVerify([locationManagerMock requestLocation]);
+}
+
+- (void) testProcessRegionUpdateWithEventType {
+    // test
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+    
+    // verify
+    OCMVerify([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
+}
+
+- (void) testPostRegionUpdateWaitsForDwellTime {
+    // setup
+    _monitor.regionEventDebouncer.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {};
+    _monitor.regionEventDebouncer.dwellTime = 5;
+    OCMReject([_placesMock processRegionEvent:[OCMArg any] forRegionEventType:ACPRegionEventTypeEntry]);
+
+    // test
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+
+    // verify
+    XCTAssertEqual(1, _monitor.regionEventDebouncer.pendingCount);
+}
+
+- (void) testPostRegionUpdateOppositeEventsWithinDwellTimeAreNotReported {
+    // setup
+    _monitor.regionEventDebouncer.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {};
+    _monitor.regionEventDebouncer.dwellTime = 5;
+    OCMReject([_placesMock processRegionEvent:[OCMArg any] forRegionEventType:ACPRegionEventTypeEntry]);
+    OCMReject([_placesMock processRegionEvent:[OCMArg any] forRegionEventType:ACPRegionEventTypeExit]);
+
+    // test
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeExit];
+    [_monitor.regionEventDebouncer drain];
+
+    // verify
+    XCTAssertEqual(0, _monitor.regionEventDebouncer.pendingCount);
+    XCTAssertEqual(2, _monitor.regionEventDebouncer.suppressedEventCount);
+}
+
+- (void) testStopAllMonitoringReportsPendingRegionEvents {
+    // setup
+    _monitor.regionEventDebouncer.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {};
+    _monitor.regionEventDebouncer.dwellTime = 5;
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+
+    // test
+    [_monitor stopAllMonitoring:NO];
+
+    // verify
+    OCMVerify([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
+}
+
+- (void) testStopAllMonitoringWithClearDropsPendingRegionEvents {
+    // setup
+    _monitor.regionEventDebouncer.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {};
+    _monitor.regionEventDebouncer.dwellTime = 5;
+    OCMReject([_placesMock processRegionEvent:[OCMArg any] forRegionEventType:ACPRegionEventTypeEntry]);
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+
+    // test
+    [_monitor stopAllMonitoring:YES];
+
+    // verify
+    XCTAssertEqual(0, _monitor.regionEventDebouncer.pendingCount);
+}
+
+- (void) testPostRegionUpdateBoundaryExitRefreshesLocation {
+    // setup
+    CLCircularRegion *boundary = [[CLCircularRegion alloc] initWithCenter:_fakeLocation.coordinate
+                                                                    radius:1000
+                                                                identifier:ACPPlacesMonitorBoundaryRegionIdentifier_Test];
+    OCMStub([_monitor updateLocationNow]);
+    OCMReject([_placesMock processRegionEvent:[OCMArg any] forRegionEventType:ACPRegionEventTypeExit]);
+    
+    // test
+    [_monitor postRegionUpdate:boundary withEventType:ACPRegionEventTypeExit];
+    
+    // verify
+    OCMVerify([_monitor updateLocationNow]);
+}
+
+- (void) testAddDeviceToBoundaryRegionIsIgnored {
+    // setup
+    CLCircularRegion *boundary = [[CLCircularRegion alloc] initWithCenter:_fakeLocation.coordinate
+                                                                    radius:1000
+                                                                identifier:ACPPlacesMonitorBoundaryRegionIdentifier_Test];
+    
+    // test
+    [_monitor addDeviceToRegion:boundary];
+    
+    // verify
+    XCTAssertEqual(0, _monitor.userWithinRegions.count);
+}
+
+- (void) testScheduleNearbyPoisAddsBoundaryWhenSlotsRunOut {
+    // setup
+    NSMutableArray *candidates = [NSMutableArray array];
+    for (int i = 0; i < ACPPlacesMonitorDefaultMaxMonitoredRegionCount_Test + 5; i++) {
+        ACPPlacesPoi *poi = [[ACPPlacesPoi alloc] init];
+        poi.identifier = [NSString stringWithFormat:@"poi%d", i];
+        poi.latitude = 12.34 + i * 0.001;
+        poi.longitude = 23.45;
+        poi.radius = 50;
+        [candidates addObject:poi];
+    }
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+    
+    // test
+    [_monitor scheduleNearbyPois:candidates forLocation:_fakeLocation];
+    
+    // verify
+    XCTAssertNotNil(_monitor.boundaryRegion);
+    OCMVerify([_monitor processNearbyPois:[OCMArg checkWithBlock:^BOOL(NSArray *pois) {
+        return pois.count == ACPPlacesMonitorDefaultMaxMonitoredRegionCount_Test - 1;
+    }]]);
+}
+
+- (void) testScheduleNearbyPoisClustersWhenSlotsRunOut {
+    // setup
+    NSMutableArray *candidates = [NSMutableArray array];
+    [candidates addObjectsFromArray:[self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:8]];
+    [candidates addObjectsFromArray:[self foodCourtPoisWithPrefix:@"b" atLatitude:12.35 count:8]];
+    [candidates addObjectsFromArray:[self foodCourtPoisWithPrefix:@"c" atLatitude:12.36 count:8]];
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+
+    // test
+    [_monitor scheduleNearbyPois:candidates forLocation:_fakeLocation];
+
+    // verify
+    XCTAssertNotNil(_monitor.regionClusters);
+    XCTAssertEqual(21, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterClusterSlotsSaved]);
+    OCMVerify([_monitor processNearbyPois:[OCMArg checkWithBlock:^BOOL(NSArray<ACPPlacesPoi*> *pois) {
+        return pois.count == 3 && [self.monitor.regionClusters membersOfClusterWithIdentifier:pois[0].identifier].count == 8;
+    }]]);
+}
+
+- (void) testScheduleNearbyPoisDoesNotClusterWhenPoisFit {
+    // setup
+    NSArray *candidates = [self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:8];
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+
+    // test
+    [_monitor scheduleNearbyPois:candidates forLocation:_fakeLocation];
+
+    // verify
+    XCTAssertNil(_monitor.regionClusters);
+    XCTAssertEqual(0, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterClusterSlotsSaved]);
+    OCMVerify([_monitor processNearbyPois:candidates]);
+}
+
+- (void) testPostRegionUpdateClusterEntryRequestsLocation {
+    // setup
+    NSArray *members = [self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:3];
+    _monitor.regionClusters = [ACPPlacesRegionClusters clustersWithPois:members maximumRadius:200];
+    ACPPlacesPoi *clusterPoi = _monitor.regionClusters.regionPois[0];
+    CLCircularRegion *cluster = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(clusterPoi.latitude, clusterPoi.longitude)
+                                                                  radius:clusterPoi.radius
+                                                              identifier:clusterPoi.identifier];
+    OCMStub([_monitor updateLocationNow]);
+    OCMReject([_placesMock processRegionEvent:[OCMArg any] forRegionEventType:ACPRegionEventTypeEntry]);
+
+    // test
+    [_monitor postRegionUpdate:cluster withEventType:ACPRegionEventTypeEntry];
+
+    // verify
+    OCMVerify([_monitor updateLocationNow]);
+    XCTAssertTrue(_monitor.clusterResolutionPending);
+    XCTAssertEqual(1, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterClusterResolutionFixes]);
+    XCTAssertEqual(0, _monitor.regionEventDebouncer.pendingCount);
+}
+
+- (void) testPostRegionUpdateClusterEntryWithContinuousUpdatesDoesNotRequestLocation {
+    // setup
+    _monitor.regionClusters = [ACPPlacesRegionClusters clustersWithPois:[self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:3]
+                                                         maximumRadius:200];
+    ACPPlacesPoi *clusterPoi = _monitor.regionClusters.regionPois[0];
+    CLCircularRegion *cluster = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(clusterPoi.latitude, clusterPoi.longitude)
+                                                                  radius:clusterPoi.radius
+                                                              identifier:clusterPoi.identifier];
+    _monitor.continuousLocationState = 1;
+    OCMReject([_monitor updateLocationNow]);
+
+    // test
+    [_monitor postRegionUpdate:cluster withEventType:ACPRegionEventTypeEntry];
+
+    // verify
+    XCTAssertFalse(_monitor.clusterResolutionPending);
+    XCTAssertEqual(0, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterClusterResolutionFixes]);
+}
+
+- (void) testPostLocationUpdateResolvesClusterMembers {
+    // setup
+    NSArray<ACPPlacesPoi*> *members = [self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:3];
+    [_monitor.containmentEngine loadPois:members];
+    _monitor.clusterResolutionPending = YES;
+    CLLocation *location = [[CLLocation alloc] initWithLatitude:members[2].latitude longitude:members[2].longitude];
+    OCMStub([_monitor requestNearbyPoisForLocation:[OCMArg any]]);
+
+    // test
+    [_monitor postLocationUpdate:location];
+
+    // verify
+    XCTAssertFalse(_monitor.clusterResolutionPending);
+    OCMVerify([_monitor detectRegionChangesForLocation:location]);
+    XCTAssertTrue([_monitor.userWithinRegions containsObject:@"a2"]);
+    XCTAssertFalse([_monitor.userWithinRegions containsObject:@"a0"]);
+}
+
+- (void) testPostRegionUpdateClusterExitReportsMemberExits {
+    // setup
+    NSArray<ACPPlacesPoi*> *members = [self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:3];
+    _monitor.regionClusters = [ACPPlacesRegionClusters clustersWithPois:members maximumRadius:200];
+    ACPPlacesPoi *clusterPoi = _monitor.regionClusters.regionPois[0];
+    CLCircularRegion *cluster = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(clusterPoi.latitude, clusterPoi.longitude)
+                                                                  radius:clusterPoi.radius
+                                                              identifier:clusterPoi.identifier];
+    [_monitor.userWithinRegions addObject:@"a1"];
+    _monitor.regionEventDebouncer.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {};
+    _monitor.regionEventDebouncer.dwellTime = 5;
+
+    // test
+    [_monitor postRegionUpdate:cluster withEventType:ACPRegionEventTypeExit];
+
+    // verify
+    XCTAssertFalse([_monitor.userWithinRegions containsObject:@"a1"]);
+    XCTAssertEqual(1, _monitor.regionEventDebouncer.pendingCount);
+}
+
+- (void) testStartMonitoringGeoFencesClusterMonitorsMembersThroughCluster {
+    // setup
+    NSArray<ACPPlacesPoi*> *members = [self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:3];
+    members[1].userIsWithin = YES;
+    _monitor.regionClusters = [ACPPlacesRegionClusters clustersWithPois:members maximumRadius:200];
+    ACPPlacesPoi *clusterPoi = _monitor.regionClusters.regionPois[0];
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock isMonitoringAvailableForClass:[CLCircularRegion class]]).andReturn(YES);
+    OCMStub([locationManagerMock maximumRegionMonitoringDistance]).andReturn(1000);
+    _monitor.locationManager = locationManagerMock;
+    OCMStub([_monitor userHasDeclinedLocationPermission:kCLAuthorizationStatusRestricted]).andReturn(NO);
+
+    // test
+    [_monitor startMonitoringGeoFences:@[clusterPoi]];
+
+    // verify
+    OCMVerify([locationManagerMock startMonitoringForRegion:[OCMArg checkWithBlock:^BOOL(CLRegion *region) {
+        return [region.identifier isEqualToString:clusterPoi.identifier];
+    }]]);
+    NSArray *expectedRegions = @[clusterPoi.identifier, @"a0", @"a1", @"a2"];
+    XCTAssertEqualObjects(expectedRegions, _monitor.currentlyMonitoredRegions);
+    XCTAssertTrue([_monitor.userWithinRegions containsObject:@"a1"]);
+    XCTAssertTrue([_monitor.userWithinRegions containsObject:clusterPoi.identifier]);
+    OCMVerify([_placesMock processRegionEvent:[OCMArg checkWithBlock:^BOOL(CLRegion *region) {
+        return [region.identifier isEqualToString:@"a1"];
+    }] forRegionEventType:ACPRegionEventTypeEntry]);
+}
+
+- (void) testStartMonitoringGeoFencesCapsRadiusWithoutChangingPoi {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock isMonitoringAvailableForClass:[CLCircularRegion class]]).andReturn(YES);
+    OCMStub([locationManagerMock maximumRegionMonitoringDistance]).andReturn(100);
+    _monitor.locationManager = locationManagerMock;
+    OCMStub([_monitor userHasDeclinedLocationPermission:kCLAuthorizationStatusRestricted]).andReturn(NO);
+
+    // test
+    [_monitor startMonitoringGeoFences:@[_fakePoi]];
+
+    // verify
+    OCMVerify([locationManagerMock startMonitoringForRegion:[OCMArg checkWithBlock:^BOOL(CLCircularRegion *region) {
+        return region.radius == 100;
+    }]]);
+    XCTAssertEqual(500, _fakePoi.radius);
+}
+
+- (void) testProcessNearbyPoisKeepsBeaconPois {
+    // setup
+    ACPPlacesPoi *beaconPoi = [self beaconPoiWithLocationManager:OCMClassMock([CLLocationManager class])];
+    ACPPlacesPoi *otherPoi = [self foodCourtPoisWithPrefix:@"a" atLatitude:12.34 count:1][0];
+    id rangerClassMock = OCMClassMock([ACPPlacesBeaconRanger class]);
+    OCMStub([rangerClassMock isRangingAvailable]).andReturn(YES);
+    OCMStub([rangerClassMock beaconRegionForPoi:[OCMArg any]]).andForwardToRealObject();
+    OCMStub([_monitor startMonitoringGeoFences:[OCMArg any]]).andReturn(YES);
+
+    // test
+    [_monitor processNearbyPois:@[beaconPoi, otherPoi]];
+
+    // verify
+    XCTAssertEqualObjects(@[beaconPoi.identifier], _monitor.beaconPois.allKeys);
+    [rangerClassMock stopMocking];
+}
+
+- (void) testProcessNearbyPoisWithoutRangingKeepsNoBeaconPois {
+    // setup
+    ACPPlacesPoi *beaconPoi = [self beaconPoiWithLocationManager:OCMClassMock([CLLocationManager class])];
+    id rangerClassMock = OCMClassMock([ACPPlacesBeaconRanger class]);
+    OCMStub([rangerClassMock isRangingAvailable]).andReturn(NO);
+    OCMStub([_monitor startMonitoringGeoFences:[OCMArg any]]).andReturn(YES);
+
+    // test
+    [_monitor processNearbyPois:@[beaconPoi]];
+
+    // verify
+    XCTAssertNil(_monitor.beaconPois);
+    [rangerClassMock stopMocking];
+}
+
+- (void) testPostRegionUpdateBeaconPoiGeofenceStartsRanging {
+    // setup
+    id rangingManagerMock = OCMClassMock([CLLocationManager class]);
+    ACPPlacesPoi *beaconPoi = [self beaconPoiWithLocationManager:rangingManagerMock];
+    _monitor.beaconPois = @{beaconPoi.identifier: beaconPoi};
+    [_monitor.userWithinRegions addObject:beaconPoi.identifier];
+    OCMReject([_placesMock processRegionEvent:[OCMArg any] forRegionEventType:ACPRegionEventTypeEntry]);
+
+    // test
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+
+    // verify - the geofence is not reported, and location updates get coarser while the beacon is ranged
+    XCTAssertTrue(_monitor.beaconRanger.isRanging);
+    OCMVerify([rangingManagerMock startRangingBeaconsInRegion:[OCMArg any]]);
+    XCTAssertEqual(ACPPlacesMonitorBeaconDesiredAccuracy_Test, _monitor.locationManager.desiredAccuracy);
+}
+
+- (void) testPostRegionUpdateBeaconPoiGeofenceExitStopsRanging {
+    // setup
+    id rangingManagerMock = OCMClassMock([CLLocationManager class]);
+    ACPPlacesPoi *beaconPoi = [self beaconPoiWithLocationManager:rangingManagerMock];
+    _monitor.beaconPois = @{beaconPoi.identifier: beaconPoi};
+    [_monitor.userWithinRegions addObject:beaconPoi.identifier];
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+    [_monitor.userWithinRegions removeObject:beaconPoi.identifier];
+
+    // test
+    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeExit];
+
+    // verify
+    XCTAssertFalse(_monitor.beaconRanger.isActive);
+    OCMVerify([rangingManagerMock stopRangingBeaconsInRegion:[OCMArg any]]);
+    XCTAssertEqual(kCLLocationAccuracyBest, _monitor.locationManager.desiredAccuracy);
+}
+
+- (void) testCloseBeaconReportsPoiEntry {
+    // setup
+    ACPPlacesPoi *beaconPoi = [self beaconPoiWithLocationManager:OCMClassMock([CLLocationManager class])];
+    [_monitor.beaconRanger rangePois:@[beaconPoi]];
+    id beacon = OCMClassMock([CLBeacon class]);
+    OCMStub([beacon proximityUUID]).andReturn([[NSUUID alloc] initWithUUIDString:@"E2C56DB5-DFFB-48D2-B060-D0F5A71096E0"]);
+    OCMStub([beacon major]).andReturn(@(1));
+    OCMStub([beacon minor]).andReturn(@(1));
+    OCMStub([beacon accuracy]).andReturn(1.0);
+
+    // test
+    [_monitor.beaconRanger processBeacons:@[beacon]];
+
+    // verify
+    OCMVerify([_placesMock processRegionEvent:[OCMArg checkWithBlock:^BOOL(CLRegion *region) {
+        return [region isKindOfClass:[CLBeaconRegion class]] && [region.identifier isEqualToString:beaconPoi.identifier];
+    }] forRegionEventType:ACPRegionEventTypeEntry]);
+    XCTAssertEqual(1, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterBeaconEntries]);
+}
+
+- (void) testStopMonitoringContinuousLocationChangesRecordsOnTime {
+    // setup
+    _monitor.continuousLocationState = 1;
+    _monitor.continuousLocationStartedAt = [[NSProcessInfo processInfo] systemUptime] - 30;
+
+    // test
+    [_monitor stopMonitoringContinuousLocationChanges];
+
+    // verify
+    XCTAssertEqual(30, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterContinuousLocationSeconds]);
+}
+
+- (void) testStartMonitoringGeoFencesRegistersBoundaryRegion {
+    // setup
+    CLCircularRegion *boundary = [[CLCircularRegion alloc] initWithCenter:_fakeLocation.coordinate
+                                                                    radius:1000
+                                                                identifier:ACPPlacesMonitorBoundaryRegionIdentifier_Test];
+    _monitor.boundaryRegion = boundary;
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock isMonitoringAvailableForClass:[CLCircularRegion class]]).andReturn(YES);
+    OCMStub([locationManagerMock maximumRegionMonitoringDistance]).andReturn(1000);
+    _monitor.locationManager = locationManagerMock;
+    OCMStub([_monitor userHasDeclinedLocationPermission:kCLAuthorizationStatusRestricted]).andReturn(NO);
+    
+    // test
+    [_monitor startMonitoringGeoFences:@[]];
+    
+    // verify
+    OCMVerify([locationManagerMock startMonitoringForRegion:boundary]);
+    XCTAssertEqual(0, _monitor.currentlyMonitoredRegions.count);
+}
+
+- (void) testStopMonitoringGeoFencesStopsBoundaryRegion {
+    // setup
+    CLCircularRegion *boundary = [[CLCircularRegion alloc] initWithCenter:_fakeLocation.coordinate
+                                                                    radius:1000
+                                                                identifier:ACPPlacesMonitorBoundaryRegionIdentifier_Test];
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock monitoredRegions]).andReturn([NSSet setWithObject:boundary]);
+    _monitor.locationManager = locationManagerMock;
+    
+    // test
+    [_monitor stopMonitoringGeoFences];
+    
+    // verify
+    OCMVerify([locationManagerMock stopMonitoringForRegion:boundary]);
+}
+
+- (void) testPostLocationUpdateSingleFlight {
+    // setup - the first request never completes
+    OCMExpect([_placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                               limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                            callback:[OCMArg any]
+                                       errorCallback:[OCMArg any]]);
+    CLLocation *secondLocation = [[CLLocation alloc] initWithLatitude:45.0 longitude:45.0];
+    
+    // test
+    [_monitor postLocationUpdate:_fakeLocation];
+    [_monitor postLocationUpdate:secondLocation];
+    
+    // verify
+    OCMVerifyAll(_placesMock);
+    XCTAssertEqual(1, _monitor.poiRequests.issuedRequestCount);
+    XCTAssertTrue(_monitor.poiRequests.isRequestInFlight);
+}
+
+- (void) testPostLocationUpdateCacheHitCancelsRequestInFlight {
+    // setup
+    __block void (^pendingCallback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+    OCMStub([_placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                          callback:[OCMArg any]
+                                     errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
+        void (^callback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+        [invocation getArgument:&callback atIndex:4];
+        pendingCallback = callback;
+    }));
+    CLLocation *cachedLocation = [[CLLocation alloc] initWithLatitude:45.0 longitude:45.0];
+    [_monitor.poiCache cachePois:@[] forLocation:cachedLocation];
+    [_monitor postLocationUpdate:_fakeLocation];
+    
+    // test
+    [_monitor postLocationUpdate:cachedLocation];
+    OCMReject([_monitor processNearbyPois:@[_fakePoi]]);
+    pendingCallback(@[_fakePoi]);
+    
+    // verify
+    XCTAssertEqual(1, _monitor.poiRequests.staleResponseCount);
+}
+
+- (void) testPostLocationUpdateRetriesTransientError {
+    // setup - a stand-in for the Places service that is down for the first request
+    __block int requestCount = 0;
+    OCMStub([_placesMock getNearbyPointsOfInterest:_fakeLocation
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                          callback:[OCMArg any]
+                                     errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
+        void (^callback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+        void (^errorCallback)(ACPPlacesRequestError result);
+        [invocation getArgument:&callback atIndex:4];
+        [invocation getArgument:&errorCallback atIndex:5];
+        
+        if (requestCount++ == 0) {
+            errorCallback(ACPPlacesRequestErrorQueryServiceUnavailable);
+        } else {
+            callback(@[self.fakePoi]);
+        }
+    }));
+    __block dispatch_block_t retryBlock = nil;
+    _monitor.retryScheduler.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {
+        retryBlock = block;
+    };
+    _monitor.retryScheduler.networkReachable = ^BOOL {
+        return YES;
+    };
+    
+    // test
+    [_monitor postLocationUpdate:_fakeLocation];
+    XCTAssertNotNil(retryBlock);
+    XCTAssertEqual(_fakeLocation, _monitor.retryScheduler.pendingLocation);
+    retryBlock();
+    
+    // verify
+    XCTAssertEqual(2, requestCount);
+    OCMVerify([_monitor processNearbyPois:@[_fakePoi]]);
+    XCTAssertEqual(ACPPlacesCircuitStateClosed, _monitor.retryScheduler.circuitState);
+}
+
+- (void) testPostLocationUpdateConfigurationErrorIsNotRetried {
+    // setup
+    OCMStub([_placesMock getNearbyPointsOfInterest:_fakeLocation
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                          callback:[OCMArg any]
+                                     errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
+        void (^errorCallback)(ACPPlacesRequestError result);
+        [invocation getArgument:&errorCallback atIndex:5];
+        errorCallback(ACPPlacesRequestErrorConfigurationError);
+    }));
+    
+    // test
+    [_monitor postLocationUpdate:_fakeLocation];
+    
+    // verify
+    XCTAssertNil(_monitor.retryScheduler.pendingLocation);
+}
+
+- (void) testPostLocationUpdateDeferredWhileRetryIsScheduled {
+    // setup
+    _monitor.retryScheduler.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {};
+    [_monitor.retryScheduler recordFailureForLocation:_fakeLocation];
+    CLLocation *newerLocation = [[CLLocation alloc] initWithLatitude:45.0 longitude:45.0];
+    OCMReject([_placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                               limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                            callback:[OCMArg any]
+                                       errorCallback:[OCMArg any]]);
+    
     // test
-    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorQueryServiceUnavailable];
+    [_monitor postLocationUpdate:newerLocation];
     
     // verify
-    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: The Places Query Service is unavailable. Try again later.";
-    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
-                             tag:ACPPlacesMonitorExtensionName_Test
-                         message:errorString]);
+    XCTAssertEqual(newerLocation, _monitor.retryScheduler.pendingLocation);
 }
 
-- (void) testHandlePlacesRequestErrorServerResponseError {
+- (void) testStopAllMonitoringCancelsRequestInFlight {
+    // setup
+    OCMStub([_placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                          callback:[OCMArg any]
+                                     errorCallback:[OCMArg any]]);
+    [_monitor postLocationUpdate:_fakeLocation];
+    
     // test
-    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorServerResponseError];
+    [_monitor stopAllMonitoring:NO];
     
     // verify
-    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: There is an error in the response from the server.";
-    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
-                             tag:ACPPlacesMonitorExtensionName_Test
-                         message:errorString]);
+    XCTAssertFalse(_monitor.poiRequests.isRequestInFlight);
 }
 
-- (void) testHandlePlacesRequestErrorUnknownError {
+- (void) testDetectRegionChangesEntry {
+    // setup
+    [_monitor.containmentEngine loadPois:@[_fakePoi]];
+    OCMStub([_monitor postRegionUpdate:[OCMArg any] withEventType:ACPRegionEventTypeEntry]);
+    CLLocation *location = [[CLLocation alloc] initWithCoordinate:_fakeLocation.coordinate
+                                                         altitude:0
+                                               horizontalAccuracy:5
+                                                 verticalAccuracy:-1
+                                                        timestamp:[NSDate date]];
+    
     // test
-    [_monitor handlePlacesRequestError:ACPPlacesRequestErrorUnknownError];
+    [_monitor detectRegionChangesForLocation:location];
     
     // verify
-    NSString *errorString = @"An error occurred while attempting to retrieve nearby points of interest: Unknown error.";
-    OCMVerify([self.coreMock log:ACPMobileLogLevelWarning
-                             tag:ACPPlacesMonitorExtensionName_Test
-                         message:errorString]);
+    XCTAssertTrue([_monitor.userWithinRegions containsObject:_fakePoi.identifier]);
+    OCMVerify([_monitor postRegionUpdate:[OCMArg checkWithBlock:^BOOL(CLRegion *region) {
+        return [region.identifier isEqualToString:self.fakePoi.identifier];
+    }] withEventType:ACPRegionEventTypeEntry]);
 }
 
-- (void) testUpdateLocationNow {
+- (void) testDetectRegionChangesExit {
     // setup
-    id locationManagerMock = OCMClassMock([CLLocationManager class]);
-    _monitor.locationManager = locationManagerMock;
+    [_monitor.containmentEngine loadPois:@[_fakePoi]];
+    [_monitor.userWithinRegions addObject:_fakePoi.identifier];
+    OCMStub([_monitor postRegionUpdate:[OCMArg any] withEventType:ACPRegionEventTypeExit]);
+    CLLocation *location = [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(12.34 + 0.01, 23.45)
+                                                         altitude:0
+                                               horizontalAccuracy:5
+                                                 verticalAccuracy:-1
+                                                        timestamp:[NSDate date]];
     
     // test
-    [_monitor updateLocationNow];
+    [_monitor detectRegionChangesForLocation:location];
     
     // verify
-    OCMVerify([locationManagerMock requestLocation]);
+    XCTAssertFalse([_monitor.userWithinRegions containsObject:_fakePoi.identifier]);
+    OCMVerify([_monitor postRegionUpdate:[OCMArg any] withEventType:ACPRegionEventTypeExit]);
 }
 
-- (void) testProcessRegionUpdateWithEventType {
+- (void) testPostLocationUpdateSkipsContainmentWhenNotContinuous {
+    // setup
+    [_monitor.poiCache cachePois:@[_fakePoi] forLocation:_fakeLocation];
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+    OCMReject([_monitor detectRegionChangesForLocation:[OCMArg any]]);
+    
     // test
-    [_monitor postRegionUpdate:_fakeRegion withEventType:ACPRegionEventTypeEntry];
+    [_monitor postLocationUpdate:_fakeLocation];
+}
+
+- (void) testPostLocationUpdateRunsContainmentWhenContinuous {
+    // setup
+    _monitor.continuousLocationState = 1;
+    [_monitor.poiCache cachePois:@[_fakePoi] forLocation:_fakeLocation];
+    OCMStub([_monitor processNearbyPois:[OCMArg any]]);
+    
+    // test
+    [_monitor postLocationUpdate:_fakeLocation];
     
     // verify
-    OCMVerify([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
+    OCMVerify([_monitor detectRegionChangesForLocation:_fakeLocation]);
 }
 
 - (void) testLoadPersistedValues {
@@ -762,13 +1955,13 @@
     _monitor.monitorMode = ACPPlacesMonitorModeContinuous;
     [_monitor.currentlyMonitoredRegions removeAllObjects];
     [_monitor.userWithinRegions removeAllObjects];
-    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
-    [defaults setObject:@(ACPPlacesMonitorRequestAuthorizationLevelWhenInUse) forKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test];
-    [defaults setObject:@(ACPPlacesMonitorModeContinuous) forKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
-    [defaults setObject:@[_fakeRegion.identifier] forKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
-    [defaults setObject:@[_fakeRegion.identifier] forKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
-    [defaults setBool:true forKey:ACPPlacesMonitorDefaultsIsMonitoringStarted_Test];
-    [defaults synchronize];
+    CLLocation *queryLocation = [[CLLocation alloc] initWithLatitude:12.34 longitude:23.45];
+    [self persistValues:@{ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test: @(ACPPlacesMonitorRequestAuthorizationLevelWhenInUse),
+                          ACPPlacesMonitorDefaultsMonitorMode_Test: @(ACPPlacesMonitorModeContinuous),
+                          ACPPlacesMonitorDefaultsMonitoredRegions_Test: @[_fakeRegion.identifier],
+                          ACPPlacesMonitorDefaultsUserWithinRegions_Test: @[_fakeRegion.identifier],
+                          ACPPlacesMonitorDefaultsIsMonitoringStarted_Test: @(true),
+                          ACPPlacesMonitorStateLastQueryLocation_Test: queryLocation}];
     
     // test
     [_monitor loadPersistedValues];
@@ -781,6 +1974,33 @@
     XCTAssertTrue([_fakeRegion.identifier isEqualToString:_monitor.currentlyMonitoredRegions[0]]);
     XCTAssertEqual(1, _monitor.userWithinRegions.count);
     XCTAssertTrue([_fakeRegion.identifier isEqualToString:_monitor.userWithinRegions[0]]);
+    XCTAssertEqual(queryLocation.coordinate.latitude, _monitor.lastQueryLocation.coordinate.latitude);
+    XCTAssertEqual(queryLocation.coordinate.longitude, _monitor.lastQueryLocation.coordinate.longitude);
+}
+
+- (void) testLoadPersistedValuesDropsUserWithinRegionsThatAreNotMonitored {
+    // setup
+    [self persistValues:@{ACPPlacesMonitorDefaultsMonitoredRegions_Test: @[_fakeRegion.identifier],
+                          ACPPlacesMonitorDefaultsUserWithinRegions_Test: @[_fakeRegion.identifier, @"stale region"]}];
+    
+    // test
+    [_monitor loadPersistedValues];
+    
+    // verify
+    XCTAssertEqual(1, _monitor.userWithinRegions.count);
+    XCTAssertTrue([_fakeRegion.identifier isEqualToString:_monitor.userWithinRegions[0]]);
+}
+
+- (void) testLoadPersistedValuesPrefersPendingWrites {
+    // setup
+    [self persistValues:@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(ACPPlacesMonitorModeSignificantChanges)}];
+    [_monitor.persistence setObject:@(ACPPlacesMonitorModeContinuous) forKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
+    
+    // test
+    [_monitor loadPersistedValues];
+    
+    // verify
+    XCTAssertEqual(ACPPlacesMonitorModeContinuous, _monitor.monitorMode);
 }
 
 
@@ -799,6 +2019,7 @@
     XCTAssertEqual(false, _monitor.isMonitoringStarted);
     XCTAssertEqual(0, _monitor.currentlyMonitoredRegions.count);
     XCTAssertEqual(0, _monitor.userWithinRegions.count);
+    XCTAssertNil(_monitor.lastQueryLocation);
 }
 
 - (void) testResetMonitoredGeofencesNoMonitoredRegions {
@@ -851,52 +2072,166 @@
 
 - (void) testUpdateMonitorMode {
     // setup
-    [[NSUserDefaults standardUserDefaults] setInteger:ACPPlacesMonitorModeSignificantChanges
-                                               forKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [self persistValues:@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(ACPPlacesMonitorModeSignificantChanges)}];
     
     // test
     [_monitor updateMonitorMode:ACPPlacesMonitorModeContinuous];
+    [_monitor.persistence flush];
     
     // verify
     OCMVerify([_monitor beginTrackingLocation]);
-    XCTAssertEqual(ACPPlacesMonitorModeContinuous, [[NSUserDefaults standardUserDefaults]
-                                                    integerForKey:ACPPlacesMonitorDefaultsMonitorMode_Test]);
+    XCTAssertEqual(ACPPlacesMonitorModeContinuous, [[self persistedValueForKey:ACPPlacesMonitorDefaultsMonitorMode_Test] integerValue]);
 }
 
 
 - (void) testUpdateRequestAuthorizationLevel {
     // setup
-    [[NSUserDefaults standardUserDefaults] setInteger:ACPPlacesRequestMonitorAuthorizationLevelAlways
-                                               forKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [self persistValues:@{ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test: @(ACPPlacesRequestMonitorAuthorizationLevelAlways)}];
     
     //test
     [_monitor updateRequestAuthorizationLevel:ACPPlacesMonitorRequestAuthorizationLevelWhenInUse];
+    [_monitor.persistence flush];
     
     //verify
     OCMReject([_monitor startMonitoring]);
-    XCTAssertEqual(ACPPlacesMonitorRequestAuthorizationLevelWhenInUse, [[NSUserDefaults standardUserDefaults]
-                                                    integerForKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test]);
+    XCTAssertEqual(ACPPlacesMonitorRequestAuthorizationLevelWhenInUse,
+                   [[self persistedValueForKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test] integerValue]);
 }
 
 
 - (void) testUpdateRequestAuthorizationLevelWhenMontoringHasStarted {
     // setup
     _monitor.isMonitoringStarted = true;
-    [[NSUserDefaults standardUserDefaults] setInteger:ACPPlacesMonitorRequestAuthorizationLevelWhenInUse
-                                               forKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [self persistValues:@{ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test: @(ACPPlacesMonitorRequestAuthorizationLevelWhenInUse)}];
     
     //test
     [_monitor updateRequestAuthorizationLevel:ACPPlacesRequestMonitorAuthorizationLevelAlways];
+    [_monitor.persistence flush];
     
     //verify
     OCMVerify([_monitor startMonitoring]);
-    XCTAssertEqual(ACPPlacesRequestMonitorAuthorizationLevelAlways, [[NSUserDefaults standardUserDefaults]
-                                                    integerForKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test]);
+    XCTAssertEqual(ACPPlacesRequestMonitorAuthorizationLevelAlways,
+                   [[self persistedValueForKey:ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test] integerValue]);
+}
+
+
+- (void) testBeginTrackingLocationAdaptiveFar {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    _monitor.locationManager = locationManagerMock;
+    _monitor.monitorMode = ACPPlacesMonitorModeAdaptive;
+    
+    // test
+    [_monitor beginTrackingLocation];
+    
+    // verify
+    OCMVerify([_monitor stopMonitoringContinuousLocationChanges]);
+    OCMVerify([_monitor startMonitoringSignificantLocationChanges]);
+    OCMVerify([locationManagerMock setDesiredAccuracy:kCLLocationAccuracyHundredMeters]);
+    OCMVerify([_monitor persistMonitoringStatus]);
+    OCMVerify([_monitor updateLocationNow]);
+}
+
+- (void) testUpdateAdaptiveTrackingApproachingFence {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock monitoredRegions]).andReturn([NSSet setWithObject:_fakeRegion]);
+    _monitor.locationManager = locationManagerMock;
+    _monitor.monitorMode = ACPPlacesMonitorModeAdaptive;
+    [_monitor.currentlyMonitoredRegions addObject:_fakeRegion.identifier];
+    CLLocation *nearLocation = [[CLLocation alloc] initWithLatitude:12.34 + 0.006 longitude:23.45];
+    
+    // test
+    [_monitor updateAdaptiveTrackingForLocation:nearLocation];
+    
+    // verify
+    XCTAssertEqual(ACPPlacesAdaptiveStateApproaching, _monitor.adaptiveState);
+    OCMVerify([_monitor startMonitoringContinuousLocationChanges]);
+    OCMVerify([locationManagerMock setDistanceFilter:ACPPlacesMonitorAdaptiveNearDistanceFilter_Test]);
+    OCMVerify([_coreMock log:ACPMobileLogLevelDebug
+                         tag:ACPPlacesMonitorExtensionName_Test
+                     message:[OCMArg checkWithBlock:^BOOL(NSString *message) {
+        return [message hasPrefix:@"Adaptive monitoring switched from far to approaching"];
+    }]]);
+}
+
+- (void) testUpdateAdaptiveTrackingNoFences {
+    // setup
+    _monitor.monitorMode = ACPPlacesMonitorModeAdaptive;
+    OCMReject([_monitor startMonitoringContinuousLocationChanges]);
+    
+    // test
+    [_monitor updateAdaptiveTrackingForLocation:_fakeLocation];
+    
+    // verify
+    XCTAssertEqual(ACPPlacesAdaptiveStateFar, _monitor.adaptiveState);
+}
+
+- (void) testAdaptiveTimeLimitBacksOff {
+    // setup
+    _monitor.monitorMode = ACPPlacesMonitorModeAdaptive;
+    _monitor.adaptiveState = ACPPlacesAdaptiveStateApproaching;
+    _monitor.adaptiveTimerGeneration = 3;
+    
+    // test
+    [_monitor adaptiveTimeLimitReachedForGeneration:3];
+    
+    // verify
+    XCTAssertEqual(ACPPlacesAdaptiveStateBackedOff, _monitor.adaptiveState);
+    OCMVerify([_monitor stopMonitoringContinuousLocationChanges]);
+}
+
+- (void) testAdaptiveTimeLimitIgnoredWhenSuperseded {
+    // setup
+    _monitor.monitorMode = ACPPlacesMonitorModeAdaptive;
+    _monitor.adaptiveState = ACPPlacesAdaptiveStateApproaching;
+    _monitor.adaptiveTimerGeneration = 4;
+    
+    // test
+    [_monitor adaptiveTimeLimitReachedForGeneration:3];
+    
+    // verify
+    XCTAssertEqual(ACPPlacesAdaptiveStateApproaching, _monitor.adaptiveState);
+}
+
+- (void) testDistanceToNearestFence {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock monitoredRegions]).andReturn([NSSet setWithObject:_fakeRegion]);
+    _monitor.locationManager = locationManagerMock;
+    [_monitor.currentlyMonitoredRegions addObject:_fakeRegion.identifier];
+    
+    // test
+    CLLocationDistance distance = [_monitor distanceToNearestFenceFromLocation:_fakeLocation];
+    
+    // verify - the location is at the center of the 500 meter fence
+    XCTAssertEqualWithAccuracy(500, distance, 1);
+}
+
+- (void) testDistanceToNearestFenceIgnoresRegionsNotOwned {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock monitoredRegions]).andReturn([NSSet setWithObject:_fakeRegion]);
+    _monitor.locationManager = locationManagerMock;
+    
+    // verify
+    XCTAssertEqual(CLLocationDistanceMax, [_monitor distanceToNearestFenceFromLocation:_fakeLocation]);
 }
 
+- (void) testUpdateMonitorModeLeavingAdaptiveRestoresAccuracy {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    _monitor.locationManager = locationManagerMock;
+    _monitor.adaptiveState = ACPPlacesAdaptiveStateApproaching;
+    
+    // test
+    [_monitor updateMonitorMode:ACPPlacesMonitorModeSignificantChanges];
+    
+    // verify
+    XCTAssertEqual(ACPPlacesAdaptiveStateFar, _monitor.adaptiveState);
+    OCMVerify([locationManagerMock setDesiredAccuracy:kCLLocationAccuracyBest]);
+    OCMVerify([locationManagerMock setDistanceFilter:ACPPlacesMonitorDefaultDistanceFilter_Test]);
+}
 
 - (void) testBeginTrackingLocationContinuous {
     // setup
@@ -1045,7 +2380,7 @@
                                     identifier:_fakePoi.identifier]).andReturn(_fakeRegion);
     [_monitor.userWithinRegions addObject:_fakeRegion.identifier];
     OCMReject([locationManagerMock startMonitoringForRegion:_fakeRegion]);
-    OCMReject([_monitor addDeviceToRegion:_fakeRegion]);
+    OCMReject([_monitor addDeviceToRegionIfAbsent:_fakeRegion]);
     OCMReject([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
     OCMReject([_monitor updateCurrentlyMonitoredRegionsInPersistence]);
     
@@ -1070,7 +2405,7 @@
                                     identifier:_fakePoi.identifier]).andReturn(_fakeRegion);
     [_monitor.userWithinRegions addObject:_fakeRegion.identifier];
     OCMReject([locationManagerMock startMonitoringForRegion:_fakeRegion]);
-    OCMReject([_monitor addDeviceToRegion:_fakeRegion]);
+    OCMReject([_monitor addDeviceToRegionIfAbsent:_fakeRegion]);
     OCMReject([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
     OCMReject([_monitor updateCurrentlyMonitoredRegionsInPersistence]);
     
@@ -1098,7 +2433,7 @@
                                     identifier:_fakePoi.identifier]).andReturn(_fakeRegion);
     [_monitor.userWithinRegions addObject:_fakeRegion.identifier];
     OCMReject([locationManagerMock startMonitoringForRegion:_fakeRegion]);
-    OCMReject([_monitor addDeviceToRegion:_fakeRegion]);
+    OCMReject([_monitor addDeviceToRegionIfAbsent:_fakeRegion]);
     OCMReject([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
     
     // test
@@ -1129,7 +2464,7 @@
     OCMVerify([locationManagerMock startMonitoringForRegion:_fakeRegion]);
     XCTAssertEqual(1, _monitor.currentlyMonitoredRegions.count);
     XCTAssertTrue([_fakeRegion.identifier isEqualToString:_monitor.currentlyMonitoredRegions[0]]);
-    OCMVerify([_monitor addDeviceToRegion:_fakeRegion]);
+    OCMVerify([_monitor addDeviceToRegionIfAbsent:_fakeRegion]);
     OCMVerify([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
     OCMVerify([_monitor updateCurrentlyMonitoredRegionsInPersistence]);
 }
@@ -1147,7 +2482,7 @@
                                         radius:_fakePoi.radius
                                     identifier:_fakePoi.identifier]).andReturn(_fakeRegion);
     [_monitor.userWithinRegions addObject:_fakeRegion.identifier];
-    OCMReject([_monitor addDeviceToRegion:_fakeRegion]);
+    OCMReject([_monitor addDeviceToRegionIfAbsent:_fakeRegion]);
     OCMReject([_placesMock processRegionEvent:_fakeRegion forRegionEventType:ACPRegionEventTypeEntry]);
     
     // test
@@ -1160,6 +2495,48 @@
     OCMVerify([_monitor updateCurrentlyMonitoredRegionsInPersistence]);
 }
 
+- (void) testStartMonitoringGeoFencesKeepsUnchangedRegion {
+    // setup
+    _fakePoi.userIsWithin = NO;
+    NSArray *newGeoFences = @[_fakePoi];
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock isMonitoringAvailableForClass:[CLCircularRegion class]]).andReturn(YES);
+    OCMStub([locationManagerMock maximumRegionMonitoringDistance]).andReturn(1000);
+    OCMStub([locationManagerMock monitoredRegions]).andReturn([NSSet setWithObject:_fakeRegion]);
+    _monitor.locationManager = locationManagerMock;
+    OCMStub([_monitor userHasDeclinedLocationPermission:kCLAuthorizationStatusRestricted]).andReturn(NO);
+    [_monitor.currentlyMonitoredRegions addObject:_fakeRegion.identifier];
+    OCMReject([locationManagerMock startMonitoringForRegion:[OCMArg any]]);
+    OCMReject([locationManagerMock stopMonitoringForRegion:[OCMArg any]]);
+    
+    // test
+    BOOL result = [_monitor startMonitoringGeoFences:newGeoFences];
+    
+    // verify
+    XCTAssertTrue(result);
+    XCTAssertEqual(1, _monitor.lastGeofenceDiff.keptCount);
+    XCTAssertEqual(1, _monitor.currentlyMonitoredRegions.count);
+}
+
+- (void) testStartMonitoringGeoFencesStopsRemovedRegion {
+    // setup
+    NSArray *newGeoFences = @[];
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock isMonitoringAvailableForClass:[CLCircularRegion class]]).andReturn(YES);
+    OCMStub([locationManagerMock monitoredRegions]).andReturn([NSSet setWithObject:_fakeRegion]);
+    _monitor.locationManager = locationManagerMock;
+    OCMStub([_monitor userHasDeclinedLocationPermission:kCLAuthorizationStatusRestricted]).andReturn(NO);
+    [_monitor.currentlyMonitoredRegions addObject:_fakeRegion.identifier];
+    
+    // test
+    [_monitor startMonitoringGeoFences:newGeoFences];
+    
+    // verify
+    OCMVerify([locationManagerMock stopMonitoringForRegion:_fakeRegion]);
+    XCTAssertEqual(1, _monitor.lastGeofenceDiff.removedCount);
+    XCTAssertEqual(0, _monitor.currentlyMonitoredRegions.count);
+}
+
 - (void) testStopMonitoringGeoFences {
     // setup
     [_monitor.currentlyMonitoredRegions addObject:_fakeRegion.identifier];
@@ -1313,6 +2690,63 @@
                      message:@"Continuous location collection is disabled"]);
 }
 
+- (void) testStartMonitoringSignificantLocationChangesAlreadyStarted {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock significantLocationChangeMonitoringAvailable]).andReturn(YES);
+    _monitor.locationManager = locationManagerMock;
+    [_monitor startMonitoringSignificantLocationChanges];
+    OCMReject([locationManagerMock startMonitoringSignificantLocationChanges]);
+    
+    // test
+    [_monitor startMonitoringSignificantLocationChanges];
+    
+    // verify
+    XCTAssertTrue(_monitor.isMonitoringStarted);
+}
+
+- (void) testStopMonitoringSignificantLocationChangesAlreadyStopped {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock significantLocationChangeMonitoringAvailable]).andReturn(YES);
+    _monitor.locationManager = locationManagerMock;
+    [_monitor stopMonitoringSignificantLocationChanges];
+    OCMReject([locationManagerMock stopMonitoringSignificantLocationChanges]);
+    
+    // test
+    [_monitor stopMonitoringSignificantLocationChanges];
+}
+
+- (void) testStopMonitoringContinuousLocationChangesAlreadyStopped {
+    // setup
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    _monitor.locationManager = locationManagerMock;
+    [_monitor stopMonitoringContinuousLocationChanges];
+    OCMReject([locationManagerMock stopUpdatingLocation]);
+    
+    // test
+    [_monitor stopMonitoringContinuousLocationChanges];
+    
+    // verify
+    XCTAssertFalse(_monitor.isMonitoringStarted);
+}
+
+- (void) testStartMonitoringContinuousLocationChangesAfterStop {
+    // setup
+    OCMStub([_monitor userHasDeclinedLocationPermission:kCLAuthorizationStatusRestricted]).andReturn(NO);
+    id locationManagerMock = OCMClassMock([CLLocationManager class]);
+    OCMStub([locationManagerMock respondsToSelector:@selector(startUpdatingLocation)]).andReturn(YES);
+    _monitor.locationManager = locationManagerMock;
+    [_monitor stopMonitoringContinuousLocationChanges];
+    
+    // test
+    [_monitor startMonitoringContinuousLocationChanges];
+    
+    // verify
+    XCTAssertTrue(_monitor.isMonitoringStarted);
+    OCMVerify([locationManagerMock startUpdatingLocation]);
+}
+
 - (void) testUserHasDeclinedLocationPermissionDenied {
     // setup
     CLAuthorizationStatus status = kCLAuthorizationStatusDenied;
@@ -1382,11 +2816,14 @@
     // setup
     [_monitor.userWithinRegions addObject:_fakeRegion.identifier];
     [_monitor.currentlyMonitoredRegions addObject:@"5678"];
+    _monitor.lastQueryLocation = _fakeLocation;
     
     // test
     [_monitor clearMonitorData];
     
     // verify
+    XCTAssertNil(_monitor.lastQueryLocation);
+    XCTAssertNil([_monitor.persistence objectForKey:ACPPlacesMonitorStateLastQueryLocation_Test]);
     XCTAssertEqual(0, _monitor.currentlyMonitoredRegions.count);
     OCMVerify([_monitor updateCurrentlyMonitoredRegionsInPersistence]);
     XCTAssertEqual(0, _monitor.userWithinRegions.count);
@@ -1398,14 +2835,130 @@
     // test by setting "isMonitoringStarted" to false
     _monitor.isMonitoringStarted = false;
     [_monitor persistMonitoringStatus];
-    XCTAssertFalse([[NSUserDefaults standardUserDefaults]
-                                            boolForKey:ACPPlacesMonitorDefaultsIsMonitoringStarted_Test]);
+    [_monitor.persistence flush];
+    XCTAssertFalse([[self persistedValueForKey:ACPPlacesMonitorDefaultsIsMonitoringStarted_Test] boolValue]);
     
     // test by switchting "isMonitoringStarted" to true
     _monitor.isMonitoringStarted = true;
     [_monitor persistMonitoringStatus];
-    XCTAssertTrue([[NSUserDefaults standardUserDefaults]
-                                            boolForKey:ACPPlacesMonitorDefaultsIsMonitoringStarted_Test]);
+    [_monitor.persistence flush];
+    XCTAssertTrue([[self persistedValueForKey:ACPPlacesMonitorDefaultsIsMonitoringStarted_Test] boolValue]);
+}
+
+#pragma mark - executor
+- (void) testPostLocationUpdateReturnsBeforeTheWorkIsDone {
+    // setup - the executor is kept busy until the test lets it go
+    _monitor.executor = [[ACPPlacesSerialExecutor alloc] init];
+    dispatch_semaphore_t busy = dispatch_semaphore_create(0);
+    [_monitor.executor execute:^{
+        dispatch_semaphore_wait(busy, DISPATCH_TIME_FOREVER);
+    }];
+    
+    // test
+    [_monitor postLocationUpdate:_fakeLocation];
+    
+    // verify
+    XCTAssertEqual(0, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterLocationUpdates]);
+    dispatch_semaphore_signal(busy);
+    [_monitor.executor executeAndWait:^{}];
+    XCTAssertEqual(1, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterLocationUpdates]);
+}
+
+- (void) testDeviceIsWithinRegionDoesNotWaitForTheExecutor {
+    // setup - the executor is kept busy until the test lets it go
+    _monitor.executor = [[ACPPlacesSerialExecutor alloc] init];
+    dispatch_semaphore_t busy = dispatch_semaphore_create(0);
+    [_monitor.executor execute:^{
+        dispatch_semaphore_wait(busy, DISPATCH_TIME_FOREVER);
+    }];
+    
+    // test
+    [_monitor addDeviceToRegion:_fakeRegion];
+    BOOL withinAfterEntry = [_monitor deviceIsWithinRegion:_fakeRegion];
+    [_monitor removeDeviceFromRegion:_fakeRegion];
+    BOOL withinAfterExit = [_monitor deviceIsWithinRegion:_fakeRegion];
+    
+    // verify - the answer reflects the callbacks before it, while their persistence writes are still queued
+    XCTAssertTrue(withinAfterEntry);
+    XCTAssertFalse(withinAfterExit);
+    dispatch_semaphore_signal(busy);
+    [_monitor.executor executeAndWait:^{}];
+    XCTAssertEqual(0, _monitor.userWithinRegions.count);
+}
+
+- (void) testPlacesResponseIsHandledOnExecutor {
+    // setup
+    _monitor.executor = [[ACPPlacesSerialExecutor alloc] init];
+    __block void (^pendingCallback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+    OCMStub([_placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                             limit:ACPPlacesMonitorCandidatePoiCount_Test
+                                          callback:[OCMArg any]
+                                     errorCallback:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
+        void (^callback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+        [invocation getArgument:&callback atIndex:4];
+        pendingCallback = callback;
+    }));
+    [_monitor postLocationUpdate:_fakeLocation];
+    [_monitor.executor executeAndWait:^{}];
+    __block BOOL handledOnExecutor = NO;
+    OCMStub([_monitor scheduleNearbyPois:[OCMArg any] forLocation:[OCMArg any]]).andDo((^(NSInvocation *invocation) {
+        handledOnExecutor = self.monitor.executor.isCurrent;
+    }));
+    
+    // test - the Places extension calls back on a thread of its own
+    dispatch_sync(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        pendingCallback(@[self.fakePoi]);
+    });
+    [_monitor.executor executeAndWait:^{}];
+    
+    // verify
+    XCTAssertTrue(handledOnExecutor);
+}
+
+- (void) testConcurrentEventsAndDelegateCallbacks {
+    // setup - the hub, CoreLocation and the app all call into the monitor at once
+    _monitor.executor = [[ACPPlacesSerialExecutor alloc] init];
+    CLLocationManager *manager = _monitor.locationManager;
+    ACPExtensionEvent *event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameUpdateLocationNow_Test
+                                                                    type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                                  source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                                    data:nil
+                                                                   error:nil];
+    size_t iterations = 3000;
+    
+    // test
+    dispatch_apply(iterations, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        switch (iteration % 6) {
+            case 0:
+                [self.monitor queueEvent:event];
+                [self.monitor processEvents];
+                break;
+            case 1:
+                [self.monitor.locationDelegate locationManager:manager didUpdateLocations:@[self.fakeLocation]];
+                break;
+            case 2:
+                [self.monitor.locationDelegate locationManager:manager didEnterRegion:self.fakeRegion];
+                break;
+            case 3:
+                [self.monitor.locationDelegate locationManager:manager didExitRegion:self.fakeRegion];
+                break;
+            case 4:
+                [self.monitor postLocationUpdate:self.fakeLocation];
+                break;
+            default:
+                [self.monitor configurationDidChange];
+                [self.monitor processEvents];
+                break;
+        }
+    });
+    [_monitor.executor executeAndWait:^{}];
+    
+    // verify - nothing was lost and the region bookkeeping never saw a duplicate entry
+    XCTAssertEqual(iterations / 3, [_monitor.metrics valueOfCounter:ACPPlacesMetricCounterLocationUpdates]);
+    XCTAssertFalse([_monitor.eventQueue hasNext]);
+    XCTAssertTrue(_monitor.userWithinRegions.count <= 1);
+    XCTAssertEqualObjects(_monitor.userWithinRegions.count ? _monitor.userWithinRegions : nil,
+                          [_monitor.persistence objectForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test]);
 }
 
 @end
@@ -49,6 +49,7 @@
     
     _listener = [[ACPPlacesMonitorListener alloc] initForTesting:_parentMock];
     _coreMock = OCMClassMock([ACPCore class]);
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelVerbose);
 }
 
 - (void) tearDown {
@@ -125,6 +126,7 @@
     // verify
     XCTAssertEqual(1, _counterProcessEventsCalled);
     XCTAssertEqual(0, _counterQueueEventCalled);
+    OCMVerify([_parentMock configurationDidChange]);
 }
 
 - (void) testPlacesResponseContentEventHappy {
@@ -47,6 +47,7 @@
     _locationDelegate = [[ACPPlacesMonitorLocationDelegate alloc] init];
     _placesMock = OCMClassMock([ACPPlacesMonitorInternal class]);
     _coreMock = OCMClassMock([ACPCore class]);
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelVerbose);
     _locationDelegate.parent = _placesMock;
     _manager = [[CLLocationManager alloc] init];
     _fakeLocation = [[CLLocation alloc] initWithLatitude:12.34 longitude:23.45];
@@ -0,0 +1,106 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesMonitorLogTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <ACPCore/ACPCore.h>
+#import "OCMock.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesMonitorLog.h"
+
+// counts how many times it was formatted into a message
+@interface ACPPlacesLogArgument : NSObject
+@property (nonatomic) NSUInteger descriptionCount;
+@end
+
+@implementation ACPPlacesLogArgument
+- (NSString*) description {
+    _descriptionCount++;
+    return @"argument";
+}
+@end
+
+@interface ACPPlacesMonitorLogTests : XCTestCase
+@property (nonatomic, strong) id coreMock;
+@property (nonatomic, strong) ACPPlacesLogArgument *argument;
+@end
+
+@implementation ACPPlacesMonitorLogTests
+
+- (void) setUp {
+    _coreMock = OCMClassMock([ACPCore class]);
+    _argument = [[ACPPlacesLogArgument alloc] init];
+}
+
+- (void) tearDown {
+    [_coreMock stopMocking];
+}
+
+- (void) testLevelEnabled {
+    // setup
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelWarning);
+
+    // verify
+    XCTAssertTrue(ACPPlacesMonitorLogLevelEnabled(ACPMobileLogLevelError));
+    XCTAssertTrue(ACPPlacesMonitorLogLevelEnabled(ACPMobileLogLevelWarning));
+    XCTAssertFalse(ACPPlacesMonitorLogLevelEnabled(ACPMobileLogLevelDebug));
+    XCTAssertFalse(ACPPlacesMonitorLogLevelEnabled(ACPMobileLogLevelVerbose));
+}
+
+- (void) testEnabledLevelIsFormattedAndLogged {
+    // setup
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelDebug);
+
+    // test
+    ACPPlacesMonitorLogDebug(@"value %@ (%lu)", _argument, (unsigned long)2);
+
+    // verify
+    OCMVerify([_coreMock log:ACPMobileLogLevelDebug tag:ACPPlacesMonitorExtensionName_Test message:@"value argument (2)"]);
+    XCTAssertEqual(1, _argument.descriptionCount);
+}
+
+- (void) testDisabledLevelIsNotFormatted {
+    // setup
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelError);
+    OCMReject([_coreMock log:ACPMobileLogLevelDebug tag:[OCMArg any] message:[OCMArg any]]);
+    OCMReject([_coreMock log:ACPMobileLogLevelVerbose tag:[OCMArg any] message:[OCMArg any]]);
+
+    // test
+    ACPPlacesMonitorLogDebug(@"value %@", _argument);
+    ACPPlacesMonitorLogVerbose(@"value %@", _argument);
+
+    // verify
+    XCTAssertEqual(0, _argument.descriptionCount);
+}
+
+- (void) testArgumentsAreNotEvaluatedWhenDisabled {
+    // setup
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelWarning);
+    __block NSUInteger evaluations = 0;
+    NSString* (^argument)(void) = ^NSString* {
+        evaluations++;
+        return @"argument";
+    };
+
+    // test
+    ACPPlacesMonitorLogDebug(@"value %@", argument());
+    ACPPlacesMonitorLogWarning(@"value %@", argument());
+
+    // verify
+    XCTAssertEqual(1, evaluations);
+    OCMVerify([_coreMock log:ACPMobileLogLevelWarning tag:ACPPlacesMonitorExtensionName_Test message:@"value argument"]);
+}
+
+@end
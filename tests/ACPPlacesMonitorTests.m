@@ -38,6 +38,7 @@
 - (void) setUp {
     _monitorMock = OCMClassMock([ACPPlacesMonitor class]);
     _coreMock = OCMClassMock([ACPCore class]);
+    OCMStub([_coreMock logLevel]).andReturn(ACPMobileLogLevelVerbose);
 }
 
 - (void) testExtensionVersion {
@@ -152,6 +153,80 @@
                                         withData:@{}]);
 }
 
+- (void) testSetMetricsReportingInterval {
+    // test
+    [ACPPlacesMonitor setMetricsReportingInterval:30];
+
+    // verify
+    OCMVerify([_monitorMock dispatchMonitorEvent:ACPPlacesMonitorEventNameSetMetricsReportingInterval_Test
+                                        withData:@{ACPPlacesMonitorEventDataMetricsReportingInterval_Test:@(30)}]);
+}
+
+- (void) testSetRegionEventDwellTime {
+    // test
+    [ACPPlacesMonitor setRegionEventDwellTime:5];
+
+    // verify
+    OCMVerify([_monitorMock dispatchMonitorEvent:ACPPlacesMonitorEventNameSetRegionEventDwellTime_Test
+                                        withData:@{ACPPlacesMonitorEventDataRegionEventDwellTime_Test:@(5)}]);
+}
+
+- (void) testSetRegionEventDwellTimeNegativeValue {
+    // test
+    [ACPPlacesMonitor setRegionEventDwellTime:-5];
+
+    // verify
+    OCMVerify([_monitorMock dispatchMonitorEvent:ACPPlacesMonitorEventNameSetRegionEventDwellTime_Test
+                                        withData:@{ACPPlacesMonitorEventDataRegionEventDwellTime_Test:@(0)}]);
+}
+
+- (void) testSetPoiPackPath {
+    // test
+    [ACPPlacesMonitor setPoiPackPath:@"/path/to/pois.pack"];
+
+    // verify
+    OCMVerify([_monitorMock dispatchMonitorEvent:ACPPlacesMonitorEventNameSetPoiPack_Test
+                                        withData:@{ACPPlacesMonitorEventDataPoiPackPath_Test:@"/path/to/pois.pack"}]);
+}
+
+- (void) testSetPoiPackPathNil {
+    // test
+    [ACPPlacesMonitor setPoiPackPath:nil];
+
+    // verify
+    OCMVerify([_monitorMock dispatchMonitorEvent:ACPPlacesMonitorEventNameSetPoiPack_Test withData:@{}]);
+}
+
+- (void) testGetMetrics {
+    // setup
+    NSDictionary *snapshot = @{@"counters":@{}};
+    OCMStub([_coreMock dispatchEventWithResponseCallback:[OCMArg any]
+                                        responseCallback:[OCMArg any]
+                                                   error:[OCMArg anyObjectRef]]).andDo(^(NSInvocation *invocation) {
+        ACPExtensionEvent *request;
+        void (^responseCallback)(ACPExtensionEvent *responseEvent);
+        [invocation getArgument:&request atIndex:2];
+        [invocation getArgument:&responseCallback atIndex:3];
+        XCTAssertEqualObjects(ACPPlacesMonitorEventNameGetMetrics_Test, request.eventName);
+        responseCallback([ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameMetrics_Test
+                                                              type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                            source:ACPPlacesMonitorEventSourceResponseContent_Test
+                                                              data:@{ACPPlacesMonitorEventDataMetrics_Test:snapshot}
+                                                             error:nil]);
+        BOOL result = YES;
+        [invocation setReturnValue:&result];
+    });
+    __block NSDictionary *received = nil;
+
+    // test
+    [ACPPlacesMonitor getMetrics:^(NSDictionary * _Nullable metrics) {
+        received = metrics;
+    }];
+
+    // verify
+    XCTAssertEqualObjects(snapshot, received);
+}
+
 - (void) testDispatchMonitorEventWithData {
     // setup
     NSString *eventName = @"my event name";
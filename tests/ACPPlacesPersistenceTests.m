@@ -0,0 +1,271 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPersistenceTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <UIKit/UIKit.h>
+#import "OCMock.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesPersistence.h"
+#import "ACPPlacesStateStore.h"
+
+static NSString* const ACPPlacesPersistenceTestsSuite = @"com.adobe.placesmonitor.persistencetests";
+
+@interface ACPPlacesPersistenceTests : XCTestCase
+@property (nonatomic, strong) NSUserDefaults *defaults;
+@property (nonatomic, strong) ACPPlacesPersistence *persistence;
+@property (nonatomic, strong) ACPPlacesStateStore *stateStore;
+@end
+
+@implementation ACPPlacesPersistenceTests
+
+- (void) setUp {
+    _defaults = [[NSUserDefaults alloc] initWithSuiteName:ACPPlacesPersistenceTestsSuite];
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults flushDelay:60];
+    NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    _stateStore = [[ACPPlacesStateStore alloc] initWithFileURL:fileURL];
+}
+
+- (void) tearDown {
+    [_defaults removePersistentDomainForName:ACPPlacesPersistenceTestsSuite];
+    [_stateStore remove];
+    [[NSFileManager defaultManager] removeItemAtURL:_stateStore.backupURL error:nil];
+}
+
+- (void) testWritesAreStagedUntilFlush {
+    // test
+    [_persistence setObject:@[@"a"] forKey:@"key"];
+
+    // verify
+    XCTAssertTrue([_persistence hasPendingWrites]);
+    XCTAssertNil([_defaults objectForKey:@"key"]);
+    XCTAssertEqualObjects(@[@"a"], [_persistence objectForKey:@"key"]);
+}
+
+- (void) testFlushWritesAllDirtyValues {
+    // setup
+    [_persistence setObject:@[@"a"] forKey:@"key1"];
+    [_persistence setObject:@(2) forKey:@"key2"];
+
+    // test
+    [_persistence flush];
+
+    // verify
+    XCTAssertFalse([_persistence hasPendingWrites]);
+    XCTAssertEqualObjects(@[@"a"], [_defaults objectForKey:@"key1"]);
+    XCTAssertEqualObjects(@(2), [_defaults objectForKey:@"key2"]);
+    XCTAssertEqual(1, _persistence.flushCount);
+}
+
+- (void) testFlushWithNothingDirtyDoesNotWrite {
+    // setup
+    id defaultsMock = OCMPartialMock(_defaults);
+    OCMReject([defaultsMock synchronize]);
+
+    // test
+    [_persistence flush];
+
+    // verify
+    XCTAssertEqual(0, _persistence.flushCount);
+}
+
+- (void) testSettingNilRemovesKey {
+    // setup
+    [_defaults setObject:@"old" forKey:@"key"];
+
+    // test
+    [_persistence setObject:nil forKey:@"key"];
+
+    // verify
+    XCTAssertNil([_persistence objectForKey:@"key"]);
+    [_persistence flush];
+    XCTAssertNil([_defaults objectForKey:@"key"]);
+}
+
+- (void) testReadFallsBackToUserDefaults {
+    // setup
+    [_defaults setObject:@"persisted" forKey:@"key"];
+
+    // verify
+    XCTAssertEqualObjects(@"persisted", [_persistence objectForKey:@"key"]);
+}
+
+- (void) testRepeatedWritesAreCoalesced {
+    // test
+    [_persistence setObject:@[@"a"] forKey:@"key"];
+    [_persistence setObject:@[@"a", @"b"] forKey:@"key"];
+    [_persistence setObject:@[@"a", @"b", @"c"] forKey:@"key"];
+    [_persistence flush];
+
+    // verify
+    XCTAssertEqual(3, _persistence.requestedWriteCount);
+    XCTAssertEqual(2, _persistence.coalescedWriteCount);
+    XCTAssertEqual(1, _persistence.flushCount);
+    XCTAssertEqual(3 * 36, _persistence.bytesSaved);
+    NSArray *expected = @[@"a", @"b", @"c"];
+    XCTAssertEqualObjects(expected, [_defaults objectForKey:@"key"]);
+}
+
+- (void) testBytesSavedOnlyCountsSupersededValues {
+    // test
+    [_persistence setObject:@"first" forKey:@"key"];
+    [_persistence setObject:@"second" forKey:@"key"];
+    [_persistence setObject:@"other" forKey:@"otherKey"];
+    [_persistence flush];
+
+    // verify
+    XCTAssertEqual(5, _persistence.bytesSaved);
+}
+
+- (void) testMutationsAfterWriteAreNotStaged {
+    // setup
+    NSMutableArray *regions = [@[@"a"] mutableCopy];
+
+    // test
+    [_persistence setObject:regions forKey:@"key"];
+    [regions addObject:@"b"];
+    [_persistence flush];
+
+    // verify
+    XCTAssertEqualObjects(@[@"a"], [_defaults objectForKey:@"key"]);
+}
+
+- (void) testFlushHappensAfterDelay {
+    // setup
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults flushDelay:0.1];
+
+    // test
+    [_persistence setObject:@"value" forKey:@"key"];
+
+    // verify
+    XCTestExpectation *expectation = [self expectationWithDescription:@"flushed"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertFalse([_persistence hasPendingWrites]);
+    XCTAssertEqualObjects(@"value", [_defaults objectForKey:@"key"]);
+}
+
+- (void) testFlushOnEnterBackground {
+    // setup
+    [_persistence setObject:@"value" forKey:@"key"];
+
+    // test
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationDidEnterBackgroundNotification object:nil];
+
+    // verify
+    XCTAssertFalse([_persistence hasPendingWrites]);
+    XCTAssertEqualObjects(@"value", [_defaults objectForKey:@"key"]);
+}
+
+- (void) testFlushOnWillTerminate {
+    // setup
+    [_persistence setObject:@"value" forKey:@"key"];
+
+    // test
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationWillTerminateNotification object:nil];
+
+    // verify
+    XCTAssertFalse([_persistence hasPendingWrites]);
+    XCTAssertEqualObjects(@"value", [_defaults objectForKey:@"key"]);
+}
+
+- (void) testStoredKeysAreWrittenToStateFile {
+    // setup
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults stateStore:_stateStore flushDelay:60];
+
+    // test
+    [_persistence setObject:@[@"a"] forKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
+    [_persistence setObject:@"value" forKey:@"key"];
+    [_persistence flush];
+
+    // verify
+    XCTAssertEqualObjects(@[@"a"], [_stateStore load][ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertNil([_defaults objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertEqualObjects(@"value", [_defaults objectForKey:@"key"]);
+    XCTAssertEqual(1, _persistence.flushCount);
+}
+
+- (void) testStoredKeysAreReadFromStateFile {
+    // setup
+    [_stateStore writeValues:@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(2)}];
+    [_defaults setObject:@(1) forKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
+
+    // test
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults stateStore:_stateStore flushDelay:60];
+
+    // verify - the state file wins, and user defaults are left alone once it exists
+    XCTAssertEqualObjects(@(2), [_persistence objectForKey:ACPPlacesMonitorDefaultsMonitorMode_Test]);
+    XCTAssertEqualObjects(@(1), [_defaults objectForKey:ACPPlacesMonitorDefaultsMonitorMode_Test]);
+}
+
+- (void) testUserDefaultsAreMigratedWithoutStateFile {
+    // setup
+    [_defaults setObject:@[@"a"] forKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test];
+
+    // test
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults stateStore:_stateStore flushDelay:60];
+
+    // verify
+    XCTAssertEqualObjects(@[@"a"], [_persistence objectForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test]);
+    XCTAssertEqualObjects(@[@"a"], [_stateStore load][ACPPlacesMonitorDefaultsUserWithinRegions_Test]);
+    XCTAssertNil([_defaults objectForKey:ACPPlacesMonitorDefaultsUserWithinRegions_Test]);
+}
+
+- (void) testCorruptStateFileIsNotMigratedAgain {
+    // setup - a value left behind in user defaults, and a state file which no longer decodes
+    [_stateStore writeValues:@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(2)}];
+    [@"not a state file" writeToURL:_stateStore.fileURL atomically:YES encoding:NSUTF8StringEncoding error:nil];
+    [_defaults setObject:@(1) forKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
+
+    // test
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults stateStore:_stateStore flushDelay:60];
+
+    // verify
+    XCTAssertNil([_persistence objectForKey:ACPPlacesMonitorDefaultsMonitorMode_Test]);
+    XCTAssertEqualObjects(@(1), [_defaults objectForKey:ACPPlacesMonitorDefaultsMonitorMode_Test]);
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:_stateStore.backupURL.path]);
+}
+
+- (void) testRemovingStoredKey {
+    // setup
+    [_stateStore writeValues:@{ACPPlacesMonitorDefaultsMonitoredRegions_Test: @[@"a"]}];
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults stateStore:_stateStore flushDelay:60];
+
+    // test
+    [_persistence setObject:nil forKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
+    [_persistence flush];
+
+    // verify
+    XCTAssertNil([_persistence objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertNil([_stateStore load][ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+}
+
+- (void) testStoredKeysOnlyDoNotSynchronizeUserDefaults {
+    // setup
+    _persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:_defaults stateStore:_stateStore flushDelay:60];
+    id defaultsMock = OCMPartialMock(_defaults);
+    OCMReject([defaultsMock synchronize]);
+
+    // test
+    [_persistence setObject:@(1) forKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
+    [_persistence flush];
+
+    // verify
+    XCTAssertEqualObjects(@(1), [_stateStore load][ACPPlacesMonitorDefaultsMonitorMode_Test]);
+}
+
+@end
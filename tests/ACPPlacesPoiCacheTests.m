@@ -0,0 +1,200 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiCacheTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesPoiCache.h"
+
+// expose private members for testing
+@interface ACPPlacesPoiCache()
+@property(nonatomic, strong) NSMutableDictionary* cells;
+@end
+
+@interface ACPPlacesPoiCacheTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesPoiCache *cache;
+@property (nonatomic, strong) NSDate *now;
+@property (nonatomic, strong) ACPPlacesPoi *fakePoi;
+@end
+
+@implementation ACPPlacesPoiCacheTests
+
+- (void) setUp {
+    _cache = [[ACPPlacesPoiCache alloc] initWithCellSize:1000 validityRadius:500 timeToLive:60 capacity:2];
+    _now = [NSDate date];
+    _fakePoi = [[ACPPlacesPoi alloc] init];
+    _fakePoi.identifier = @"region identifier";
+    _fakePoi.latitude = 40.0;
+    _fakePoi.longitude = -111.0;
+    _fakePoi.radius = 100;
+    _fakePoi.userIsWithin = NO;
+}
+
+- (CLLocation*) locationWithLatitude: (double) latitude longitude: (double) longitude age: (NSTimeInterval) age {
+    return [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(latitude, longitude)
+                                         altitude:0
+                               horizontalAccuracy:10
+                                 verticalAccuracy:10
+                                        timestamp:[_now dateByAddingTimeInterval:age]];
+}
+
+- (void) testInit {
+    ACPPlacesPoiCache *cache = [[ACPPlacesPoiCache alloc] init];
+
+    XCTAssertNotNil(cache);
+    XCTAssertEqual(ACPPlacesMonitorPoiCacheCellSize_Test, cache.cellSize);
+    XCTAssertEqual(ACPPlacesMonitorPoiCacheValidityRadius_Test, cache.validityRadius);
+    XCTAssertEqual(ACPPlacesMonitorPoiCacheTimeToLive_Test, cache.timeToLive);
+    XCTAssertEqual(ACPPlacesMonitorPoiCacheCapacity_Test, cache.capacity);
+    XCTAssertEqual(0, cache.hitCount);
+    XCTAssertEqual(0, cache.missCount);
+}
+
+- (void) testEmptyCacheIsAMiss {
+    // test
+    NSArray *result = [_cache poisNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // verify
+    XCTAssertNil(result);
+    XCTAssertEqual(0, _cache.hitCount);
+    XCTAssertEqual(1, _cache.missCount);
+}
+
+- (void) testHitWithinValidityRadius {
+    // setup
+    [_cache cachePois:@[_fakePoi] forLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // test - roughly 220 meters north of the query location
+    NSArray *result = [_cache poisNearLocation:[self locationWithLatitude:40.002 longitude:-111.0 age:30]];
+
+    // verify
+    XCTAssertEqual(1, result.count);
+    XCTAssertEqualObjects(_fakePoi.identifier, [result[0] identifier]);
+    XCTAssertEqual(1, _cache.hitCount);
+    XCTAssertEqual(0, _cache.missCount);
+}
+
+- (void) testHitAcrossCellBoundary {
+    // setup - a query location just south of a row boundary
+    double boundary = 4443 * 1000 / 111320.0;
+    [_cache cachePois:@[_fakePoi] forLocation:[self locationWithLatitude:boundary - 0.0005 longitude:-111.0 age:0]];
+
+    // test
+    NSArray *result = [_cache poisNearLocation:[self locationWithLatitude:boundary + 0.0005 longitude:-111.0 age:0]];
+
+    // verify
+    XCTAssertNotNil(result);
+}
+
+- (void) testMissOutsideValidityRadius {
+    // setup
+    [_cache cachePois:@[_fakePoi] forLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // test - roughly 900 meters north of the query location
+    NSArray *result = [_cache poisNearLocation:[self locationWithLatitude:40.008 longitude:-111.0 age:0]];
+
+    // verify
+    XCTAssertNil(result);
+    XCTAssertEqual(1, _cache.missCount);
+}
+
+- (void) testMissWhenExpired {
+    // setup
+    [_cache cachePois:@[_fakePoi] forLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // test
+    NSArray *result = [_cache poisNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:61]];
+
+    // verify
+    XCTAssertNil(result);
+    XCTAssertEqual(1, _cache.missCount);
+}
+
+- (void) testHitRecalculatesUserIsWithin {
+    // setup
+    [_cache cachePois:@[_fakePoi] forLocation:[self locationWithLatitude:40.003 longitude:-111.0 age:0]];
+
+    // test
+    NSArray<ACPPlacesPoi*> *result = [_cache poisNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // verify
+    XCTAssertTrue(result[0].userIsWithin);
+
+    // test
+    result = [_cache poisNearLocation:[self locationWithLatitude:40.003 longitude:-111.0 age:0]];
+
+    // verify
+    XCTAssertFalse(result[0].userIsWithin);
+}
+
+- (void) testHitDoesNotChangeCachedPois {
+    // setup
+    _fakePoi.userIsWithin = NO;
+    [_cache cachePois:@[_fakePoi] forLocation:[self locationWithLatitude:40.003 longitude:-111.0 age:0]];
+
+    // test
+    NSArray<ACPPlacesPoi*> *result = [_cache poisNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // verify
+    XCTAssertTrue(result[0].userIsWithin);
+    XCTAssertNotEqual(_fakePoi, result[0]);
+    XCTAssertEqualObjects(_fakePoi.identifier, result[0].identifier);
+    XCTAssertFalse(_fakePoi.userIsWithin);
+}
+
+- (void) testNilResponseIsCachedAsEmpty {
+    // setup
+    [_cache cachePois:nil forLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // test
+    NSArray *result = [_cache poisNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]];
+
+    // verify
+    XCTAssertNotNil(result);
+    XCTAssertEqual(0, result.count);
+    XCTAssertEqual(1, _cache.hitCount);
+}
+
+- (void) testCapacityEvictsOldestEntry {
+    // setup
+    CLLocation *oldest = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+    [_cache cachePois:@[_fakePoi] forLocation:oldest];
+    [_cache cachePois:@[] forLocation:[self locationWithLatitude:41.0 longitude:-111.0 age:1]];
+
+    // test
+    [_cache cachePois:@[] forLocation:[self locationWithLatitude:42.0 longitude:-111.0 age:2]];
+
+    // verify
+    XCTAssertEqual(2, _cache.cells.count);
+    XCTAssertNil([_cache poisNearLocation:oldest]);
+}
+
+- (void) testInvalidate {
+    // setup
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+    [_cache cachePois:@[_fakePoi] forLocation:location];
+
+    // test
+    [_cache invalidate];
+
+    // verify
+    XCTAssertEqual(0, _cache.cells.count);
+    XCTAssertNil([_cache poisNearLocation:location]);
+}
+
+@end
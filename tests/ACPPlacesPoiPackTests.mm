@@ -0,0 +1,262 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiPackTests.mm
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesCoreBridge.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesPoiPack.h"
+
+#include "placesmonitor/PoiPack.hpp"
+
+@interface ACPPlacesPoiPackTests : XCTestCase
+@property (nonatomic, copy) NSString *path;
+@property (nonatomic, strong) NSDate *now;
+@property (nonatomic, strong) ACPPlacesPoiPack *pack;
+@end
+
+@implementation ACPPlacesPoiPackTests
+
+- (void) setUp {
+    _path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    _now = [NSDate date];
+
+    // three POIs about 1 km apart along a line of latitude, and one far away
+    [self writePackWithPois:@[[self poiWithIdentifier:@"a" latitude:40.0 longitude:-111.0],
+                              [self poiWithIdentifier:@"b" latitude:40.0 longitude:-110.988],
+                              [self poiWithIdentifier:@"c" latitude:40.0 longitude:-110.976],
+                              [self poiWithIdentifier:@"far" latitude:10.0 longitude:10.0]]
+                   revision:7];
+    _pack = [[ACPPlacesPoiPack alloc] initWithPath:_path refreshInterval:60];
+}
+
+- (void) tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:_path error:nil];
+}
+
+- (ACPPlacesPoi*) poiWithIdentifier: (NSString*) identifier latitude: (double) latitude longitude: (double) longitude {
+    ACPPlacesPoi *poi = [[ACPPlacesPoi alloc] init];
+    poi.identifier = identifier;
+    poi.name = [identifier uppercaseString];
+    poi.latitude = latitude;
+    poi.longitude = longitude;
+    poi.radius = 100;
+    return poi;
+}
+
+- (void) writePackWithPois: (NSArray<ACPPlacesPoi*>*) pois revision: (uint64_t) revision {
+    std::vector<uint8_t> bytes = placesmonitor::PoiPack::encode(ACPPlacesCorePois(pois), revision);
+    [[NSData dataWithBytes:bytes.data() length:bytes.size()] writeToFile:_path atomically:YES];
+}
+
+- (CLLocation*) locationWithLatitude: (double) latitude longitude: (double) longitude age: (NSTimeInterval) age {
+    return [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(latitude, longitude)
+                                         altitude:0
+                               horizontalAccuracy:10
+                                 verticalAccuracy:10
+                                        timestamp:[_now dateByAddingTimeInterval:age]];
+}
+
+- (NSArray<NSString*>*) identifiersOfPois: (NSArray<ACPPlacesPoi*>*) pois {
+    return [pois valueForKey:@"identifier"];
+}
+
+- (void) testInit {
+    ACPPlacesPoiPack *pack = [[ACPPlacesPoiPack alloc] initWithPath:_path];
+
+    XCTAssertNotNil(pack);
+    XCTAssertEqualObjects(_path, pack.path);
+    XCTAssertEqual(4, pack.count);
+    XCTAssertEqual(7, pack.revision);
+    XCTAssertEqual(ACPPlacesMonitorPoiPackRefreshInterval_Test, pack.refreshInterval);
+    XCTAssertEqual(0, pack.deltaCount);
+}
+
+- (void) testInitMissingFile {
+    XCTAssertNil([[ACPPlacesPoiPack alloc] initWithPath:[_path stringByAppendingString:@".missing"]]);
+}
+
+- (void) testInitInvalidFile {
+    // setup
+    [[@"lat,lon\n40,-111\n" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:_path atomically:YES];
+
+    // verify
+    XCTAssertNil([[ACPPlacesPoiPack alloc] initWithPath:_path]);
+}
+
+- (void) testPoisNearLocationAreSortedByDistance {
+    // test
+    NSArray<ACPPlacesPoi*> *pois = [_pack poisNearLocation:[self locationWithLatitude:40.0 longitude:-110.977 age:0] limit:10];
+
+    // verify
+    NSArray *expected = @[@"c", @"b", @"a"];
+    XCTAssertEqualObjects(expected, [self identifiersOfPois:pois]);
+    XCTAssertEqualObjects(@"C", pois[0].name);
+    XCTAssertEqual(100, pois[0].radius);
+}
+
+- (void) testPoisNearLocationHonorsLimit {
+    // test
+    NSArray<ACPPlacesPoi*> *pois = [_pack poisNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0] limit:2];
+
+    // verify
+    NSArray *expected = @[@"a", @"b"];
+    XCTAssertEqualObjects(expected, [self identifiersOfPois:pois]);
+}
+
+- (void) testPoisNearLocationSetsUserIsWithin {
+    // test
+    NSArray<ACPPlacesPoi*> *pois = [_pack poisNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0] limit:2];
+
+    // verify
+    XCTAssertTrue(pois[0].userIsWithin);
+    XCTAssertFalse(pois[1].userIsWithin);
+}
+
+- (void) testPoisNearLocationNothingNearby {
+    // test
+    NSArray<ACPPlacesPoi*> *pois = [_pack poisNearLocation:[self locationWithLatitude:-40.0 longitude:100.0 age:0] limit:10];
+
+    // verify
+    XCTAssertEqual(0, pois.count);
+}
+
+- (void) testDeltaOverridesPackPoi {
+    // setup
+    ACPPlacesPoi *moved = [self poiWithIdentifier:@"b" latitude:40.0 longitude:-110.9995];
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+
+    // test
+    [_pack applyDelta:@[[self poiWithIdentifier:@"a" latitude:40.0 longitude:-111.0], moved,
+                        [self poiWithIdentifier:@"c" latitude:40.0 longitude:-110.976]]
+          forLocation:location
+                limit:10];
+
+    // verify
+    NSArray *expected = @[@"a", @"b", @"c"];
+    XCTAssertEqualObjects(expected, [self identifiersOfPois:[_pack poisNearLocation:location limit:10]]);
+    XCTAssertTrue([_pack poisNearLocation:location limit:10][1].userIsWithin);
+    XCTAssertEqual(1, _pack.deltaCount);
+}
+
+- (void) testDeltaAddsNewPoi {
+    // setup
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+    NSArray *response = @[[self poiWithIdentifier:@"a" latitude:40.0 longitude:-111.0],
+                          [self poiWithIdentifier:@"new" latitude:40.0 longitude:-110.995]];
+
+    // test
+    [_pack applyDelta:response forLocation:location limit:2];
+
+    // verify
+    NSArray *expected = @[@"a", @"new", @"b", @"c"];
+    XCTAssertEqualObjects(expected, [self identifiersOfPois:[_pack poisNearLocation:location limit:10]]);
+}
+
+- (void) testShortDeltaRemovesPackPoisItDidNotReturn {
+    // setup
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+
+    // test - fewer POIs than asked for, so the response covers the whole search radius
+    [_pack applyDelta:@[[self poiWithIdentifier:@"c" latitude:40.0 longitude:-110.976]] forLocation:location limit:10];
+
+    // verify
+    NSArray *expected = @[@"c"];
+    XCTAssertEqualObjects(expected, [self identifiersOfPois:[_pack poisNearLocation:location limit:10]]);
+}
+
+- (void) testFullDeltaOnlyCoversUpToItsFarthestPoi {
+    // setup
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+
+    // test - "a" is gone, "b" marks the edge of the area the response speaks for
+    [_pack applyDelta:@[[self poiWithIdentifier:@"b" latitude:40.0 longitude:-110.988]] forLocation:location limit:1];
+
+    // verify
+    NSArray *expected = @[@"b", @"c"];
+    XCTAssertEqualObjects(expected, [self identifiersOfPois:[_pack poisNearLocation:location limit:10]]);
+}
+
+- (void) testNilDeltaEmptiesTheArea {
+    // setup
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+
+    // test
+    [_pack applyDelta:nil forLocation:location limit:10];
+
+    // verify
+    XCTAssertEqual(0, [_pack poisNearLocation:location limit:10].count);
+    XCTAssertEqual(1, [_pack poisNearLocation:[self locationWithLatitude:10.0 longitude:10.0 age:0] limit:10].count);
+}
+
+- (void) testNewerDeltaWins {
+    // setup
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+    [_pack applyDelta:nil forLocation:location limit:10];
+
+    // test
+    [_pack applyDelta:@[[self poiWithIdentifier:@"a" latitude:40.0 longitude:-111.0]]
+          forLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:10]
+                limit:10];
+
+    // verify
+    NSArray *expected = @[@"a"];
+    XCTAssertEqualObjects(expected, [self identifiersOfPois:[_pack poisNearLocation:location limit:10]]);
+    XCTAssertEqual(1, _pack.deltaCount);
+}
+
+- (void) testDeltaCapacity {
+    // test
+    for (NSUInteger i = 0; i <= ACPPlacesMonitorPoiPackDeltaCapacity_Test; i++) {
+        [_pack applyDelta:@[] forLocation:[self locationWithLatitude:i longitude:0 age:0] limit:10];
+    }
+
+    // verify
+    XCTAssertEqual(ACPPlacesMonitorPoiPackDeltaCapacity_Test, _pack.deltaCount);
+    XCTAssertTrue([_pack needsRefreshNearLocation:[self locationWithLatitude:0 longitude:0 age:0]]);
+}
+
+- (void) testNeedsRefresh {
+    // setup
+    [_pack applyDelta:@[] forLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0] limit:10];
+
+    // verify
+    XCTAssertFalse([_pack needsRefreshNearLocation:[self locationWithLatitude:40.0 longitude:-110.995 age:30]]);
+    XCTAssertTrue([_pack needsRefreshNearLocation:[self locationWithLatitude:40.0 longitude:-110.976 age:30]]);
+    XCTAssertTrue([_pack needsRefreshNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:61]]);
+}
+
+- (void) testNeedsRefreshWithoutDeltas {
+    XCTAssertTrue([_pack needsRefreshNearLocation:[self locationWithLatitude:40.0 longitude:-111.0 age:0]]);
+}
+
+- (void) testDiscardDeltas {
+    // setup
+    CLLocation *location = [self locationWithLatitude:40.0 longitude:-111.0 age:0];
+    [_pack applyDelta:nil forLocation:location limit:10];
+
+    // test
+    [_pack discardDeltas];
+
+    // verify
+    XCTAssertEqual(0, _pack.deltaCount);
+    XCTAssertEqual(3, [_pack poisNearLocation:location limit:10].count);
+    XCTAssertTrue([_pack needsRefreshNearLocation:location]);
+}
+
+@end
@@ -0,0 +1,235 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiPrefetcherTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesMetrics.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesPoiCache.h"
+#import "ACPPlacesPoiPrefetcher.h"
+
+// always predicts the device ends up at the same place
+@interface ACPPlacesFixedPredictor : NSObject <ACPPlacesTrajectoryPredictor>
+@property (nonatomic, strong) CLLocation *target;
+@property (nonatomic) NSUInteger callCount;
+@end
+
+@implementation ACPPlacesFixedPredictor
+- (CLLocation*) predictLocationAfter: (NSTimeInterval) seconds fromHistory: (NSArray<CLLocation*>*) history {
+    _callCount++;
+    return [[CLLocation alloc] initWithCoordinate:_target.coordinate
+                                         altitude:0
+                               horizontalAccuracy:10
+                                 verticalAccuracy:-1
+                                        timestamp:[history.lastObject.timestamp dateByAddingTimeInterval:seconds]];
+}
+@end
+
+@interface ACPPlacesPoiPrefetcherTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesPoiPrefetcher *prefetcher;
+@property (nonatomic, strong) ACPPlacesPoiCache *cache;
+@property (nonatomic, strong) ACPPlacesMetrics *metrics;
+@property (nonatomic, strong) NSMutableArray<CLLocation*> *fetchedLocations;
+@property (nonatomic, strong) NSMutableArray<ACPPlacesPoiResponseBlock> *responseBlocks;
+@property (nonatomic, strong) NSMutableArray<ACPPlacesPoiErrorBlock> *errorBlocks;
+@property (nonatomic, strong) ACPPlacesPoi *fakePoi;
+@end
+
+@implementation ACPPlacesPoiPrefetcherTests
+
+- (void) setUp {
+    _fetchedLocations = [NSMutableArray array];
+    _responseBlocks = [NSMutableArray array];
+    _errorBlocks = [NSMutableArray array];
+    _cache = [[ACPPlacesPoiCache alloc] init];
+    _metrics = [[ACPPlacesMetrics alloc] init];
+
+    // requests stay outstanding until the test completes them
+    __weak ACPPlacesPoiPrefetcherTests *weakSelf = self;
+    _prefetcher = [[ACPPlacesPoiPrefetcher alloc] initWithCache:_cache fetchBlock:^(CLLocation *location,
+                                                                                    ACPPlacesPoiResponseBlock response,
+                                                                                    ACPPlacesPoiErrorBlock error) {
+        [weakSelf.fetchedLocations addObject:location];
+        [weakSelf.responseBlocks addObject:response];
+        [weakSelf.errorBlocks addObject:error];
+    }];
+    _prefetcher.metrics = _metrics;
+
+    _fakePoi = [[ACPPlacesPoi alloc] init];
+    _fakePoi.identifier = @"poi";
+    _fakePoi.latitude = 40.01;
+    _fakePoi.longitude = -111;
+    _fakePoi.radius = 100;
+}
+
+#pragma mark - helpers
+// a fix on a road heading north at 20 meters per second
+- (CLLocation*) drivingLocationAtMeters: (CLLocationDistance) meters timestamp: (NSTimeInterval) timestamp {
+    return [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(40 + meters / 111195.0, -111)
+                                         altitude:0
+                               horizontalAccuracy:10
+                                 verticalAccuracy:-1
+                                           course:0
+                                            speed:20
+                                        timestamp:[NSDate dateWithTimeIntervalSince1970:1000 + timestamp]];
+}
+
+- (CLLocationDistance) metersNorthOfOrigin: (CLLocation*) location {
+    return [location distanceFromLocation:[[CLLocation alloc] initWithLatitude:40 longitude:-111]];
+}
+
+#pragma mark - tests
+- (void) testSlowDeviceIsNotPrefetched {
+    // setup
+    CLLocation *walking = [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(40, -111)
+                                                        altitude:0
+                                              horizontalAccuracy:10
+                                                verticalAccuracy:-1
+                                                          course:0
+                                                           speed:1.5
+                                                       timestamp:[NSDate date]];
+
+    // test
+    [_prefetcher addLocation:walking];
+
+    // verify
+    XCTAssertEqual(0, _fetchedLocations.count);
+    XCTAssertEqual(0, _prefetcher.predictionCount);
+}
+
+- (void) testMovingDeviceIsPrefetchedOneRequestAtATime {
+    // test
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+
+    // verify
+    XCTAssertEqual(ACPPlacesMonitorPrefetchMaximumPoints_Test, _prefetcher.predictionCount);
+    XCTAssertEqual(1, _fetchedLocations.count);
+    XCTAssertEqualWithAccuracy(ACPPlacesMonitorPrefetchSpacing_Test, [self metersNorthOfOrigin:_fetchedLocations[0]], 1);
+
+    for (NSUInteger i = 1; i < ACPPlacesMonitorPrefetchMaximumPoints_Test; i++) {
+        _responseBlocks[i - 1](@[]);
+        XCTAssertEqual(i + 1, _fetchedLocations.count);
+        XCTAssertEqualWithAccuracy((i + 1) * ACPPlacesMonitorPrefetchSpacing_Test, [self metersNorthOfOrigin:_fetchedLocations[i]], 1);
+    }
+
+    _responseBlocks.lastObject(@[]);
+    XCTAssertEqual(ACPPlacesMonitorPrefetchMaximumPoints_Test, _prefetcher.issuedRequestCount);
+    XCTAssertEqual(ACPPlacesMonitorPrefetchMaximumPoints_Test, [_metrics valueOfCounter:ACPPlacesMetricCounterPoiPrefetches]);
+}
+
+- (void) testPrefetchedResponseAnswersLaterFix {
+    // setup
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+
+    // test
+    _responseBlocks[0](@[_fakePoi]);
+
+    // verify - the device reaches the point 50 seconds later and needs no request
+    NSArray<ACPPlacesPoi*> *cached = [_cache poisNearLocation:[self drivingLocationAtMeters:1000 timestamp:50]];
+    XCTAssertEqual(1, cached.count);
+    XCTAssertEqualObjects(@"poi", cached[0].identifier);
+}
+
+- (void) testReachingPredictionIsHit {
+    // setup
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+
+    // test
+    [_prefetcher addLocation:[self drivingLocationAtMeters:1000 timestamp:50]];
+
+    // verify
+    XCTAssertEqual(1, _prefetcher.hitCount);
+    XCTAssertEqual(0, _prefetcher.missCount);
+    XCTAssertEqual(1.0, _prefetcher.hitRate);
+    XCTAssertEqual(1, [_metrics valueOfCounter:ACPPlacesMetricCounterPrefetchHits]);
+}
+
+- (void) testTurningAwayIsMiss {
+    // setup
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+    CLLocation *parked = [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(40, -110.9)
+                                                       altitude:0
+                                             horizontalAccuracy:10
+                                               verticalAccuracy:-1
+                                                         course:0
+                                                          speed:0
+                                                      timestamp:[NSDate dateWithTimeIntervalSince1970:3000]];
+
+    // test
+    [_prefetcher addLocation:parked];
+
+    // verify
+    XCTAssertEqual(0, _prefetcher.hitCount);
+    XCTAssertEqual(ACPPlacesMonitorPrefetchMaximumPoints_Test, _prefetcher.missCount);
+    XCTAssertEqual(ACPPlacesMonitorPrefetchMaximumPoints_Test, [_metrics valueOfCounter:ACPPlacesMetricCounterPrefetchMisses]);
+}
+
+- (void) testCanFetchHoldsRequestsBack {
+    // setup
+    _prefetcher.canFetch = ^BOOL {
+        return NO;
+    };
+
+    // test
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+
+    // verify - the predictions are still made so they can be scored
+    XCTAssertEqual(0, _fetchedLocations.count);
+    XCTAssertEqual(ACPPlacesMonitorPrefetchMaximumPoints_Test, _prefetcher.predictionCount);
+}
+
+- (void) testCancelDiscardsInFlightResponse {
+    // setup
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+
+    // test
+    [_prefetcher cancel];
+    _responseBlocks[0](@[_fakePoi]);
+
+    // verify
+    XCTAssertEqual(1, _fetchedLocations.count);
+    XCTAssertNil([_cache poisNearLocation:[self drivingLocationAtMeters:1000 timestamp:50]]);
+}
+
+- (void) testErrorDropsQueuedPoints {
+    // setup
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+
+    // test
+    _errorBlocks[0](ACPPlacesRequestErrorConnectivityError);
+
+    // verify
+    XCTAssertEqual(1, _fetchedLocations.count);
+}
+
+- (void) testPredictorIsPluggable {
+    // setup
+    ACPPlacesFixedPredictor *predictor = [[ACPPlacesFixedPredictor alloc] init];
+    predictor.target = [[CLLocation alloc] initWithLatitude:40.05 longitude:-111];
+    _prefetcher.predictor = predictor;
+
+    // test
+    [_prefetcher addLocation:[self drivingLocationAtMeters:0 timestamp:0]];
+
+    // verify - every point along the path is at the target, so one request covers them all
+    XCTAssertTrue(predictor.callCount > 0);
+    XCTAssertEqual(1, _fetchedLocations.count);
+    XCTAssertEqualWithAccuracy(0, [_fetchedLocations[0] distanceFromLocation:predictor.target], 1);
+}
+
+@end
@@ -0,0 +1,194 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesPoiRequestCoordinatorTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesPoiRequestCoordinator.h"
+
+@interface ACPPlacesPoiRequestCoordinatorTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesPoiRequestCoordinator *coordinator;
+@property (nonatomic, strong) NSMutableArray<CLLocation*> *fetchedLocations;
+@property (nonatomic, strong) NSMutableArray<ACPPlacesPoiResponseBlock> *responseBlocks;
+@property (nonatomic, strong) NSMutableArray<ACPPlacesPoiErrorBlock> *errorBlocks;
+@property (nonatomic, strong) NSMutableArray<CLLocation*> *deliveredLocations;
+@property (nonatomic, strong) NSMutableArray<NSNumber*> *deliveredErrors;
+@end
+
+@implementation ACPPlacesPoiRequestCoordinatorTests
+
+- (void) setUp {
+    _fetchedLocations = [NSMutableArray array];
+    _responseBlocks = [NSMutableArray array];
+    _errorBlocks = [NSMutableArray array];
+    _deliveredLocations = [NSMutableArray array];
+    _deliveredErrors = [NSMutableArray array];
+
+    // requests stay outstanding until the test completes them
+    __weak ACPPlacesPoiRequestCoordinatorTests *weakSelf = self;
+    _coordinator = [[ACPPlacesPoiRequestCoordinator alloc] initWithFetchBlock:^(CLLocation *location,
+                                                                                ACPPlacesPoiResponseBlock response,
+                                                                                ACPPlacesPoiErrorBlock error) {
+        [weakSelf.fetchedLocations addObject:location];
+        [weakSelf.responseBlocks addObject:response];
+        [weakSelf.errorBlocks addObject:error];
+    } responseHandler:^(NSArray<ACPPlacesPoi*> *pois, CLLocation *location) {
+        [weakSelf.deliveredLocations addObject:location];
+    } errorHandler:^(ACPPlacesRequestError error, CLLocation *location) {
+        [weakSelf.deliveredErrors addObject:@(error)];
+    }];
+}
+
+- (CLLocation*) locationWithLatitude: (double) latitude {
+    return [[CLLocation alloc] initWithLatitude:latitude longitude:23.45];
+}
+
+- (void) testSingleRequest {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1];
+
+    // test
+    [_coordinator requestPoisNearLocation:location];
+    XCTAssertTrue(_coordinator.isRequestInFlight);
+    _responseBlocks[0](@[]);
+
+    // verify
+    XCTAssertEqualObjects(@[location], _fetchedLocations);
+    XCTAssertEqualObjects(@[location], _deliveredLocations);
+    XCTAssertFalse(_coordinator.isRequestInFlight);
+    XCTAssertEqual(1, _coordinator.issuedRequestCount);
+}
+
+- (void) testOnlyOneRequestInFlight {
+    // test
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:1]];
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:2]];
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:3]];
+
+    // verify
+    XCTAssertEqual(1, _fetchedLocations.count);
+    XCTAssertEqual(1, _coordinator.issuedRequestCount);
+}
+
+- (void) testBurstIsCoalescedIntoOneFollowUp {
+    // setup
+    CLLocation *first = [self locationWithLatitude:1];
+    CLLocation *latest = [self locationWithLatitude:4];
+    [_coordinator requestPoisNearLocation:first];
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:2]];
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:3]];
+    [_coordinator requestPoisNearLocation:latest];
+
+    // test
+    _responseBlocks[0](@[]);
+
+    // verify - the first response is delivered and only the latest location is fetched next
+    XCTAssertEqualObjects(@[first], _deliveredLocations);
+    NSArray *expectedFetches = @[first, latest];
+    XCTAssertEqualObjects(expectedFetches, _fetchedLocations);
+    XCTAssertTrue(_coordinator.isRequestInFlight);
+    XCTAssertEqual(2, _coordinator.avoidedRequestCount);
+
+    // the follow-up completes normally
+    _responseBlocks[1](@[]);
+    NSArray *expectedDeliveries = @[first, latest];
+    XCTAssertEqualObjects(expectedDeliveries, _deliveredLocations);
+    XCTAssertFalse(_coordinator.isRequestInFlight);
+}
+
+- (void) testCancelledResponseIsDiscarded {
+    // setup
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:1]];
+
+    // test
+    [_coordinator cancelOutstandingRequests];
+    _responseBlocks[0](@[]);
+
+    // verify
+    XCTAssertEqual(0, _deliveredLocations.count);
+    XCTAssertEqual(1, _coordinator.staleResponseCount);
+    XCTAssertFalse(_coordinator.isRequestInFlight);
+}
+
+- (void) testLateResponseDoesNotOverwriteNewerRequest {
+    // setup
+    CLLocation *newer = [self locationWithLatitude:2];
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:1]];
+    [_coordinator cancelOutstandingRequests];
+    [_coordinator requestPoisNearLocation:newer];
+
+    // test - the newer request completes first, then the cancelled one
+    _responseBlocks[1](@[]);
+    _responseBlocks[0](@[]);
+
+    // verify
+    XCTAssertEqualObjects(@[newer], _deliveredLocations);
+    XCTAssertEqual(1, _coordinator.staleResponseCount);
+}
+
+- (void) testCancelDropsFollowUp {
+    // setup
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:1]];
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:2]];
+
+    // test
+    [_coordinator cancelOutstandingRequests];
+    _responseBlocks[0](@[]);
+
+    // verify
+    XCTAssertEqual(1, _fetchedLocations.count);
+    XCTAssertEqual(1, _coordinator.avoidedRequestCount);
+}
+
+- (void) testErrorIsDeliveredAndDropsFollowUp {
+    // setup
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:1]];
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:2]];
+
+    // test
+    _errorBlocks[0](ACPPlacesRequestErrorConnectivityError);
+
+    // verify
+    XCTAssertEqualObjects(@[@(ACPPlacesRequestErrorConnectivityError)], _deliveredErrors);
+    XCTAssertEqual(1, _fetchedLocations.count);
+    XCTAssertFalse(_coordinator.isRequestInFlight);
+}
+
+- (void) testStaleErrorIsDiscarded {
+    // setup
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:1]];
+    [_coordinator cancelOutstandingRequests];
+
+    // test
+    _errorBlocks[0](ACPPlacesRequestErrorConnectivityError);
+
+    // verify
+    XCTAssertEqual(0, _deliveredErrors.count);
+    XCTAssertEqual(1, _coordinator.staleResponseCount);
+}
+
+- (void) testGenerationAdvances {
+    // test
+    [_coordinator requestPoisNearLocation:[self locationWithLatitude:1]];
+    NSUInteger first = _coordinator.generation;
+    [_coordinator cancelOutstandingRequests];
+
+    // verify
+    XCTAssertTrue(_coordinator.generation > first);
+}
+
+@end
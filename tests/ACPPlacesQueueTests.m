@@ -3,7 +3,7 @@
  This file is licensed to you under the Apache License, Version 2.0 (the "License");
  you may not use this file except in compliance with the License. You may obtain a copy
  of the License at http://www.apache.org/licenses/LICENSE-2.0
- 
+
  Unless required by applicable law or agreed to in writing, software distributed under
  the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
  OF ANY KIND, either express or implied. See the License for the specific language
@@ -18,12 +18,13 @@
 #import "OCMock.h"
 #import <Foundation/Foundation.h>
 #import "ACPExtensionEvent.h"
+#import "ACPPlacesMonitorConstantsTests.h"
 #import "ACPPlacesQueue.h"
 
 
 // expose private members for testing
 @interface ACPPlacesQueue()
-@property(nonatomic, strong) NSMutableArray* queuedEvents;
+@property(nonatomic) NSUInteger capacity;
 @end
 
 
@@ -39,75 +40,96 @@
     _event = [ACPExtensionEvent extensionEventWithName:@"name" type:@"type" source:@"source" data:nil error:nil];
 }
 
+- (ACPExtensionEvent*) eventNamed: (NSString*) name data: (NSDictionary*) data {
+    return [ACPExtensionEvent extensionEventWithName:name
+                                                type:ACPPlacesMonitorEventTypeMonitor_Test
+                                              source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                data:data
+                                               error:nil];
+}
+
 - (void) testInit {
     XCTAssertNotNil(_queue);
-    XCTAssertNotNil(_queue.queuedEvents);
+    XCTAssertEqual(0, [_queue count]);
+    XCTAssertEqual(ACPPlacesMonitorEventQueueCapacity_Test, _queue.capacity);
 }
 
 - (void) testAdd {
-    XCTAssertEqual(0, _queue.queuedEvents.count);
+    XCTAssertEqual(0, [_queue count]);
     [_queue add:_event];
-    XCTAssertEqual(1, _queue.queuedEvents.count);
+    XCTAssertEqual(1, [_queue count]);
 }
 
 - (void) testAddNilEventParameter {
-    XCTAssertEqual(0, _queue.queuedEvents.count);
+    XCTAssertEqual(0, [_queue count]);
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wnonnull"
     [_queue add:nil];
 #pragma clang diagnostic pop
-    XCTAssertEqual(0, _queue.queuedEvents.count);
+    XCTAssertEqual(0, [_queue count]);
 }
 
 - (void) testPoll {
     // setup
-    [_queue.queuedEvents addObject:_event];
-    
+    [_queue add:_event];
+
     // test
     ACPExtensionEvent *result = [_queue poll];
-    
+
     // verify
     XCTAssertEqual(_event, result);
-    XCTAssertEqual(0, _queue.queuedEvents.count);
+    XCTAssertEqual(0, [_queue count]);
 }
 
 - (void) testPollWithEmptyQueue {
     // test
     ACPExtensionEvent *result = [_queue poll];
-    
+
     // verify
     XCTAssertNil(result);
-    XCTAssertEqual(0, _queue.queuedEvents.count);
+    XCTAssertEqual(0, [_queue count]);
+}
+
+- (void) testPollKeepsOrder {
+    // setup
+    ACPExtensionEvent *second = [self eventNamed:@"second" data:nil];
+    [_queue add:_event];
+    [_queue add:second];
+
+    // verify
+    XCTAssertEqual(_event, [_queue poll]);
+    XCTAssertEqual(second, [_queue poll]);
+    XCTAssertNil([_queue poll]);
 }
 
 - (void) testPeek {
     // setup
-    [_queue.queuedEvents addObject:_event];
-    
+    [_queue add:_event];
+
     // test
     ACPExtensionEvent *result = [_queue peek];
-    
+
     // verify
     XCTAssertEqual(_event, result);
-    XCTAssertEqual(1, _queue.queuedEvents.count);
+    XCTAssertEqual(1, [_queue count]);
 }
 
 - (void) testPeekWithEmptyQueue {
     // test
     ACPExtensionEvent *result = [_queue peek];
-    
+
     // verify
     XCTAssertNil(result);
-    XCTAssertEqual(0, _queue.queuedEvents.count);
+    XCTAssertEqual(0, [_queue count]);
 }
 
 - (void) testHasNext {
     // setup
-    [_queue.queuedEvents addObject:_event];
-    
+    [_queue add:_event];
+
     // test
     bool result = [_queue hasNext];
-    
+
     // verify
     XCTAssertTrue(result);
 }
@@ -115,20 +137,169 @@
 - (void) testHasNextEmptyQueue {
     // test
     bool result = [_queue hasNext];
-    
+
     // verify
     XCTAssertFalse(result);
 }
 
-- (void) testHasNextNilQueue {
+- (void) testFullQueueDropsOldestEvent {
     // setup
-    _queue.queuedEvents = nil;
-    
+    _queue = [[ACPPlacesQueue alloc] initWithCapacity:2];
+    ACPExtensionEvent *second = [self eventNamed:@"second" data:nil];
+    ACPExtensionEvent *third = [self eventNamed:@"third" data:nil];
+
     // test
-    bool result = [_queue hasNext];
-    
+    [_queue add:_event];
+    [_queue add:second];
+    [_queue add:third];
+
     // verify
-    XCTAssertFalse(result);
+    XCTAssertEqual(2, [_queue count]);
+    XCTAssertEqual(second, [_queue poll]);
+    XCTAssertEqual(third, [_queue poll]);
+}
+
+- (void) testFullQueueNeverDropsStop {
+    // setup
+    _queue = [[ACPPlacesQueue alloc] initWithCapacity:2];
+    ACPExtensionEvent *stop = [self eventNamed:ACPPlacesMonitorEventNameStop_Test data:nil];
+    ACPExtensionEvent *second = [self eventNamed:@"second" data:nil];
+    ACPExtensionEvent *third = [self eventNamed:@"third" data:nil];
+
+    // test
+    [_queue add:stop];
+    [_queue add:second];
+    [_queue add:third];
+
+    // verify
+    XCTAssertEqual(2, [_queue count]);
+    XCTAssertEqual(stop, [_queue poll]);
+    XCTAssertEqual(third, [_queue poll]);
+}
+
+- (void) testMonitorConfigurationIsNotMovedAcrossStop {
+    // setup
+    ACPExtensionEvent *first = [self eventNamed:ACPPlacesMonitorEventNameUpdateMonitorConfiguration_Test data:nil];
+    ACPExtensionEvent *stop = [self eventNamed:ACPPlacesMonitorEventNameStop_Test data:nil];
+    ACPExtensionEvent *second = [self eventNamed:ACPPlacesMonitorEventNameUpdateMonitorConfiguration_Test data:nil];
+
+    // test
+    [_queue add:first];
+    [_queue add:stop];
+    [_queue add:second];
+
+    // verify
+    XCTAssertEqual(first, [_queue poll]);
+    XCTAssertEqual(stop, [_queue poll]);
+    XCTAssertEqual(second, [_queue poll]);
+}
+
+- (void) testWrapsAroundCapacity {
+    // setup
+    _queue = [[ACPPlacesQueue alloc] initWithCapacity:2];
+
+    // test
+    for (int i = 0; i < 5; i++) {
+        ACPExtensionEvent *event = [self eventNamed:[NSString stringWithFormat:@"event%d", i] data:nil];
+        [_queue add:event];
+        XCTAssertEqual(event, [_queue poll]);
+    }
+
+    // verify
+    XCTAssertFalse([_queue hasNext]);
+}
+
+- (void) testDuplicateUpdateLocationNowIsDropped {
+    // setup
+    ACPExtensionEvent *first = [self eventNamed:ACPPlacesMonitorEventNameUpdateLocationNow_Test data:nil];
+
+    // test
+    [_queue add:first];
+    for (int i = 0; i < 4; i++) {
+        [_queue add:[self eventNamed:ACPPlacesMonitorEventNameUpdateLocationNow_Test data:nil]];
+    }
+
+    // verify
+    XCTAssertEqual(1, [_queue count]);
+    XCTAssertEqual(first, [_queue peek]);
+    XCTAssertEqual(4, _queue.coalescedEventCount);
+}
+
+- (void) testDuplicateStartIsDropped {
+    // test
+    [_queue add:[self eventNamed:ACPPlacesMonitorEventNameStart_Test data:nil]];
+    [_queue add:[self eventNamed:ACPPlacesMonitorEventNameStart_Test data:nil]];
+
+    // verify
+    XCTAssertEqual(1, [_queue count]);
+}
+
+- (void) testLastMonitorConfigurationWins {
+    // setup
+    ACPExtensionEvent *start = [self eventNamed:ACPPlacesMonitorEventNameStart_Test data:nil];
+    ACPExtensionEvent *continuous = [self eventNamed:ACPPlacesMonitorEventNameUpdateMonitorConfiguration_Test
+                                                data:@{ACPPlacesMonitorEventDataMonitorMode_Test:@(1)}];
+    ACPExtensionEvent *significant = [self eventNamed:ACPPlacesMonitorEventNameUpdateMonitorConfiguration_Test
+                                                 data:@{ACPPlacesMonitorEventDataMonitorMode_Test:@(2)}];
+
+    // test
+    [_queue add:continuous];
+    [_queue add:start];
+    [_queue add:significant];
+
+    // verify - the latest value keeps the position of the pending event
+    XCTAssertEqual(2, [_queue count]);
+    XCTAssertEqual(significant, [_queue poll]);
+    XCTAssertEqual(start, [_queue poll]);
+    XCTAssertEqual(1, _queue.coalescedEventCount);
+}
+
+- (void) testLastRequestAuthorizationLevelWins {
+    // setup
+    ACPExtensionEvent *whenInUse = [self eventNamed:ACPPlacesMonitorEventNameSetRequestAuthorizationLevel_Test
+                                               data:@{ACPPlacesMonitorEventDataRequestAuthorizationLevel_Test:@(1)}];
+    ACPExtensionEvent *always = [self eventNamed:ACPPlacesMonitorEventNameSetRequestAuthorizationLevel_Test
+                                            data:@{ACPPlacesMonitorEventDataRequestAuthorizationLevel_Test:@(0)}];
+
+    // test
+    [_queue add:whenInUse];
+    [_queue add:always];
+
+    // verify
+    XCTAssertEqual(1, [_queue count]);
+    XCTAssertEqual(always, [_queue peek]);
+}
+
+- (void) testStopCancelsPendingStart {
+    // setup
+    ACPExtensionEvent *updateLocation = [self eventNamed:ACPPlacesMonitorEventNameUpdateLocationNow_Test data:nil];
+    ACPExtensionEvent *stop = [self eventNamed:ACPPlacesMonitorEventNameStop_Test data:nil];
+
+    // test
+    [_queue add:[self eventNamed:ACPPlacesMonitorEventNameStart_Test data:nil]];
+    [_queue add:updateLocation];
+    [_queue add:stop];
+
+    // verify
+    XCTAssertEqual(2, [_queue count]);
+    XCTAssertEqual(updateLocation, [_queue poll]);
+    XCTAssertEqual(stop, [_queue poll]);
+    XCTAssertEqual(1, _queue.coalescedEventCount);
+}
+
+- (void) testStartAfterStopIsQueued {
+    // setup
+    ACPExtensionEvent *stop = [self eventNamed:ACPPlacesMonitorEventNameStop_Test data:nil];
+    ACPExtensionEvent *start = [self eventNamed:ACPPlacesMonitorEventNameStart_Test data:nil];
+
+    // test
+    [_queue add:stop];
+    [_queue add:start];
+
+    // verify
+    XCTAssertEqual(2, [_queue count]);
+    XCTAssertEqual(stop, [_queue poll]);
+    XCTAssertEqual(start, [_queue poll]);
 }
 
 @end
@@ -0,0 +1,136 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionClustersTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesRegionClusters.h"
+
+@interface ACPPlacesRegionClustersTests : XCTestCase
+@end
+
+@implementation ACPPlacesRegionClustersTests
+
+// creates a poi north of 40,-111, roughly metersAway from it
+- (ACPPlacesPoi*) poiWithIdentifier: (NSString*) identifier metersAway: (double) metersAway radius: (double) radius {
+    ACPPlacesPoi *poi = [[ACPPlacesPoi alloc] init];
+    poi.identifier = identifier;
+    poi.latitude = 40.0 + metersAway / 111320.0;
+    poi.longitude = -111.0;
+    poi.radius = radius;
+    return poi;
+}
+
+- (void) testOverlappingPoisShareARegion {
+    // setup
+    ACPPlacesPoi *a = [self poiWithIdentifier:@"a" metersAway:0 radius:20];
+    ACPPlacesPoi *b = [self poiWithIdentifier:@"b" metersAway:30 radius:20];
+    ACPPlacesPoi *c = [self poiWithIdentifier:@"c" metersAway:60 radius:20];
+
+    // test
+    ACPPlacesRegionClusters *clusters = [ACPPlacesRegionClusters clustersWithPois:@[a, b, c]
+                                                                   maximumRadius:ACPPlacesMonitorClusterMaximumRadius_Test];
+
+    // verify
+    XCTAssertEqual(1, clusters.regionPois.count);
+    XCTAssertEqual(2, clusters.savedSlots);
+    ACPPlacesPoi *clusterPoi = clusters.regionPois[0];
+    NSArray *expectedMembers = @[a, b, c];
+    XCTAssertEqualObjects(expectedMembers, [clusters membersOfClusterWithIdentifier:clusterPoi.identifier]);
+    XCTAssertTrue(clusterPoi.radius >= 50 && clusterPoi.radius <= 52);
+    XCTAssertEqualWithAccuracy(40.0 + 30 / 111320.0, clusterPoi.latitude, 1e-6);
+}
+
+- (void) testDistantPoisAreNotClustered {
+    // setup
+    ACPPlacesPoi *a = [self poiWithIdentifier:@"a" metersAway:0 radius:20];
+    ACPPlacesPoi *b = [self poiWithIdentifier:@"b" metersAway:500 radius:20];
+
+    // test
+    ACPPlacesRegionClusters *clusters = [ACPPlacesRegionClusters clustersWithPois:@[a, b]
+                                                                   maximumRadius:ACPPlacesMonitorClusterMaximumRadius_Test];
+
+    // verify
+    NSArray *expectedPois = @[a, b];
+    XCTAssertEqualObjects(expectedPois, clusters.regionPois);
+    XCTAssertEqual(0, clusters.savedSlots);
+    XCTAssertNil([clusters membersOfClusterWithIdentifier:@"a"]);
+}
+
+- (void) testClusterTakesThePlaceOfItsFirstMember {
+    // setup
+    ACPPlacesPoi *alone = [self poiWithIdentifier:@"alone" metersAway:-1000 radius:20];
+    ACPPlacesPoi *a = [self poiWithIdentifier:@"a" metersAway:0 radius:20];
+    ACPPlacesPoi *far = [self poiWithIdentifier:@"far" metersAway:1000 radius:20];
+    ACPPlacesPoi *b = [self poiWithIdentifier:@"b" metersAway:30 radius:20];
+
+    // test
+    ACPPlacesRegionClusters *clusters = [ACPPlacesRegionClusters clustersWithPois:@[alone, a, far, b]
+                                                                   maximumRadius:ACPPlacesMonitorClusterMaximumRadius_Test];
+
+    // verify
+    XCTAssertEqual(3, clusters.regionPois.count);
+    XCTAssertEqual(alone, clusters.regionPois[0]);
+    XCTAssertNotNil([clusters membersOfClusterWithIdentifier:clusters.regionPois[1].identifier]);
+    XCTAssertEqual(far, clusters.regionPois[2]);
+}
+
+- (void) testLargePoisAreNotClustered {
+    // setup
+    ACPPlacesPoi *a = [self poiWithIdentifier:@"a" metersAway:0 radius:300];
+    ACPPlacesPoi *b = [self poiWithIdentifier:@"b" metersAway:30 radius:20];
+
+    // test
+    ACPPlacesRegionClusters *clusters = [ACPPlacesRegionClusters clustersWithPois:@[a, b]
+                                                                   maximumRadius:ACPPlacesMonitorClusterMaximumRadius_Test];
+
+    // verify
+    XCTAssertEqual(2, clusters.regionPois.count);
+    XCTAssertEqual(0, clusters.savedSlots);
+}
+
+- (void) testNoMaximumRadiusDisablesClustering {
+    // setup
+    NSArray *pois = @[[self poiWithIdentifier:@"a" metersAway:0 radius:20],
+                      [self poiWithIdentifier:@"b" metersAway:30 radius:20]];
+
+    // test
+    ACPPlacesRegionClusters *clusters = [ACPPlacesRegionClusters clustersWithPois:pois maximumRadius:0];
+
+    // verify
+    XCTAssertEqualObjects(pois, clusters.regionPois);
+}
+
+- (void) testIsClusterRegion {
+    // setup
+    ACPPlacesRegionClusters *clusters = [ACPPlacesRegionClusters clustersWithPois:@[[self poiWithIdentifier:@"a" metersAway:0 radius:20],
+                                                                                    [self poiWithIdentifier:@"b" metersAway:30 radius:20]]
+                                                                   maximumRadius:ACPPlacesMonitorClusterMaximumRadius_Test];
+    CLCircularRegion *cluster = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(40, -111)
+                                                                  radius:50
+                                                              identifier:clusters.regionPois[0].identifier];
+    CLCircularRegion *poi = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(40, -111)
+                                                              radius:50
+                                                          identifier:@"a"];
+
+    // verify
+    XCTAssertTrue([ACPPlacesRegionClusters isClusterRegion:cluster]);
+    XCTAssertFalse([ACPPlacesRegionClusters isClusterRegion:poi]);
+}
+
+@end
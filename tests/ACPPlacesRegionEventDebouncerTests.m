@@ -0,0 +1,345 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionEventDebouncerTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlacesMetrics.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesRegionEventDebouncer.h"
+
+@interface ACPPlacesRegionEventDebouncerTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesRegionEventDebouncer *debouncer;
+@property (nonatomic) NSTimeInterval now;
+@property (nonatomic, strong) NSMutableArray<NSNumber*> *timerDelays;
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *timerBlocks;
+@property (nonatomic, strong) NSMutableArray<NSArray<ACPPlacesRegionEvent*>*> *batches;
+@property (nonatomic, strong) CLRegion *regionA;
+@property (nonatomic, strong) CLRegion *regionB;
+@property (nonatomic) NSUInteger startedTaskCount;
+@property (nonatomic, strong) NSMutableArray<NSNumber*> *endedTasks;
+@property (nonatomic, copy) dispatch_block_t expirationHandler;
+@end
+
+@implementation ACPPlacesRegionEventDebouncerTests
+
+- (void) setUp {
+    _now = 1000;
+    _timerDelays = [NSMutableArray array];
+    _timerBlocks = [NSMutableArray array];
+    _batches = [NSMutableArray array];
+    _endedTasks = [NSMutableArray array];
+    _regionA = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(12.34, 23.45) radius:100 identifier:@"a"];
+    _regionB = [[CLCircularRegion alloc] initWithCenter:CLLocationCoordinate2DMake(12.35, 23.45) radius:100 identifier:@"b"];
+
+    _debouncer = [[ACPPlacesRegionEventDebouncer alloc] initWithDwellTime:5];
+    [self setUpFakesForDebouncer:_debouncer];
+}
+
+// advances the fake clock to the last armed timer and fires it
+- (void) fireLastTimer {
+    _now += [_timerDelays.lastObject doubleValue];
+    _timerBlocks.lastObject();
+}
+
+- (void) testDefaults {
+    // test
+    ACPPlacesRegionEventDebouncer *debouncer = [[ACPPlacesRegionEventDebouncer alloc] init];
+
+    // verify
+    XCTAssertEqual(ACPPlacesMonitorRegionEventDwellTime_Test, debouncer.dwellTime);
+    XCTAssertEqual(0, debouncer.pendingCount);
+    XCTAssertEqual(0, debouncer.suppressedEventCount);
+    XCTAssertEqual(0, debouncer.flushCount);
+}
+
+- (void) testNegativeDwellTimeIsClamped {
+    // test
+    _debouncer.dwellTime = -1;
+
+    // verify
+    XCTAssertEqual(0, _debouncer.dwellTime);
+}
+
+- (void) testNoDwellTimeReportsImmediately {
+    // setup
+    _debouncer.dwellTime = 0;
+
+    // test
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // verify
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(_regionA, _batches[0][0].region);
+    XCTAssertEqual(ACPRegionEventTypeEntry, _batches[0][0].type);
+    XCTAssertEqual(0, _debouncer.pendingCount);
+    XCTAssertEqual(0, _timerBlocks.count);
+}
+
+- (void) testEventIsReportedAfterDwellTime {
+    // test
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // verify
+    XCTAssertEqual(0, _batches.count);
+    XCTAssertEqual(1, _debouncer.pendingCount);
+    XCTAssertEqualObjects(@(5), _timerDelays.lastObject);
+
+    [self fireLastTimer];
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(_regionA, _batches[0][0].region);
+    XCTAssertEqual(0, _debouncer.pendingCount);
+    XCTAssertEqual(1, _debouncer.flushCount);
+}
+
+- (void) testOppositeEventCancelsPendingEvent {
+    // test
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    _now += 2;
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeExit];
+
+    // verify
+    XCTAssertEqual(0, _debouncer.pendingCount);
+    XCTAssertEqual(2, _debouncer.suppressedEventCount);
+    [self fireLastTimer];
+    XCTAssertEqual(0, _batches.count);
+}
+
+- (void) testFlappingOnAFenceEdgeReportsOnlyTheSettledEvent {
+    // test - enter, exit, enter
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    _now += 1;
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeExit];
+    _now += 1;
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    _now += 5;
+    [_debouncer flush];
+
+    // verify
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(1, _batches[0].count);
+    XCTAssertEqual(ACPRegionEventTypeEntry, _batches[0][0].type);
+    XCTAssertEqual(2, _debouncer.suppressedEventCount);
+}
+
+- (void) testRepeatedEventIsDropped {
+    // test
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    _now += 3;
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // verify - the dwell time keeps running from the first event
+    XCTAssertEqual(1, _debouncer.pendingCount);
+    XCTAssertEqual(1, _debouncer.suppressedEventCount);
+    _now += 2;
+    [_debouncer flush];
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(1, _batches[0].count);
+}
+
+- (void) testSettledEventsAreBatchedInOrder {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeExit];
+    _now += 1;
+    [_debouncer addRegion:_regionB eventType:ACPRegionEventTypeEntry];
+
+    // test
+    _now += 10;
+    [_debouncer flush];
+
+    // verify
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(2, _batches[0].count);
+    XCTAssertEqual(_regionA, _batches[0][0].region);
+    XCTAssertEqual(ACPRegionEventTypeExit, _batches[0][0].type);
+    XCTAssertEqual(_regionB, _batches[0][1].region);
+    XCTAssertEqual(ACPRegionEventTypeEntry, _batches[0][1].type);
+}
+
+- (void) testTimerIsRearmedForLaterEvents {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    _now += 2;
+    [_debouncer addRegion:_regionB eventType:ACPRegionEventTypeEntry];
+    XCTAssertEqual(1, _timerBlocks.count);
+
+    // test
+    [self fireLastTimer];
+
+    // verify
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(_regionA, _batches[0][0].region);
+    XCTAssertEqual(2, _timerBlocks.count);
+    XCTAssertEqualObjects(@(2), _timerDelays.lastObject);
+
+    [self fireLastTimer];
+    XCTAssertEqual(2, _batches.count);
+    XCTAssertEqual(_regionB, _batches[1][0].region);
+}
+
+- (void) testDrainReportsPendingEvents {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // test
+    [_debouncer drain];
+
+    // verify
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(0, _debouncer.pendingCount);
+}
+
+- (void) testCancelDropsPendingEvents {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // test
+    [_debouncer cancel];
+
+    // verify
+    XCTAssertEqual(0, _debouncer.pendingCount);
+    [self fireLastTimer];
+    XCTAssertEqual(0, _batches.count);
+}
+
+- (void) testShorterDwellTimeSettlesPendingEvents {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    _now += 2;
+
+    // test
+    _debouncer.dwellTime = 1;
+
+    // verify
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(0, _debouncer.pendingCount);
+}
+
+- (void) testRetiredTimerIsIgnored {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    dispatch_block_t retiredTimer = _timerBlocks.lastObject;
+    [_debouncer cancel];
+    [_debouncer addRegion:_regionB eventType:ACPRegionEventTypeEntry];
+
+    // test
+    _now += 5;
+    retiredTimer();
+
+    // verify
+    XCTAssertEqual(0, _batches.count);
+    XCTAssertEqual(1, _debouncer.pendingCount);
+}
+
+- (void) testNilRegionIsIgnored {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wnonnull"
+    [_debouncer addRegion:nil eventType:ACPRegionEventTypeEntry];
+#pragma clang diagnostic pop
+
+    // verify
+    XCTAssertEqual(0, _debouncer.pendingCount);
+}
+
+- (void) testMetricsAreRecorded {
+    // setup
+    ACPPlacesMetrics *metrics = [[ACPPlacesMetrics alloc] init];
+    _debouncer.metrics = metrics;
+
+    // test
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeExit];
+    [_debouncer addRegion:_regionB eventType:ACPRegionEventTypeEntry];
+    [_debouncer addRegion:_regionB eventType:ACPRegionEventTypeEntry];
+    [_debouncer drain];
+
+    // verify
+    XCTAssertEqual(3, [metrics valueOfCounter:ACPPlacesMetricCounterSuppressedRegionEvents]);
+    XCTAssertEqual(1, [metrics valueOfCounter:ACPPlacesMetricCounterRegionEventBatches]);
+}
+
+- (void) testNoBackgroundTaskWithoutDwellTime {
+    // setup
+    _debouncer.dwellTime = 0;
+
+    // test
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // verify
+    XCTAssertEqual(0, _startedTaskCount);
+}
+
+- (void) testBackgroundTaskIsHeldWhileEventsArePending {
+    // test
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+    [_debouncer addRegion:_regionB eventType:ACPRegionEventTypeEntry];
+
+    // verify
+    XCTAssertEqual(1, _startedTaskCount);
+    XCTAssertEqual(0, _endedTasks.count);
+    [self fireLastTimer];
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqualObjects(@[@(1)], _endedTasks);
+}
+
+- (void) testCancelEndsBackgroundTask {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // test
+    [_debouncer cancel];
+
+    // verify
+    XCTAssertEqualObjects(@[@(1)], _endedTasks);
+}
+
+- (void) testExpiredBackgroundTaskDrainsPendingEvents {
+    // setup
+    [_debouncer addRegion:_regionA eventType:ACPRegionEventTypeEntry];
+
+    // test
+    _expirationHandler();
+
+    // verify
+    XCTAssertEqual(1, _batches.count);
+    XCTAssertEqual(_regionA, _batches[0][0].region);
+    XCTAssertEqual(0, _debouncer.pendingCount);
+    XCTAssertEqualObjects(@[@(1)], _endedTasks);
+}
+
+#pragma mark - helpers
+- (void) setUpFakesForDebouncer: (ACPPlacesRegionEventDebouncer*) debouncer {
+    __weak ACPPlacesRegionEventDebouncerTests *weakSelf = self;
+    debouncer.clock = ^NSTimeInterval {
+        return weakSelf.now;
+    };
+    debouncer.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {
+        [weakSelf.timerDelays addObject:@(delay)];
+        [weakSelf.timerBlocks addObject:block];
+    };
+    debouncer.flushHandler = ^(NSArray<ACPPlacesRegionEvent*> *events) {
+        [weakSelf.batches addObject:events];
+    };
+    debouncer.backgroundTaskStarter = ^UIBackgroundTaskIdentifier (dispatch_block_t expirationHandler) {
+        weakSelf.expirationHandler = expirationHandler;
+        return ++weakSelf.startedTaskCount;
+    };
+    debouncer.backgroundTaskEnder = ^(UIBackgroundTaskIdentifier task) {
+        [weakSelf.endedTasks addObject:@(task)];
+    };
+}
+
+@end
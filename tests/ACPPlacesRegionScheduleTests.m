@@ -0,0 +1,152 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRegionScheduleTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlaces.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesRegionSchedule.h"
+
+@interface ACPPlacesRegionScheduleTests : XCTestCase
+@property (nonatomic, strong) CLLocation *location;
+@end
+
+@implementation ACPPlacesRegionScheduleTests
+
+- (void) setUp {
+    _location = [[CLLocation alloc] initWithLatitude:40.0 longitude:-111.0];
+}
+
+// creates a poi north of the test location, roughly metersAway from it
+- (ACPPlacesPoi*) poiWithIdentifier: (NSString*) identifier metersAway: (double) metersAway radius: (double) radius {
+    ACPPlacesPoi *poi = [[ACPPlacesPoi alloc] init];
+    poi.identifier = identifier;
+    poi.latitude = 40.0 + metersAway / 111320.0;
+    poi.longitude = -111.0;
+    poi.radius = radius;
+    return poi;
+}
+
+- (void) testAllCandidatesFit {
+    // setup
+    NSArray *candidates = @[[self poiWithIdentifier:@"a" metersAway:1000 radius:100],
+                            [self poiWithIdentifier:@"b" metersAway:500 radius:100]];
+
+    // test
+    ACPPlacesRegionSchedule *schedule = [ACPPlacesRegionSchedule scheduleWithCandidates:candidates
+                                                                             atLocation:_location
+                                                                              slotCount:2
+                                                                          maximumRadius:1000];
+
+    // verify
+    XCTAssertEqualObjects(candidates, schedule.selectedPois);
+    XCTAssertNil(schedule.boundaryRegion);
+    XCTAssertEqual(0, schedule.deferredCount);
+}
+
+- (void) testRanksByEdgeDistance {
+    // setup - "big" has the farthest center but the closest edge
+    ACPPlacesPoi *near = [self poiWithIdentifier:@"near" metersAway:600 radius:100];
+    ACPPlacesPoi *big = [self poiWithIdentifier:@"big" metersAway:900 radius:800];
+    ACPPlacesPoi *far = [self poiWithIdentifier:@"far" metersAway:2000 radius:100];
+    ACPPlacesPoi *farther = [self poiWithIdentifier:@"farther" metersAway:3000 radius:100];
+
+    // test
+    ACPPlacesRegionSchedule *schedule = [ACPPlacesRegionSchedule scheduleWithCandidates:@[farther, far, near, big]
+                                                                             atLocation:_location
+                                                                              slotCount:3
+                                                                          maximumRadius:10000];
+
+    // verify
+    XCTAssertEqual(2, schedule.selectedPois.count);
+    XCTAssertEqual(big, schedule.selectedPois[0]);
+    XCTAssertEqual(near, schedule.selectedPois[1]);
+    XCTAssertEqual(2, schedule.deferredCount);
+}
+
+- (void) testBoundaryReachesClosestDeferredCandidate {
+    // setup
+    NSArray *candidates = @[[self poiWithIdentifier:@"a" metersAway:500 radius:100],
+                            [self poiWithIdentifier:@"b" metersAway:2000 radius:100],
+                            [self poiWithIdentifier:@"c" metersAway:3000 radius:100]];
+
+    // test
+    ACPPlacesRegionSchedule *schedule = [ACPPlacesRegionSchedule scheduleWithCandidates:candidates
+                                                                             atLocation:_location
+                                                                              slotCount:2
+                                                                          maximumRadius:10000];
+
+    // verify
+    CLCircularRegion *boundary = schedule.boundaryRegion;
+    XCTAssertNotNil(boundary);
+    XCTAssertEqualObjects(ACPPlacesMonitorBoundaryRegionIdentifier_Test, boundary.identifier);
+    XCTAssertEqualWithAccuracy(1900, boundary.radius, 5);
+    XCTAssertEqualWithAccuracy(40.0, boundary.center.latitude, 0.000001);
+    XCTAssertTrue(boundary.notifyOnExit);
+    XCTAssertFalse(boundary.notifyOnEntry);
+}
+
+- (void) testBoundaryRadiusIsClamped {
+    // setup
+    NSArray *candidates = @[[self poiWithIdentifier:@"a" metersAway:10 radius:100],
+                            [self poiWithIdentifier:@"b" metersAway:20 radius:100],
+                            [self poiWithIdentifier:@"c" metersAway:5000 radius:100]];
+
+    // test
+    ACPPlacesRegionSchedule *small = [ACPPlacesRegionSchedule scheduleWithCandidates:candidates
+                                                                          atLocation:_location
+                                                                           slotCount:2
+                                                                       maximumRadius:10000];
+    ACPPlacesRegionSchedule *large = [ACPPlacesRegionSchedule scheduleWithCandidates:candidates
+                                                                          atLocation:_location
+                                                                           slotCount:3
+                                                                       maximumRadius:1000];
+
+    // verify - the device is inside "b" so its edge distance is negative
+    XCTAssertEqual(ACPPlacesMonitorBoundaryMinimumRadius_Test, small.boundaryRegion.radius);
+    XCTAssertEqual(1000, large.boundaryRegion.radius);
+}
+
+- (void) testSingleSlotHasNoBoundary {
+    // setup
+    NSArray *candidates = @[[self poiWithIdentifier:@"a" metersAway:500 radius:100],
+                            [self poiWithIdentifier:@"b" metersAway:2000 radius:100]];
+
+    // test
+    ACPPlacesRegionSchedule *schedule = [ACPPlacesRegionSchedule scheduleWithCandidates:candidates
+                                                                             atLocation:_location
+                                                                              slotCount:1
+                                                                          maximumRadius:10000];
+
+    // verify
+    XCTAssertEqual(1, schedule.selectedPois.count);
+    XCTAssertNil(schedule.boundaryRegion);
+    XCTAssertEqual(1, schedule.deferredCount);
+}
+
+- (void) testIsBoundaryRegion {
+    CLCircularRegion *boundary = [[CLCircularRegion alloc] initWithCenter:_location.coordinate
+                                                                   radius:100
+                                                               identifier:ACPPlacesMonitorBoundaryRegionIdentifier_Test];
+    CLCircularRegion *poiRegion = [[CLCircularRegion alloc] initWithCenter:_location.coordinate
+                                                                    radius:100
+                                                                identifier:@"poi"];
+    XCTAssertTrue([ACPPlacesRegionSchedule isBoundaryRegion:boundary]);
+    XCTAssertFalse([ACPPlacesRegionSchedule isBoundaryRegion:poiRegion]);
+}
+
+@end
@@ -0,0 +1,358 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRetrySchedulerTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesRetryScheduler.h"
+
+@interface ACPPlacesRetrySchedulerTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesRetryScheduler *scheduler;
+@property (nonatomic) NSTimeInterval now;
+@property (nonatomic) double random;
+@property (nonatomic) BOOL reachable;
+@property (nonatomic, strong) NSMutableArray<NSNumber*> *timerDelays;
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *timerBlocks;
+@property (nonatomic, strong) NSMutableArray<CLLocation*> *replayedLocations;
+@end
+
+@implementation ACPPlacesRetrySchedulerTests
+
+- (void) setUp {
+    _now = 1000;
+    _random = 0;
+    _reachable = YES;
+    _timerDelays = [NSMutableArray array];
+    _timerBlocks = [NSMutableArray array];
+    _replayedLocations = [NSMutableArray array];
+
+    _scheduler = [[ACPPlacesRetryScheduler alloc] initWithBaseDelay:2
+                                                       maximumDelay:60
+                                                    maximumAttempts:3
+                                                   failureThreshold:2
+                                                       openDuration:600];
+
+    [self setUpFakesForScheduler:_scheduler];
+}
+
+- (CLLocation*) locationWithLatitude: (double) latitude age: (NSTimeInterval) age {
+    return [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(latitude, 23.45)
+                                         altitude:0
+                               horizontalAccuracy:5
+                                 verticalAccuracy:-1
+                                        timestamp:[NSDate dateWithTimeIntervalSinceNow:-age]];
+}
+
+// advances the fake clock to the last armed timer and fires it
+- (void) fireLastTimer {
+    _now += [_timerDelays.lastObject doubleValue];
+    _timerBlocks.lastObject();
+}
+
+- (void) testDefaults {
+    // test
+    ACPPlacesRetryScheduler *scheduler = [[ACPPlacesRetryScheduler alloc] init];
+
+    // verify
+    XCTAssertEqual(ACPPlacesMonitorRetryBaseDelay_Test, scheduler.baseDelay);
+    XCTAssertEqual(ACPPlacesMonitorRetryMaximumDelay_Test, scheduler.maximumDelay);
+    XCTAssertEqual(ACPPlacesMonitorRetryMaximumAttempts_Test, scheduler.maximumAttempts);
+    XCTAssertEqual(ACPPlacesMonitorCircuitBreakerFailureThreshold_Test, scheduler.failureThreshold);
+    XCTAssertEqual(ACPPlacesMonitorCircuitBreakerOpenDuration_Test, scheduler.openDuration);
+    XCTAssertEqual(ACPPlacesCircuitStateClosed, scheduler.circuitState);
+}
+
+- (void) testBackoffIsExponentialAndCapped {
+    XCTAssertEqual(2, [_scheduler backoffForAttempt:0]);
+    XCTAssertEqual(4, [_scheduler backoffForAttempt:1]);
+    XCTAssertEqual(32, [_scheduler backoffForAttempt:4]);
+    XCTAssertEqual(60, [_scheduler backoffForAttempt:5]);
+    XCTAssertEqual(60, [_scheduler backoffForAttempt:1000]);
+}
+
+- (void) testNothingIsDeferredWithoutFailures {
+    XCTAssertFalse([_scheduler shouldDeferLocation:[self locationWithLatitude:1 age:0]]);
+    XCTAssertEqual(0, _timerBlocks.count);
+}
+
+- (void) testFailureSchedulesJitteredRetry {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    _random = 0.5;
+
+    // test
+    [_scheduler recordFailureForLocation:location];
+
+    // verify - half of the backoff is fixed, half is scaled by the random value
+    XCTAssertEqual(1, _timerDelays.count);
+    XCTAssertEqualWithAccuracy(1.5, [_timerDelays[0] doubleValue], 0.0001);
+    XCTAssertEqual(location, _scheduler.pendingLocation);
+}
+
+- (void) testRetryReplaysLocation {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    [_scheduler recordFailureForLocation:location];
+
+    // test
+    [self fireLastTimer];
+
+    // verify
+    XCTAssertEqualObjects(@[location], _replayedLocations);
+    XCTAssertEqual(1, _scheduler.attempt);
+    XCTAssertNil(_scheduler.pendingLocation);
+}
+
+- (void) testOnlyLatestLocationIsReplayed {
+    // setup
+    CLLocation *latest = [self locationWithLatitude:3 age:0];
+    [_scheduler recordFailureForLocation:[self locationWithLatitude:1 age:10]];
+
+    // test
+    XCTAssertTrue([_scheduler shouldDeferLocation:[self locationWithLatitude:2 age:5]]);
+    XCTAssertTrue([_scheduler shouldDeferLocation:latest]);
+    [self fireLastTimer];
+
+    // verify
+    XCTAssertEqualObjects(@[latest], _replayedLocations);
+    XCTAssertEqual(1, _timerBlocks.count);
+}
+
+- (void) testOlderFailureDoesNotReplaceNewerLocation {
+    // setup
+    CLLocation *newer = [self locationWithLatitude:2 age:0];
+    [_scheduler recordFailureForLocation:newer];
+
+    // test
+    [_scheduler recordFailureForLocation:[self locationWithLatitude:1 age:30]];
+
+    // verify
+    XCTAssertEqual(newer, _scheduler.pendingLocation);
+}
+
+- (void) testBackoffGrowsWithEachAttempt {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    _scheduler = [[ACPPlacesRetryScheduler alloc] initWithBaseDelay:2 maximumDelay:60 maximumAttempts:3
+                                                   failureThreshold:100 openDuration:600];
+    [self setUpFakesForScheduler:_scheduler];
+
+    // test
+    [_scheduler recordFailureForLocation:location];
+    [self fireLastTimer];
+    [_scheduler recordFailureForLocation:location];
+    [self fireLastTimer];
+    [_scheduler recordFailureForLocation:location];
+
+    // verify
+    NSArray *expected = @[@(1), @(2), @(4)];
+    XCTAssertEqualObjects(expected, _timerDelays);
+}
+
+- (void) testGivesUpAfterMaximumAttempts {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    _scheduler = [[ACPPlacesRetryScheduler alloc] initWithBaseDelay:2 maximumDelay:60 maximumAttempts:2
+                                                   failureThreshold:100 openDuration:600];
+    [self setUpFakesForScheduler:_scheduler];
+
+    // test
+    for (int i = 0; i < 2; i++) {
+        [_scheduler recordFailureForLocation:location];
+        [self fireLastTimer];
+    }
+    [_scheduler recordFailureForLocation:location];
+
+    // verify
+    XCTAssertEqual(2, _replayedLocations.count);
+    XCTAssertEqual(1, _scheduler.abandonedCount);
+    XCTAssertNil(_scheduler.pendingLocation);
+    XCTAssertFalse([_scheduler shouldDeferLocation:location]);
+}
+
+- (void) testUnreachableNetworkPostponesWithoutUsingAttempt {
+    // setup
+    [_scheduler recordFailureForLocation:[self locationWithLatitude:1 age:0]];
+    _reachable = NO;
+
+    // test
+    [self fireLastTimer];
+
+    // verify
+    XCTAssertEqual(0, _replayedLocations.count);
+    XCTAssertEqual(0, _scheduler.attempt);
+    XCTAssertEqual(2, _timerBlocks.count);
+
+    // connectivity returns
+    _reachable = YES;
+    [self fireLastTimer];
+    XCTAssertEqual(1, _replayedLocations.count);
+}
+
+- (void) testUnreachableNetworkBacksOffUpToMaximumDelay {
+    // setup
+    [_scheduler recordFailureForLocation:[self locationWithLatitude:1 age:0]];
+    _reachable = NO;
+
+    // test
+    for (int i = 0; i < 6; i++) {
+        [self fireLastTimer];
+    }
+
+    // verify
+    NSArray *expected = @[@(1), @(2), @(4), @(8), @(16), @(30), @(30)];
+    XCTAssertEqualObjects(expected, _timerDelays);
+    XCTAssertEqual(0, _scheduler.attempt);
+    XCTAssertEqual(0, _replayedLocations.count);
+}
+
+- (void) testReachabilityChangeRetriesPostponedRequestRightAway {
+    // setup
+    [_scheduler recordFailureForLocation:[self locationWithLatitude:1 age:0]];
+    _reachable = NO;
+    [self fireLastTimer];
+    _reachable = YES;
+
+    // test
+    [_scheduler networkReachabilityDidChange];
+
+    // verify
+    XCTAssertEqualObjects(@(0), _timerDelays.lastObject);
+    [self fireLastTimer];
+    XCTAssertEqual(1, _replayedLocations.count);
+    XCTAssertEqual(1, _scheduler.attempt);
+
+    // the stale offline timer no longer fires
+    _timerBlocks[1]();
+    XCTAssertEqual(1, _replayedLocations.count);
+}
+
+- (void) testReachabilityChangeLeavesFailureBackoffAlone {
+    // setup
+    [_scheduler recordFailureForLocation:[self locationWithLatitude:1 age:0]];
+
+    // test
+    [_scheduler networkReachabilityDidChange];
+
+    // verify
+    XCTAssertEqual(1, _timerBlocks.count);
+    XCTAssertEqual(0, _replayedLocations.count);
+}
+
+- (void) testCircuitOpensAfterConsecutiveFailures {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    [_scheduler recordFailureForLocation:location];
+    [self fireLastTimer];
+
+    // test
+    [_scheduler recordFailureForLocation:location];
+
+    // verify - the retry waits for the circuit to half-open
+    XCTAssertEqual(ACPPlacesCircuitStateOpen, _scheduler.circuitState);
+    XCTAssertEqualWithAccuracy(600, [_timerDelays.lastObject doubleValue], 0.0001);
+    XCTAssertTrue([_scheduler shouldDeferLocation:location]);
+}
+
+- (void) testHalfOpenProbeSuccessClosesCircuit {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    [_scheduler recordFailureForLocation:location];
+    [self fireLastTimer];
+    [_scheduler recordFailureForLocation:location];
+
+    // test
+    [self fireLastTimer];
+    XCTAssertEqual(ACPPlacesCircuitStateHalfOpen, _scheduler.circuitState);
+    [_scheduler recordSuccess];
+
+    // verify
+    XCTAssertEqual(ACPPlacesCircuitStateClosed, _scheduler.circuitState);
+    XCTAssertEqual(0, _scheduler.attempt);
+    XCTAssertFalse([_scheduler shouldDeferLocation:location]);
+}
+
+- (void) testHalfOpenProbeFailureReopensCircuit {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    [_scheduler recordFailureForLocation:location];
+    [self fireLastTimer];
+    [_scheduler recordFailureForLocation:location];
+    [self fireLastTimer];
+
+    // test
+    [_scheduler recordFailureForLocation:location];
+
+    // verify
+    XCTAssertEqual(ACPPlacesCircuitStateOpen, _scheduler.circuitState);
+    XCTAssertEqualWithAccuracy(600, [_timerDelays.lastObject doubleValue], 0.0001);
+}
+
+- (void) testOpenCircuitLetsProbeThroughAfterOpenDuration {
+    // setup
+    CLLocation *location = [self locationWithLatitude:1 age:0];
+    _scheduler = [[ACPPlacesRetryScheduler alloc] initWithBaseDelay:2 maximumDelay:60 maximumAttempts:0
+                                                   failureThreshold:1 openDuration:600];
+    [self setUpFakesForScheduler:_scheduler];
+    [_scheduler recordFailureForLocation:location];
+    XCTAssertTrue([_scheduler shouldDeferLocation:location]);
+
+    // test
+    _now += 600;
+    _timerBlocks.lastObject();
+
+    // verify - the deferred location is replayed as the probe
+    XCTAssertEqual(1, _replayedLocations.count);
+    XCTAssertEqual(ACPPlacesCircuitStateHalfOpen, _scheduler.circuitState);
+}
+
+- (void) testCancelDropsPendingRetry {
+    // setup
+    [_scheduler recordFailureForLocation:[self locationWithLatitude:1 age:0]];
+
+    // test
+    [_scheduler cancel];
+    [self fireLastTimer];
+
+    // verify
+    XCTAssertEqual(0, _replayedLocations.count);
+    XCTAssertNil(_scheduler.pendingLocation);
+}
+
+#pragma mark - helpers
+// a fake clock and timer, timers only fire when the test says so
+- (void) setUpFakesForScheduler: (ACPPlacesRetryScheduler*) scheduler {
+    __weak ACPPlacesRetrySchedulerTests *weakSelf = self;
+    scheduler.clock = ^NSTimeInterval {
+        return weakSelf.now;
+    };
+    scheduler.dispatcher = ^(NSTimeInterval delay, dispatch_block_t block) {
+        [weakSelf.timerDelays addObject:@(delay)];
+        [weakSelf.timerBlocks addObject:block];
+    };
+    scheduler.randomSource = ^double {
+        return weakSelf.random;
+    };
+    scheduler.networkReachable = ^BOOL {
+        return weakSelf.reachable;
+    };
+    scheduler.replayHandler = ^(CLLocation *location) {
+        [weakSelf.replayedLocations addObject:location];
+    };
+}
+
+@end
@@ -0,0 +1,138 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesSerialExecutorTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesSerialExecutor.h"
+
+@interface ACPPlacesSerialExecutorTests : XCTestCase
+@property (nonatomic, strong) ACPPlacesSerialExecutor *executor;
+@end
+
+@implementation ACPPlacesSerialExecutorTests
+
+- (void) setUp {
+    _executor = [[ACPPlacesSerialExecutor alloc] init];
+}
+
+- (void) testInit {
+    XCTAssertEqualObjects(ACPPlacesMonitorExecutorLabel_Test, _executor.label);
+    XCTAssertFalse(_executor.isCurrent);
+}
+
+- (void) testBlocksRunInSubmissionOrder {
+    // setup
+    NSMutableArray<NSNumber*> *order = [NSMutableArray array];
+
+    // test
+    for (int i = 0; i < 100; i++) {
+        [_executor execute:^{
+            [order addObject:@(i)];
+        }];
+    }
+    [_executor executeAndWait:^{}];
+
+    // verify
+    XCTAssertEqual(100, order.count);
+    for (int i = 0; i < 100; i++) {
+        XCTAssertEqualObjects(@(i), order[i]);
+    }
+}
+
+- (void) testIsCurrentOnlyOnExecutor {
+    // setup
+    __block BOOL isCurrent = NO;
+    __block BOOL otherIsCurrent = YES;
+    ACPPlacesSerialExecutor *other = [[ACPPlacesSerialExecutor alloc] initWithLabel:@"other"];
+
+    // test
+    [_executor executeAndWait:^{
+        isCurrent = self.executor.isCurrent;
+        otherIsCurrent = other.isCurrent;
+    }];
+
+    // verify
+    XCTAssertTrue(isCurrent);
+    XCTAssertFalse(otherIsCurrent);
+    XCTAssertEqualObjects(@"other", other.label);
+}
+
+- (void) testExecuteFromExecutorRunsRightAway {
+    // setup
+    NSMutableArray<NSString*> *order = [NSMutableArray array];
+
+    // test
+    [_executor executeAndWait:^{
+        [self.executor execute:^{
+            [order addObject:@"inner"];
+        }];
+        [order addObject:@"outer"];
+    }];
+
+    // verify
+    NSArray *expected = @[@"inner", @"outer"];
+    XCTAssertEqualObjects(expected, order);
+}
+
+- (void) testExecuteAndWaitFromExecutorDoesNotDeadlock {
+    // setup
+    __block BOOL ran = NO;
+
+    // test
+    [_executor executeAndWait:^{
+        [self.executor executeAndWait:^{
+            ran = YES;
+        }];
+    }];
+
+    // verify
+    XCTAssertTrue(ran);
+}
+
+- (void) testConcurrentSubmissionsAreSerialized {
+    // setup - the counter is not atomic, lost updates would show up as a smaller total
+    __block NSUInteger counter = 0;
+
+    // test
+    dispatch_apply(1000, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        [self.executor execute:^{
+            counter++;
+        }];
+    });
+    [_executor executeAndWait:^{}];
+
+    // verify
+    XCTAssertEqual(1000, counter);
+}
+
+- (void) testExecuteAfterDelay {
+    // setup
+    XCTestExpectation *expectation = [self expectationWithDescription:@"delayed block ran"];
+    __block BOOL isCurrent = NO;
+
+    // test
+    [_executor execute:^{
+        isCurrent = self.executor.isCurrent;
+        [expectation fulfill];
+    } afterDelay:0.1];
+
+    // verify
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertTrue(isCurrent);
+}
+
+@end
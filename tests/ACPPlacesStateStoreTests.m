@@ -0,0 +1,169 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesStateStoreTests.m
+//
+
+#import <XCTest/XCTest.h>
+#import <Foundation/Foundation.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesStateStore.h"
+
+static NSString* const ACPPlacesStateStoreTestsSuite = @"com.adobe.placesmonitor.statestoretests";
+
+@interface ACPPlacesStateStoreTests : XCTestCase
+@property (nonatomic, strong) NSURL *fileURL;
+@property (nonatomic, strong) ACPPlacesStateStore *store;
+@property (nonatomic, strong) NSUserDefaults *defaults;
+@end
+
+@implementation ACPPlacesStateStoreTests
+
+- (void) setUp {
+    NSURL *directory = [NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES];
+    _fileURL = [[directory URLByAppendingPathComponent:[NSUUID UUID].UUIDString isDirectory:YES]
+                URLByAppendingPathComponent:ACPPlacesMonitorStateFileName_Test];
+    _store = [[ACPPlacesStateStore alloc] initWithFileURL:_fileURL];
+    _defaults = [[NSUserDefaults alloc] initWithSuiteName:ACPPlacesStateStoreTestsSuite];
+}
+
+- (void) tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:[_fileURL URLByDeletingLastPathComponent] error:nil];
+    [_defaults removePersistentDomainForName:ACPPlacesStateStoreTestsSuite];
+}
+
+- (void) testDefaultLocation {
+    // test
+    ACPPlacesStateStore *store = [[ACPPlacesStateStore alloc] init];
+
+    // verify
+    XCTAssertEqualObjects(ACPPlacesMonitorStateFileName_Test, store.fileURL.lastPathComponent);
+    XCTAssertEqualObjects(ACPPlacesMonitorStateDirectoryName_Test,
+                          [store.fileURL URLByDeletingLastPathComponent].lastPathComponent);
+}
+
+- (void) testLoadWithoutFile {
+    XCTAssertNil([_store load]);
+}
+
+- (void) testWriteAndLoad {
+    // setup
+    CLLocation *location = [[CLLocation alloc] initWithCoordinate:CLLocationCoordinate2DMake(12.34, 23.45)
+                                                         altitude:0
+                                               horizontalAccuracy:15
+                                                 verticalAccuracy:-1
+                                                        timestamp:[NSDate dateWithTimeIntervalSince1970:1500000000]];
+    NSDictionary *values = @{ACPPlacesMonitorDefaultsMonitoredRegions_Test: @[@"a", @"b"],
+                             ACPPlacesMonitorDefaultsUserWithinRegions_Test: @[@"a"],
+                             ACPPlacesMonitorDefaultsMonitorMode_Test: @(2),
+                             ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test: @(1),
+                             ACPPlacesMonitorDefaultsIsMonitoringStarted_Test: @(YES),
+                             ACPPlacesMonitorStateLastQueryLocation_Test: location};
+
+    // test
+    XCTAssertTrue([_store writeValues:values]);
+    NSDictionary *loaded = [[[ACPPlacesStateStore alloc] initWithFileURL:_fileURL] load];
+
+    // verify
+    XCTAssertEqualObjects(values[ACPPlacesMonitorDefaultsMonitoredRegions_Test], loaded[ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertEqualObjects(values[ACPPlacesMonitorDefaultsUserWithinRegions_Test], loaded[ACPPlacesMonitorDefaultsUserWithinRegions_Test]);
+    XCTAssertEqualObjects(@(2), loaded[ACPPlacesMonitorDefaultsMonitorMode_Test]);
+    XCTAssertEqualObjects(@(1), loaded[ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test]);
+    XCTAssertTrue([loaded[ACPPlacesMonitorDefaultsIsMonitoringStarted_Test] boolValue]);
+    CLLocation *loadedLocation = loaded[ACPPlacesMonitorStateLastQueryLocation_Test];
+    XCTAssertEqual(12.34, loadedLocation.coordinate.latitude);
+    XCTAssertEqual(23.45, loadedLocation.coordinate.longitude);
+    XCTAssertEqual(15, loadedLocation.horizontalAccuracy);
+    XCTAssertEqualObjects(location.timestamp, loadedLocation.timestamp);
+}
+
+- (void) testMissingValuesAreNotLoaded {
+    // test
+    XCTAssertTrue([_store writeValues:@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(1)}]);
+
+    // verify
+    XCTAssertEqualObjects(@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(1)}, [_store load]);
+}
+
+- (void) testUnknownKeysAreIgnored {
+    // test
+    XCTAssertTrue([_store writeValues:@{@"unknown": @"value"}]);
+
+    // verify
+    XCTAssertEqualObjects(@{}, [_store load]);
+}
+
+- (void) testCorruptFileIsMovedAside {
+    // setup
+    XCTAssertTrue([_store writeValues:@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(1)}]);
+    NSMutableData *data = [NSMutableData dataWithContentsOfURL:_fileURL];
+    ((uint8_t*)data.mutableBytes)[data.length - 1] ^= 0xFF;
+    [data writeToURL:_fileURL atomically:YES];
+
+    // test
+    NSDictionary *values = [_store load];
+
+    // verify - the corrupt file is kept, and a second load finds no file
+    XCTAssertEqualObjects(@{}, values);
+    XCTAssertEqualObjects(data, [NSData dataWithContentsOfURL:_store.backupURL]);
+    XCTAssertNil([_store load]);
+}
+
+- (void) testMigrateFromUserDefaults {
+    // setup
+    [_defaults setObject:@[@"a"] forKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
+    [_defaults setInteger:1 forKey:ACPPlacesMonitorDefaultsMonitorMode_Test];
+    [_defaults setObject:@"unrelated" forKey:@"unrelated"];
+
+    // test
+    NSDictionary *values = [_store migrateFromUserDefaults:_defaults];
+
+    // verify
+    XCTAssertEqualObjects(@[@"a"], values[ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertEqualObjects(@(1), values[ACPPlacesMonitorDefaultsMonitorMode_Test]);
+    XCTAssertEqualObjects(@[@"a"], [_store load][ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertNil([_defaults objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertNil([_defaults objectForKey:ACPPlacesMonitorDefaultsMonitorMode_Test]);
+    XCTAssertEqualObjects(@"unrelated", [_defaults objectForKey:@"unrelated"]);
+}
+
+- (void) testFailedMigrationKeepsUserDefaults {
+    // setup - a file where the state directory should be
+    NSURL *blocker = [NSURL fileURLWithPath:NSTemporaryDirectory()];
+    blocker = [blocker URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    [[NSData data] writeToURL:blocker atomically:YES];
+    ACPPlacesStateStore *store = [[ACPPlacesStateStore alloc] initWithFileURL:[blocker URLByAppendingPathComponent:@"state.bin"]];
+    [_defaults setObject:@[@"a"] forKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test];
+
+    // test
+    NSDictionary *values = [store migrateFromUserDefaults:_defaults];
+
+    // verify
+    XCTAssertEqualObjects(@[@"a"], values[ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    XCTAssertEqualObjects(@[@"a"], [_defaults objectForKey:ACPPlacesMonitorDefaultsMonitoredRegions_Test]);
+    [[NSFileManager defaultManager] removeItemAtURL:blocker error:nil];
+}
+
+- (void) testRemove {
+    // setup
+    XCTAssertTrue([_store writeValues:@{ACPPlacesMonitorDefaultsMonitorMode_Test: @(1)}]);
+
+    // test
+    [_store remove];
+
+    // verify
+    XCTAssertNil([_store load]);
+}
+
+@end
@@ -0,0 +1,67 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesLocalPoiService.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+#import "ACPPlaces.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @class ACPPlacesLocalPoiService
+ *
+ * @discussion A deterministic stand-in for the Places Query Service and the Places extension.
+ *
+ * Nearby POI queries are answered from a fixed POI library, nearest first, with userIsWithin computed from the query
+ * location.  Region events sent to Places are recorded along with the simulated time they were received.
+ */
+@interface ACPPlacesLocalPoiService : NSObject
+
+@property(nonatomic, readonly) NSArray<ACPPlacesPoi*>* pois;
+@property(nonatomic, readonly) NSUInteger queryCount;
+
+/**
+ * @brief Entry and exit events as dictionaries with identifier, type (ACPRegionEventType) and time keys
+ */
+@property(nonatomic, readonly) NSArray<NSDictionary*>* regionEvents;
+
+/**
+ * @brief Returns the simulated time in seconds since 1970
+ */
+@property(nonatomic, copy) NSTimeInterval (^clock)(void);
+
+- (instancetype) initWithPois: (NSArray<ACPPlacesPoi*>*) pois;
+
+/**
+ * @brief Answers a nearby POI query with copies of the closest POIs
+ */
+- (NSArray<ACPPlacesPoi*>*) nearbyPoisForLocation: (CLLocation*) location limit: (NSUInteger) limit;
+
+/**
+ * @brief Records a region event reported to Places
+ */
+- (void) recordRegionEvent: (CLRegion*) region type: (ACPRegionEventType) type;
+
+/**
+ * @brief Makes the ACPPlaces class methods used by the monitor talk to this service
+ *
+ * @param placesMock an OCMock class mock of ACPPlaces
+ */
+- (void) installOnPlacesMock: (id) placesMock;
+
+@end
+
+NS_ASSUME_NONNULL_END
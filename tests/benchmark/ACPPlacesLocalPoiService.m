@@ -0,0 +1,116 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesLocalPoiService.m
+//
+
+#import "OCMock.h"
+#import "ACPPlacesLocalPoiService.h"
+
+@interface ACPPlacesLocalPoiService()
+@property(nonatomic, readwrite) NSArray<ACPPlacesPoi*>* pois;
+@property(nonatomic, readwrite) NSUInteger queryCount;
+@property(nonatomic, strong) NSMutableArray<NSDictionary*>* recordedEvents;
+@end
+
+@implementation ACPPlacesLocalPoiService
+
+- (instancetype) initWithPois: (NSArray<ACPPlacesPoi*>*) pois {
+    if (self = [super init]) {
+        self.pois = pois;
+        self.recordedEvents = [NSMutableArray array];
+        self.clock = ^NSTimeInterval {
+            return [[NSDate date] timeIntervalSince1970];
+        };
+    }
+
+    return self;
+}
+
+- (NSArray<NSDictionary*>*) regionEvents {
+    return [_recordedEvents copy];
+}
+
+- (NSArray<ACPPlacesPoi*>*) nearbyPoisForLocation: (CLLocation*) location limit: (NSUInteger) limit {
+    _queryCount++;
+
+    NSMutableArray<NSNumber*>* distances = [NSMutableArray arrayWithCapacity:_pois.count];
+
+    for (ACPPlacesPoi* poi in _pois) {
+        CLLocation* center = [[CLLocation alloc] initWithLatitude:poi.latitude longitude:poi.longitude];
+        [distances addObject:@([location distanceFromLocation:center])];
+    }
+
+    // sort indexes rather than POIs so ties always resolve by library order
+    NSMutableArray<NSNumber*>* order = [NSMutableArray arrayWithCapacity:_pois.count];
+
+    for (NSUInteger i = 0; i < _pois.count; i++) {
+        [order addObject:@(i)];
+    }
+
+    [order sortUsingComparator:^NSComparisonResult(NSNumber* a, NSNumber* b) {
+        NSComparisonResult result = [distances[a.unsignedIntegerValue] compare:distances[b.unsignedIntegerValue]];
+        return result != NSOrderedSame ? result : [a compare:b];
+    }];
+
+    NSMutableArray<ACPPlacesPoi*>* nearby = [NSMutableArray array];
+
+    for (NSNumber* index in order) {
+        if (nearby.count == limit) {
+            break;
+        }
+
+        // the monitor may clamp radii, so every response gets fresh objects
+        ACPPlacesPoi* source = _pois[index.unsignedIntegerValue];
+        ACPPlacesPoi* poi = [[ACPPlacesPoi alloc] init];
+        poi.identifier = source.identifier;
+        poi.name = source.name;
+        poi.latitude = source.latitude;
+        poi.longitude = source.longitude;
+        poi.radius = source.radius;
+        poi.userIsWithin = [distances[index.unsignedIntegerValue] doubleValue] <= source.radius;
+        [nearby addObject:poi];
+    }
+
+    return nearby;
+}
+
+- (void) recordRegionEvent: (CLRegion*) region type: (ACPRegionEventType) type {
+    [_recordedEvents addObject:@{@"identifier": region.identifier, @"type": @(type), @"time": @(_clock())}];
+}
+
+- (void) installOnPlacesMock: (id) placesMock {
+    __weak ACPPlacesLocalPoiService* weakSelf = self;
+    OCMStub([placesMock getNearbyPointsOfInterest:[OCMArg any]
+                                            limit:0
+                                         callback:[OCMArg any]
+                                    errorCallback:[OCMArg any]]).ignoringNonObjectArgs().andDo(^(NSInvocation* invocation) {
+        __unsafe_unretained CLLocation* location;
+        NSUInteger limit;
+        void (^callback)(NSArray<ACPPlacesPoi*>* _Nullable nearbyPoi);
+        [invocation getArgument:&location atIndex:2];
+        [invocation getArgument:&limit atIndex:3];
+        [invocation getArgument:&callback atIndex:4];
+        callback([weakSelf nearbyPoisForLocation:location limit:limit]);
+    });
+
+    OCMStub([placesMock processRegionEvent:[OCMArg any] forRegionEventType:0]).ignoringNonObjectArgs().andDo(^(NSInvocation* invocation) {
+        __unsafe_unretained CLRegion* region;
+        ACPRegionEventType type;
+        [invocation getArgument:&region atIndex:2];
+        [invocation getArgument:&type atIndex:3];
+        [weakSelf recordRegionEvent:region type:type];
+    });
+}
+
+@end
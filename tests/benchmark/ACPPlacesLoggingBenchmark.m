@@ -0,0 +1,167 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesLoggingBenchmark.m
+//
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import <ACPCore/ACPCore.h>
+#import <ACPCore/ACPExtensionEvent.h>
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesMonitorLog.h"
+
+static NSUInteger const ACPPlacesBenchmarkLoggedEventCount = 10000;
+static NSUInteger const ACPPlacesBenchmarkNearbyPoiCount = 10;
+
+// stands in for a POI in the logged list and counts how often it is turned into text
+@interface ACPPlacesBenchmarkPoi : NSObject
+@property (nonatomic) NSUInteger descriptionCount;
+@end
+
+@implementation ACPPlacesBenchmarkPoi
+- (NSString*) description {
+    _descriptionCount++;
+    return @"{identifier: poi, latitude: 40.4, longitude: -111.8, radius: 100}";
+}
+@end
+
+/**
+ * Compares the two log lines the monitor hits for every event with logging turned down to warnings, as they were
+ * written before (the message built up front and handed to ACPCore) and through the lazy logging macros.
+ *
+ * Allocations are counted as the heap blocks still alive when the events are done, before the autorelease pool is
+ * drained, which is where every message built only to be thrown away by ACPCore ends up.
+ */
+@interface ACPPlacesLoggingBenchmark : XCTestCase
+@property (nonatomic) ACPMobileLogLevel originalLogLevel;
+@property (nonatomic, strong) ACPExtensionEvent *event;
+@property (nonatomic, strong) NSArray<ACPPlacesBenchmarkPoi*> *nearbyPoi;
+@end
+
+@implementation ACPPlacesLoggingBenchmark
+
+- (void) setUp {
+    _originalLogLevel = [ACPCore logLevel];
+    [ACPCore setLogLevel:ACPMobileLogLevelWarning];
+    _event = [ACPExtensionEvent extensionEventWithName:ACPPlacesMonitorEventNameStart_Test
+                                                  type:ACPPlacesMonitorEventTypeMonitor_Test
+                                                source:ACPPlacesMonitorEventSourceRequestContent_Test
+                                                  data:nil
+                                                 error:nil];
+    NSMutableArray *nearbyPoi = [NSMutableArray array];
+
+    for (NSUInteger i = 0; i < ACPPlacesBenchmarkNearbyPoiCount; i++) {
+        [nearbyPoi addObject:[[ACPPlacesBenchmarkPoi alloc] init]];
+    }
+
+    _nearbyPoi = nearbyPoi;
+}
+
+- (void) tearDown {
+    [ACPCore setLogLevel:_originalLogLevel];
+}
+
+- (void) logEagerly: (ACPExtensionEvent*) event nearbyPoi: (NSArray*) nearbyPoi {
+    [ACPCore log:ACPMobileLogLevelVerbose
+             tag:ACPPlacesMonitorExtensionName
+         message:[NSString stringWithFormat:@"ACPPlacesMonitor heard event '%@' (type:%@ - source:%@)", event.eventName, event.eventType, event.eventSource]];
+    [ACPCore log:ACPMobileLogLevelDebug
+             tag:ACPPlacesMonitorExtensionName
+         message:[NSString stringWithFormat:@"Received a new list of POIs from Places: %@", nearbyPoi]];
+}
+
+- (void) logLazily: (ACPExtensionEvent*) event nearbyPoi: (NSArray*) nearbyPoi {
+    ACPPlacesMonitorLogVerbose(@"ACPPlacesMonitor heard event '%@' (type:%@ - source:%@)", event.eventName, event.eventType, event.eventSource);
+    ACPPlacesMonitorLogDebug(@"Received a new list of POIs from Places: %@", nearbyPoi);
+}
+
+- (double) allocationsPerEvent: (void (^)(void)) logEvent {
+    malloc_statistics_t before;
+    malloc_statistics_t after;
+
+    @autoreleasepool {
+        malloc_zone_statistics(NULL, &before);
+
+        for (NSUInteger i = 0; i < ACPPlacesBenchmarkLoggedEventCount; i++) {
+            logEvent();
+        }
+
+        malloc_zone_statistics(NULL, &after);
+    }
+
+    double blocks = after.blocks_in_use > before.blocks_in_use ? after.blocks_in_use - before.blocks_in_use : 0;
+    return blocks / ACPPlacesBenchmarkLoggedEventCount;
+}
+
+- (void) testDisabledMessagesAreNotFormatted {
+    // test
+    [self logEagerly:_event nearbyPoi:_nearbyPoi];
+    NSUInteger eagerDescriptions = _nearbyPoi[0].descriptionCount;
+    [self logLazily:_event nearbyPoi:_nearbyPoi];
+
+    // verify
+    XCTAssertEqual(1, eagerDescriptions);
+    XCTAssertEqual(eagerDescriptions, _nearbyPoi[0].descriptionCount);
+}
+
+- (void) testAllocationsPerEvent {
+    // setup
+    ACPExtensionEvent *event = _event;
+    NSArray *nearbyPoi = _nearbyPoi;
+
+    // test
+    double eager = [self allocationsPerEvent:^{
+        [self logEagerly:event nearbyPoi:nearbyPoi];
+    }];
+    double lazy = [self allocationsPerEvent:^{
+        [self logLazily:event nearbyPoi:nearbyPoi];
+    }];
+
+    // verify
+    NSLog(@"Heap blocks allocated per event with logging at warning, eager: %.2f, lazy: %.2f", eager, lazy);
+    XCTAssertTrue(eager >= 2);
+    XCTAssertTrue(lazy < 1);
+}
+
+- (void) testEagerLogging {
+    // setup
+    ACPExtensionEvent *event = _event;
+    NSArray *nearbyPoi = _nearbyPoi;
+
+    // test
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < ACPPlacesBenchmarkLoggedEventCount; i++) {
+            @autoreleasepool {
+                [self logEagerly:event nearbyPoi:nearbyPoi];
+            }
+        }
+    }];
+}
+
+- (void) testLazyLogging {
+    // setup
+    ACPExtensionEvent *event = _event;
+    NSArray *nearbyPoi = _nearbyPoi;
+
+    // test
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < ACPPlacesBenchmarkLoggedEventCount; i++) {
+            @autoreleasepool {
+                [self logLazily:event nearbyPoi:nearbyPoi];
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,49 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRecordingLocationManager.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @class ACPPlacesRecordingLocationManager
+ *
+ * @discussion A CLLocationManager that counts the calls made by the monitor and emulates the OS.
+ *
+ * Replayed fixes are delivered to the delegate the way iOS would for the services that are currently running:
+ * every fix that passes the distance filter while updating location, the next fix after requestLocation, and a fix
+ * every 500 meters and 5 minutes while monitoring significant changes.  Monitored regions report entries and exits
+ * as soon as a fix crosses their boundary; a region that already contains the device when it is registered
+ * does not report an entry, like on a device.
+ */
+@interface ACPPlacesRecordingLocationManager : CLLocationManager
+
+@property(nonatomic, readonly) NSUInteger startMonitoringForRegionCount;
+@property(nonatomic, readonly) NSUInteger stopMonitoringForRegionCount;
+@property(nonatomic, readonly) NSUInteger deliveredLocationCount;
+@property(nonatomic, readonly) NSUInteger requestLocationCount;
+@property(nonatomic, readonly) BOOL isUpdatingLocation;
+@property(nonatomic, readonly) BOOL isMonitoringSignificantChanges;
+
+/**
+ * @brief Feeds the next fix of a trace to the emulated OS
+ */
+- (void) replayLocation: (CLLocation*) location;
+
+@end
+
+NS_ASSUME_NONNULL_END
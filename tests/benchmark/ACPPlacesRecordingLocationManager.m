@@ -0,0 +1,162 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesRecordingLocationManager.m
+//
+
+#import "ACPPlacesRecordingLocationManager.h"
+
+// documented behavior of the significant-change location service
+static CLLocationDistance const ACPPlacesSignificantChangeDistance = 500.0;
+static NSTimeInterval const ACPPlacesSignificantChangeInterval = 300.0;
+
+@interface ACPPlacesRecordingLocationManager()
+@property(nonatomic, readwrite) NSUInteger startMonitoringForRegionCount;
+@property(nonatomic, readwrite) NSUInteger stopMonitoringForRegionCount;
+@property(nonatomic, readwrite) NSUInteger deliveredLocationCount;
+@property(nonatomic, readwrite) NSUInteger requestLocationCount;
+@property(nonatomic, readwrite) BOOL isUpdatingLocation;
+@property(nonatomic, readwrite) BOOL isMonitoringSignificantChanges;
+@property(nonatomic) BOOL locationRequested;
+@property(nonatomic, strong) NSMutableDictionary<NSString*, CLRegion*>* regions;
+@property(nonatomic, strong) NSMutableDictionary<NSString*, NSNumber*>* regionStates;
+@property(nonatomic, strong, nullable) CLLocation* lastReplayedLocation;
+@property(nonatomic, strong, nullable) CLLocation* lastDeliveredLocation;
+@end
+
+@implementation ACPPlacesRecordingLocationManager
+
+- (instancetype) init {
+    if (self = [super init]) {
+        self.regions = [NSMutableDictionary dictionary];
+        self.regionStates = [NSMutableDictionary dictionary];
+    }
+
+    return self;
+}
+
+#pragma mark - CLLocationManager overrides
+- (CLAuthorizationStatus) authorizationStatus {
+    return kCLAuthorizationStatusAuthorizedAlways;
+}
+
+- (CLLocationDistance) maximumRegionMonitoringDistance {
+    return 10000.0;
+}
+
+- (NSSet<__kindof CLRegion*>*) monitoredRegions {
+    return [NSSet setWithArray:_regions.allValues];
+}
+
+- (void) requestAlwaysAuthorization {
+}
+
+- (void) requestWhenInUseAuthorization {
+}
+
+- (void) startMonitoringForRegion: (CLRegion*) region {
+    _startMonitoringForRegionCount++;
+    _regions[region.identifier] = region;
+
+    // the state at registration is known to the OS but never reported as an entry
+    if (_lastReplayedLocation && [region isKindOfClass:[CLCircularRegion class]]) {
+        _regionStates[region.identifier] = @([(CLCircularRegion*)region containsCoordinate:_lastReplayedLocation.coordinate]);
+    } else {
+        [_regionStates removeObjectForKey:region.identifier];
+    }
+}
+
+- (void) stopMonitoringForRegion: (CLRegion*) region {
+    _stopMonitoringForRegionCount++;
+    [_regions removeObjectForKey:region.identifier];
+    [_regionStates removeObjectForKey:region.identifier];
+}
+
+- (void) startUpdatingLocation {
+    _isUpdatingLocation = YES;
+}
+
+- (void) stopUpdatingLocation {
+    _isUpdatingLocation = NO;
+}
+
+- (void) startMonitoringSignificantLocationChanges {
+    _isMonitoringSignificantChanges = YES;
+}
+
+- (void) stopMonitoringSignificantLocationChanges {
+    _isMonitoringSignificantChanges = NO;
+}
+
+- (void) requestLocation {
+    _requestLocationCount++;
+    _locationRequested = YES;
+}
+
+#pragma mark - replay
+- (void) replayLocation: (CLLocation*) location {
+    self.lastReplayedLocation = location;
+    [self deliverRegionEventsForLocation:location];
+
+    if ([self shouldDeliverLocation:location]) {
+        _locationRequested = NO;
+        _deliveredLocationCount++;
+        self.lastDeliveredLocation = location;
+        [self.delegate locationManager:self didUpdateLocations:@[location]];
+    }
+}
+
+- (BOOL) shouldDeliverLocation: (CLLocation*) location {
+    if (_locationRequested) {
+        return YES;
+    }
+
+    CLLocationDistance moved = _lastDeliveredLocation ? [location distanceFromLocation:_lastDeliveredLocation] : DBL_MAX;
+
+    if (_isUpdatingLocation && (self.distanceFilter == kCLDistanceFilterNone || moved >= self.distanceFilter)) {
+        return YES;
+    }
+
+    if (_isMonitoringSignificantChanges) {
+        NSTimeInterval elapsed = _lastDeliveredLocation ?
+                                 [location.timestamp timeIntervalSinceDate:_lastDeliveredLocation.timestamp] : DBL_MAX;
+        return moved >= ACPPlacesSignificantChangeDistance && elapsed >= ACPPlacesSignificantChangeInterval;
+    }
+
+    return NO;
+}
+
+- (void) deliverRegionEventsForLocation: (CLLocation*) location {
+    // regions can be replaced from inside a callback, so walk a snapshot
+    for (CLRegion* region in [_regions.allValues copy]) {
+        if (![region isKindOfClass:[CLCircularRegion class]] || !_regions[region.identifier]) {
+            continue;
+        }
+
+        BOOL inside = [(CLCircularRegion*)region containsCoordinate:location.coordinate];
+        NSNumber* previous = _regionStates[region.identifier];
+        _regionStates[region.identifier] = @(inside);
+
+        if (!previous || previous.boolValue == inside) {
+            continue;
+        }
+
+        if (inside && region.notifyOnEntry) {
+            [self.delegate locationManager:self didEnterRegion:region];
+        } else if (!inside && region.notifyOnExit) {
+            [self.delegate locationManager:self didExitRegion:region];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,98 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesStateStoreBenchmark.m
+//
+
+#import <XCTest/XCTest.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesStateStore.h"
+
+// keys other SDKs and the app keep in the same defaults domain
+static NSUInteger const ACPPlacesBenchmarkUnrelatedDefaultsCount = 2000;
+static NSUInteger const ACPPlacesBenchmarkMonitoredRegionCount = 20;
+
+/**
+ * Compares loading the monitor's state on a cold start from the state file and from NSUserDefaults.
+ *
+ * Within one process NSUserDefaults serves reads from its cache, so the defaults path is measured as what the first
+ * read after a relaunch costs: reading and parsing the domain's property list.
+ */
+@interface ACPPlacesStateStoreBenchmark : XCTestCase
+@property (nonatomic, strong) NSURL *directory;
+@property (nonatomic, strong) NSDictionary *monitorValues;
+@end
+
+@implementation ACPPlacesStateStoreBenchmark
+
+- (void) setUp {
+    _directory = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    [[NSFileManager defaultManager] createDirectoryAtURL:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+
+    NSMutableArray *regions = [NSMutableArray array];
+
+    for (NSUInteger i = 0; i < ACPPlacesBenchmarkMonitoredRegionCount; i++) {
+        [regions addObject:[NSUUID UUID].UUIDString];
+    }
+
+    _monitorValues = @{ACPPlacesMonitorDefaultsMonitoredRegions_Test: regions,
+                       ACPPlacesMonitorDefaultsUserWithinRegions_Test: @[regions[0]],
+                       ACPPlacesMonitorDefaultsMonitorMode_Test: @(2),
+                       ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test: @(2),
+                       ACPPlacesMonitorDefaultsIsMonitoringStarted_Test: @(YES)};
+}
+
+- (void) tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:_directory error:nil];
+}
+
+- (void) testLoadFromUserDefaultsDomain {
+    // setup
+    NSMutableDictionary *domain = [_monitorValues mutableCopy];
+
+    for (NSUInteger i = 0; i < ACPPlacesBenchmarkUnrelatedDefaultsCount; i++) {
+        domain[[NSString stringWithFormat:@"com.example.sdk.key%lu", (unsigned long)i]] =
+            @{@"identifier": [NSUUID UUID].UUIDString, @"count": @(i), @"enabled": @(i % 2 == 0)};
+    }
+
+    NSURL *plistURL = [_directory URLByAppendingPathComponent:@"domain.plist"];
+    NSData *plist = [NSPropertyListSerialization dataWithPropertyList:domain
+                                                               format:NSPropertyListBinaryFormat_v1_0
+                                                              options:0
+                                                                error:nil];
+    XCTAssertTrue([plist writeToURL:plistURL atomically:YES]);
+
+    // test
+    [self measureBlock:^{
+        NSData *data = [NSData dataWithContentsOfURL:plistURL];
+        NSDictionary *loaded = [NSPropertyListSerialization propertyListWithData:data options:0 format:nil error:nil];
+        XCTAssertEqual(ACPPlacesBenchmarkMonitoredRegionCount,
+                       [loaded[ACPPlacesMonitorDefaultsMonitoredRegions_Test] count]);
+    }];
+}
+
+- (void) testLoadFromStateFile {
+    // setup
+    ACPPlacesStateStore *store = [[ACPPlacesStateStore alloc] initWithFileURL:[_directory URLByAppendingPathComponent:ACPPlacesMonitorStateFileName_Test]];
+    XCTAssertTrue([store writeValues:_monitorValues]);
+
+    // test
+    [self measureBlock:^{
+        NSDictionary *loaded = [store load];
+        XCTAssertEqual(ACPPlacesBenchmarkMonitoredRegionCount,
+                       [loaded[ACPPlacesMonitorDefaultsMonitoredRegions_Test] count]);
+    }];
+}
+
+@end
@@ -0,0 +1,49 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesTrace.h
+//
+
+#import <CoreLocation/CoreLocation.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class ACPPlacesPoi;
+
+/**
+ * @class ACPPlacesTrace
+ *
+ * @discussion A recorded movement trace used by the replay benchmark.
+ *
+ * Traces are read from GPX files (trkpt elements with a time, and an optional hdop that is converted to a horizontal
+ * accuracy) or from CSV files with a timestamp,latitude,longitude,accuracy header.
+ */
+@interface ACPPlacesTrace : NSObject
+
+@property(nonatomic, readonly) NSString* name;
+@property(nonatomic, readonly) NSArray<CLLocation*>* locations;
+
+/**
+ * @brief Loads a .gpx or .csv trace, returns nil if the file can't be read or contains no fixes
+ */
++ (nullable instancetype) traceWithContentsOfFile: (NSString*) path;
+
+/**
+ * @brief Loads POIs from a CSV file with an identifier,latitude,longitude,radius header
+ */
++ (NSArray<ACPPlacesPoi*>*) poisWithContentsOfFile: (NSString*) path;
+
+@end
+
+NS_ASSUME_NONNULL_END
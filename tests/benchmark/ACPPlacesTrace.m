@@ -0,0 +1,171 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesTrace.m
+//
+
+#import "ACPPlaces.h"
+#import "ACPPlacesTrace.h"
+
+// GPX only carries a dilution of precision, this is the usual rule of thumb to turn it into meters
+static double const ACPPlacesTraceMetersPerHdop = 5.0;
+static double const ACPPlacesTraceDefaultAccuracy = 10.0;
+
+@interface ACPPlacesTrace() <NSXMLParserDelegate>
+@property(nonatomic, readwrite) NSString* name;
+@property(nonatomic, readwrite) NSArray<CLLocation*>* locations;
+
+// GPX parser state
+@property(nonatomic, strong) NSMutableArray<CLLocation*>* parsedLocations;
+@property(nonatomic, strong) NSMutableString* elementText;
+@property(nonatomic) CLLocationCoordinate2D pointCoordinate;
+@property(nonatomic, strong) NSDate* pointTime;
+@property(nonatomic) double pointAccuracy;
+@property(nonatomic, strong) NSISO8601DateFormatter* dateFormatter;
+@end
+
+@implementation ACPPlacesTrace
+
++ (instancetype) traceWithContentsOfFile: (NSString*) path {
+    ACPPlacesTrace* trace = [[ACPPlacesTrace alloc] init];
+    trace.name = [[path lastPathComponent] stringByDeletingPathExtension];
+
+    if ([[path pathExtension] isEqualToString:@"gpx"]) {
+        trace.locations = [trace locationsFromGpxFile:path];
+    } else {
+        trace.locations = [trace locationsFromCsvFile:path];
+    }
+
+    return trace.locations.count ? trace : nil;
+}
+
++ (NSArray<ACPPlacesPoi*>*) poisWithContentsOfFile: (NSString*) path {
+    NSMutableArray<ACPPlacesPoi*>* pois = [NSMutableArray array];
+
+    for (NSArray<NSString*>* fields in [self rowsFromCsvFile:path]) {
+        if (fields.count < 4) {
+            continue;
+        }
+
+        ACPPlacesPoi* poi = [[ACPPlacesPoi alloc] init];
+        poi.identifier = fields[0];
+        poi.name = fields[0];
+        poi.latitude = [fields[1] doubleValue];
+        poi.longitude = [fields[2] doubleValue];
+        poi.radius = [fields[3] integerValue];
+        [pois addObject:poi];
+    }
+
+    return pois;
+}
+
+#pragma mark - csv
++ (NSArray<NSArray<NSString*>*>*) rowsFromCsvFile: (NSString*) path {
+    NSString* contents = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+    NSMutableArray<NSArray<NSString*>*>* rows = [NSMutableArray array];
+    BOOL header = YES;
+
+    for (NSString* line in [contents componentsSeparatedByCharactersInSet:[NSCharacterSet newlineCharacterSet]]) {
+        if (!line.length) {
+            continue;
+        }
+
+        if (header) {
+            header = NO;
+            continue;
+        }
+
+        [rows addObject:[line componentsSeparatedByString:@","]];
+    }
+
+    return rows;
+}
+
+- (NSArray<CLLocation*>*) locationsFromCsvFile: (NSString*) path {
+    NSMutableArray<CLLocation*>* locations = [NSMutableArray array];
+
+    for (NSArray<NSString*>* fields in [ACPPlacesTrace rowsFromCsvFile:path]) {
+        if (fields.count < 3) {
+            continue;
+        }
+
+        double accuracy = fields.count > 3 ? [fields[3] doubleValue] : ACPPlacesTraceDefaultAccuracy;
+        [locations addObject:[self locationWithCoordinate:CLLocationCoordinate2DMake([fields[1] doubleValue], [fields[2] doubleValue])
+                                                 accuracy:accuracy
+                                                timestamp:[NSDate dateWithTimeIntervalSince1970:[fields[0] doubleValue]]]];
+    }
+
+    return locations;
+}
+
+#pragma mark - gpx
+- (NSArray<CLLocation*>*) locationsFromGpxFile: (NSString*) path {
+    NSXMLParser* parser = [[NSXMLParser alloc] initWithContentsOfURL:[NSURL fileURLWithPath:path]];
+    parser.delegate = self;
+    self.parsedLocations = [NSMutableArray array];
+    self.dateFormatter = [[NSISO8601DateFormatter alloc] init];
+
+    if (![parser parse]) {
+        return @[];
+    }
+
+    return _parsedLocations;
+}
+
+- (void) parser: (NSXMLParser*) parser
+    didStartElement: (NSString*) elementName
+       namespaceURI: (NSString*) namespaceURI
+      qualifiedName: (NSString*) qName
+         attributes: (NSDictionary<NSString*, NSString*>*) attributeDict {
+    if ([elementName isEqualToString:@"trkpt"]) {
+        self.pointCoordinate = CLLocationCoordinate2DMake([attributeDict[@"lat"] doubleValue], [attributeDict[@"lon"] doubleValue]);
+        self.pointTime = nil;
+        self.pointAccuracy = ACPPlacesTraceDefaultAccuracy;
+    }
+
+    self.elementText = [NSMutableString string];
+}
+
+- (void) parser: (NSXMLParser*) parser foundCharacters: (NSString*) string {
+    [_elementText appendString:string];
+}
+
+- (void) parser: (NSXMLParser*) parser
+    didEndElement: (NSString*) elementName
+     namespaceURI: (NSString*) namespaceURI
+    qualifiedName: (NSString*) qName {
+    NSString* text = [_elementText stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+
+    if ([elementName isEqualToString:@"time"]) {
+        self.pointTime = [_dateFormatter dateFromString:text];
+    } else if ([elementName isEqualToString:@"hdop"]) {
+        self.pointAccuracy = [text doubleValue] * ACPPlacesTraceMetersPerHdop;
+    } else if ([elementName isEqualToString:@"trkpt"] && _pointTime) {
+        [_parsedLocations addObject:[self locationWithCoordinate:_pointCoordinate
+                                                        accuracy:_pointAccuracy
+                                                       timestamp:_pointTime]];
+    }
+}
+
+#pragma mark - helpers
+- (CLLocation*) locationWithCoordinate: (CLLocationCoordinate2D) coordinate
+                              accuracy: (double) accuracy
+                             timestamp: (NSDate*) timestamp {
+    return [[CLLocation alloc] initWithCoordinate:coordinate
+                                         altitude:0
+                               horizontalAccuracy:accuracy
+                                 verticalAccuracy:-1
+                                        timestamp:timestamp];
+}
+
+@end
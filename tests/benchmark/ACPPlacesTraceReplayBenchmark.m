@@ -0,0 +1,265 @@
+/*
+ Copyright 2019 Adobe. All rights reserved.
+ This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License. You may obtain a copy
+ of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software distributed under
+ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ OF ANY KIND, either express or implied. See the License for the specific language
+ governing permissions and limitations under the License.
+ */
+
+//
+// ACPPlacesTraceReplayBenchmark.m
+//
+
+#import <XCTest/XCTest.h>
+#import "OCMock.h"
+#import "ACPCore.h"
+#import "ACPPlaces.h"
+#import "ACPPlacesMetrics.h"
+#import "ACPPlacesMonitor.h"
+#import "ACPPlacesMonitorConstantsTests.h"
+#import "ACPPlacesMonitorInternal.h"
+#import "ACPPlacesMonitorLocationDelegate.h"
+#import "ACPPlacesPersistence.h"
+#import "ACPPlacesSerialExecutor.h"
+#import "ACPPlacesStateStore.h"
+#import "ACPPlacesLocalPoiService.h"
+#import "ACPPlacesRecordingLocationManager.h"
+#import "ACPPlacesTrace.h"
+
+// when set, the results of all replays are written to this path as JSON for compare_benchmark.py
+static NSString* const ACPPlacesBenchmarkOutputVariable = @"ACPPLACESMONITOR_BENCHMARK_OUTPUT";
+static NSString* const ACPPlacesBenchmarkDefaultsSuite = @"com.adobe.placesmonitor.benchmark";
+
+static NSMutableArray<NSDictionary*>* ACPPlacesBenchmarkResults;
+
+// replays run on the simulated clock, so the monitor handles every fix before the next one is replayed
+@interface ACPPlacesBenchmarkExecutor : ACPPlacesSerialExecutor
+@end
+
+@implementation ACPPlacesBenchmarkExecutor
+- (BOOL) isCurrent {
+    return YES;
+}
+@end
+
+// expose private members for testing
+@interface ACPPlacesMonitorInternal()
+@property(nonatomic, strong) ACPPlacesSerialExecutor* executor;
+@property(nonatomic, strong) ACPPlacesMonitorLocationDelegate* locationDelegate;
+@property(atomic, strong) CLLocationManager* locationManager;
+@property(nonatomic, strong) ACPPlacesPersistence* persistence;
+@property(nonatomic, strong) NSMutableArray<NSString*>* currentlyMonitoredRegions;
+@property(nonatomic, strong) NSMutableArray<NSString*>* userWithinRegions;
+@property(nonatomic, strong) ACPPlacesMetrics* metrics;
+- (void) updateMonitorMode: (ACPPlacesMonitorMode) monitorMode;
+- (void) startMonitoring;
+@end
+
+@interface ACPPlacesTraceReplayBenchmark : XCTestCase
+@property (nonatomic, strong) NSString *tracesPath;
+@property (nonatomic, strong) NSArray<ACPPlacesPoi*> *pois;
+@property (nonatomic, strong) id coreMock;
+@end
+
+@implementation ACPPlacesTraceReplayBenchmark
+
++ (void) setUp {
+    ACPPlacesBenchmarkResults = [NSMutableArray array];
+}
+
++ (void) tearDown {
+    NSString *outputPath = [[NSProcessInfo processInfo] environment][ACPPlacesBenchmarkOutputVariable];
+
+    if (!outputPath.length) {
+        return;
+    }
+
+    NSData *json = [NSJSONSerialization dataWithJSONObject:@{@"results": ACPPlacesBenchmarkResults}
+                                                   options:NSJSONWritingPrettyPrinted
+                                                     error:nil];
+    [json writeToFile:outputPath atomically:YES];
+}
+
+- (void) setUp {
+    // traces are read straight from the source tree, the simulator shares the host file system
+    _tracesPath = [[[NSString stringWithUTF8String:__FILE__] stringByDeletingLastPathComponent]
+                   stringByAppendingPathComponent:@"traces"];
+    _pois = [ACPPlacesTrace poisWithContentsOfFile:[_tracesPath stringByAppendingPathComponent:@"pois.csv"]];
+    _coreMock = OCMClassMock([ACPCore class]);
+}
+
+- (void) tearDown {
+    [_coreMock stopMocking];
+    [[[NSUserDefaults alloc] initWithSuiteName:ACPPlacesBenchmarkDefaultsSuite]
+     removePersistentDomainForName:ACPPlacesBenchmarkDefaultsSuite];
+}
+
+- (void) testReplayCommute {
+    [self replayTraceNamed:@"commute.csv"];
+}
+
+- (void) testReplayWalk {
+    [self replayTraceNamed:@"walk.gpx"];
+}
+
+- (void) testReplayDwell {
+    [self replayTraceNamed:@"dwell.csv"];
+}
+
+// a walk through a retail park, where more small shops are nearby than there are region slots
+- (void) testReplayRetailPark {
+    _pois = [ACPPlacesTrace poisWithContentsOfFile:[_tracesPath stringByAppendingPathComponent:@"retail_park_pois.csv"]];
+    XCTAssertTrue(_pois.count > ACPPlacesMonitorDefaultMaxMonitoredRegionCount_Test);
+    [self replayTraceNamed:@"retail_park.csv"];
+}
+
+#pragma mark - replay
+- (void) replayTraceNamed: (NSString*) fileName {
+    ACPPlacesTrace *trace = [ACPPlacesTrace traceWithContentsOfFile:[_tracesPath stringByAppendingPathComponent:fileName]];
+    XCTAssertNotNil(trace, @"unable to load trace %@", fileName);
+    XCTAssertTrue(_pois.count > 0);
+
+    NSDictionary<NSString*, NSNumber*> *modes = @{@"significantChanges": @(ACPPlacesMonitorModeSignificantChanges),
+                                                  @"continuous": @(ACPPlacesMonitorModeContinuous),
+                                                  @"adaptive": @(ACPPlacesMonitorModeAdaptive)};
+
+    for (NSString *modeName in [modes.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        NSDictionary *result = [self replayTrace:trace mode:[modes[modeName] integerValue] modeName:modeName];
+        NSLog(@"[benchmark] %@", result);
+        [ACPPlacesBenchmarkResults addObject:result];
+
+        XCTAssertTrue([result[@"poiQueries"] integerValue] > 0);
+        XCTAssertTrue([result[@"truthEntries"] integerValue] > 0);
+    }
+}
+
+- (NSDictionary*) replayTrace: (ACPPlacesTrace*) trace mode: (ACPPlacesMonitorMode) mode modeName: (NSString*) modeName {
+    // setup - time only moves forward with the trace
+    __block NSTimeInterval now = trace.locations.firstObject.timestamp.timeIntervalSince1970;
+    ACPPlacesLocalPoiService *service = [[ACPPlacesLocalPoiService alloc] initWithPois:_pois];
+    service.clock = ^NSTimeInterval {
+        return now;
+    };
+    id placesMock = OCMClassMock([ACPPlaces class]);
+    [service installOnPlacesMock:placesMock];
+
+    NSUserDefaults *defaults = [[NSUserDefaults alloc] initWithSuiteName:ACPPlacesBenchmarkDefaultsSuite];
+    [defaults removePersistentDomainForName:ACPPlacesBenchmarkDefaultsSuite];
+    NSURL *stateURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:ACPPlacesBenchmarkDefaultsSuite];
+    ACPPlacesStateStore *stateStore = [[ACPPlacesStateStore alloc] initWithFileURL:stateURL];
+    [stateStore remove];
+    ACPPlacesMonitorInternal *monitor = [[ACPPlacesMonitorInternal alloc] init];
+    monitor.executor = [[ACPPlacesBenchmarkExecutor alloc] init];
+    monitor.persistence = [[ACPPlacesPersistence alloc] initWithUserDefaults:defaults stateStore:stateStore flushDelay:3600];
+    [monitor.currentlyMonitoredRegions removeAllObjects];
+    [monitor.userWithinRegions removeAllObjects];
+
+    ACPPlacesRecordingLocationManager *manager = [[ACPPlacesRecordingLocationManager alloc] init];
+    manager.delegate = monitor.locationDelegate;
+    monitor.locationManager = manager;
+
+    // test
+    [monitor updateMonitorMode:mode];
+    [monitor startMonitoring];
+
+    NSTimeInterval lastFlush = now;
+
+    for (CLLocation *location in trace.locations) {
+        now = location.timestamp.timeIntervalSince1970;
+        [manager replayLocation:location];
+
+        // the write-behind timer runs on wall time, so it is emulated on the simulated clock
+        if ([monitor.persistence hasPendingWrites] && now - lastFlush >= ACPPlacesMonitorPersistenceFlushDelay_Test) {
+            [monitor.persistence flush];
+            lastFlush = now;
+        }
+    }
+
+    [monitor.persistence flush];
+    [placesMock stopMocking];
+
+    // verify
+    NSMutableDictionary *result = [@{@"trace": trace.name,
+                                     @"mode": modeName,
+                                     @"fixes": @(trace.locations.count),
+                                     @"deliveredFixes": @(manager.deliveredLocationCount),
+                                     @"poiQueries": @(service.queryCount),
+                                     @"regionStarts": @(manager.startMonitoringForRegionCount),
+                                     @"regionStops": @(manager.stopMonitoringForRegionCount),
+                                     @"persistenceWrites": @(monitor.persistence.flushCount),
+                                     @"persistenceRequestedWrites": @(monitor.persistence.requestedWriteCount),
+                                     @"requestedLocations": @(manager.requestLocationCount),
+                                     @"clusterSlotsSaved": @([monitor.metrics valueOfCounter:ACPPlacesMetricCounterClusterSlotsSaved]),
+                                     @"clusterResolutionFixes": @([monitor.metrics valueOfCounter:ACPPlacesMetricCounterClusterResolutionFixes])} mutableCopy];
+    [result addEntriesFromDictionary:[self entryDetectionForTrace:trace events:service.regionEvents]];
+    return result;
+}
+
+#pragma mark - ground truth
+/**
+ * @brief Compares the entries reported to Places with the entries that really happened along the trace
+ *
+ * @discussion A visit starts with the first fix inside a POI.  It counts as detected if Places received an entry
+ * for the POI between the end of the previous visit and the end of this one; the delay is measured from the start
+ * of the visit.
+ */
+- (NSDictionary*) entryDetectionForTrace: (ACPPlacesTrace*) trace events: (NSArray<NSDictionary*>*) events {
+    NSUInteger truthEntries = 0;
+    NSUInteger detectedEntries = 0;
+    double totalDelay = 0;
+    double maximumDelay = 0;
+
+    for (ACPPlacesPoi *poi in _pois) {
+        CLLocation *center = [[CLLocation alloc] initWithLatitude:poi.latitude longitude:poi.longitude];
+        NSMutableArray<NSNumber*> *entryTimes = [NSMutableArray array];
+        for (NSDictionary *event in events) {
+            if ([event[@"identifier"] isEqualToString:poi.identifier] &&
+                [event[@"type"] integerValue] == ACPRegionEventTypeEntry) {
+                [entryTimes addObject:event[@"time"]];
+            }
+        }
+
+        BOOL inside = NO;
+        double visitStart = 0;
+        double previousVisitEnd = -DBL_MAX;
+
+        for (NSUInteger i = 0; i <= trace.locations.count; i++) {
+            BOOL last = i == trace.locations.count;
+            CLLocation *location = last ? nil : trace.locations[i];
+            BOOL nowInside = !last && [location distanceFromLocation:center] <= poi.radius;
+
+            if (!inside && nowInside) {
+                visitStart = location.timestamp.timeIntervalSince1970;
+            } else if (inside && !nowInside) {
+                double visitEnd = last ? DBL_MAX : location.timestamp.timeIntervalSince1970;
+                truthEntries++;
+
+                for (NSNumber *time in entryTimes) {
+                    if (time.doubleValue >= previousVisitEnd && time.doubleValue < visitEnd) {
+                        double delay = MAX(0, time.doubleValue - visitStart);
+                        totalDelay += delay;
+                        maximumDelay = MAX(maximumDelay, delay);
+                        detectedEntries++;
+                        break;
+                    }
+                }
+
+                previousVisitEnd = visitEnd;
+            }
+
+            inside = nowInside;
+        }
+    }
+
+    return @{@"truthEntries": @(truthEntries),
+             @"detectedEntries": @(detectedEntries),
+             @"missedEntries": @(truthEntries - detectedEntries),
+             @"meanEntryDelay": @(detectedEntries ? totalDelay / detectedEntries : 0),
+             @"maxEntryDelay": @(maximumDelay)};
+}
+
+@end
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+#
+# Copyright 2019 Adobe. All rights reserved.
+# This file is licensed to you under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License. You may obtain a copy
+# of the License at http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software distributed under
+# the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+# OF ANY KIND, either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+#
+
+"""Compares trace replay benchmark results with the stored baseline.
+
+usage: compare_benchmark.py RESULTS BASELINE [--update] [--tolerance PERCENT]
+
+Every metric is lower-is-better.  A metric regresses when it grows by more than the tolerance and by more than
+one unit, so small traces don't fail on a single extra query.  A trace and mode missing from either side is a
+failure, as is a missing baseline; --update replaces the baseline with the results, which must then be reviewed
+and committed.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+
+METRICS = [
+    "poiQueries",
+    "regionStarts",
+    "regionStops",
+    "persistenceWrites",
+    "requestedLocations",
+    "missedEntries",
+    "meanEntryDelay",
+    "maxEntryDelay",
+]
+
+
+def load(path):
+    with open(path) as f:
+        return {(r["trace"], r["mode"]): r for r in json.load(f)["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("results")
+    parser.add_argument("baseline")
+    parser.add_argument("--update", action="store_true", help="store the results as the new baseline")
+    parser.add_argument("--tolerance", type=float, default=5.0, help="allowed growth in percent (default 5)")
+    args = parser.parse_args()
+
+    try:
+        results = load(args.results)
+    except (OSError, ValueError, KeyError) as error:
+        print("unable to read benchmark results %s: %s" % (args.results, error))
+        return 2
+
+    if args.update:
+        shutil.copyfile(args.results, args.baseline)
+        print("stored %d results as the baseline in %s" % (len(results), args.baseline))
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print("no benchmark baseline at %s, record one with --update and commit it" % args.baseline)
+        return 2
+
+    try:
+        baseline = load(args.baseline)
+    except (OSError, ValueError, KeyError) as error:
+        print("unable to read benchmark baseline %s: %s" % (args.baseline, error))
+        return 2
+
+    regressions = 0
+    print("%-10s %-20s %-26s %12s %12s %9s" % ("trace", "mode", "metric", "baseline", "current", "change"))
+
+    for key in sorted(results):
+        if key not in baseline:
+            print("%-10s %-20s not in baseline" % key)
+            regressions += 1
+            continue
+
+        for metric in METRICS:
+            old = float(baseline[key].get(metric, 0))
+            new = float(results[key].get(metric, 0))
+            change = (new - old) / old * 100.0 if old else (0.0 if new == old else float("inf"))
+            regressed = new - old > 1 and change > args.tolerance
+            regressions += regressed
+            print("%-10s %-20s %-26s %12.1f %12.1f %8.1f%%%s" % (key[0], key[1], metric, old, new, change,
+                                                                 "  REGRESSION" if regressed else ""))
+
+    for key in sorted(set(baseline) - set(results)):
+        print("%-10s %-20s missing from results" % key)
+        regressions += 1
+
+    print("%d regression(s)" % regressions)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+# Copyright 2019 Adobe. All rights reserved.
+# This file is licensed to you under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License. You may obtain a copy
+# of the License at http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software distributed under
+# the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+# OF ANY KIND, either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+#
+
+"""Checks the preprocessor definitions the sources rely on to tell debug and release builds apart.
+
+usage: check_build_settings.py [ROOT]
+
+ACPPlacesMonitorLog.h compiles verbose logging out of builds without DEBUG.  The Debug and Test configurations of
+the project must define DEBUG=1, the Release configurations must not, and the podspec must keep the definitions
+CocoaPods sets for the app's debug configurations.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+PROJECT = "ACPPlacesMonitor.xcodeproj/project.pbxproj"
+PODSPEC = "ACPPlacesMonitor.podspec"
+LOG_HEADER = "ACPPlacesMonitor/ACPPlacesMonitorLog.h"
+
+CONFIGURATION = re.compile(r"^\t\t(\w{24}) /\* (\w+) \*/ = \{\n\t\t\tisa = XCBuildConfiguration;(.*?)^\t\t\};",
+                           re.MULTILINE | re.DOTALL)
+CONFIGURATION_LIST = re.compile(r"isa = XCConfigurationList;\s*buildConfigurations = \((.*?)\);", re.DOTALL)
+DEFINITIONS = re.compile(r"GCC_PREPROCESSOR_DEFINITIONS = (\((.*?)\)|\"?([^;\"]*)\"?);", re.DOTALL)
+
+
+def definitions(settings):
+    match = DEFINITIONS.search(settings)
+
+    if not match:
+        return ["$(inherited)"]
+
+    values = match.group(2) if match.group(2) is not None else match.group(3)
+    return [value.strip().strip('"') for value in re.split(r"[,\s]+", values) if value.strip()]
+
+
+def defines_debug(values):
+    return "DEBUG=1" in values or "DEBUG" in values
+
+
+def check_project(path):
+    with open(path) as f:
+        project = f.read()
+
+    configurations = {identifier: (name, definitions(settings))
+                      for identifier, name, settings in CONFIGURATION.findall(project)}
+    lists = [re.findall(r"(\w{24}) /\*", body) for body in CONFIGURATION_LIST.findall(project)]
+
+    # the project's own list is the one whose configurations are inherited by every target
+    project_list = next((identifiers for identifiers in lists
+                         if any(defines_debug(configurations[identifier][1]) for identifier in identifiers)), [])
+    project_definitions = {configurations[identifier][0]: configurations[identifier][1] for identifier in project_list}
+    errors = []
+
+    for identifier, (name, values) in sorted(configurations.items()):
+        resolved = list(values)
+
+        if "$(inherited)" in values and identifier not in project_list:
+            resolved += project_definitions.get(name, [])
+
+        if name == "Release" and defines_debug(resolved):
+            errors.append("%s: the %s Release configuration defines DEBUG" % (path, identifier))
+        elif name != "Release" and not defines_debug(resolved):
+            errors.append("%s: the %s %s configuration does not define DEBUG=1" % (path, identifier, name))
+
+    if not project_list:
+        errors.append("%s: no configuration defines DEBUG=1" % path)
+
+    return errors
+
+
+def check_podspec(path):
+    with open(path) as f:
+        podspec = f.read()
+
+    match = re.search(r"\"GCC_PREPROCESSOR_DEFINITIONS\"\s*=>\s*\"([^\"]*)\"", podspec)
+
+    if match and "$(inherited)" not in match.group(1):
+        return ["%s: GCC_PREPROCESSOR_DEFINITIONS drops $(inherited), and with it DEBUG=1 in debug builds" % path]
+
+    return []
+
+
+def check_log_header(path):
+    with open(path) as f:
+        header = f.read()
+
+    if not re.search(r"^#if !DEBUG\b", header, re.MULTILINE):
+        return ["%s: verbose logging is no longer compiled out on DEBUG" % path]
+
+    return []
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("root", nargs="?", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    args = parser.parse_args()
+
+    errors = (check_project(os.path.join(args.root, PROJECT)) +
+              check_podspec(os.path.join(args.root, PODSPEC)) +
+              check_log_header(os.path.join(args.root, LOG_HEADER)))
+
+    for error in errors:
+        print(error)
+
+    print("%d build setting problem(s)" % len(errors))
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -21,12 +21,65 @@
 static NSString* const ACPPlacesMonitorExtensionVersion_Test = @"2.1.4";
 static NSString* const ACPPlacesMonitorExtensionName_Test = @"com.adobe.placesMonitor";
 static int const ACPPlacesMonitorDefaultMaxMonitoredRegionCount_Test = 20;
+static int const ACPPlacesMonitorCandidatePoiCount_Test = 50;
+static NSString* const ACPPlacesMonitorBoundaryRegionIdentifier_Test = @"acpplacesmonitor.boundary";
+static double const ACPPlacesMonitorBoundaryMinimumRadius_Test = 100.0;
+static double const ACPPlacesMonitorClusterMaximumRadius_Test = 200.0;
+static NSString* const ACPPlacesMonitorExecutorLabel_Test = @"com.adobe.placesMonitor.executor";
+
+static double const ACPPlacesMonitorPoiCacheCellSize_Test = 1000.0;
+static double const ACPPlacesMonitorPoiCacheValidityRadius_Test = 500.0;
+static double const ACPPlacesMonitorPoiCacheTimeToLive_Test = 900.0;
+static int const ACPPlacesMonitorPoiCacheCapacity_Test = 16;
+
+static double const ACPPlacesMonitorPoiPackSearchRadius_Test = 50000.0;
+static double const ACPPlacesMonitorPoiPackRefreshInterval_Test = 86400.0;
+static double const ACPPlacesMonitorPoiPackRefreshRadius_Test = 2000.0;
+static int const ACPPlacesMonitorPoiPackDeltaCapacity_Test = 16;
+
+static int const ACPPlacesMonitorPrefetchHistorySize_Test = 8;
+static double const ACPPlacesMonitorPrefetchHistoryWindow_Test = 600.0;
+static double const ACPPlacesMonitorPrefetchHorizon_Test = 300.0;
+static double const ACPPlacesMonitorPrefetchMinimumSpeed_Test = 5.0;
+static double const ACPPlacesMonitorPrefetchSpacing_Test = 1000.0;
+static int const ACPPlacesMonitorPrefetchMaximumPoints_Test = 4;
+static double const ACPPlacesMonitorPrefetchHitRadius_Test = 500.0;
+
+static double const ACPPlacesMonitorDefaultDistanceFilter_Test = 100.0;
+static double const ACPPlacesMonitorAdaptiveNearDistance_Test = 500.0;
+static double const ACPPlacesMonitorAdaptiveFarDistance_Test = 1000.0;
+static double const ACPPlacesMonitorAdaptiveNearDistanceFilter_Test = 10.0;
+static double const ACPPlacesMonitorAdaptiveContinuousTimeLimit_Test = 300.0;
+
+static double const ACPPlacesMonitorContainmentMinimumBand_Test = 10.0;
+static double const ACPPlacesMonitorContainmentMaximumAccuracy_Test = 100.0;
+
+static double const ACPPlacesMonitorBeaconRangingWindow_Test = 4.0;
+static double const ACPPlacesMonitorBeaconRangingInterval_Test = 20.0;
+static double const ACPPlacesMonitorBeaconEntryDistance_Test = 3.0;
+static double const ACPPlacesMonitorBeaconExitDistance_Test = 8.0;
+static double const ACPPlacesMonitorBeaconExitTimeout_Test = 45.0;
+static double const ACPPlacesMonitorBeaconDesiredAccuracy_Test = 100.0;
+static NSString* const ACPPlacesMonitorBeaconRegionIdentifierPrefix_Test = @"acpplacesmonitor.beacon.";
+
+static double const ACPPlacesMonitorRegionEventDwellTime_Test = 0.0;
+
+static double const ACPPlacesMonitorRetryBaseDelay_Test = 2.0;
+static double const ACPPlacesMonitorRetryMaximumDelay_Test = 300.0;
+static int const ACPPlacesMonitorRetryMaximumAttempts_Test = 5;
+static int const ACPPlacesMonitorCircuitBreakerFailureThreshold_Test = 3;
+static double const ACPPlacesMonitorCircuitBreakerOpenDuration_Test = 600.0;
 
 static NSString* const ACPPlacesMonitorDefaultsMonitoredRegions_Test = @"acpplacesmonitor.monitoredregions";
 static NSString* const ACPPlacesMonitorDefaultsUserWithinRegions_Test = @"acpplacesmonitor.userwithinregions";
 static NSString* const ACPPlacesMonitorDefaultsMonitorMode_Test = @"acpplacesmonitor.monitormode";
 static NSString* const ACPPlacesMonitorDefaultsRequestAuthorizationLevel_Test = @"acpplacesmonitor.requestauthorizationlevel";
 static NSString* const ACPPlacesMonitorDefaultsIsMonitoringStarted_Test = @"acpplacesmonitor.ismonitoringstarted";
+static NSString* const ACPPlacesMonitorStateLastQueryLocation_Test = @"acpplacesmonitor.lastquerylocation";
+static NSString* const ACPPlacesMonitorStateDirectoryName_Test = @"com.adobe.placesmonitor";
+static NSString* const ACPPlacesMonitorStateFileName_Test = @"state.bin";
+static double const ACPPlacesMonitorPersistenceFlushDelay_Test = 2.0;
+static int const ACPPlacesMonitorEventQueueCapacity_Test = 32;
 
 #pragma mark - Event Data Keys
 // event sources
@@ -60,9 +113,23 @@ static NSString* const ACPPlacesMonitorEventNameStop_Test = @"stop monitoring";
 static NSString* const ACPPlacesMonitorEventNameUpdateLocationNow_Test = @"update location now";
 static NSString* const ACPPlacesMonitorEventNameUpdateMonitorConfiguration_Test = @"update monitor configuration";
 static NSString* const ACPPlacesMonitorEventNameSetRequestAuthorizationLevel_Test = @"set request authorization level";
+static NSString* const ACPPlacesMonitorEventNameGetMetrics_Test = @"get metrics";
+static NSString* const ACPPlacesMonitorEventNameSetMetricsReportingInterval_Test = @"set metrics reporting interval";
+static NSString* const ACPPlacesMonitorEventNameMetrics_Test = @"places monitor metrics";
+static NSString* const ACPPlacesMonitorEventNameSetRegionEventDwellTime_Test = @"set region event dwell time";
+static NSString* const ACPPlacesMonitorEventNameLocationManagerReady_Test = @"location manager ready";
+static NSString* const ACPPlacesMonitorEventNameSetPoiPack_Test = @"set poi pack";
 
 static NSString* const ACPPlacesMonitorEventDataMonitorMode_Test = @"monitormode";
 static NSString* const ACPPlacesMonitorEventDataClear_Test = @"clearclientdata";
 static NSString* const ACPPlacesMonitorEventDataRequestAuthorizationLevel_Test = @"requestauthorizationlevel";
+static NSString* const ACPPlacesMonitorEventDataMetrics_Test = @"metrics";
+static NSString* const ACPPlacesMonitorEventDataMetricsReportingInterval_Test = @"metricsreportinginterval";
+static NSString* const ACPPlacesMonitorEventDataRegionEventDwellTime_Test = @"regioneventdwelltime";
+static NSString* const ACPPlacesMonitorEventDataPoiPackPath_Test = @"poipackpath";
+
+static NSString* const ACPPlacesMonitorPoiMetadataBeaconUuid_Test = @"beaconuuid";
+static NSString* const ACPPlacesMonitorPoiMetadataBeaconMajor_Test = @"beaconmajor";
+static NSString* const ACPPlacesMonitorPoiMetadataBeaconMinor_Test = @"beaconminor";
 
 #endif /* ACPPlacesMonitorConstantsTests_h */